@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Reads the JSON or CSV written by `bench` and, for each pair of neighbouring
+tiers swept in it, prints the operand size from which the faster tier wins at
+every larger size measured, as the build flag that sets it.
+
+    ./bench --ops mul_basecase,mul_karatsuba --max 200 --format json --out r.json
+    python3 crossover.py r.json
+"""
+
+import csv
+import json
+import sys
+
+# (slower below the crossover, faster above it, flag)
+TIERS = [
+    ("mul_basecase", "mul_karatsuba", "JL_MUL_KARATSUBA_THRESHOLD"),
+    ("sqr_basecase", "sqr_karatsuba", "JL_SQR_KARATSUBA_THRESHOLD"),
+    ("mul_karatsuba", "mul_toom3", "JL_MUL_TOOM3_THRESHOLD"),
+    ("mul_toom3", "mul_toom4", "JL_MUL_TOOM4_THRESHOLD"),
+    ("mul_toom4", "mul_ntt", "JL_MUL_NTT_THRESHOLD"),
+]
+
+
+def load(path):
+    with open(path) as f:
+        if path.endswith(".json"):
+            rows = json.load(f)["results"]
+        else:
+            rows = list(csv.DictReader(f))
+    times = {}
+    for r in rows:
+        times.setdefault(r["op"], {})[int(r["limbs"])] = float(r["median_ns"])
+    return times
+
+
+def crossover(lo, hi):
+    """Smallest size from which hi is never slower than lo, or None."""
+    sizes = sorted(set(lo) & set(hi))
+    at = None
+    for n in reversed(sizes):
+        if hi[n] > lo[n]:
+            break
+        at = n
+    return at
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+    times = load(sys.argv[1])
+    for lo, hi, flag in TIERS:
+        if lo not in times or hi not in times:
+            continue
+        n = crossover(times[lo], times[hi])
+        if n is None:
+            print("# %s never beats %s in this sweep" % (hi, lo))
+        else:
+            print("-D%s=%d  # %s -> %s" % (flag, n, lo, hi))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+extern "C" {
+#include "../src/add_par.h"
+#include "../src/add_sub_mul.h"
+#include "../src/csa.h"
+#include "../src/div.h"
+#include "../src/layout.h"
+#include "../src/mul_par.h"
+#include "../src/ntt.h"
+#include "../src/pool.h"
+#include "../src/root.h"
+#include "../src/toom.h"
+}
+
+// Sweeps operand sizes geometrically for every operation in `ops`, and reports
+// the median time per call, in ns and in TSC ticks, over a number of samples.
+// Each sample repeats the call until it has run for at least --min-time, after
+// a warm-up call that also sizes the repeat count. See --help.
+
+struct buffers {
+  std::vector<jl_limb_t> x, y, z, r, scratch;
+  std::vector<uint8_t> bx, by, bz;
+};
+
+struct op {
+  const char *name;
+  size_t max_n; // Largest size swept unless --no-cap, to keep sweeps short.
+  // Scratch limbs for operands of n limbs.
+  size_t (*itch)(size_t n);
+  void (*run)(buffers &b, size_t n);
+};
+
+static size_t no_itch(size_t) { return 0; }
+
+static const op ops[] = {
+    {"add_bstrings", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       uint8_t flags;
+       add_bstrings(b.bx.data(), b.by.data(), b.bz.data(), &flags, 8 * n,
+                    8 * n, 8 * n + 1);
+     }},
+    {"sub_bstrings", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       uint8_t flags;
+       sub_bstrings(b.bx.data(), b.by.data(), b.bz.data(), &flags, 8 * n,
+                    8 * n, 8 * n);
+     }},
+    // One more term of a running sum, against add_bstrings above. The
+    // accumulator keeps growing by a few bits a call, and is never freed.
+    {"csa_add_bstring", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       static jl_csa acc;
+       csa_add_bstring(&acc, b.bx.data(), 8 * n);
+     }},
+    {"add_n", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) { add_n(b.z.data(), b.x.data(), b.y.data(), n); }},
+    {"sub_n", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) { sub_n(b.z.data(), b.x.data(), b.y.data(), n); }},
+    {"addmul_1", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) { addmul_1(b.z.data(), b.x.data(), n, b.y[0]); }},
+    {"mul_basecase", 2000, no_itch,
+     [](buffers &b, size_t n) {
+       mul_basecase(b.z.data(), b.x.data(), n, b.y.data(), n);
+     }},
+    {"mul_karatsuba", 20000,
+     [](size_t n) { return mul_karatsuba_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_karatsuba(b.z.data(), b.x.data(), n, b.y.data(), n,
+                     b.scratch.data());
+     }},
+    {"mul_toom3", 50000, [](size_t n) { return mul_toom3_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_toom3(b.z.data(), b.x.data(), n, b.y.data(), n, b.scratch.data());
+     }},
+    {"mul_toom4", 50000, [](size_t n) { return mul_toom4_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_toom4(b.z.data(), b.x.data(), n, b.y.data(), n, b.scratch.data());
+     }},
+    {"mul_ntt", SIZE_MAX, [](size_t n) { return mul_ntt_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_ntt(b.z.data(), b.x.data(), n, b.y.data(), n, b.scratch.data());
+     }},
+    {"mul_limbs", SIZE_MAX, [](size_t n) { return mul_limbs_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_limbs(b.z.data(), b.x.data(), n, b.y.data(), n, b.scratch.data());
+     }},
+    {"mul_limbs_par", SIZE_MAX,
+     [](size_t n) { return mul_limbs_par_itch(n, n); },
+     [](buffers &b, size_t n) {
+       mul_limbs_par(b.z.data(), b.x.data(), n, b.y.data(), n,
+                     b.scratch.data());
+     }},
+    {"mul_bstrings", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       uint8_t flags;
+       mul_bstrings(b.bx.data(), b.by.data(), b.bz.data(), &flags, 8 * n,
+                    8 * n, 16 * n);
+     }},
+    {"mul_layout_be", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       uint8_t flags;
+       mul_layout(b.bx.data(), b.by.data(), b.bz.data(), &flags, 8 * n, 8 * n,
+                  16 * n, &jl_layout_be);
+     }},
+    {"sqr_basecase", 2000, no_itch,
+     [](buffers &b, size_t n) { sqr_basecase(b.z.data(), b.x.data(), n); }},
+    {"sqr_karatsuba", 20000, [](size_t n) { return sqr_karatsuba_itch(n); },
+     [](buffers &b, size_t n) {
+       sqr_karatsuba(b.z.data(), b.x.data(), n, b.scratch.data());
+     }},
+    {"sqr_toom3", 50000, [](size_t n) { return sqr_toom3_itch(n); },
+     [](buffers &b, size_t n) {
+       sqr_toom3(b.z.data(), b.x.data(), n, b.scratch.data());
+     }},
+    {"sqr_toom4", 50000, [](size_t n) { return sqr_toom4_itch(n); },
+     [](buffers &b, size_t n) {
+       sqr_toom4(b.z.data(), b.x.data(), n, b.scratch.data());
+     }},
+    {"sqr_ntt", SIZE_MAX, [](size_t n) { return sqr_ntt_itch(n); },
+     [](buffers &b, size_t n) {
+       sqr_ntt(b.z.data(), b.x.data(), n, b.scratch.data());
+     }},
+    {"sqr_limbs", SIZE_MAX, [](size_t n) { return sqr_limbs_itch(n); },
+     [](buffers &b, size_t n) {
+       sqr_limbs(b.z.data(), b.x.data(), n, b.scratch.data());
+     }},
+    // 2n limbs by n limbs.
+    {"divrem_limbs", SIZE_MAX,
+     [](size_t n) { return divrem_limbs_itch(2 * n, n); },
+     [](buffers &b, size_t n) {
+       divrem_limbs(b.z.data(), b.r.data(), b.x.data(), 2 * n, b.y.data(), n,
+                    b.scratch.data());
+     }},
+    // The root and remainder of 2n limbs.
+    {"sqrtrem_bstrings", SIZE_MAX, no_itch,
+     [](buffers &b, size_t n) {
+       uint8_t flags;
+       sqrtrem_bstrings(b.bx.data(), b.bz.data(), b.bz.data() + 8 * n, &flags,
+                        16 * n, 8 * n, 8 * n + 1);
+     }},
+};
+
+// Knobs --set can change before the sweep, e.g. to time mul_karatsuba with its
+// recursion cut off at a candidate threshold.
+static const struct {
+  const char *name;
+  void (*set)(size_t n);
+} knobs[] = {
+    {"mul_karatsuba", set_mul_karatsuba_threshold},
+    {"sqr_karatsuba", set_sqr_karatsuba_threshold},
+    {"mul_toom3", set_mul_toom3_threshold},
+    {"mul_toom4", set_mul_toom4_threshold},
+    {"mul_ntt", set_mul_ntt_threshold},
+    {"div_dc", set_div_dc_threshold},
+    {"mul_par_grain", set_mul_par_grain},
+    {"add_par_grain", set_add_par_grain},
+};
+
+static bool set_knob(const char *kv) {
+  const char *eq = strchr(kv, '=');
+  if (eq == NULL)
+    return false;
+  for (size_t i = 0; i < sizeof(knobs) / sizeof(knobs[0]); i++) {
+    if (strncmp(kv, knobs[i].name, eq - kv) == 0 &&
+        knobs[i].name[eq - kv] == 0) {
+      knobs[i].set(strtoull(eq + 1, NULL, 10));
+      return true;
+    }
+  }
+  return false;
+}
+
+struct result {
+  const char *op;
+  size_t limbs;
+  size_t samples;
+  size_t iters;
+  double median_ns;
+  double min_ns;
+  double median_ticks;
+};
+
+static uint64_t ticks() {
+#if HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static double median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  const size_t h = v.size() / 2;
+  return v.size() % 2 ? v[h] : (v[h - 1] + v[h]) / 2;
+}
+
+static result time_op(const op &o, buffers &b, size_t n, size_t samples,
+                      double min_ns) {
+  typedef std::chrono::steady_clock clock;
+
+  // Warm up, and repeat enough calls that a sample lasts at least min_ns.
+  auto t0 = clock::now();
+  o.run(b, n);
+  double once =
+      std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+  size_t iters = 1;
+  while (once * iters < min_ns && iters < ((size_t)1 << 30))
+    iters *= 2;
+
+  std::vector<double> ns, tk;
+  for (size_t s = 0; s < samples; s++) {
+    const uint64_t c0 = ticks();
+    auto t1 = clock::now();
+    for (size_t i = 0; i < iters; i++)
+      o.run(b, n);
+    auto t2 = clock::now();
+    const uint64_t c1 = ticks();
+    ns.push_back(std::chrono::duration<double, std::nano>(t2 - t1).count() /
+                 iters);
+    tk.push_back((double)(c1 - c0) / iters);
+  }
+
+  result r = {o.name, n, samples, iters, median(ns),
+              *std::min_element(ns.begin(), ns.end()), median(tk)};
+  return r;
+}
+
+static void fill(buffers &b, size_t n, size_t itch) {
+  const size_t limbs = 2 * n + 1;
+  if (b.x.size() >= limbs && b.scratch.size() >= itch)
+    return;
+
+  uint64_t s = 0x9E3779B97F4A7C15ull;
+  b.x.resize(limbs);
+  b.y.resize(limbs);
+  for (size_t i = 0; i < limbs; i++) {
+    s = s * 6364136223846793005ull + 1442695040888963407ull;
+    b.x[i] = s;
+    s = s * 6364136223846793005ull + 1442695040888963407ull;
+    b.y[i] = s | ((jl_limb_t)1 << 63); // A normalized divisor at any length.
+  }
+  b.z.assign(2 * limbs, 0);
+  b.r.assign(limbs, 0);
+  b.scratch.resize(std::max(itch, b.scratch.size()));
+  b.bx.resize(8 * limbs);
+  b.by.resize(8 * limbs);
+  b.bz.resize(16 * limbs);
+  memcpy(b.bx.data(), b.x.data(), 8 * limbs);
+  memcpy(b.by.data(), b.y.data(), 8 * limbs);
+}
+
+static void usage(const char *argv0) {
+  printf("usage: %s [options]\n"
+         "  --ops a,b,...     operations to run (default: all, see --list)\n"
+         "  --min N           smallest operand size in limbs (default 1)\n"
+         "  --max N           largest operand size in limbs (default 10000)\n"
+         "  --ratio R         growth factor between sizes (default 1.25)\n"
+         "  --samples K       timed samples per size (default 7)\n"
+         "  --min-time MS     minimum length of a sample (default 1)\n"
+         "  --threads N       start a pool of N threads (default: stopped)\n"
+         "  --set KNOB=N      set a threshold first; KNOB is mul_karatsuba,\n"
+         "                    sqr_karatsuba, mul_toom3, mul_toom4, mul_ntt,\n"
+         "                    div_dc, mul_par_grain or add_par_grain\n"
+         "  --no-cap          sweep quadratic ops past their usual cap\n"
+         "  --format csv|json output format (default csv)\n"
+         "  --out FILE        write results to FILE instead of stdout\n"
+         "  --list            list the operations and exit\n",
+         argv0);
+}
+
+static void write_csv(FILE *f, const std::vector<result> &rs) {
+  fprintf(f, "op,limbs,samples,iters,median_ns,min_ns,ns_per_limb,"
+             "ticks_per_limb\n");
+  for (const result &r : rs) {
+    fprintf(f, "%s,%zu,%zu,%zu,%.1f,%.1f,%.4f,", r.op, r.limbs, r.samples,
+            r.iters, r.median_ns, r.min_ns, r.median_ns / r.limbs);
+    if (HAVE_TSC)
+      fprintf(f, "%.4f", r.median_ticks / r.limbs);
+    fprintf(f, "\n");
+  }
+}
+
+static void write_json(FILE *f, const std::vector<result> &rs) {
+  fprintf(f, "{\n  \"limb_kernels\": %u,\n  \"pool_threads\": %zu,\n",
+          get_limb_kernels(), get_pool_threads());
+  fprintf(f, "  \"ticks\": \"%s\",\n  \"results\": [", HAVE_TSC ? "tsc" : "");
+  for (size_t i = 0; i < rs.size(); i++) {
+    const result &r = rs[i];
+    fprintf(f,
+            "%s\n    {\"op\": \"%s\", \"limbs\": %zu, \"samples\": %zu, "
+            "\"iters\": %zu, \"median_ns\": %.1f, \"min_ns\": %.1f, "
+            "\"ns_per_limb\": %.4f, \"ticks_per_limb\": ",
+            i ? "," : "", r.op, r.limbs, r.samples, r.iters, r.median_ns,
+            r.min_ns, r.median_ns / r.limbs);
+    if (HAVE_TSC)
+      fprintf(f, "%.4f}", r.median_ticks / r.limbs);
+    else
+      fprintf(f, "null}");
+  }
+  fprintf(f, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+  std::string only, format = "csv", out;
+  size_t min_n = 1, max_n = 10000, samples = 7, threads = 0;
+  double ratio = 1.25, min_ms = 1;
+  bool cap = true;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+    if (a == "--no-cap") {
+      cap = false;
+      continue;
+    }
+    if (a == "--list") {
+      for (const op &o : ops)
+        printf("%s\n", o.name);
+      return 0;
+    }
+    if (a == "--help" || a == "-h" || v == NULL) {
+      usage(argv[0]);
+      return a == "--help" || a == "-h" ? 0 : 1;
+    }
+    i++;
+    if (a == "--ops")
+      only = "," + std::string(v) + ",";
+    else if (a == "--min")
+      min_n = strtoull(v, NULL, 10);
+    else if (a == "--max")
+      max_n = strtoull(v, NULL, 10);
+    else if (a == "--ratio")
+      ratio = strtod(v, NULL);
+    else if (a == "--samples")
+      samples = strtoull(v, NULL, 10);
+    else if (a == "--min-time")
+      min_ms = strtod(v, NULL);
+    else if (a == "--threads")
+      threads = strtoull(v, NULL, 10);
+    else if (a == "--set") {
+      if (!set_knob(v)) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if (a == "--format")
+      format = v;
+    else if (a == "--out")
+      out = v;
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (min_n == 0 || max_n < min_n || ratio <= 1 || samples == 0 ||
+      (format != "csv" && format != "json")) {
+    usage(argv[0]);
+    return 1;
+  }
+  if (set_pool_threads(threads)) {
+    fprintf(stderr, "couldn't start %zu threads\n", threads);
+    return 1;
+  }
+
+  std::vector<size_t> sizes;
+  for (size_t n = min_n; n <= max_n;) {
+    sizes.push_back(n);
+    const size_t next = (size_t)(n * ratio + 0.5);
+    n = next > n ? next : n + 1;
+  }
+
+  buffers b;
+  std::vector<result> rs;
+  for (const op &o : ops) {
+    if (!only.empty() && only.find("," + std::string(o.name) + ",") ==
+                             std::string::npos)
+      continue;
+    for (size_t n : sizes) {
+      if (cap && n > o.max_n)
+        break;
+      fill(b, n, o.itch(n));
+      rs.push_back(time_op(o, b, n, samples, min_ms * 1e6));
+      fprintf(stderr, "%s %zu: %.1f ns\n", o.name, n, rs.back().median_ns);
+    }
+  }
+
+  FILE *f = out.empty() ? stdout : fopen(out.c_str(), "w");
+  if (f == NULL) {
+    fprintf(stderr, "couldn't open %s\n", out.c_str());
+    return 1;
+  }
+  if (format == "json")
+    write_json(f, rs);
+  else
+    write_csv(f, rs);
+  if (f != stdout)
+    fclose(f);
+
+  set_pool_threads(0);
+  return 0;
+}
@@ -0,0 +1,201 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "add_par.h"
+#include "limb.h"
+#include "pool.h"
+
+/*
+ * Carry chains on the thread pool. The chain is cut into limb-aligned chunks
+ * that are added (subtracted) as tasks, each with no carry in except the
+ * first. Besides its carry out, a chunk notes whether its result is flat: all
+ * ones for a sum, all zeros for a difference, i.e. whether a carry in would
+ * run straight through it. One pass over the chunks then settles every real
+ * carry in, and the chunks that get one are incremented (decremented) in
+ * place, again as tasks. That mostly stops after a limb; only a flat chunk is
+ * rewritten in full, and those are spread over the pool like the rest.
+ */
+
+#define ADD_PAR_CHUNKS 64
+
+static size_t add_par_grain = JL_ADD_PAR_GRAIN;
+
+/**
+ * @brief Sets the chunk size, in bytes, below which add_bytes_par and
+ * sub_bytes_par stop splitting. Rounded down to whole limbs, and never below
+ * one. The build-time default is JL_ADD_PAR_GRAIN.
+ */
+void set_add_par_grain(size_t n) {
+  n -= n % JL_LIMB_BYTES;
+  add_par_grain = n < JL_LIMB_BYTES ? JL_LIMB_BYTES : n;
+}
+
+size_t get_add_par_grain(void) { return add_par_grain; }
+
+typedef struct {
+  const uint8_t *x;
+  const uint8_t *y;
+  uint8_t *z;
+  size_t n;
+  jl_limb_t carry; // Carry (borrow) in, then out.
+  int flat;
+} add_par_chunk;
+
+static void add_chunk(void *arg) {
+  add_par_chunk *c = arg;
+  jl_limb_t carry = c->carry;
+  jl_limb_t ones = ~(jl_limb_t)0;
+
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= c->n; i += JL_LIMB_BYTES) {
+    jl_limb_t s =
+        addc_limb(load_limb(c->x + i), load_limb(c->y + i), carry, &carry);
+    store_limb(c->z + i, s);
+    ones &= s;
+  }
+
+  if (i < c->n) {
+    const size_t t = c->n - i;
+    jl_limb_t s = load_limb_partial(c->x + i, t) +
+                  load_limb_partial(c->y + i, t) + carry;
+    store_limb_partial(c->z + i, s, t);
+    carry = s >> (8 * t);
+    ones &= s | (~(jl_limb_t)0 << (8 * t));
+  }
+
+  c->carry = carry;
+  c->flat = ones == ~(jl_limb_t)0;
+}
+
+static void sub_chunk(void *arg) {
+  add_par_chunk *c = arg;
+  jl_limb_t borrow = c->carry;
+  jl_limb_t bits = 0;
+
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= c->n; i += JL_LIMB_BYTES) {
+    jl_limb_t d =
+        subb_limb(load_limb(c->x + i), load_limb(c->y + i), borrow, &borrow);
+    store_limb(c->z + i, d);
+    bits |= d;
+  }
+
+  if (i < c->n) {
+    const size_t t = c->n - i;
+    jl_limb_t d = load_limb_partial(c->x + i, t) -
+                  load_limb_partial(c->y + i, t) - borrow;
+    store_limb_partial(c->z + i, d, t);
+    borrow = (d >> (8 * t)) & 1;
+    bits |= d & ~(~(jl_limb_t)0 << (8 * t));
+  }
+
+  c->carry = borrow;
+  c->flat = bits == 0;
+}
+
+// z += 1 over the chunk, stopping where the carry does.
+static void add_fix(void *arg) {
+  add_par_chunk *c = arg;
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= c->n; i += JL_LIMB_BYTES) {
+    jl_limb_t s = load_limb(c->z + i) + 1;
+    store_limb(c->z + i, s);
+    if (s != 0)
+      return;
+  }
+  if (i < c->n)
+    store_limb_partial(c->z + i, load_limb_partial(c->z + i, c->n - i) + 1,
+                       c->n - i);
+}
+
+// z -= 1 over the chunk, stopping where the borrow does.
+static void sub_fix(void *arg) {
+  add_par_chunk *c = arg;
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= c->n; i += JL_LIMB_BYTES) {
+    jl_limb_t d = load_limb(c->z + i);
+    store_limb(c->z + i, d - 1);
+    if (d != 0)
+      return;
+  }
+  if (i < c->n)
+    store_limb_partial(c->z + i, load_limb_partial(c->z + i, c->n - i) - 1,
+                       c->n - i);
+}
+
+static jl_limb_t run_par(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                         size_t n, jl_limb_t carry, void (*chunk)(void *),
+                         void (*fix)(void *)) {
+  size_t k_n = n / add_par_grain;
+  const size_t threads = get_pool_threads();
+  if (k_n > 4 * threads)
+    k_n = 4 * threads;
+  if (k_n > ADD_PAR_CHUNKS)
+    k_n = ADD_PAR_CHUNKS;
+  if (k_n == 0)
+    k_n = 1;
+  size_t len = n / k_n;
+  len -= len % JL_LIMB_BYTES;
+  if (len == 0)
+    k_n = 1;
+
+  add_par_chunk c[ADD_PAR_CHUNKS];
+  jl_task t[ADD_PAR_CHUNKS];
+  for (size_t k = 0; k < k_n; k++) {
+    c[k].x = x + k * len;
+    c[k].y = y + k * len;
+    c[k].z = z + k * len;
+    c[k].n = k + 1 < k_n ? len : n - k * len;
+    c[k].carry = k == 0 ? carry : 0;
+  }
+
+  for (size_t k = 1; k < k_n; k++)
+    pool_spawn(&t[k], chunk, &c[k]);
+  chunk(&c[0]);
+  for (size_t k = k_n - 1; k > 0; k--)
+    pool_join(&t[k]);
+
+  // The carry into chunk k is the carry out of chunk k - 1, which a flat
+  // chunk k - 1 passes on from its own carry in.
+  int fix_n = 0;
+  carry = c[0].carry;
+  for (size_t k = 1; k < k_n; k++) {
+    const jl_limb_t in = carry;
+    carry = c[k].carry | (c[k].flat & in);
+    c[k].carry = in;
+    fix_n += in != 0;
+  }
+
+  if (fix_n != 0) {
+    for (size_t k = 1; k < k_n; k++)
+      if (c[k].carry)
+        pool_spawn(&t[k], fix, &c[k]);
+    for (size_t k = k_n - 1; k > 0; k--)
+      if (c[k].carry)
+        pool_join(&t[k]);
+  }
+
+  return carry;
+}
+
+/**
+ * @brief z = @p x + @p y + @p carry over @p n bytes, split into chunks that
+ * run on the thread pool (see set_pool_threads and set_add_par_grain).
+ * Returns the carry out. Runs on the calling thread while the pool is
+ * stopped.
+ *
+ * @p z may alias @p x or @p y.
+ */
+jl_limb_t add_bytes_par(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        size_t n, jl_limb_t carry) {
+  return run_par(x, y, z, n, carry, add_chunk, add_fix);
+}
+
+/**
+ * @brief z = @p x - @p y - @p borrow over @p n bytes. Same contract as
+ * add_bytes_par; returns the borrow out.
+ */
+jl_limb_t sub_bytes_par(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        size_t n, jl_limb_t borrow) {
+  return run_par(x, y, z, n, borrow, sub_chunk, sub_fix);
+}
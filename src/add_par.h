@@ -0,0 +1,25 @@
+#ifndef __JL_ADD_PAR_H__
+#define __JL_ADD_PAR_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Chunk size, in bytes, below which add_bytes_par and sub_bytes_par stop
+// splitting a carry chain. add_bstrings and sub_bstrings only go parallel for
+// chains of at least two chunks. Can also be changed at runtime.
+#ifndef JL_ADD_PAR_GRAIN
+#define JL_ADD_PAR_GRAIN (1 << 18)
+#endif
+
+void set_add_par_grain(size_t n);
+
+size_t get_add_par_grain(void);
+
+jl_limb_t add_bytes_par(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        size_t n, jl_limb_t carry);
+
+jl_limb_t sub_bytes_par(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        size_t n, jl_limb_t borrow);
+#endif
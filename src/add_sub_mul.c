@@ -1,207 +1,223 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "add_par.h"
+#include "add_sub_mul.h"
+#include "arena.h"
+#include "cpu.h"
+#include "limb.h"
+#include "mul_adx.h"
+#include "mul_par.h"
+#include "ntt.h"
+#include "perf.h"
+#include "pool.h"
+#include "toom.h"
 
 /**
- * @brief Perform addition of 8 bit unsigned ints, using only 8 bit unsigned
- * ints.
- *
- * @remark It can be shown that cases 1, 2 and 3 are mutually exclusive and
- * collectively exhaustive.
- *
- * @param[in] x (uint8_t): Summand.
- * @param[in] y (uint8_t): Summand.
- * @param[out] z (uint8_t*): Should be empty. Stores @p x + @p y + @p carry if
- * less than 256, @p x + @p y + @p - 256 otherwise.
- * @param[out] carry (uint8_t): Set to 1 if @p x + @p y + @p carry > 255. Must
- * be one or zero.
- * @param[in] i (size_t): offset from @p z.
+ * @brief Word-at-a-time carry chains. Each kernel processes the first @p n
+ * bytes of its operands one limb per iteration, finishes the last @p n % 8
+ * bytes with a single partial limb, and returns the outgoing carry (borrow).
+ * Operands needn't be aligned, and @p z may alias @p x or @p y.
  */
-static void add_block(uint8_t x, uint8_t y, uint8_t *z, uint8_t *carry,
-                      size_t i) {
-  // Case 1: x + y == 255 and carry == 1.
-  if (y == 0xFF - x) {
-    if (*carry) {
-      z[i] = 0;
-      *carry = 1;
-      return;
-    }
-  }
 
-  // Case 2: x + y > 255 and 0 <= carry <= 1.
-  if (y > 0xFF - x) {
-    z[i] = (y - (0xFF - x)) + *carry - 1;
-    *carry = 1;
-    return;
+// z = x + y + carry.
+static jl_limb_t add_run_xy(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                            size_t n, jl_limb_t carry) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i,
+               addc_limb(load_limb(x + i), load_limb(y + i), carry, &carry));
+
+  if (i < n) {
+    const size_t t = n - i;
+    jl_limb_t s =
+        load_limb_partial(x + i, t) + load_limb_partial(y + i, t) + carry;
+    store_limb_partial(z + i, s, t);
+    carry = s >> (8 * t);
   }
 
-  // Case 3: x + y + carry <= 255.
-  z[i] = x + y + *carry;
-  *carry = 0;
+  return carry;
 }
 
-/**
- * @brief Perform subtraction of 8 bit unsigned ints, using only 8 bit unsigned
- * ints.
- *
- * @remark It can be shown that cases 1, 2 and 3 are mutually exclusive and
- * collectively exhaustive.
- *
- * @param[in] x (uint8_t): From which @p y will be subtracted.
- * @param[in] y (uint8_t): To be subtracted from @p x.
- * @param[out] z (uint8_t*): Should be empty. Stores @p x - @p y - @p carry if
- * nonnegative, 256 + @p x - @p y - @p otherwise.
- * @param[out] carry (uint8_t): Set to 1 if @p x - @p y - @p carry < 0. Must be
- * one or zero.
- * @param[in] i (size_t): offset from @p z.
- */
-static void sub_block(uint8_t x, uint8_t y, uint8_t *z, uint8_t *carry,
-                      size_t i) {
-  // Case 1: x - y - carry == -1;
-  if (x == y) {
-    if (*carry == 1) {
-      z[i] = 0xFF;
-      return; // Carry stays 1.
-    }
+// add_run_xy with no carry in, on the thread pool if the chain is long enough
+// to split.
+static jl_limb_t add_run(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                         size_t n) {
+  if (n >= 2 * get_add_par_grain() && get_pool_threads() > 1)
+    return add_bytes_par(x, y, z, n, 0);
+  return add_run_xy(x, y, z, n, 0);
+}
+
+// z = x + carry. Stops propagating (and just copies) once carry is zero.
+static jl_limb_t add_run_x(const uint8_t *x, uint8_t *z, size_t n,
+                           jl_limb_t carry) {
+  size_t i = 0;
+  for (; carry && i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES) {
+    jl_limb_t s = load_limb(x + i) + 1;
+    store_limb(z + i, s);
+    carry = s == 0;
   }
 
-  // Case 2: x - y < 0
-  if (y > x) {
-    z[i] = (((0xFF - y) + x) - *carry) + 1;
-    *carry = 1;
-    return;
+  if (carry && i < n) {
+    const size_t t = n - i;
+    jl_limb_t s = load_limb_partial(x + i, t) + 1;
+    store_limb_partial(z + i, s, t);
+    carry = s >> (8 * t);
+    i = n;
   }
 
-  // Case 3: x - y - carry >= 0
-  z[i] = x - y - *carry;
-  *carry = 0;
+  if (z != x && i < n)
+    memcpy(z + i, x + i, n - i);
+
+  return carry;
 }
 
-/**
- * @brief Perform multiplication of 8 bit unsigned ints, using only 8 bit
- * unsigned ints.
- *
- * @param[in] x (uint8_t): Factor.
- * @param[in] y (uint8_t): Factor.
- * @param[out] z (uint8_t*): Must be two bytes. Will store the LSBS in the first
- * byte, and MSBS in the second byte.
- */
-static void mult_block(uint8_t x, uint8_t y, uint8_t *z) {
-  const uint8_t x0 = x & 0x0F; // last 4 bits of x
-  const uint8_t x1 = x >> 4;   // first 4 bits of x
-  const uint8_t y0 = y & 0x0F; // last 4 bits of y
-  const uint8_t y1 = y >> 4;   // first 4 bits of y
-  uint8_t z0 = x0 * y0;
-  uint8_t z1 = 0;
-  uint8_t z2 = x1 * y1;
-  uint8_t c = 0;
+// z = x - y - borrow.
+static jl_limb_t sub_run_xy(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                            size_t n, jl_limb_t borrow) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i,
+               subb_limb(load_limb(x + i), load_limb(y + i), borrow, &borrow));
+
+  if (i < n) {
+    const size_t t = n - i;
+    jl_limb_t d =
+        load_limb_partial(x + i, t) - load_limb_partial(y + i, t) - borrow;
+    store_limb_partial(z + i, d, t);
+    borrow = (d >> (8 * t)) & 1;
+  }
+
+  return borrow;
+}
+
+// sub_run_xy with no borrow in, on the thread pool if the chain is long enough
+// to split.
+static jl_limb_t sub_run(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                         size_t n) {
+  if (n >= 2 * get_add_par_grain() && get_pool_threads() > 1)
+    return sub_bytes_par(x, y, z, n, 0);
+  return sub_run_xy(x, y, z, n, 0);
+}
+
+// z = x - borrow. Stops propagating (and just copies) once borrow is zero.
+static jl_limb_t sub_run_x(const uint8_t *x, uint8_t *z, size_t n,
+                           jl_limb_t borrow) {
+  size_t i = 0;
+  for (; borrow && i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES) {
+    jl_limb_t d = load_limb(x + i);
+    store_limb(z + i, d - 1);
+    borrow = d == 0;
+  }
 
-  add_block(x0 * y1, x1 * y0, &z1, &c, 0); // Compute z1.
+  if (borrow && i < n) {
+    const size_t t = n - i;
+    jl_limb_t d = load_limb_partial(x + i, t) - 1;
+    store_limb_partial(z + i, d, t);
+    borrow = (d >> (8 * t)) & 1;
+    i = n;
+  }
 
-  if (c)
-    z2 += (1 << 4);
+  if (z != x && i < n)
+    memcpy(z + i, x + i, n - i);
 
-  c = 0;
+  return borrow;
+}
 
-  // Compute temp 0 (LS 8 bits of prod).
-  add_block(z0, (z1 << 4), z, &c, 0);
+// z = 0 - y - borrow.
+static jl_limb_t sub_run_y(const uint8_t *y, uint8_t *z, size_t n,
+                           jl_limb_t borrow) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i, subb_limb(0, load_limb(y + i), borrow, &borrow));
 
-  if (c)
-    z2 += 1;
+  if (i < n) {
+    const size_t t = n - i;
+    jl_limb_t d = 0 - load_limb_partial(y + i, t) - borrow;
+    store_limb_partial(z + i, d, t);
+    borrow = (d >> (8 * t)) & 1;
+  }
 
-  c = 0;
+  return borrow;
+}
 
-  // Compute temp 1 (MS 8 bits of prod).
-  add_block(z2, (z1 >> 4), z, &c, 1);
+// z = 0 - borrow. The borrow, if any, runs through every byte.
+static jl_limb_t sub_run_0(uint8_t *z, size_t n, jl_limb_t borrow) {
+  memset(z, borrow ? 0xFF : 0x00, n);
+  return borrow;
 }
 
 // x_size <= y_size <= z_size
 static uint8_t sub_bstrings_nocheck_xyz(const uint8_t *x, const uint8_t *y,
                                         uint8_t *z, size_t x_size,
                                         size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < x_size; i++)
-    sub_block(x[i], y[i], z, &carry, i);
+  jl_limb_t borrow = sub_run(x, y, z, x_size);
   // x[i] is zero
-  for (int i = x_size; i < y_size; i++)
-    sub_block(0, y[i], z, &carry, i);
+  borrow = sub_run_y(y + x_size, z + x_size, y_size - x_size, borrow);
   // x[i] and y[i] are zero
-  for (int i = y_size; i < z_size; i++)
-    sub_block(0, 0, z, &carry, i);
+  borrow = sub_run_0(z + y_size, z_size - y_size, borrow);
 
-  return carry;
+  return borrow;
 }
 
 // x_size <= z_size <= y_size
 static uint8_t sub_bstrings_nocheck_xzy(const uint8_t *x, const uint8_t *y,
                                         uint8_t *z, size_t x_size,
                                         size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < x_size; i++)
-    sub_block(x[i], y[i], z, &carry, i);
+  jl_limb_t borrow = sub_run(x, y, z, x_size);
   // x[i] is zero
-  for (int i = x_size; i < z_size; i++)
-    sub_block(0, y[i], z, &carry, i);
+  borrow = sub_run_y(y + x_size, z + x_size, z_size - x_size, borrow);
 
-  return carry;
+  return borrow;
 }
 
 // y_size <= x_size <= z_size
 static uint8_t sub_bstrings_nocheck_yxz(const uint8_t *x, const uint8_t *y,
                                         uint8_t *z, size_t x_size,
                                         size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < y_size; i++)
-    sub_block(x[i], y[i], z, &carry, i);
+  jl_limb_t borrow = sub_run(x, y, z, y_size);
   // y[i] is zero
-  for (int i = y_size; i < x_size; i++)
-    sub_block(x[i], 0, z, &carry, i);
+  borrow = sub_run_x(x + y_size, z + y_size, x_size - y_size, borrow);
   // y[i] and x[i] are zero
-  for (int i = x_size; i < z_size; i++)
-    sub_block(0, 0, z, &carry, i);
+  borrow = sub_run_0(z + x_size, z_size - x_size, borrow);
 
-  return carry;
+  return borrow;
 }
 
 // y_size <= z_size <= x_size
 static uint8_t sub_bstrings_nocheck_yzx(const uint8_t *x, const uint8_t *y,
                                         uint8_t *z, size_t x_size,
                                         size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < y_size; i++)
-    sub_block(x[i], y[i], z, &carry, i);
+  jl_limb_t borrow = sub_run(x, y, z, y_size);
   // y[i] is zero.
-  for (int i = y_size; i < z_size; i++)
-    sub_block(x[i], 0, z, &carry, i);
+  borrow = sub_run_x(x + y_size, z + y_size, z_size - y_size, borrow);
 
-  return carry;
+  return borrow;
 }
 
 // z_size <= x_size, y_size
 static uint8_t sub_bstrings_nocheck_zxy(const uint8_t *x, const uint8_t *y,
                                         uint8_t *z, size_t x_size,
                                         size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < z_size; i++)
-    sub_block(x[i], y[i], z, &carry, i);
-
-  return carry;
+  return sub_run(x, y, z, z_size);
 }
 
 /**
  * @brief Adds @p x and @p y and stores their sum in @p z without performing any
  * error handling.
  *
- * Requires y_size <= x_size, and that x, y, and z are not null.
+ * Requires y_size <= x_size, and that x, y, and z are not null. While the
+ * thread pool runs, long carry chains are split over it (see add_bytes_par).
  */
 uint8_t add_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
                              size_t x_size, size_t y_size, size_t z_size) {
-  uint8_t carry = 0;
-  for (int i = 0; i < y_size && i < z_size; i++)
-    add_block(x[i], y[i], z, &carry, i);
+  const size_t n = y_size < z_size ? y_size : z_size;
+  const size_t m = x_size < z_size ? x_size : z_size;
+  uint8_t carry = add_run(x, y, z, n);
   // y[i] is zero.
-  for (int i = y_size; i < x_size && i < z_size; i++)
-    add_block(x[i], 0, z, &carry, i);
+  carry = add_run_x(x + n, z + n, m - n, carry);
 
   // If we have room for overflow.
   if (x_size < z_size && carry != 0) {
@@ -239,7 +255,8 @@ uint8_t add_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
  *
  * (3) If y == x: sub(x, y, z) = 0, and always fits in z.
  *
- * Requires that @p x, @p y, and @p z are not null.
+ * Requires that @p x, @p y, and @p z are not null. While the thread pool
+ * runs, long borrow chains are split over it (see sub_bytes_par).
  */
 uint8_t sub_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
                              size_t x_size, size_t y_size, size_t z_size) {
@@ -271,20 +288,860 @@ uint8_t sub_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
   return carry;
 }
 
-uint8_t mul_bstrings_8_gradeschool_nocheck(const uint8_t *x, const uint8_t *y,
-                                           uint8_t *z, size_t x_size,
-                                           size_t y_size, size_t z_size) {
-  uint8_t temp[3] = {0, 0, 0}; // prod LSBs, prod MSBs, flag byte
-  for (size_t i = 0; i < x_size; i++) {
-    for (size_t j = 0; j < y_size; j++) {
-      if (x[i] | y[j]) {
-        mult_block(x[i], y[j], temp);
-        add_bstrings(z + i + j, temp, z + i + j, temp + 2, z_size - i - j, 2,
-                     z_size - i - j);
-      }
-    }
+/**
+ * @brief Stores @p x + @p y in @p z, all of @p n limbs. @p z may alias @p x or
+ * @p y.
+ *
+ * @return (jl_limb_t): The carry out of @p z[n - 1].
+ */
+jl_limb_t add_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                size_t n) {
+  jl_limb_t carry = 0;
+  for (size_t i = 0; i < n; i++)
+    z[i] = addc_limb(x[i], y[i], carry, &carry);
+
+  return carry;
+}
+
+/**
+ * @brief Stores @p x - @p y in @p z, all of @p n limbs. @p z may alias @p x or
+ * @p y.
+ *
+ * @return (jl_limb_t): The borrow out of @p z[n - 1].
+ */
+jl_limb_t sub_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                size_t n) {
+  jl_limb_t borrow = 0;
+  for (size_t i = 0; i < n; i++)
+    z[i] = subb_limb(x[i], y[i], borrow, &borrow);
+
+  return borrow;
+}
+
+/**
+ * @brief Stores @p x + @p c in @p z, where @p x and @p z have @p n limbs and
+ * @p c is a single limb. @p z may alias @p x.
+ *
+ * @return (jl_limb_t): The carry out of @p z[n - 1].
+ */
+jl_limb_t add_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t c) {
+  size_t i = 0;
+  for (; c && i < n; i++) {
+    z[i] = x[i] + c;
+    c = z[i] < c;
+  }
+  if (z != x)
+    for (; i < n; i++)
+      z[i] = x[i];
+
+  return c;
+}
+
+/**
+ * @brief Stores @p x - @p b in @p z, where @p x and @p z have @p n limbs and
+ * @p b is a single limb. @p z may alias @p x.
+ *
+ * @return (jl_limb_t): The borrow out of @p z[n - 1].
+ */
+jl_limb_t sub_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t b) {
+  size_t i = 0;
+  for (; b && i < n; i++) {
+    const jl_limb_t d = x[i] - b;
+    b = d > x[i];
+    z[i] = d;
+  }
+  if (z != x)
+    for (; i < n; i++)
+      z[i] = x[i];
+
+  return b;
+}
+
+/**
+ * @brief Compares @p x and @p y, both of @p n limbs.
+ *
+ * @return (int): 1 if @p x > @p y, -1 if @p x < @p y, 0 otherwise.
+ */
+int cmp_n(const jl_limb_t *x, const jl_limb_t *y, size_t n) {
+  while (n-- > 0)
+    if (x[n] != y[n])
+      return x[n] > y[n] ? 1 : -1;
+
+  return 0;
+}
+
+/**
+ * @brief Shifts the @p n limbs of @p x left by @p cnt bits into @p z, 0 < @p
+ * cnt < 64.
+ *
+ * @p z may equal @p x, or start above it.
+ *
+ * @return (jl_limb_t): The bits shifted out of the top, in the low bits.
+ */
+jl_limb_t lshift(jl_limb_t *z, const jl_limb_t *x, size_t n, unsigned cnt) {
+  if (n == 0)
+    return 0;
+
+  const unsigned tnc = JL_LIMB_BITS - cnt;
+  const jl_limb_t out = x[n - 1] >> tnc;
+  for (size_t i = n - 1; i > 0; i--)
+    z[i] = (x[i] << cnt) | (x[i - 1] >> tnc);
+  z[0] = x[0] << cnt;
+
+  return out;
+}
+
+/**
+ * @brief Shifts the @p n limbs of @p x right by @p cnt bits into @p z, 0 < @p
+ * cnt < 64.
+ *
+ * @p z may equal @p x, or start below it.
+ *
+ * @return (jl_limb_t): The bits shifted out of the bottom, in the high bits.
+ */
+jl_limb_t rshift(jl_limb_t *z, const jl_limb_t *x, size_t n, unsigned cnt) {
+  if (n == 0)
+    return 0;
+
+  const unsigned tnc = JL_LIMB_BITS - cnt;
+  const jl_limb_t out = x[0] << tnc;
+  for (size_t i = 0; i + 1 < n; i++)
+    z[i] = (x[i] >> cnt) | (x[i + 1] << tnc);
+  z[n - 1] = x[n - 1] >> cnt;
+
+  return out;
+}
+
+// Portable kernels behind mul_1, addmul_1 and mul_basecase.
+static jl_limb_t mul_1_generic(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                               jl_limb_t y) {
+  jl_limb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    jl_limb_t hi;
+    jl_limb_t lo = mul_limb(x[i], y, &hi);
+    lo += carry;
+    carry = hi + (lo < carry);
+    z[i] = lo;
+  }
+
+  return carry;
+}
+
+static jl_limb_t addmul_1_generic(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                                  jl_limb_t y) {
+  jl_limb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    jl_limb_t hi;
+    jl_limb_t lo = mul_limb(x[i], y, &hi);
+    lo += carry;
+    hi += lo < carry;
+    const jl_limb_t s = z[i] + lo;
+    hi += s < lo;
+    z[i] = s;
+    carry = hi;
+  }
+
+  return carry;
+}
+
+static void mul_basecase_generic(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                                 const jl_limb_t *y, size_t y_n) {
+  if (y_n == 0) {
+    memset(z, 0, x_n * sizeof(jl_limb_t));
+    return;
+  }
+
+  z[x_n] = mul_1_generic(z, x, x_n, y[0]);
+  for (size_t j = 1; j < y_n; j++)
+    z[x_n + j] = addmul_1_generic(z + j, x, x_n, y[j]);
+}
+
+/*
+ * mul_1, addmul_1 and mul_basecase run through these pointers. They start on
+ * the portable kernels, and are moved to the fastest ones the CPU supports
+ * when the library loads.
+ */
+
+typedef jl_limb_t (*row_fn)(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                            jl_limb_t y);
+typedef void (*basecase_fn)(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                            const jl_limb_t *y, size_t y_n);
+
+static row_fn mul_1_kernel = mul_1_generic;
+static row_fn addmul_1_kernel = addmul_1_generic;
+static basecase_fn mul_basecase_kernel = mul_basecase_generic;
+static unsigned limb_kernel_features = 0;
+
+/**
+ * @brief Picks the kernels behind mul_1, addmul_1 and mul_basecase from the
+ * JL_CPU_* extensions in @p features. Extensions the CPU lacks are ignored, so
+ * set_limb_kernels(0) forces the portable kernels and
+ * set_limb_kernels(cpu_features()) restores the default. Not safe to call
+ * while other threads are multiplying.
+ */
+void set_limb_kernels(unsigned features) {
+  features &= cpu_features();
+
+  mul_1_kernel = mul_1_generic;
+  addmul_1_kernel = addmul_1_generic;
+  mul_basecase_kernel = mul_basecase_generic;
+  limb_kernel_features = 0;
+
+#if JL_HAVE_ADX_ASM
+  const unsigned adx = JL_CPU_BMI2 | JL_CPU_ADX;
+  if ((features & adx) == adx) {
+    mul_1_kernel = mul_1_adx;
+    addmul_1_kernel = addmul_1_adx;
+    mul_basecase_kernel = mul_basecase_adx;
+    limb_kernel_features = adx;
+  }
+#endif
+}
+
+/**
+ * @brief The JL_CPU_* extensions the current kernels use.
+ */
+unsigned get_limb_kernels(void) { return limb_kernel_features; }
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor)) static void init_limb_kernels(void) {
+  set_limb_kernels(cpu_features());
+}
+#endif
+
+/**
+ * @brief Multiplies the @p n limbs of @p x by the single limb @p y and stores
+ * the low @p n limbs of the product in @p z.
+ *
+ * @p z may equal @p x, but may not otherwise overlap it.
+ *
+ * @return (jl_limb_t): The most significant limb of the product.
+ */
+jl_limb_t mul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y) {
+  return mul_1_kernel(z, x, n, y);
+}
+
+/**
+ * @brief Adds @p x * @p y to the @p n limbs of @p z, where @p x has @p n limbs
+ * and @p y is a single limb.
+ *
+ * @p z may equal @p x, but may not otherwise overlap it.
+ *
+ * @return (jl_limb_t): The carry limb out of @p z[n - 1].
+ */
+jl_limb_t addmul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y) {
+  return addmul_1_kernel(z, x, n, y);
+}
+
+/**
+ * @brief Subtracts @p x * @p y from the @p n limbs of @p z, where @p x has @p
+ * n limbs and @p y is a single limb.
+ *
+ * @p z may equal @p x, but may not otherwise overlap it.
+ *
+ * @return (jl_limb_t): The borrow limb out of @p z[n - 1], i.e. the amount
+ * that must still be subtracted at @p z[n].
+ */
+jl_limb_t submul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y) {
+  jl_limb_t borrow = 0;
+  for (size_t i = 0; i < n; i++) {
+    jl_limb_t hi;
+    jl_limb_t lo = mul_limb(x[i], y, &hi);
+    lo += borrow;
+    hi += lo < borrow;
+    const jl_limb_t d = z[i] - lo;
+    hi += d > z[i];
+    z[i] = d;
+    borrow = hi;
+  }
+
+  return borrow;
+}
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z, one addmul_1 row per limb of @p y.
+ *
+ * @p z may not overlap @p x or @p y.
+ */
+void mul_basecase(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                  const jl_limb_t *y, size_t y_n) {
+  mul_basecase_kernel(z, x, x_n, y, y_n);
+}
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z. Each product x_i x_j
+ * with i < j is computed once, in addmul_1 rows, then the sum is doubled and
+ * the squares x_i^2 added down the diagonal in a single pass.
+ *
+ * @p z may not overlap @p x.
+ */
+void sqr_basecase(jl_limb_t *z, const jl_limb_t *x, size_t n) {
+  if (n == 0)
+    return;
+
+  // Off-diagonal products into z[1, 2n - 1).
+  z[0] = 0;
+  z[2 * n - 1] = 0;
+  if (n == 1)
+    z[1] = 0;
+  else
+    z[n] = mul_1(z + 1, x + 1, n - 1, x[0]);
+  for (size_t i = 1; i + 1 < n; i++)
+    z[n + i] = addmul_1(z + 2 * i + 1, x + i + 1, n - 1 - i, x[i]);
+
+  // z = 2 z + sum x_i^2 B^2i.
+  jl_limb_t carry = 0, top = 0;
+  for (size_t i = 0; i < n; i++) {
+    const jl_limb_t a = z[2 * i], b = z[2 * i + 1];
+    jl_limb_t hi;
+    const jl_limb_t lo = mul_limb(x[i], x[i], &hi);
+    z[2 * i] = addc_limb((a << 1) | top, lo, carry, &carry);
+    z[2 * i + 1] = addc_limb((b << 1) | (a >> 63), hi, carry, &carry);
+    top = b >> 63;
+  }
+}
+
+typedef void (*mul_limbs_fn)(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                             const jl_limb_t *y, size_t y_n,
+                             jl_limb_t *scratch);
+typedef size_t (*mul_itch_fn)(size_t x_n, size_t y_n);
+
+static size_t mul_karatsuba_threshold = JL_MUL_KARATSUBA_THRESHOLD;
+
+/**
+ * @brief Sets the operand size, in limbs, below which mul_karatsuba falls back
+ * to mul_basecase. Values below 2 are raised to 2. The build-time default is
+ * JL_MUL_KARATSUBA_THRESHOLD.
+ */
+void set_mul_karatsuba_threshold(size_t n) {
+  mul_karatsuba_threshold = n < 2 ? 2 : n;
+}
+
+size_t get_mul_karatsuba_threshold(void) { return mul_karatsuba_threshold; }
+
+/**
+ * @brief Number of scratch limbs mul_karatsuba needs for an @p x_n by @p y_n
+ * limb product. Each level of recursion takes 4 * ceil(n / 2) limbs and hands
+ * the rest to the level below, so the total is less than 4 * (n + log2(n)).
+ * The bound doesn't depend on the threshold, so changing it is always safe.
+ */
+size_t mul_karatsuba_itch(size_t x_n, size_t y_n) {
+  size_t n = x_n > y_n ? x_n : y_n;
+  size_t itch = 0;
+  while (n > 1) {
+    n = (n + 1) / 2;
+    itch += 4 * n;
+  }
+
+  return itch;
+}
+
+/**
+ * @brief z = |x - y|, where @p x has @p x_n limbs, @p y has @p y_n <= @p x_n
+ * limbs, and @p z has @p x_n limbs. The difference step of every Karatsuba
+ * split, serial or parallel.
+ *
+ * @return (int): 1 if @p x < @p y, 0 otherwise.
+ */
+int abs_sub_n(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+              const jl_limb_t *y, size_t y_n) {
+  size_t top = x_n;
+  while (top > y_n && x[top - 1] == 0)
+    top--;
+
+  if (top == y_n && cmp_n(x, y, y_n) < 0) {
+    sub_n(z, y, x, y_n);
+    for (size_t i = y_n; i < x_n; i++)
+      z[i] = 0;
+    return 1;
+  }
+
+  jl_limb_t borrow = sub_n(z, x, y, y_n);
+  sub_1(z + y_n, x + y_n, x_n - y_n, borrow);
+  return 0;
+}
+
+/**
+ * @brief The recombination step of a Karatsuba product split at @p h limbs,
+ * with x = x1 B^h + x0 and y = y1 B^h + y0:
+ *
+ *    x y = x1 y1 B^2h + (x0 y0 + x1 y1 - (x0 - x1)(y0 - y1)) B^h + x0 y0.
+ *
+ * @p z holds x0 y0 in its low 2 @p h limbs and x1 y1 above them, @p z_n limbs
+ * in all, with 3 @p h <= @p z_n <= 4 @p h. @p t holds the 2 @p h limbs of
+ * |(x0 - x1)(y0 - y1)|, and @p neg is 1 if that product is negative. Adds
+ * the middle term into @p z, overwriting @p t.
+ */
+void karatsuba_combine(jl_limb_t *z, jl_limb_t *t, size_t h, size_t z_n,
+                       int neg) {
+  const size_t z2_n = z_n - 2 * h;
+
+  // t = x0 y0 + x1 y1 -/+ t. The true value is below 2 B^2h, so top is 0 or 1
+  // once both steps are done, even if it wraps in between.
+  jl_limb_t top;
+  if (neg) {
+    top = add_n(t, z, t, 2 * h);
+  } else {
+    top = -sub_n(t, z, t, 2 * h);
+  }
+  jl_limb_t carry = add_n(t, t, z + 2 * h, z2_n);
+  top += add_1(t + z2_n, t + z2_n, 2 * h - z2_n, carry);
+
+  // z += t B^h. t always fits below the top of z, and top spills only if
+  // there's room for it.
+  carry = add_n(z + h, z + h, t, 2 * h);
+  add_1(z + 3 * h, z + 3 * h, z_n - 3 * h, carry + top);
+}
+
+static void mul_karatsuba_rec(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                              const jl_limb_t *y, size_t y_n,
+                              jl_limb_t *scratch);
+
+// x_n >= y_n, y_n <= ceil(x_n / 2): multiply y by y_n-limb slices of x with
+// mul and accumulate. Needs 2 y_n limbs of scratch, plus whatever mul needs
+// for a y_n by y_n product and a y_n by (x_n mod y_n) product.
+static void mul_unbalanced(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                           const jl_limb_t *y, size_t y_n, jl_limb_t *scratch,
+                           mul_limbs_fn mul) {
+  jl_limb_t *t = scratch;
+  scratch += 2 * y_n;
+
+  mul(z, x, y_n, y, y_n, scratch);
+  for (size_t off = y_n; off < x_n; off += y_n) {
+    const size_t len = x_n - off < y_n ? x_n - off : y_n;
+    mul(t, y, y_n, x + off, len, scratch);
+    // z[off, off + y_n) holds the top of the previous slice.
+    jl_limb_t carry = add_n(z + off, z + off, t, y_n);
+    add_1(z + off + y_n, t + y_n, len, carry);
+  }
+}
+
+// x_n >= y_n > ceil(x_n / 2). With x = x1 B^h + x0 and y = y1 B^h + y0,
+//
+//    x y = x1 y1 B^2h + (x0 y0 + x1 y1 - (x0 - x1)(y0 - y1)) B^h + x0 y0.
+//
+// The two outer products go straight into z; the middle is built in scratch.
+static void mul_karatsuba_balanced(jl_limb_t *z, const jl_limb_t *x,
+                                   size_t x_n, const jl_limb_t *y, size_t y_n,
+                                   jl_limb_t *scratch) {
+  const size_t h = (x_n + 1) / 2;
+  const size_t x1_n = x_n - h;
+  const size_t y1_n = y_n - h;
+
+  jl_limb_t *dx = scratch;
+  jl_limb_t *dy = dx + h;
+  jl_limb_t *t = dy + h;
+  scratch = t + 2 * h;
+
+  // Sign of (x0 - x1)(y0 - y1).
+  const int neg =
+      abs_sub_n(dx, x, h, x + h, x1_n) ^ abs_sub_n(dy, y, h, y + h, y1_n);
+
+  mul_karatsuba_rec(z, x, h, y, h, scratch);
+  mul_karatsuba_rec(z + 2 * h, x + h, x1_n, y + h, y1_n, scratch);
+  mul_karatsuba_rec(t, dx, h, dy, h, scratch);
+
+  karatsuba_combine(z, t, h, x_n + y_n, neg);
+}
+
+static void mul_karatsuba_rec(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                              const jl_limb_t *y, size_t y_n,
+                              jl_limb_t *scratch) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  if (y_n < mul_karatsuba_threshold)
+    mul_basecase(z, x, x_n, y, y_n);
+  else if (2 * y_n <= x_n + 1)
+    mul_unbalanced(z, x, x_n, y, y_n, scratch, mul_karatsuba_rec);
+  else
+    mul_karatsuba_balanced(z, x, x_n, y, y_n, scratch);
+}
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z using Karatsuba's algorithm, falling back to mul_basecase once the
+ * smaller operand drops below the threshold (see
+ * set_mul_karatsuba_threshold).
+ *
+ * @p z may not overlap @p x, @p y or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_karatsuba_itch(@p x_n, @p
+ * y_n) limbs. No other memory is allocated.
+ */
+void mul_karatsuba(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                   const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  mul_karatsuba_rec(z, x, x_n, y, y_n, scratch);
+}
+
+static size_t sqr_karatsuba_threshold = JL_SQR_KARATSUBA_THRESHOLD;
+
+/**
+ * @brief Sets the operand size, in limbs, below which sqr_karatsuba falls back
+ * to sqr_basecase. Values below 2 are raised to 2. The build-time default is
+ * JL_SQR_KARATSUBA_THRESHOLD.
+ */
+void set_sqr_karatsuba_threshold(size_t n) {
+  sqr_karatsuba_threshold = n < 2 ? 2 : n;
+}
+
+size_t get_sqr_karatsuba_threshold(void) { return sqr_karatsuba_threshold; }
+
+/**
+ * @brief Number of scratch limbs sqr_karatsuba needs for an @p n limb square.
+ * A level takes 3 * ceil(n / 2) limbs, so mul_karatsuba_itch is enough.
+ */
+size_t sqr_karatsuba_itch(size_t n) { return mul_karatsuba_itch(n, n); }
+
+// With x = x1 B^h + x0,
+//
+//    x^2 = x1^2 B^2h + (x0^2 + x1^2 - (x0 - x1)^2) B^h + x0^2.
+//
+// Same layout as mul_karatsuba_balanced, but the middle term is always
+// subtracted.
+static void sqr_karatsuba_rec(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                              jl_limb_t *scratch) {
+  if (n < sqr_karatsuba_threshold) {
+    sqr_basecase(z, x, n);
+    return;
+  }
+
+  const size_t h = (n + 1) / 2;
+  const size_t x1_n = n - h;
+
+  jl_limb_t *dx = scratch;
+  jl_limb_t *t = dx + h;
+  scratch = t + 2 * h;
+
+  abs_sub_n(dx, x, h, x + h, x1_n);
+
+  sqr_karatsuba_rec(z, x, h, scratch);
+  sqr_karatsuba_rec(z + 2 * h, x + h, x1_n, scratch);
+  sqr_karatsuba_rec(t, dx, h, scratch);
+
+  // x0^2 + x1^2 - t, which is nonnegative.
+  karatsuba_combine(z, t, h, 2 * n, 0);
+}
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z using Karatsuba's
+ * algorithm, which needs three half-size squares, falling back to
+ * sqr_basecase below the threshold (see set_sqr_karatsuba_threshold).
+ *
+ * @p z may not overlap @p x or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_karatsuba_itch(@p n) limbs.
+ */
+void sqr_karatsuba(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                   jl_limb_t *scratch) {
+  sqr_karatsuba_rec(z, x, n, scratch);
+}
+
+/**
+ * @brief Number of scratch limbs mul_limbs needs for an @p x_n by @p y_n limb
+ * product at the thresholds set when it's called: none at schoolbook sizes,
+ * and mul_karatsuba_itch while Karatsuba goes all the way down. Above that,
+ * every recursive tier takes at most 6 n + 64 limbs at a level of n limbs and
+ * hands children of at most n / 2 + 1 limbs the rest, the leaves below 4
+ * limbs share 64 more, and the NTT is a leaf that never needs more than it
+ * would at the top level, so the sum bounds all of them at once.
+ */
+size_t mul_limbs_itch(size_t x_n, size_t y_n) {
+  const size_t lo = x_n < y_n ? x_n : y_n;
+  size_t n = x_n > y_n ? x_n : y_n;
+  // Equal sizes may be a square, which goes by the squaring thresholds.
+  const int square = x_n == y_n;
+  if (lo < mul_karatsuba_threshold &&
+      (!square || n < sqr_karatsuba_threshold))
+    return 0;
+  if (2 * lo > n + 1 && lo < get_mul_toom3_threshold())
+    return mul_karatsuba_itch(x_n, y_n);
+
+  size_t itch = 64;
+  if (n >= JL_MUL_NTT_MIN_LIMBS)
+    itch += mul_ntt_itch(n, n);
+  for (; n > 3; n = n / 2 + 1)
+    itch += 6 * n + 64;
+
+  return itch;
+}
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z, picking the algorithm from the size of the smaller operand:
+ *
+ *    mul_basecase < JL_MUL_KARATSUBA_THRESHOLD <= mul_karatsuba
+ *                 < JL_MUL_TOOM3_THRESHOLD <= mul_toom3
+ *                 < JL_MUL_TOOM4_THRESHOLD <= mul_toom4
+ *                 < JL_MUL_NTT_THRESHOLD <= mul_ntt
+ *
+ * Operands more than 2:1 apart are first cut into balanced slices, and
+ * x * x is handed to sqr_limbs.
+ *
+ * @p z may not overlap @p x, @p y or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_limbs_itch(@p x_n, @p y_n)
+ * limbs.
+ */
+void mul_limbs(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  if (x == y && x_n == y_n)
+    sqr_limbs(z, x, x_n, scratch);
+  else if (y_n < mul_karatsuba_threshold)
+    mul_basecase(z, x, x_n, y, y_n);
+  else if (2 * y_n <= x_n + 1)
+    mul_unbalanced(z, x, x_n, y, y_n, scratch, mul_limbs);
+  else if (y_n < get_mul_toom3_threshold())
+    mul_karatsuba(z, x, x_n, y, y_n, scratch);
+  else if (y_n < get_mul_toom4_threshold())
+    mul_toom3(z, x, x_n, y, y_n, scratch);
+  else if (y_n < get_mul_ntt_threshold())
+    mul_toom4(z, x, x_n, y, y_n, scratch);
+  else
+    mul_ntt(z, x, x_n, y, y_n, scratch);
+}
+
+/**
+ * @brief Number of scratch limbs sqr_limbs needs for an @p n limb square. No
+ * squaring tier takes more at any level than its multiplication counterpart.
+ */
+size_t sqr_limbs_itch(size_t n) { return mul_limbs_itch(n, n); }
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z, picking the algorithm
+ * from @p n:
+ *
+ *    sqr_basecase < JL_SQR_KARATSUBA_THRESHOLD <= sqr_karatsuba
+ *                 < JL_MUL_TOOM3_THRESHOLD <= sqr_toom3
+ *                 < JL_MUL_TOOM4_THRESHOLD <= sqr_toom4
+ *                 < JL_MUL_NTT_THRESHOLD <= sqr_ntt
+ *
+ * @p z may not overlap @p x or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_limbs_itch(@p n) limbs.
+ */
+void sqr_limbs(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch) {
+  if (n < sqr_karatsuba_threshold)
+    sqr_basecase(z, x, n);
+  else if (n < get_mul_toom3_threshold())
+    sqr_karatsuba(z, x, n, scratch);
+  else if (n < get_mul_toom4_threshold())
+    sqr_toom3(z, x, n, scratch);
+  else if (n < get_mul_ntt_threshold())
+    sqr_toom4(z, x, n, scratch);
+  else
+    sqr_ntt(z, x, n, scratch);
+}
+
+/**
+ * @brief Number of scratch limbs addmul_limbs and submul_limbs need for an @p
+ * x_n by @p y_n limb product: room for the product, plus mul_limbs_itch.
+ */
+size_t addmul_limbs_itch(size_t x_n, size_t y_n) {
+  return x_n + y_n + mul_limbs_itch(x_n, y_n);
+}
+
+// z += x y or z -= x y, as rows of addmul_1 or submul_1 with the carry of
+// each row run into z past it. x_n >= y_n, and z_n >= x_n + y_n.
+static jl_limb_t addmul_rows(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                             size_t x_n, const jl_limb_t *y, size_t y_n,
+                             int sub) {
+  jl_limb_t carry = 0;
+  for (size_t i = 0; i < y_n; i++) {
+    jl_limb_t *zi = z + i;
+    if (sub)
+      carry |= sub_1(zi + x_n, zi + x_n, z_n - i - x_n,
+                     submul_1(zi, x, x_n, y[i]));
+    else
+      carry |= add_1(zi + x_n, zi + x_n, z_n - i - x_n,
+                     addmul_1(zi, x, x_n, y[i]));
+  }
+  return carry;
+}
+
+static jl_limb_t addmul_submul(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                              size_t x_n, const jl_limb_t *y, size_t y_n,
+                              jl_limb_t *scratch, int sub) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+  if (y_n == 0)
+    return 0;
+
+  // Schoolbook sizes, where mul_limbs would do the same rows into a
+  // temporary.
+  if (y_n < mul_karatsuba_threshold)
+    return addmul_rows(z, z_n, x, x_n, y, y_n, sub);
+
+  const size_t p_n = x_n + y_n;
+  mul_limbs(scratch, x, x_n, y, y_n, scratch + p_n);
+  if (sub)
+    return sub_1(z + p_n, z + p_n, z_n - p_n, sub_n(z, z, scratch, p_n));
+  return add_1(z + p_n, z + p_n, z_n - p_n, add_n(z, z, scratch, p_n));
+}
+
+/**
+ * @brief Adds the product of @p x and @p y to the @p z_n limbs of @p z, where
+ * @p z_n >= @p x_n + @p y_n. Below the Karatsuba threshold the product is
+ * never formed: each limb of the shorter operand adds its row straight into
+ * @p z. Bigger products are built in @p scratch by mul_limbs and added in one
+ * pass.
+ *
+ * @p z may not overlap @p x, @p y or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least addmul_limbs_itch(@p x_n, @p
+ * y_n) limbs. Untouched at schoolbook sizes, where it may be NULL.
+ *
+ * @return (jl_limb_t): The carry out of @p z[z_n - 1].
+ */
+jl_limb_t addmul_limbs(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                       size_t x_n, const jl_limb_t *y, size_t y_n,
+                       jl_limb_t *scratch) {
+  return addmul_submul(z, z_n, x, x_n, y, y_n, scratch, 0);
+}
+
+/**
+ * @brief Subtracts the product of @p x and @p y from the @p z_n limbs of @p
+ * z. Same contract as addmul_limbs.
+ *
+ * @return (jl_limb_t): The borrow out of @p z[z_n - 1], 1 if @p x * @p y was
+ * larger than @p z, in which case @p z wraps modulo B^@p z_n.
+ */
+jl_limb_t submul_limbs(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                       size_t x_n, const jl_limb_t *y, size_t y_n,
+                       jl_limb_t *scratch) {
+  return addmul_submul(z, z_n, x, x_n, y, y_n, scratch, 1);
+}
+
+// Products of at most this many limbs (operands plus result) are done on the
+// stack.
+#define JL_MUL_STACK_LIMBS 64
+
+static void mul_basecase_scratch(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                                 const jl_limb_t *y, size_t y_n,
+                                 jl_limb_t *scratch) {
+  // Longer operand on the inside: fewer, longer rows.
+  if (x_n >= y_n)
+    mul_basecase(z, x, x_n, y, y_n);
+  else
+    mul_basecase(z, y, y_n, x, x_n);
+}
+
+static size_t mul_basecase_itch(size_t x_n, size_t y_n) { return 0; }
+
+// Unpacks x and y into limbs, multiplies them with mul, and packs the low
+// z_size bytes of the product into z. Temporaries come from arena if it isn't
+// NULL, and from the stack or malloc otherwise. Returns an error code.
+static uint8_t mul_bstrings_nocheck(const uint8_t *x, const uint8_t *y,
+                                    uint8_t *z, size_t x_size, size_t y_size,
+                                    size_t z_size, mul_limbs_fn mul,
+                                    mul_itch_fn itch, jl_arena *arena) {
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t y_n = limbs_for_bytes(y_size);
+  const size_t total = 2 * (x_n + y_n) + itch(x_n, y_n);
+
+  jl_limb_t stack[JL_MUL_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  size_t mark = 0;
+  if (arena != NULL) {
+    mark = arena_mark(arena);
+    buf = arena_alloc(arena, total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  } else if (total > JL_MUL_STACK_LIMBS) {
+    buf = malloc(total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  }
+
+  jl_limb_t *xl = buf;
+  jl_limb_t *yl = xl + x_n;
+  jl_limb_t *zl = yl + y_n;
+  bytes_to_limbs(xl, x_n, x, x_size);
+  bytes_to_limbs(yl, y_n, y, y_size);
+
+  mul(zl, xl, x_n, yl, y_n, zl + x_n + y_n);
+
+  limbs_to_bytes(z, z_size, zl, x_n + y_n);
+
+  if (arena != NULL)
+    arena_release(arena, mark);
+  else if (buf != stack)
+    free(buf);
+
+  return 0;
+}
+
+typedef void (*sqr_limbs_fn)(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                             jl_limb_t *scratch);
+typedef size_t (*sqr_itch_fn)(size_t n);
+
+static void sqr_basecase_scratch(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                                 jl_limb_t *scratch) {
+  sqr_basecase(z, x, n);
+}
+
+static size_t sqr_basecase_itch(size_t n) { return 0; }
+
+// Unpacks x into limbs, squares it with sqr, and packs the low z_size bytes of
+// the square into z. Temporaries come from arena as in mul_bstrings_nocheck.
+// Returns an error code.
+static uint8_t sqr_bstrings_nocheck(const uint8_t *x, uint8_t *z,
+                                    size_t x_size, size_t z_size,
+                                    sqr_limbs_fn sqr, sqr_itch_fn itch,
+                                    jl_arena *arena) {
+  const size_t n = limbs_for_bytes(x_size);
+  const size_t total = 3 * n + itch(n);
+
+  jl_limb_t stack[JL_MUL_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  size_t mark = 0;
+  if (arena != NULL) {
+    mark = arena_mark(arena);
+    buf = arena_alloc(arena, total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  } else if (total > JL_MUL_STACK_LIMBS) {
+    buf = malloc(total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
   }
 
+  jl_limb_t *xl = buf;
+  jl_limb_t *zl = xl + n;
+  bytes_to_limbs(xl, n, x, x_size);
+
+  sqr(zl, xl, n, zl + 2 * n);
+
+  limbs_to_bytes(z, z_size, zl, 2 * n);
+
+  if (arena != NULL)
+    arena_release(arena, mark);
+  else if (buf != stack)
+    free(buf);
+
   return 0;
 }
 
@@ -293,7 +1150,7 @@ uint8_t mul_bstrings_8_gradeschool_nocheck(const uint8_t *x, const uint8_t *y,
  *
  *  - Error codes:
  *      0. Success.
- *      1. @p x, @p y, or @p z is NULL.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
  *
  *  - Flags (bit index, significance increasing):
  *      0. Carry bit. Set if the last carried value is 1. Implies @p x +
@@ -322,7 +1179,7 @@ uint8_t add_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
                      uint8_t *flags, size_t x_size, size_t y_size,
                      size_t z_size) {
   // Error check 1.
-  if (x == NULL | y == NULL | z == NULL)
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
     return 1;
 
   // Require x be larger than y.
@@ -341,7 +1198,9 @@ uint8_t add_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
     }
   }
 
+  JL_PERF_BEGIN(JL_PERF_ADD, x_size);
   *flags = add_bstrings_nocheck(x, y, z, x_size, y_size, z_size);
+  JL_PERF_END();
 
   return 0;
 }
@@ -354,7 +1213,7 @@ uint8_t add_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
  *
  *  - Error codes:
  *      0. Success.
- *      1. @p x, @p y, or @p z is NULL.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
  *
  *  - Flags:
  *      0. Carry bit is set.
@@ -377,10 +1236,12 @@ uint8_t sub_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
                      uint8_t *flags, size_t x_size, size_t y_size,
                      size_t z_size) {
   // Error check 1.
-  if (x == NULL | y == NULL | z == NULL)
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
     return 1;
 
+  JL_PERF_BEGIN(JL_PERF_SUB, x_size > y_size ? x_size : y_size);
   *flags = sub_bstrings_nocheck(x, y, z, x_size, y_size, z_size);
+  JL_PERF_END();
 
   return 0;
 }
@@ -388,17 +1249,21 @@ uint8_t sub_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
 /**
  * @brief Multiplies x and y, and stores the product in @p z. If @p z_size is
  * smaller than the binary representation of @p x * @p y, @p z will store the
- * least significant @p z_size bytes of the product.
+ * least significant @p z_size bytes of the product. Bytes of @p z past the
+ * product are zeroed.
  *
  *  - Error codes:
  *      0. Success.
- *      1. @p x, @p y, or @p z is NULL.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
  *
  * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
  * order.
  * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
  * order.
- * @param[out] z (uint8_t*): Address of least significant byte of @p z.
+ * @param[out] z (uint8_t*): Address of least significant byte of @p z. May
+ * not overlap @p x or @p y.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
  * @param x_size[in] (size_t): Size of @p x.
  * @param y_size[in] (size_t): Size of @p y.
  * @param z_size[in] (size_t): Size of @p z.
@@ -409,10 +1274,373 @@ uint8_t mul_bstrings_8_gradeschool(const uint8_t *x, const uint8_t *y,
                                    uint8_t *z, uint8_t *flags, size_t x_size,
                                    size_t y_size, size_t z_size) {
   // Error check 1.
-  if (x == NULL | y == NULL | z == NULL)
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  return mul_bstrings_nocheck(x, y, z, x_size, y_size, z_size,
+                              mul_basecase_scratch, mul_basecase_itch, NULL);
+}
+
+/**
+ * @brief Multiplies x and y with Karatsuba's algorithm, and stores the product
+ * in @p z. Same contract as mul_bstrings_8_gradeschool, which it matches for
+ * operands below the Karatsuba threshold.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): Address of least significant byte of @p z. May
+ * not overlap @p x or @p y.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param y_size[in] (size_t): Size of @p y.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t mul_bstrings_karatsuba(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                               uint8_t *flags, size_t x_size, size_t y_size,
+                               size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  return mul_bstrings_nocheck(x, y, z, x_size, y_size, z_size, mul_karatsuba,
+                              mul_karatsuba_itch, NULL);
+}
+
+/**
+ * @brief Multiplies x and y, and stores the product in @p z, choosing between
+ * the gradeschool, Karatsuba, Toom-Cook and NTT algorithms by operand size (see
+ * mul_limbs). Same contract as mul_bstrings_8_gradeschool. Once the thread
+ * pool is started (see set_pool_threads), operands of at least the parallel
+ * grain go through mul_limbs_par instead.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): Address of least significant byte of @p z. May
+ * not overlap @p x or @p y.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param y_size[in] (size_t): Size of @p y.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t mul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
     return 1;
 
-  *flags = mul_bstrings_8_gradeschool_nocheck(x, y, z, x_size, y_size, z_size);
+  *flags = 0;
+
+  // Big enough to split, and there's a pool to split over.
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t y_n = limbs_for_bytes(y_size);
+  const int par = get_pool_threads() > 1 &&
+                  (x_n < y_n ? x_n : y_n) >= get_mul_par_grain();
+
+  JL_PERF_BEGIN(JL_PERF_MUL, x_size > y_size ? x_size : y_size);
+  const uint8_t rc = mul_bstrings_nocheck(
+      x, y, z, x_size, y_size, z_size, par ? mul_limbs_par : mul_limbs,
+      par ? mul_limbs_par_itch : mul_limbs_itch, NULL);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief Multiplies x and y with a three-prime number-theoretic transform, and
+ * stores the product in @p z. Same contract as mul_bstrings_8_gradeschool.
+ * Only worthwhile for very large operands; see mul_ntt.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): Address of least significant byte of @p z. May
+ * not overlap @p x or @p y.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param y_size[in] (size_t): Size of @p y.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t mul_bstrings_ntt(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                         uint8_t *flags, size_t x_size, size_t y_size,
+                         size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  return mul_bstrings_nocheck(x, y, z, x_size, y_size, z_size, mul_ntt,
+                              mul_ntt_itch, NULL);
+}
+
+/**
+ * @brief Squares @p x, and stores the square in @p z. Faster than
+ * mul_bstrings(x, x, ...), since each cross product is only formed once. The
+ * algorithm is picked as in sqr_limbs, or sqr_limbs_par as in mul_bstrings.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): Address of least significant byte of @p z. The
+ * square is truncated or zero-padded to @p z_size bytes. May not overlap @p
+ * x.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t sqr_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                     size_t x_size, size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  const int par = get_pool_threads() > 1 &&
+                  limbs_for_bytes(x_size) >= get_mul_par_grain();
+
+  JL_PERF_BEGIN(JL_PERF_SQR, x_size);
+  const uint8_t rc = sqr_bstrings_nocheck(
+      x, z, x_size, z_size, par ? sqr_limbs_par : sqr_limbs,
+      par ? sqr_limbs_par_itch : sqr_limbs_itch, NULL);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief Squares @p x with sqr_basecase only. Same contract as sqr_bstrings.
+ */
+uint8_t sqr_bstrings_basecase(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                              size_t x_size, size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  return sqr_bstrings_nocheck(x, z, x_size, z_size, sqr_basecase_scratch,
+                              sqr_basecase_itch, NULL);
+}
+
+/**
+ * @brief Bytes of arena mul_bstrings_arena needs for an @p x_size by @p
+ * y_size byte product, whether or not the thread pool is running.
+ */
+size_t mul_bstrings_itch(size_t x_size, size_t y_size) {
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t y_n = limbs_for_bytes(y_size);
+  const size_t itch = mul_limbs_itch(x_n, y_n);
+  const size_t par_itch = mul_limbs_par_itch(x_n, y_n);
+
+  return (2 * (x_n + y_n) + (itch > par_itch ? itch : par_itch)) *
+         sizeof(jl_limb_t);
+}
+
+/**
+ * @brief mul_bstrings with every temporary taken from @p arena instead of the
+ * stack or heap. Same contract as mul_bstrings, except that error code 2 means
+ * @p arena has fewer than mul_bstrings_itch(@p x_size, @p y_size) bytes free.
+ * Everything taken from @p arena is given back before returning.
+ */
+uint8_t mul_bstrings_arena(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                           uint8_t *flags, size_t x_size, size_t y_size,
+                           size_t z_size, jl_arena *arena) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL | arena == NULL)
+    return 1;
+
+  *flags = 0;
+
+  // Split over the pool on the same terms as mul_bstrings.
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t y_n = limbs_for_bytes(y_size);
+  const int par = get_pool_threads() > 1 &&
+                  (x_n < y_n ? x_n : y_n) >= get_mul_par_grain();
+
+  JL_PERF_BEGIN(JL_PERF_MUL, x_size > y_size ? x_size : y_size);
+  const uint8_t rc = mul_bstrings_nocheck(
+      x, y, z, x_size, y_size, z_size, par ? mul_limbs_par : mul_limbs,
+      par ? mul_limbs_par_itch : mul_limbs_itch, arena);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief Bytes of arena sqr_bstrings_arena needs for an @p x_size byte
+ * square, whether or not the thread pool is running.
+ */
+size_t sqr_bstrings_itch(size_t x_size) {
+  const size_t n = limbs_for_bytes(x_size);
+  const size_t itch = sqr_limbs_itch(n);
+  const size_t par_itch = sqr_limbs_par_itch(n);
+
+  return (3 * n + (itch > par_itch ? itch : par_itch)) * sizeof(jl_limb_t);
+}
+
+/**
+ * @brief sqr_bstrings with every temporary taken from @p arena. Same contract
+ * as mul_bstrings_arena.
+ */
+uint8_t sqr_bstrings_arena(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                           size_t x_size, size_t z_size, jl_arena *arena) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL | arena == NULL)
+    return 1;
+
+  *flags = 0;
+
+  const int par = get_pool_threads() > 1 &&
+                  limbs_for_bytes(x_size) >= get_mul_par_grain();
+
+  JL_PERF_BEGIN(JL_PERF_SQR, x_size);
+  const uint8_t rc = sqr_bstrings_nocheck(
+      x, z, x_size, z_size, par ? sqr_limbs_par : sqr_limbs,
+      par ? sqr_limbs_par_itch : sqr_limbs_itch, arena);
+  JL_PERF_END();
+
+  return rc;
+}
+
+// Unpacks x, y and z into limbs, with z widened to hold z + x y, applies
+// addmul_limbs or submul_limbs, and packs the low z_size bytes back into z.
+// Returns an error code, and the flags through flags.
+static uint8_t addmul_bstrings_nocheck(const uint8_t *x, const uint8_t *y,
+                                       uint8_t *z, uint8_t *flags,
+                                       size_t x_size, size_t y_size,
+                                       size_t z_size, int sub) {
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t y_n = limbs_for_bytes(y_size);
+  const size_t z_n = limbs_for_bytes(z_size);
+  const size_t w_n = (z_n > x_n + y_n ? z_n : x_n + y_n) + 1;
+  const size_t lo = x_n < y_n ? x_n : y_n;
+  const size_t itch =
+      lo < get_mul_karatsuba_threshold() ? 0 : addmul_limbs_itch(x_n, y_n);
+  const size_t total = x_n + y_n + w_n + itch;
+
+  jl_limb_t stack[JL_MUL_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  if (total > JL_MUL_STACK_LIMBS) {
+    buf = malloc(total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  }
+
+  jl_limb_t *xl = buf;
+  jl_limb_t *yl = xl + x_n;
+  jl_limb_t *wl = yl + y_n;
+  bytes_to_limbs(xl, x_n, x, x_size);
+  bytes_to_limbs(yl, y_n, y, y_size);
+  bytes_to_limbs(wl, w_n, z, z_size);
+
+  jl_limb_t *scratch = itch ? wl + w_n : NULL;
+  if (sub) {
+    *flags = (uint8_t)submul_limbs(wl, w_n, xl, x_n, yl, y_n, scratch);
+  } else {
+    addmul_limbs(wl, w_n, xl, x_n, yl, y_n, scratch);
+    // Set if anything landed past z_size bytes.
+    size_t i = z_size / JL_LIMB_BYTES;
+    jl_limb_t past = z_size % JL_LIMB_BYTES
+                         ? wl[i++] >> (8 * (z_size % JL_LIMB_BYTES))
+                         : 0;
+    for (; i < w_n; i++)
+      past |= wl[i];
+    *flags = past != 0;
+  }
+  limbs_to_bytes(z, z_size, wl, w_n);
+
+  if (buf != stack)
+    free(buf);
 
   return 0;
 }
+
+/**
+ * @brief Adds @p x * @p y to @p z in place, without a separate product
+ * buffer at schoolbook sizes (see addmul_limbs). If @p z + @p x * @p y
+ * doesn't fit in @p z_size bytes, @p z keeps its low @p z_size bytes.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the sum doesn't fit in @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in,out] z (uint8_t*): The accumulator, little-endian. May not
+ * overlap @p x or @p y.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param y_size[in] (size_t): Size of @p y.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t addmul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t y_size,
+                        size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  return addmul_bstrings_nocheck(x, y, z, flags, x_size, y_size, z_size, 0);
+}
+
+/**
+ * @brief Subtracts @p x * @p y from @p z in place. Same contract as
+ * addmul_bstrings, except for the flag: if @p x * @p y > @p z, bit 0 of @p
+ * flags is set and @p z holds the difference modulo 2^(8 @p z_size), as with
+ * sub_bstrings.
+ */
+uint8_t submul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t y_size,
+                        size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  return addmul_bstrings_nocheck(x, y, z, flags, x_size, y_size, z_size, 1);
+}
@@ -4,6 +4,21 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "arena.h"
+#include "limb.h"
+
+// Operand size, in limbs, at which mul_karatsuba stops deferring to
+// mul_basecase. Can also be changed at runtime.
+#ifndef JL_MUL_KARATSUBA_THRESHOLD
+#define JL_MUL_KARATSUBA_THRESHOLD 24
+#endif
+
+// The same for sqr_karatsuba and sqr_basecase. sqr_basecase does about half
+// the work of mul_basecase, so it stays ahead for longer.
+#ifndef JL_SQR_KARATSUBA_THRESHOLD
+#define JL_SQR_KARATSUBA_THRESHOLD 32
+#endif
+
 uint8_t add_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
                      uint8_t *carry, size_t x_size, size_t y_size,
                      size_t z_size);
@@ -17,4 +32,120 @@ uint8_t sub_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
 
 uint8_t add_bstrings_nocheck(const uint8_t *x, const uint8_t *y, uint8_t *z,
                              size_t x_size, size_t y_size, size_t z_size);
+
+uint8_t mul_bstrings_8_gradeschool(const uint8_t *x, const uint8_t *y,
+                                   uint8_t *z, uint8_t *flags, size_t x_size,
+                                   size_t y_size, size_t z_size);
+
+uint8_t mul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size);
+
+uint8_t mul_bstrings_karatsuba(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                               uint8_t *flags, size_t x_size, size_t y_size,
+                               size_t z_size);
+
+uint8_t mul_bstrings_ntt(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                         uint8_t *flags, size_t x_size, size_t y_size,
+                         size_t z_size);
+
+uint8_t sqr_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                     size_t x_size, size_t z_size);
+
+uint8_t sqr_bstrings_basecase(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                              size_t x_size, size_t z_size);
+
+size_t mul_bstrings_itch(size_t x_size, size_t y_size);
+
+uint8_t mul_bstrings_arena(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                           uint8_t *flags, size_t x_size, size_t y_size,
+                           size_t z_size, jl_arena *arena);
+
+size_t sqr_bstrings_itch(size_t x_size);
+
+uint8_t sqr_bstrings_arena(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                           size_t x_size, size_t z_size, jl_arena *arena);
+
+uint8_t addmul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t y_size,
+                        size_t z_size);
+
+uint8_t submul_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t y_size,
+                        size_t z_size);
+
+jl_limb_t add_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                size_t n);
+
+jl_limb_t sub_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                size_t n);
+
+jl_limb_t add_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t c);
+
+jl_limb_t sub_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t b);
+
+int cmp_n(const jl_limb_t *x, const jl_limb_t *y, size_t n);
+
+int abs_sub_n(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+              const jl_limb_t *y, size_t y_n);
+
+void karatsuba_combine(jl_limb_t *z, jl_limb_t *t, size_t h, size_t z_n,
+                       int neg);
+
+jl_limb_t lshift(jl_limb_t *z, const jl_limb_t *x, size_t n, unsigned cnt);
+
+jl_limb_t rshift(jl_limb_t *z, const jl_limb_t *x, size_t n, unsigned cnt);
+
+jl_limb_t mul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y);
+
+jl_limb_t addmul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y);
+
+jl_limb_t submul_1(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y);
+
+void mul_basecase(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                  const jl_limb_t *y, size_t y_n);
+
+void set_limb_kernels(unsigned features);
+
+unsigned get_limb_kernels(void);
+
+void sqr_basecase(jl_limb_t *z, const jl_limb_t *x, size_t n);
+
+void set_mul_karatsuba_threshold(size_t n);
+
+size_t get_mul_karatsuba_threshold(void);
+
+size_t mul_karatsuba_itch(size_t x_n, size_t y_n);
+
+void mul_karatsuba(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                   const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+
+void set_sqr_karatsuba_threshold(size_t n);
+
+size_t get_sqr_karatsuba_threshold(void);
+
+size_t sqr_karatsuba_itch(size_t n);
+
+void sqr_karatsuba(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                   jl_limb_t *scratch);
+
+size_t mul_limbs_itch(size_t x_n, size_t y_n);
+
+void mul_limbs(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+
+size_t sqr_limbs_itch(size_t n);
+
+void sqr_limbs(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch);
+
+size_t addmul_limbs_itch(size_t x_n, size_t y_n);
+
+jl_limb_t addmul_limbs(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                       size_t x_n, const jl_limb_t *y, size_t y_n,
+                       jl_limb_t *scratch);
+
+jl_limb_t submul_limbs(jl_limb_t *z, size_t z_n, const jl_limb_t *x,
+                       size_t x_n, const jl_limb_t *y, size_t y_n,
+                       jl_limb_t *scratch);
 #endif
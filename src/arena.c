@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "limb.h"
+
+/**
+ * @brief Sets up @p a over the @p size bytes at @p buf. The start is rounded
+ * up to a limb boundary, which may cost up to JL_LIMB_BYTES - 1 bytes; a buffer
+ * from malloc, or a jl_limb_t array, is already aligned.
+ */
+void arena_init(jl_arena *a, void *buf, size_t size) {
+  const size_t skip = -(uintptr_t)buf & (JL_LIMB_BYTES - 1);
+  a->base = (uint8_t *)buf + skip;
+  a->size = size > skip ? size - skip : 0;
+  a->used = 0;
+  a->peak = 0;
+}
+
+/**
+ * @brief Takes @p size bytes, rounded up to whole limbs, from the top of @p a.
+ *
+ * @return (void*): The block, limb aligned, or NULL if @p a doesn't have that
+ * much left.
+ */
+void *arena_alloc(jl_arena *a, size_t size) {
+  size = (size + JL_LIMB_BYTES - 1) & ~(size_t)(JL_LIMB_BYTES - 1);
+  if (size > a->size - a->used)
+    return NULL;
+
+  void *p = a->base + a->used;
+  a->used += size;
+  if (a->used > a->peak)
+    a->peak = a->used;
+
+  return p;
+}
+
+/**
+ * @brief The current top of @p a, for a later arena_release.
+ */
+size_t arena_mark(const jl_arena *a) { return a->used; }
+
+/**
+ * @brief Frees everything allocated from @p a since @p mark was taken.
+ */
+void arena_release(jl_arena *a, size_t mark) {
+  if (mark < a->used)
+    a->used = mark;
+}
+
+/**
+ * @brief Frees everything allocated from @p a.
+ */
+void arena_reset(jl_arena *a) { a->used = 0; }
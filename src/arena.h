@@ -0,0 +1,36 @@
+#ifndef __JL_ARENA_H__
+#define __JL_ARENA_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+/**
+ * @brief A bump allocator over a caller-supplied buffer. Allocations are limb
+ * aligned and come off the top in order; arena_release pops everything
+ * allocated after a mark, so the arena also works as a stack. Nothing is ever
+ * freed to, or taken from, the system allocator.
+ *
+ * The *_arena variants of the byte-string operations take their temporaries
+ * from an arena and give them back before returning. The matching *_itch
+ * functions report how many free bytes that needs, so an arena sized once can
+ * run any number of operations up to a given size.
+ */
+typedef struct {
+  uint8_t *base; // Start of the buffer, limb aligned.
+  size_t size;   // Usable bytes from base.
+  size_t used;   // Bytes allocated.
+  size_t peak;   // Most bytes ever allocated at once.
+} jl_arena;
+
+void arena_init(jl_arena *a, void *buf, size_t size);
+
+void *arena_alloc(jl_arena *a, size_t size);
+
+size_t arena_mark(const jl_arena *a);
+
+void arena_release(jl_arena *a, size_t mark);
+
+void arena_reset(jl_arena *a);
+#endif
@@ -0,0 +1,393 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "batch.h"
+#include "cpu.h"
+#include "limb.h"
+
+#if JL_HAVE_BATCH_SIMD
+#include <immintrin.h>
+#endif
+
+// Lanes the portable kernels carry through a row at once. Their carries live
+// in a small array, and the lanes' multiplies are independent, so they overlap
+// in the pipeline where one integer's carry chain would serialize them.
+#define BATCH_BLOCK 8
+
+/*
+ * Portable kernels. Each handles lanes from @p from up, so the vector kernels
+ * can hand them whatever is left over after their last full register.
+ */
+
+static void add_batch_generic(jl_limb_t *z, const jl_limb_t *x,
+                              const jl_limb_t *y, uint8_t *carry, size_t n,
+                              size_t count, size_t from) {
+  for (size_t i = from; i < count; i += BATCH_BLOCK) {
+    const size_t w = count - i < BATCH_BLOCK ? count - i : BATCH_BLOCK;
+    jl_limb_t c[BATCH_BLOCK] = {0};
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      for (size_t l = 0; l < w; l++)
+        z[k + l] = addc_limb(x[k + l], y[k + l], c[l], &c[l]);
+    }
+    if (carry)
+      for (size_t l = 0; l < w; l++)
+        carry[i + l] = (uint8_t)c[l];
+  }
+}
+
+static void sub_batch_generic(jl_limb_t *z, const jl_limb_t *x,
+                              const jl_limb_t *y, uint8_t *borrow, size_t n,
+                              size_t count, size_t from) {
+  for (size_t i = from; i < count; i += BATCH_BLOCK) {
+    const size_t w = count - i < BATCH_BLOCK ? count - i : BATCH_BLOCK;
+    jl_limb_t b[BATCH_BLOCK] = {0};
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      for (size_t l = 0; l < w; l++)
+        z[k + l] = subb_limb(x[k + l], y[k + l], b[l], &b[l]);
+    }
+    if (borrow)
+      for (size_t l = 0; l < w; l++)
+        borrow[i + l] = (uint8_t)b[l];
+  }
+}
+
+#if JL_HAVE_BATCH_SIMD
+
+/*
+ * Vector kernels. Neither AVX2 nor AVX-512 has an add with carry, so each lane
+ * recovers its own: s = a + b wrapped iff s < a, and adding the carry in
+ * wraps iff it turns s into 0. AVX2 keeps the carries as all-ones lanes and,
+ * lacking an unsigned compare, flips the sign bits and compares signed;
+ * AVX-512 keeps them in a mask register and compares unsigned directly.
+ *
+ * Only call these after cpu_features() has reported the extension.
+ */
+
+#define JL_AVX2 __attribute__((target("avx2")))
+#define JL_AVX512 __attribute__((target("avx512f")))
+
+static inline JL_AVX2 __m256i cmplt_epu64_avx2(__m256i a, __m256i b) {
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign),
+                            _mm256_xor_si256(a, sign));
+}
+
+static inline JL_AVX2 void store_flags_avx2(uint8_t *f, __m256i m) {
+  const int bits = _mm256_movemask_pd(_mm256_castsi256_pd(m));
+  for (int l = 0; l < 4; l++)
+    f[l] = (uint8_t)(bits >> l & 1);
+}
+
+static JL_AVX2 void add_batch_avx2(jl_limb_t *z, const jl_limb_t *x,
+                                   const jl_limb_t *y, uint8_t *carry, size_t n,
+                                   size_t count) {
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i c = zero;
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      const __m256i a = _mm256_loadu_si256((const __m256i *)(x + k));
+      const __m256i b = _mm256_loadu_si256((const __m256i *)(y + k));
+      const __m256i s = _mm256_add_epi64(a, b);
+      const __m256i t = _mm256_sub_epi64(s, c);
+      c = _mm256_or_si256(cmplt_epu64_avx2(s, a),
+                          _mm256_and_si256(c, _mm256_cmpeq_epi64(t, zero)));
+      _mm256_storeu_si256((__m256i *)(z + k), t);
+    }
+    if (carry)
+      store_flags_avx2(carry + i, c);
+  }
+  add_batch_generic(z, x, y, carry, n, count, i);
+}
+
+static JL_AVX2 void sub_batch_avx2(jl_limb_t *z, const jl_limb_t *x,
+                                   const jl_limb_t *y, uint8_t *borrow,
+                                   size_t n, size_t count) {
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i c = zero;
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      const __m256i a = _mm256_loadu_si256((const __m256i *)(x + k));
+      const __m256i b = _mm256_loadu_si256((const __m256i *)(y + k));
+      const __m256i d = _mm256_sub_epi64(a, b);
+      const __m256i t = _mm256_add_epi64(d, c);
+      c = _mm256_or_si256(cmplt_epu64_avx2(a, b),
+                          _mm256_and_si256(c, _mm256_cmpeq_epi64(d, zero)));
+      _mm256_storeu_si256((__m256i *)(z + k), t);
+    }
+    if (borrow)
+      store_flags_avx2(borrow + i, c);
+  }
+  sub_batch_generic(z, x, y, borrow, n, count, i);
+}
+
+static JL_AVX512 void add_batch_avx512(jl_limb_t *z, const jl_limb_t *x,
+                                       const jl_limb_t *y, uint8_t *carry,
+                                       size_t n, size_t count) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi64(1);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __mmask8 c = 0;
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      const __m512i a = _mm512_loadu_si512(x + k);
+      const __m512i b = _mm512_loadu_si512(y + k);
+      const __m512i s = _mm512_add_epi64(a, b);
+      const __m512i t = _mm512_mask_add_epi64(s, c, s, one);
+      c = _mm512_cmplt_epu64_mask(s, a) |
+          _mm512_mask_cmpeq_epu64_mask(c, t, zero);
+      _mm512_storeu_si512(z + k, t);
+    }
+    if (carry)
+      for (int l = 0; l < 8; l++)
+        carry[i + l] = (uint8_t)(c >> l & 1);
+  }
+  add_batch_generic(z, x, y, carry, n, count, i);
+}
+
+static JL_AVX512 void sub_batch_avx512(jl_limb_t *z, const jl_limb_t *x,
+                                       const jl_limb_t *y, uint8_t *borrow,
+                                       size_t n, size_t count) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi64(1);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __mmask8 c = 0;
+    for (size_t j = 0; j < n; j++) {
+      const size_t k = j * count + i;
+      const __m512i a = _mm512_loadu_si512(x + k);
+      const __m512i b = _mm512_loadu_si512(y + k);
+      const __m512i d = _mm512_sub_epi64(a, b);
+      const __m512i t = _mm512_mask_sub_epi64(d, c, d, one);
+      c = _mm512_cmplt_epu64_mask(a, b) |
+          _mm512_mask_cmpeq_epu64_mask(c, d, zero);
+      _mm512_storeu_si512(z + k, t);
+    }
+    if (borrow)
+      for (int l = 0; l < 8; l++)
+        borrow[i + l] = (uint8_t)(c >> l & 1);
+  }
+  sub_batch_generic(z, x, y, borrow, n, count, i);
+}
+#endif
+
+static void add_batch_portable(jl_limb_t *z, const jl_limb_t *x,
+                               const jl_limb_t *y, uint8_t *carry, size_t n,
+                               size_t count) {
+  add_batch_generic(z, x, y, carry, n, count, 0);
+}
+
+static void sub_batch_portable(jl_limb_t *z, const jl_limb_t *x,
+                               const jl_limb_t *y, uint8_t *borrow, size_t n,
+                               size_t count) {
+  sub_batch_generic(z, x, y, borrow, n, count, 0);
+}
+
+/*
+ * add_batch and sub_batch run through these pointers, moved to the widest
+ * vector kernels the CPU supports when the library loads.
+ */
+
+typedef void (*batch_fn)(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                         uint8_t *flags, size_t n, size_t count);
+
+static batch_fn add_batch_kernel = add_batch_portable;
+static batch_fn sub_batch_kernel = sub_batch_portable;
+static unsigned batch_kernel_features = 0;
+
+/**
+ * @brief Picks the kernels behind add_batch and sub_batch from the JL_CPU_*
+ * extensions in @p features, preferring AVX-512 to AVX2. Extensions the CPU
+ * lacks are ignored, so set_batch_kernels(0) forces the portable kernels, and
+ * set_batch_kernels(JL_CPU_AVX2) keeps off AVX-512 on CPUs that slow their
+ * clock for it. Not safe to call while other threads are using them.
+ */
+void set_batch_kernels(unsigned features) {
+  features &= cpu_features();
+
+  add_batch_kernel = add_batch_portable;
+  sub_batch_kernel = sub_batch_portable;
+  batch_kernel_features = 0;
+
+#if JL_HAVE_BATCH_SIMD
+  if (features & JL_CPU_AVX512F) {
+    add_batch_kernel = add_batch_avx512;
+    sub_batch_kernel = sub_batch_avx512;
+    batch_kernel_features = JL_CPU_AVX512F;
+  } else if (features & JL_CPU_AVX2) {
+    add_batch_kernel = add_batch_avx2;
+    sub_batch_kernel = sub_batch_avx2;
+    batch_kernel_features = JL_CPU_AVX2;
+  }
+#endif
+}
+
+/**
+ * @brief The JL_CPU_* extension the current batch kernels use, or 0.
+ */
+unsigned get_batch_kernels(void) { return batch_kernel_features; }
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor)) static void init_batch_kernels(void) {
+  set_batch_kernels(cpu_features());
+}
+#endif
+
+/**
+ * @brief Converts @p count little-endian byte strings of @p x_size bytes each,
+ * stored back to back in @p x, into @p n limb lanes in @p z. Lanes are padded
+ * with zeros past @p x_size bytes, and bytes past @p n limbs are dropped.
+ *
+ * @param[out] z (jl_limb_t*): @p n * @p count limbs.
+ * @param[in] x (const uint8_t*): @p count * @p x_size bytes.
+ */
+void pack_batch(jl_limb_t *z, const uint8_t *x, size_t x_size, size_t n,
+                size_t count) {
+  for (size_t j = 0; j < n; j++) {
+    const size_t off = j * JL_LIMB_BYTES;
+    jl_limb_t *row = z + j * count;
+    if (off >= x_size) {
+      memset(row, 0, count * sizeof(jl_limb_t));
+      continue;
+    }
+
+    const size_t len =
+        x_size - off < JL_LIMB_BYTES ? x_size - off : JL_LIMB_BYTES;
+    for (size_t i = 0; i < count; i++)
+      row[i] = load_limb_partial(x + i * x_size + off, len);
+  }
+}
+
+/**
+ * @brief Converts the @p count lanes of @p n limbs in @p x back into
+ * little-endian byte strings of @p z_size bytes each, stored back to back in
+ * @p z. Each is truncated or padded with zeros to exactly @p z_size bytes.
+ *
+ * @param[out] z (uint8_t*): @p count * @p z_size bytes.
+ * @param[in] x (const jl_limb_t*): @p n * @p count limbs.
+ */
+void unpack_batch(uint8_t *z, const jl_limb_t *x, size_t z_size, size_t n,
+                  size_t count) {
+  for (size_t off = 0; off < z_size; off += JL_LIMB_BYTES) {
+    const size_t j = off / JL_LIMB_BYTES;
+    const size_t len =
+        z_size - off < JL_LIMB_BYTES ? z_size - off : JL_LIMB_BYTES;
+    for (size_t i = 0; i < count; i++)
+      store_limb_partial(z + i * z_size + off, j < n ? x[j * count + i] : 0,
+                         len);
+  }
+}
+
+/**
+ * @brief Adds @p count pairs of @p n limb integers, lane by lane: lane i of
+ * @p z is set to lane i of @p x plus lane i of @p y, mod 2^(64 @p n).
+ *
+ * @p z may equal @p x or @p y, but may not otherwise overlap them.
+ *
+ * @param[out] z (jl_limb_t*): @p n * @p count limbs.
+ * @param[in] x (const jl_limb_t*): @p n * @p count limbs.
+ * @param[in] y (const jl_limb_t*): @p n * @p count limbs.
+ * @param[out] carry (uint8_t*): The carry out of each lane, one byte per lane.
+ * May be NULL.
+ */
+void add_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+               uint8_t *carry, size_t n, size_t count) {
+  add_batch_kernel(z, x, y, carry, n, count);
+}
+
+/**
+ * @brief Subtracts @p count pairs of @p n limb integers, lane by lane: lane i
+ * of @p z is set to lane i of @p x minus lane i of @p y, mod 2^(64 @p n).
+ *
+ * @p z may equal @p x or @p y, but may not otherwise overlap them.
+ *
+ * @param[out] z (jl_limb_t*): @p n * @p count limbs.
+ * @param[in] x (const jl_limb_t*): @p n * @p count limbs.
+ * @param[in] y (const jl_limb_t*): @p n * @p count limbs.
+ * @param[out] borrow (uint8_t*): The borrow out of each lane, one byte per
+ * lane. May be NULL.
+ */
+void sub_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+               uint8_t *borrow, size_t n, size_t count) {
+  sub_batch_kernel(z, x, y, borrow, n, count);
+}
+
+// mul_batch moves each lane of at least BATCH_GATHER_MIN and at most
+// BATCH_GATHER_MAX limbs into a contiguous tile and runs mul_basecase on it,
+// which beats multiplying in place once there are enough products per lane to
+// pay for the moves. Other sizes stay interleaved.
+#define BATCH_GATHER_MIN 8
+#define BATCH_GATHER_MAX 64
+
+/**
+ * @brief Multiplies @p count pairs of @p n limb integers, lane by lane, into
+ * full 2 @p n limb products.
+ *
+ * There is no vector multiply of 64 bit limbs into 128 bits, so this runs on
+ * the scalar multiplier. Small lanes are multiplied in place, BATCH_BLOCK at a
+ * time, so their carry chains overlap instead of running one after the other;
+ * larger ones go through mul_basecase, and so through the BMI2/ADX kernels
+ * where the CPU has them.
+ *
+ * @p z may not overlap @p x or @p y.
+ *
+ * @param[out] z (jl_limb_t*): 2 * @p n * @p count limbs, lanes interleaved the
+ * same way.
+ * @param[in] x (const jl_limb_t*): @p n * @p count limbs.
+ * @param[in] y (const jl_limb_t*): @p n * @p count limbs.
+ */
+void mul_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n,
+               size_t count) {
+  if (n >= BATCH_GATHER_MIN && n <= BATCH_GATHER_MAX) {
+    jl_limb_t xt[BATCH_GATHER_MAX], yt[BATCH_GATHER_MAX];
+    jl_limb_t zt[2 * BATCH_GATHER_MAX];
+    for (size_t i = 0; i < count; i++) {
+      for (size_t j = 0; j < n; j++) {
+        xt[j] = x[j * count + i];
+        yt[j] = y[j * count + i];
+      }
+      mul_basecase(zt, xt, n, yt, n);
+      for (size_t j = 0; j < 2 * n; j++)
+        z[j * count + i] = zt[j];
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < count; i += BATCH_BLOCK) {
+    const size_t w = count - i < BATCH_BLOCK ? count - i : BATCH_BLOCK;
+    for (size_t k = 0; k < n; k++)
+      memset(z + k * count + i, 0, w * sizeof(jl_limb_t));
+
+    // Row j adds x * y[j] into z[j..j + n], as in mul_basecase.
+    for (size_t j = 0; j < n; j++) {
+      const jl_limb_t *yj = y + j * count + i;
+      jl_limb_t c[BATCH_BLOCK] = {0};
+      for (size_t k = 0; k < n; k++) {
+        const jl_limb_t *xk = x + k * count + i;
+        jl_limb_t *zk = z + (j + k) * count + i;
+        for (size_t l = 0; l < w; l++) {
+          // x * y + c + z < 2^128, so the high limb can't overflow.
+          jl_limb_t hi;
+          jl_limb_t lo = mul_limb(xk[l], yj[l], &hi);
+          lo += c[l];
+          hi += lo < c[l];
+          const jl_limb_t s = lo + zk[l];
+          hi += s < lo;
+          zk[l] = s;
+          c[l] = hi;
+        }
+      }
+      jl_limb_t *zn = z + (j + n) * count + i;
+      for (size_t l = 0; l < w; l++)
+        zn[l] = c[l];
+    }
+  }
+}
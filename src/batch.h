@@ -0,0 +1,45 @@
+#ifndef __JL_BATCH_H__
+#define __JL_BATCH_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+/*
+ * Batched arithmetic on many independent integers of the same size n limbs,
+ * held as a structure of arrays: limb j of lane i is x[j * count + i]. Adjacent
+ * lanes sit next to each other in memory, so a vector register loads the same
+ * limb of 4 (AVX2) or 8 (AVX-512) lanes at once and runs their carry chains
+ * side by side. pack_batch and unpack_batch convert to and from an array of
+ * byte strings.
+ */
+
+// The AVX2 and AVX-512 kernels use compiler intrinsics, so they only exist on
+// x86-64 with GCC or Clang. Define JL_NO_SIMD to leave them out anyway.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) &&       \
+    !defined(JL_NO_SIMD)
+#define JL_HAVE_BATCH_SIMD 1
+#else
+#define JL_HAVE_BATCH_SIMD 0
+#endif
+
+void set_batch_kernels(unsigned features);
+
+unsigned get_batch_kernels(void);
+
+void pack_batch(jl_limb_t *z, const uint8_t *x, size_t x_size, size_t n,
+                size_t count);
+
+void unpack_batch(uint8_t *z, const jl_limb_t *x, size_t z_size, size_t n,
+                  size_t count);
+
+void add_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+               uint8_t *carry, size_t n, size_t count);
+
+void sub_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+               uint8_t *borrow, size_t n, size_t count);
+
+void mul_batch(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n,
+               size_t count);
+#endif
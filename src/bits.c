@@ -0,0 +1,941 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "bits.h"
+#include "cpu.h"
+#include "jl_int.h"
+#include "limb.h"
+
+#if JL_HAVE_BITS_SIMD
+#include <immintrin.h>
+#endif
+
+// jl_int operations with at most this many limbs of two's complement
+// temporaries work on the stack.
+#define JL_BITS_STACK_LIMBS 64
+
+/*
+ * The kernels all work on bytes. And, or, xor and popcount don't care how the
+ * bytes group into words, so the same kernels serve limb arrays. The shift
+ * kernels only do the bulk of a shift, where every word they read is inside
+ * the operand; the functions below do the ragged ends a byte at a time.
+ *
+ * The portable kernels go a 64-bit word at a time, which compilers vectorize
+ * further with whatever the target has, SSE2 at least on x86-64.
+ */
+
+static inline unsigned popcount_limb(jl_limb_t x) {
+#if JL_HAS_BUILTIN(__builtin_popcountll) || defined(__GNUC__)
+  return (unsigned)__builtin_popcountll(x);
+#else
+  x -= (x >> 1) & 0x5555555555555555ull;
+  x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return (unsigned)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static void and_portable(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                         size_t n) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i, load_limb(x + i) & load_limb(y + i));
+  for (; i < n; i++)
+    z[i] = x[i] & y[i];
+}
+
+static void or_portable(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                        size_t n) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i, load_limb(x + i) | load_limb(y + i));
+  for (; i < n; i++)
+    z[i] = x[i] | y[i];
+}
+
+static void xor_portable(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                         size_t n) {
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    store_limb(z + i, load_limb(x + i) ^ load_limb(y + i));
+  for (; i < n; i++)
+    z[i] = x[i] ^ y[i];
+}
+
+static uint64_t popcount_portable(const uint8_t *x, size_t n) {
+  uint64_t c = 0;
+  size_t i = 0;
+  for (; i + JL_LIMB_BYTES <= n; i += JL_LIMB_BYTES)
+    c += popcount_limb(load_limb(x + i));
+  for (; i < n; i++)
+    c += popcount_limb(x[i]);
+  return c;
+}
+
+// Words k = nw - 1 down to 0 of x << r, 0 < r < 64: word k of z is made from
+// words k and k - 1 of x, so x[-8] to x[8 nw - 1] must be readable. Going
+// down, z may be at or above x.
+static void lshift_body_portable(uint8_t *z, const uint8_t *x, size_t nw,
+                                 unsigned r) {
+  for (size_t k = nw; k > 0; k--) {
+    const uint8_t *p = x + (k - 1) * JL_LIMB_BYTES;
+    store_limb(z + (k - 1) * JL_LIMB_BYTES,
+               load_limb(p) << r | load_limb(p - JL_LIMB_BYTES) >> (64 - r));
+  }
+}
+
+// Words 0 to nw - 1 of x >> r, 0 < r < 64, from words k and k + 1 of x, so
+// x[0] to x[8 nw + 7] must be readable. Going up, z may be at or below x.
+static void rshift_body_portable(uint8_t *z, const uint8_t *x, size_t nw,
+                                 unsigned r) {
+  for (size_t k = 0; k < nw; k++) {
+    const uint8_t *p = x + k * JL_LIMB_BYTES;
+    store_limb(z + k * JL_LIMB_BYTES,
+               load_limb(p) >> r | load_limb(p + JL_LIMB_BYTES) << (64 - r));
+  }
+}
+
+#if JL_HAVE_BITS_SIMD
+
+/*
+ * AVX2 kernels, 32 bytes at a time, handing what's left to the portable ones.
+ * Popcount looks each nibble up in a 16-entry table with vpshufb, and sums the
+ * byte counts into 64-bit lanes with vpsadbw. Shifts move each 64-bit lane and
+ * fill in the bits from the lane below (or above), loaded 8 bytes off.
+ *
+ * Only call these after cpu_features() has reported AVX2.
+ */
+
+#define JL_AVX2 __attribute__((target("avx2")))
+
+static JL_AVX2 void and_avx2(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                             size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)(x + i));
+    const __m256i b = _mm256_loadu_si256((const __m256i *)(y + i));
+    _mm256_storeu_si256((__m256i *)(z + i), _mm256_and_si256(a, b));
+  }
+  and_portable(z + i, x + i, y + i, n - i);
+}
+
+static JL_AVX2 void or_avx2(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                            size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)(x + i));
+    const __m256i b = _mm256_loadu_si256((const __m256i *)(y + i));
+    _mm256_storeu_si256((__m256i *)(z + i), _mm256_or_si256(a, b));
+  }
+  or_portable(z + i, x + i, y + i, n - i);
+}
+
+static JL_AVX2 void xor_avx2(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                             size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)(x + i));
+    const __m256i b = _mm256_loadu_si256((const __m256i *)(y + i));
+    _mm256_storeu_si256((__m256i *)(z + i), _mm256_xor_si256(a, b));
+  }
+  xor_portable(z + i, x + i, y + i, n - i);
+}
+
+static JL_AVX2 uint64_t popcount_avx2(const uint8_t *x, size_t n) {
+  const __m256i table =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)(x + i));
+    const __m256i lo = _mm256_and_si256(v, nibble);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    const __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(table, lo),
+                                      _mm256_shuffle_epi8(table, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(c, zero));
+  }
+  const uint64_t c = (uint64_t)_mm256_extract_epi64(acc, 0) +
+                     (uint64_t)_mm256_extract_epi64(acc, 1) +
+                     (uint64_t)_mm256_extract_epi64(acc, 2) +
+                     (uint64_t)_mm256_extract_epi64(acc, 3);
+  return c + popcount_portable(x + i, n - i);
+}
+
+static JL_AVX2 void lshift_body_avx2(uint8_t *z, const uint8_t *x, size_t nw,
+                                     unsigned r) {
+  const __m128i cl = _mm_cvtsi32_si128((int)r);
+  const __m128i cr = _mm_cvtsi32_si128((int)(64 - r));
+  size_t k = nw;
+  for (; k >= 4; k -= 4) {
+    const uint8_t *p = x + (k - 4) * JL_LIMB_BYTES;
+    const __m256i a = _mm256_loadu_si256((const __m256i *)p);
+    const __m256i b =
+        _mm256_loadu_si256((const __m256i *)(p - JL_LIMB_BYTES));
+    _mm256_storeu_si256(
+        (__m256i *)(z + (k - 4) * JL_LIMB_BYTES),
+        _mm256_or_si256(_mm256_sll_epi64(a, cl), _mm256_srl_epi64(b, cr)));
+  }
+  lshift_body_portable(z, x, k, r);
+}
+
+static JL_AVX2 void rshift_body_avx2(uint8_t *z, const uint8_t *x, size_t nw,
+                                     unsigned r) {
+  const __m128i cr = _mm_cvtsi32_si128((int)r);
+  const __m128i cl = _mm_cvtsi32_si128((int)(64 - r));
+  size_t k = 0;
+  for (; k + 4 <= nw; k += 4) {
+    const uint8_t *p = x + k * JL_LIMB_BYTES;
+    const __m256i a = _mm256_loadu_si256((const __m256i *)p);
+    const __m256i b =
+        _mm256_loadu_si256((const __m256i *)(p + JL_LIMB_BYTES));
+    _mm256_storeu_si256(
+        (__m256i *)(z + k * JL_LIMB_BYTES),
+        _mm256_or_si256(_mm256_srl_epi64(a, cr), _mm256_sll_epi64(b, cl)));
+  }
+  rshift_body_portable(z + k * JL_LIMB_BYTES, x + k * JL_LIMB_BYTES, nw - k,
+                       r);
+}
+#endif
+
+/*
+ * Everything below runs through these pointers, moved to the AVX2 kernels
+ * when the library loads if the CPU has them.
+ */
+
+typedef void (*logic_fn)(uint8_t *z, const uint8_t *x, const uint8_t *y,
+                         size_t n);
+typedef void (*shift_fn)(uint8_t *z, const uint8_t *x, size_t nw, unsigned r);
+
+static logic_fn and_kernel = and_portable;
+static logic_fn or_kernel = or_portable;
+static logic_fn xor_kernel = xor_portable;
+static uint64_t (*popcount_kernel)(const uint8_t *x,
+                                   size_t n) = popcount_portable;
+static shift_fn lshift_kernel = lshift_body_portable;
+static shift_fn rshift_kernel = rshift_body_portable;
+static unsigned bits_kernel_features = 0;
+
+/**
+ * @brief Picks the kernels behind the bit operations from the JL_CPU_*
+ * extensions in @p features. Extensions the CPU lacks are ignored, so
+ * set_bits_kernels(0) forces the portable kernels. Not safe to call while
+ * other threads are using them.
+ */
+void set_bits_kernels(unsigned features) {
+  features &= cpu_features();
+
+  and_kernel = and_portable;
+  or_kernel = or_portable;
+  xor_kernel = xor_portable;
+  popcount_kernel = popcount_portable;
+  lshift_kernel = lshift_body_portable;
+  rshift_kernel = rshift_body_portable;
+  bits_kernel_features = 0;
+
+#if JL_HAVE_BITS_SIMD
+  if (features & JL_CPU_AVX2) {
+    and_kernel = and_avx2;
+    or_kernel = or_avx2;
+    xor_kernel = xor_avx2;
+    popcount_kernel = popcount_avx2;
+    lshift_kernel = lshift_body_avx2;
+    rshift_kernel = rshift_body_avx2;
+    bits_kernel_features = JL_CPU_AVX2;
+  }
+#endif
+}
+
+/**
+ * @brief The JL_CPU_* extension the current bit kernels use, or 0.
+ */
+unsigned get_bits_kernels(void) { return bits_kernel_features; }
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor)) static void init_bits_kernels(void) {
+  set_bits_kernels(cpu_features());
+}
+#endif
+
+/**
+ * @brief z = x & y on @p n limbs. @p z may be @p x or @p y.
+ */
+void and_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n) {
+  and_kernel((uint8_t *)z, (const uint8_t *)x, (const uint8_t *)y,
+             n * JL_LIMB_BYTES);
+}
+
+/**
+ * @brief z = x | y on @p n limbs. @p z may be @p x or @p y.
+ */
+void ior_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n) {
+  or_kernel((uint8_t *)z, (const uint8_t *)x, (const uint8_t *)y,
+            n * JL_LIMB_BYTES);
+}
+
+/**
+ * @brief z = x ^ y on @p n limbs. @p z may be @p x or @p y.
+ */
+void xor_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n) {
+  xor_kernel((uint8_t *)z, (const uint8_t *)x, (const uint8_t *)y,
+             n * JL_LIMB_BYTES);
+}
+
+/**
+ * @return (uint64_t): The number of set bits in the @p n limbs at @p x.
+ */
+uint64_t popcount_n(const jl_limb_t *x, size_t n) {
+  return popcount_kernel((const uint8_t *)x, n * JL_LIMB_BYTES);
+}
+
+// Significant bits in the byte string x.
+static uint64_t bstring_bits(const uint8_t *x, size_t x_size) {
+  size_t i = x_size;
+  while (i >= JL_LIMB_BYTES && load_limb(x + i - JL_LIMB_BYTES) == 0)
+    i -= JL_LIMB_BYTES;
+  while (i > 0 && x[i - 1] == 0)
+    i--;
+  if (i == 0)
+    return 0;
+  return 8 * (uint64_t)i - (clz_limb(x[i - 1]) - (JL_LIMB_BITS - 8));
+}
+
+static inline uint8_t logic_byte(uint8_t a, uint8_t b, int op) {
+  return op == 0 ? a & b : op == 1 ? a | b : a ^ b;
+}
+
+// z = x op y, for op 0, 1 or 2: and, or, xor.
+static uint8_t logic_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                              uint8_t *flags, size_t x_size, size_t y_size,
+                              size_t z_size, int op) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  // Past the shorter operand, and gives zeros and the others the longer one.
+  const size_t m = x_size < y_size ? x_size : y_size;
+  const size_t l = op == 0 ? m : x_size > y_size ? x_size : y_size;
+  const uint8_t *longer = x_size > y_size ? x : y;
+
+  // Any of the result past z_size, before z overwrites an operand.
+  uint8_t lost = 0;
+  for (size_t j = z_size; j < l && !lost; j++)
+    lost = j < m ? logic_byte(x[j], y[j], op) : longer[j];
+  *flags = lost != 0;
+
+  const size_t k = m < z_size ? m : z_size;
+  const logic_fn kernel =
+      op == 0 ? and_kernel : op == 1 ? or_kernel : xor_kernel;
+  kernel(z, x, y, k);
+  const size_t c = l < z_size ? l : z_size;
+  if (c > k)
+    memmove(z + k, longer + k, c - k);
+  memset(z + c, 0, z_size - c);
+
+  return 0;
+}
+
+/**
+ * @brief Stores the bitwise and of @p x and @p y in @p z, the shorter operand
+ * zero-extended. @p z may be @p x or @p y.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, or @p z is NULL.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the result doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): The result, zero-padded to @p z_size bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] y_size (size_t): Size of @p y.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t and_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size) {
+  return logic_bstrings(x, y, z, flags, x_size, y_size, z_size, 0);
+}
+
+/**
+ * @brief Stores the bitwise or of @p x and @p y in @p z. Same contract as
+ * and_bstrings.
+ */
+uint8_t or_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                    uint8_t *flags, size_t x_size, size_t y_size,
+                    size_t z_size) {
+  return logic_bstrings(x, y, z, flags, x_size, y_size, z_size, 1);
+}
+
+/**
+ * @brief Stores the bitwise exclusive or of @p x and @p y in @p z. Same
+ * contract as and_bstrings.
+ */
+uint8_t xor_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size) {
+  return logic_bstrings(x, y, z, flags, x_size, y_size, z_size, 2);
+}
+
+// Byte j - q of x, 0 outside it.
+static inline uint8_t byte_below(const uint8_t *x, size_t x_size, size_t j,
+                                 size_t q) {
+  return j >= q && j - q < x_size ? x[j - q] : 0;
+}
+
+// Byte j + q of x, 0 past its end.
+static inline uint8_t byte_above(const uint8_t *x, size_t x_size, size_t j,
+                                 size_t q) {
+  return j < x_size && q < x_size - j ? x[j + q] : 0;
+}
+
+/**
+ * @brief Stores @p x shifted left by @p cnt bits in @p z. @p z may be @p x.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, or @p flags is NULL.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the result doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): The result, zero-padded to @p z_size bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] cnt (uint64_t): Bits to shift by. Any count.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t lshift_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                        uint64_t cnt, size_t x_size, size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  const uint64_t bits = bstring_bits(x, x_size);
+  const uint64_t z_bits = 8 * (uint64_t)z_size;
+  *flags = bits > 0 && (cnt >= z_bits || bits > z_bits - cnt);
+  if (cnt / 8 >= z_size) {
+    memset(z, 0, z_size);
+    return 0;
+  }
+
+  // Byte j of z is made of bytes j - q and j - q - 1 of x. Everything goes
+  // from the top down, so that in place nothing is read after it's written.
+  const size_t q = (size_t)(cnt / 8);
+  const unsigned r = cnt % 8;
+  const size_t end = x_size < z_size - q ? q + x_size : z_size;
+  if (r == 0) {
+    memmove(z + q, x, end - q);
+    memset(z + end, 0, z_size - end);
+    memset(z, 0, q);
+    return 0;
+  }
+
+  // Whole words from lo to hi read only inside x.
+  const size_t lo = q + JL_LIMB_BYTES;
+  size_t nw = 0;
+  if (end >= lo + JL_LIMB_BYTES)
+    nw = (end - lo) / JL_LIMB_BYTES;
+  const size_t hi = lo + nw * JL_LIMB_BYTES;
+
+  for (size_t j = z_size; j > hi; j--)
+    z[j - 1] = (uint8_t)(byte_below(x, x_size, j - 1, q) << r |
+                         byte_below(x, x_size, j - 1, q + 1) >> (8 - r));
+  if (nw > 0)
+    lshift_kernel(z + lo, x + lo - q, nw, r);
+  for (size_t j = lo < z_size ? lo : z_size; j > 0; j--)
+    z[j - 1] = (uint8_t)(byte_below(x, x_size, j - 1, q) << r |
+                         byte_below(x, x_size, j - 1, q + 1) >> (8 - r));
+
+  return 0;
+}
+
+/**
+ * @brief Stores @p x shifted right by @p cnt bits in @p z. @p z may be @p x.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, or @p flags is NULL.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the result doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *      1. Set if any of the bits shifted out was set.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): The result, zero-padded to @p z_size bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] cnt (uint64_t): Bits to shift by. Any count.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t rshift_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                        uint64_t cnt, size_t x_size, size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  const uint64_t bits = bstring_bits(x, x_size);
+  *flags = (bits > cnt && bits - cnt > 8 * (uint64_t)z_size) |
+           (bits > 0 && ctz_bstrings(x, x_size) < cnt) << 1;
+  if (cnt / 8 >= x_size) {
+    memset(z, 0, z_size);
+    return 0;
+  }
+
+  // Byte j of z is made of bytes j + q and j + q + 1 of x, and everything
+  // goes from the bottom up.
+  const size_t q = (size_t)(cnt / 8);
+  const unsigned r = cnt % 8;
+  const size_t avail = x_size - q;
+  if (r == 0) {
+    const size_t n = avail < z_size ? avail : z_size;
+    memmove(z, x + q, n);
+    memset(z + n, 0, z_size - n);
+    return 0;
+  }
+
+  // Whole words from 0 that read only inside x.
+  size_t nw = avail >= 2 * JL_LIMB_BYTES
+                  ? (avail - JL_LIMB_BYTES) / JL_LIMB_BYTES
+                  : 0;
+  if (nw > z_size / JL_LIMB_BYTES)
+    nw = z_size / JL_LIMB_BYTES;
+
+  if (nw > 0)
+    rshift_kernel(z, x + q, nw, r);
+  for (size_t j = nw * JL_LIMB_BYTES; j < z_size; j++)
+    z[j] = (uint8_t)(byte_above(x, x_size, j, q) >> r |
+                     byte_above(x, x_size, j, q + 1) << (8 - r));
+
+  return 0;
+}
+
+/**
+ * @return (uint64_t): The number of set bits in @p x.
+ */
+uint64_t popcount_bstrings(const uint8_t *x, size_t x_size) {
+  return popcount_kernel(x, x_size);
+}
+
+/**
+ * @return (uint64_t): The number of zero bits above the highest set bit of
+ * @p x, 8 @p x_size if there is none.
+ */
+uint64_t clz_bstrings(const uint8_t *x, size_t x_size) {
+  return 8 * (uint64_t)x_size - bstring_bits(x, x_size);
+}
+
+/**
+ * @return (uint64_t): The number of zero bits below the lowest set bit of @p
+ * x, 8 @p x_size if there is none.
+ */
+uint64_t ctz_bstrings(const uint8_t *x, size_t x_size) {
+  size_t i = 0;
+  while (i + JL_LIMB_BYTES <= x_size && load_limb(x + i) == 0)
+    i += JL_LIMB_BYTES;
+  while (i < x_size && x[i] == 0)
+    i++;
+  if (i == x_size)
+    return 8 * (uint64_t)x_size;
+  return 8 * (uint64_t)i + ctz_limb(x[i]);
+}
+
+/**
+ * @return (int): Bit @p bit of @p x, 0 past its end.
+ */
+int tstbit_bstrings(const uint8_t *x, size_t x_size, uint64_t bit) {
+  return bit / 8 < x_size ? x[bit / 8] >> (bit % 8) & 1 : 0;
+}
+
+/**
+ * @brief Sets bit @p bit of @p x.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x is NULL.
+ *      3. @p bit is past the end of @p x, which is unchanged.
+ */
+uint8_t setbit_bstrings(uint8_t *x, size_t x_size, uint64_t bit) {
+  // Error check 1.
+  if (x == NULL)
+    return 1;
+
+  // Error check 3.
+  if (bit / 8 >= x_size)
+    return 3;
+
+  x[bit / 8] |= (uint8_t)(1u << (bit % 8));
+  return 0;
+}
+
+/**
+ * @brief Clears bit @p bit of @p x. Same contract as setbit_bstrings.
+ */
+uint8_t clrbit_bstrings(uint8_t *x, size_t x_size, uint64_t bit) {
+  // Error check 1.
+  if (x == NULL)
+    return 1;
+
+  // Error check 3.
+  if (bit / 8 >= x_size)
+    return 3;
+
+  x[bit / 8] &= (uint8_t)~(1u << (bit % 8));
+  return 0;
+}
+
+/**
+ * @return (size_t): The number of significant bits in |@p x|, 0 for zero.
+ */
+size_t int_bit_length(const jl_int *x) {
+  if (x->n == 0)
+    return 0;
+  return x->n * JL_LIMB_BITS - clz_limb(int_limbs(x)[x->n - 1]);
+}
+
+// x as n > x->n limbs of two's complement.
+static void to_twos(jl_limb_t *z, const jl_int *x, size_t n) {
+  memcpy(z, int_limbs(x), x->n * sizeof(jl_limb_t));
+  memset(z + x->n, 0, (n - x->n) * sizeof(jl_limb_t));
+  if (x->neg) {
+    sub_1(z, z, n, 1);
+    for (size_t i = 0; i < n; i++)
+      z[i] = ~z[i];
+  }
+}
+
+// z = x op y in two's complement, for op 0, 1 or 2: and, or, xor.
+static uint8_t int_logic(jl_int *z, const jl_int *x, const jl_int *y,
+                         int op) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  // One limb more than either operand holds its sign.
+  const size_t n = (x->n > y->n ? x->n : y->n) + 1;
+  jl_limb_t stack[JL_BITS_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  if (2 * n > JL_BITS_STACK_LIMBS) {
+    buf = malloc(2 * n * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  }
+
+  jl_limb_t *xt = buf;
+  jl_limb_t *yt = buf + n;
+  to_twos(xt, x, n);
+  to_twos(yt, y, n);
+  if (op == 0)
+    and_n(xt, xt, yt, n);
+  else if (op == 1)
+    ior_n(xt, xt, yt, n);
+  else
+    xor_n(xt, xt, yt, n);
+
+  // A negative result back to its magnitude, ~t + 1.
+  const uint8_t neg = (uint8_t)(xt[n - 1] >> (JL_LIMB_BITS - 1));
+  if (neg) {
+    for (size_t i = 0; i < n; i++)
+      xt[i] = ~xt[i];
+    add_1(xt, xt, n, 1);
+  }
+
+  uint8_t rc = int_reserve(z, n);
+  if (rc == 0) {
+    memcpy(int_limbs(z), xt, n * sizeof(jl_limb_t));
+    z->n = n;
+    z->neg = neg;
+    int_normalize(z);
+  }
+
+  if (buf != stack)
+    free(buf);
+  return rc;
+}
+
+/**
+ * @brief Stores the bitwise and of @p x and @p y in @p z, in two's
+ * complement. Any of the three may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z, @p x, or @p y is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_and(jl_int *z, const jl_int *x, const jl_int *y) {
+  return int_logic(z, x, y, 0);
+}
+
+/**
+ * @brief Stores the bitwise or of @p x and @p y in @p z. Same contract as
+ * int_and.
+ */
+uint8_t int_or(jl_int *z, const jl_int *x, const jl_int *y) {
+  return int_logic(z, x, y, 1);
+}
+
+/**
+ * @brief Stores the bitwise exclusive or of @p x and @p y in @p z. Same
+ * contract as int_and.
+ */
+uint8_t int_xor(jl_int *z, const jl_int *x, const jl_int *y) {
+  return int_logic(z, x, y, 2);
+}
+
+/**
+ * @brief Stores the bitwise complement of @p x, -@p x - 1, in @p z. The two
+ * may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_com(jl_int *z, const jl_int *x) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  jl_int one;
+  int_init(&one);
+  int_set_u64(&one, 1);
+  uint8_t rc = int_add(z, x, &one);
+  if (rc == 0)
+    rc = int_neg(z, z);
+  int_free(&one);
+  return rc;
+}
+
+/**
+ * @brief Stores @p x * 2^@p cnt in @p z. The two may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_lshift(jl_int *z, const jl_int *x, uint64_t cnt) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  const size_t n = x->n;
+  if (n == 0) {
+    z->n = 0;
+    z->neg = 0;
+    return 0;
+  }
+
+  const size_t limbs = (size_t)(cnt / JL_LIMB_BITS);
+  const unsigned r = cnt % JL_LIMB_BITS;
+  if (int_reserve(z, n + limbs + 1))
+    return 2;
+
+  // Storage is looked up after growing z, which may be x.
+  jl_limb_t *zl = int_limbs(z);
+  const jl_limb_t *xl = int_limbs(x);
+  if (r != 0) {
+    zl[n + limbs] = lshift(zl + limbs, xl, n, r);
+  } else {
+    memmove(zl + limbs, xl, n * sizeof(jl_limb_t));
+    zl[n + limbs] = 0;
+  }
+  memset(zl, 0, limbs * sizeof(jl_limb_t));
+  z->n = n + limbs + 1;
+  z->neg = x->neg;
+  int_normalize(z);
+
+  return 0;
+}
+
+/**
+ * @brief Stores floor(@p x / 2^@p cnt) in @p z, which for negative @p x is
+ * the two's complement shift. The two may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_rshift(jl_int *z, const jl_int *x, uint64_t cnt) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  const uint8_t neg = x->neg;
+  const size_t limbs = cnt / JL_LIMB_BITS < x->n ? (size_t)(cnt / JL_LIMB_BITS)
+                                                  : x->n;
+  const unsigned r = cnt % JL_LIMB_BITS;
+  const jl_limb_t *xl = int_limbs(x);
+
+  // Rounding a negative quotient down takes one more if any bit goes.
+  int inexact = 0;
+  if (neg) {
+    for (size_t i = 0; i < limbs && !inexact; i++)
+      inexact = xl[i] != 0;
+    if (limbs < x->n && r != 0)
+      inexact |= (xl[limbs] & (((jl_limb_t)1 << r) - 1)) != 0;
+  }
+
+  const size_t n = x->n - limbs;
+  if (int_reserve(z, n))
+    return 2;
+  jl_limb_t *zl = int_limbs(z);
+  xl = int_limbs(x);
+  if (n > 0 && r != 0 && limbs < x->n)
+    rshift(zl, xl + limbs, n, r);
+  else
+    memmove(zl, xl + limbs, n * sizeof(jl_limb_t));
+  z->n = n;
+  z->neg = neg;
+  int_normalize(z);
+
+  if (!inexact)
+    return 0;
+
+  // -(m >> cnt) - 1.
+  jl_int one;
+  int_init(&one);
+  int_set_u64(&one, 1);
+  const uint8_t rc = int_sub(z, z, &one);
+  int_free(&one);
+  return rc;
+}
+
+/**
+ * @return (uint64_t): The number of set bits in @p x, or UINT64_MAX if @p x
+ * is negative, which has infinitely many in two's complement.
+ */
+uint64_t int_popcount(const jl_int *x) {
+  if (x->neg)
+    return UINT64_MAX;
+  return popcount_n(int_limbs(x), x->n);
+}
+
+/**
+ * @return (int): Bit @p bit of @p x in two's complement.
+ */
+int int_tstbit(const jl_int *x, uint64_t bit) {
+  const jl_limb_t *xl = int_limbs(x);
+  const uint64_t i = bit / JL_LIMB_BITS;
+  const int b = i < x->n ? (int)(xl[i] >> (bit % JL_LIMB_BITS) & 1) : 0;
+  if (!x->neg)
+    return b;
+
+  // -m is m with every bit above its lowest set bit flipped.
+  size_t low = 0;
+  while (xl[low] == 0)
+    low++;
+  const uint64_t tz = (uint64_t)low * JL_LIMB_BITS + ctz_limb(xl[low]);
+  return bit <= tz ? b : !b;
+}
+
+/**
+ * @brief Adds 2^@p bit to the magnitude of @p x if @p add, or takes it away,
+ * which must leave it nonnegative. Only the limb holding the bit, and those a
+ * carry or borrow runs into, are touched; @p x grows only if the sum does.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      2. Memory allocation failed. @p x is unchanged.
+ */
+static uint8_t int_addbit(jl_int *x, uint64_t bit, int add) {
+  const size_t i = bit / JL_LIMB_BITS;
+  const jl_limb_t mask = (jl_limb_t)1 << (bit % JL_LIMB_BITS);
+  const size_t n = x->n;
+  jl_limb_t *xl = int_limbs(x);
+
+  if (!add) {
+    jl_limb_t b = mask;
+    for (size_t j = i; b != 0; j++) {
+      const jl_limb_t t = xl[j];
+      xl[j] = t - b;
+      b = t < b;
+    }
+    int_normalize(x);
+    return 0;
+  }
+
+  // Size the sum before writing, so that a failed allocation leaves x as it
+  // was.
+  size_t need = i < n ? n : i + 1;
+  if (i < n && xl[i] + mask < mask) {
+    size_t j = i + 1;
+    while (j < n && xl[j] == ~(jl_limb_t)0)
+      j++;
+    if (j == n)
+      need = n + 1;
+  }
+  if (int_reserve(x, need))
+    return 2;
+  xl = int_limbs(x);
+  for (size_t j = n; j < need; j++)
+    xl[j] = 0;
+  x->n = need;
+
+  jl_limb_t c = mask;
+  for (size_t j = i; c != 0; j++) {
+    xl[j] += c;
+    c = xl[j] < c;
+  }
+  return 0;
+}
+
+/**
+ * @brief Sets bit @p bit of @p x, in two's complement. This costs O(1) limbs
+ * beyond finding the lowest nonzero limb of a negative @p x, plus any carry;
+ * setting a bit past the top of a negative @p x changes nothing.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x is NULL.
+ *      2. Memory allocation failed. @p x is unchanged.
+ */
+uint8_t int_setbit(jl_int *x, uint64_t bit) {
+  // Error check 1.
+  if (x == NULL)
+    return 1;
+
+  if (int_tstbit(x, bit))
+    return 0;
+  // Setting the bit adds 2^bit to the value of x, so to the magnitude of a
+  // nonnegative x, and takes it from the magnitude of a negative one.
+  return int_addbit(x, bit, !x->neg);
+}
+
+/**
+ * @brief Clears bit @p bit of @p x, in two's complement. Same contract as
+ * int_setbit; clearing a bit past the top of a nonnegative @p x changes
+ * nothing.
+ */
+uint8_t int_clrbit(jl_int *x, uint64_t bit) {
+  // Error check 1.
+  if (x == NULL)
+    return 1;
+
+  if (!int_tstbit(x, bit))
+    return 0;
+  return int_addbit(x, bit, x->neg);
+}
@@ -0,0 +1,89 @@
+#ifndef __JL_BITS_H__
+#define __JL_BITS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "jl_int.h"
+#include "limb.h"
+
+/*
+ * Bit operations. On byte strings they work on the unsigned little-endian
+ * bytes directly, a 64-bit word or a vector register at a time, and the output
+ * may be the same buffer as an input. On jl_int they follow two's complement,
+ * as if negative values had infinitely many leading ones.
+ */
+
+// The AVX2 kernels use compiler intrinsics, so they only exist on x86-64 with
+// GCC or Clang. Define JL_NO_SIMD to leave them out anyway.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) &&       \
+    !defined(JL_NO_SIMD)
+#define JL_HAVE_BITS_SIMD 1
+#else
+#define JL_HAVE_BITS_SIMD 0
+#endif
+
+void set_bits_kernels(unsigned features);
+
+unsigned get_bits_kernels(void);
+
+void and_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n);
+
+void ior_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n);
+
+void xor_n(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y, size_t n);
+
+uint64_t popcount_n(const jl_limb_t *x, size_t n);
+
+uint8_t and_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size);
+
+uint8_t or_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                    uint8_t *flags, size_t x_size, size_t y_size,
+                    size_t z_size);
+
+uint8_t xor_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size);
+
+uint8_t lshift_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                        uint64_t cnt, size_t x_size, size_t z_size);
+
+uint8_t rshift_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                        uint64_t cnt, size_t x_size, size_t z_size);
+
+uint64_t popcount_bstrings(const uint8_t *x, size_t x_size);
+
+uint64_t clz_bstrings(const uint8_t *x, size_t x_size);
+
+uint64_t ctz_bstrings(const uint8_t *x, size_t x_size);
+
+int tstbit_bstrings(const uint8_t *x, size_t x_size, uint64_t bit);
+
+uint8_t setbit_bstrings(uint8_t *x, size_t x_size, uint64_t bit);
+
+uint8_t clrbit_bstrings(uint8_t *x, size_t x_size, uint64_t bit);
+
+size_t int_bit_length(const jl_int *x);
+
+uint8_t int_and(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_or(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_xor(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_com(jl_int *z, const jl_int *x);
+
+uint8_t int_lshift(jl_int *z, const jl_int *x, uint64_t cnt);
+
+uint8_t int_rshift(jl_int *z, const jl_int *x, uint64_t cnt);
+
+uint64_t int_popcount(const jl_int *x);
+
+int int_tstbit(const jl_int *x, uint64_t bit);
+
+uint8_t int_setbit(jl_int *x, uint64_t bit);
+
+uint8_t int_clrbit(jl_int *x, uint64_t bit);
+#endif
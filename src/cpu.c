@@ -0,0 +1,47 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cpu.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#define JL_HAVE_CPUID 1
+#else
+#define JL_HAVE_CPUID 0
+#endif
+
+/**
+ * @brief The extensions this CPU supports, as JL_CPU_* bits. Always 0 off
+ * x86-64, or without a compiler that provides cpuid.h.
+ */
+unsigned cpu_features(void) {
+  unsigned features = 0;
+#if JL_HAVE_CPUID
+  unsigned a, b, c, d;
+
+  // The vector extensions also need the OS to save their registers: leaf 1
+  // ECX bit 27 says XGETBV works, and XCR0 says which state is saved.
+  uint64_t xcr0 = 0;
+  if (__get_cpuid(1, &a, &b, &c, &d) && (c & (1u << 27))) {
+    uint32_t lo, hi;
+    __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    xcr0 = (uint64_t)hi << 32 | lo;
+  }
+  const int avx_state = (xcr0 & 0x06) == 0x06;
+  const int avx512_state = avx_state && (xcr0 & 0xe0) == 0xe0;
+
+  // Leaf 7, subleaf 0: EBX bit 5 is AVX2, bit 8 BMI2, bit 16 AVX-512F and bit
+  // 19 ADX.
+  if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+    if (b & (1u << 8))
+      features |= JL_CPU_BMI2;
+    if (b & (1u << 19))
+      features |= JL_CPU_ADX;
+    if ((b & (1u << 5)) && avx_state)
+      features |= JL_CPU_AVX2;
+    if ((b & (1u << 16)) && avx512_state)
+      features |= JL_CPU_AVX512F;
+  }
+#endif
+  return features;
+}
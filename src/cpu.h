@@ -0,0 +1,14 @@
+#ifndef __JL_CPU_H__
+#define __JL_CPU_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Instruction set extensions the kernels can use, as bits of a feature mask.
+#define JL_CPU_BMI2 0x01 // MULX.
+#define JL_CPU_ADX 0x02  // ADCX and ADOX.
+#define JL_CPU_AVX2 0x04
+#define JL_CPU_AVX512F 0x08
+
+unsigned cpu_features(void);
+#endif
@@ -0,0 +1,210 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csa.h"
+#include "limb.h"
+
+/**
+ * @brief Makes @p a an empty accumulator, holding zero.
+ */
+void csa_init(jl_csa *a) {
+  a->d = NULL;
+  a->n = 0;
+  a->alloc = 0;
+  a->pending = 0;
+}
+
+/**
+ * @brief Releases the storage of @p a and sets it to zero. @p a may be reused
+ * afterwards.
+ */
+void csa_free(jl_csa *a) {
+  free(a->d);
+  csa_init(a);
+}
+
+/**
+ * @brief Sets @p a to zero, keeping its storage.
+ */
+void csa_clear(jl_csa *a) {
+  a->n = 0;
+  a->pending = 0;
+}
+
+// Makes room for an operand of m digits: at least m + 1 digits in use, and a
+// zero digit on top, which only carries reach. New digits are zero.
+static uint8_t csa_reserve(jl_csa *a, size_t m) {
+  if (a->pending >= JL_CSA_HEADROOM)
+    csa_normalize(a);
+
+  size_t n = m + 1;
+  if (n < a->n)
+    n = a->n;
+  if (n == a->n && a->n > 0 && a->d[a->n - 1] != 0)
+    n++;
+  if (n == a->n)
+    return 0;
+
+  if (n > a->alloc) {
+    const size_t alloc = n > 2 * a->alloc ? n : 2 * a->alloc;
+    uint64_t *d = realloc(a->d, alloc * sizeof(uint64_t));
+    if (d == NULL)
+      return 2;
+    a->d = d;
+    a->alloc = alloc;
+  }
+  memset(a->d + a->n, 0, (n - a->n) * sizeof(uint64_t));
+  a->n = n;
+
+  return 0;
+}
+
+/**
+ * @brief Adds the byte string @p x to @p a. The digits of @p x are added into
+ * the words of @p a independently; no carry is propagated.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p a or @p x is NULL.
+ *      2. Memory allocation failed. The sum in @p a is unchanged.
+ *
+ * @param[in,out] a (jl_csa*): The accumulator.
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] x_size (size_t): Size of @p x.
+ */
+uint8_t csa_add_bstring(jl_csa *a, const uint8_t *x, size_t x_size) {
+  // Error check 1.
+  if (a == NULL | x == NULL)
+    return 1;
+
+  const size_t m = (x_size + JL_CSA_DIGIT_BYTES - 1) / JL_CSA_DIGIT_BYTES;
+  if (m == 0)
+    return 0;
+  if (csa_reserve(a, m))
+    return 2;
+
+  // Whole 8-byte loads while they stay inside x, keeping the low 7 bytes.
+  uint64_t *d = a->d;
+  const size_t full = x_size < 8 ? 0 : (x_size - 8) / JL_CSA_DIGIT_BYTES + 1;
+  size_t i = 0;
+  for (; i < full; i++)
+    d[i] += load_limb(x + i * JL_CSA_DIGIT_BYTES) & JL_CSA_DIGIT_MASK;
+  for (; i < m; i++) {
+    const size_t off = i * JL_CSA_DIGIT_BYTES;
+    const size_t left = x_size - off;
+    d[i] += load_limb_partial(x + off, left < JL_CSA_DIGIT_BYTES
+                                           ? left
+                                           : JL_CSA_DIGIT_BYTES);
+  }
+  a->pending++;
+
+  return 0;
+}
+
+/**
+ * @brief Adds the @p n limbs at @p x to @p a. Same contract as
+ * csa_add_bstring.
+ */
+uint8_t csa_add_limbs(jl_csa *a, const jl_limb_t *x, size_t n) {
+  // Error check 1.
+  if (a == NULL | x == NULL)
+    return 1;
+
+  const size_t m = (n * JL_LIMB_BITS + JL_CSA_DIGIT_BITS - 1) /
+                   JL_CSA_DIGIT_BITS;
+  if (m == 0)
+    return 0;
+  if (csa_reserve(a, m))
+    return 2;
+
+  // Digit i is bits 56 i to 56 i + 55, across at most two limbs.
+  uint64_t *d = a->d;
+  for (size_t i = 0; i < m; i++) {
+    const size_t bit = i * JL_CSA_DIGIT_BITS;
+    const size_t j = bit / JL_LIMB_BITS;
+    const unsigned s = bit % JL_LIMB_BITS;
+    uint64_t v = x[j] >> s;
+    if (s > JL_LIMB_BITS - JL_CSA_DIGIT_BITS && j + 1 < n)
+      v |= x[j + 1] << (JL_LIMB_BITS - s);
+    d[i] += v & JL_CSA_DIGIT_MASK;
+  }
+  a->pending++;
+
+  return 0;
+}
+
+/**
+ * @brief Propagates the carries held in the headroom of each word, leaving
+ * every digit below 2^JL_CSA_DIGIT_BITS. One pass over the digits.
+ */
+void csa_normalize(jl_csa *a) {
+  uint64_t *d = a->d;
+  uint64_t carry = 0;
+  for (size_t i = 0; i < a->n; i++) {
+    // A word is at most 256 (2^56 - 1) = 2^64 - 256, and the carry at most
+    // 255, so this can't wrap.
+    const uint64_t v = d[i] + carry;
+    d[i] = v & JL_CSA_DIGIT_MASK;
+    carry = v >> JL_CSA_DIGIT_BITS;
+  }
+  a->pending = 0;
+}
+
+/**
+ * @brief Bytes needed to hold the sum in @p a. 0 for zero. Normalizes @p a.
+ */
+size_t csa_bstring_size(jl_csa *a) {
+  csa_normalize(a);
+
+  size_t i = a->n;
+  while (i > 0 && a->d[i - 1] == 0)
+    i--;
+  if (i == 0)
+    return 0;
+
+  size_t size = (i - 1) * JL_CSA_DIGIT_BYTES;
+  for (uint64_t top = a->d[i - 1]; top != 0; top >>= 8)
+    size++;
+  return size;
+}
+
+/**
+ * @brief Writes the sum in @p a to @p z, zero-padded or truncated to @p
+ * z_size bytes. Normalizes @p a.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p a, @p z, or @p flags is NULL.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the sum doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in,out] a (jl_csa*): The accumulator.
+ * @param[out] z (uint8_t*): The sum, in little-endian order.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] z_size (size_t): Size of @p z.
+ */
+uint8_t csa_get_bstring(jl_csa *a, uint8_t *z, uint8_t *flags,
+                        size_t z_size) {
+  // Error check 1.
+  if (a == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = csa_bstring_size(a) > z_size;
+
+  size_t off = 0;
+  for (size_t i = 0; i < a->n && off < z_size; i++) {
+    const size_t left = z_size - off;
+    store_limb_partial(z + off, a->d[i],
+                       left < JL_CSA_DIGIT_BYTES ? left : JL_CSA_DIGIT_BYTES);
+    off += JL_CSA_DIGIT_BYTES;
+  }
+  if (off < z_size)
+    memset(z + off, 0, z_size - off);
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef __JL_CSA_H__
+#define __JL_CSA_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+/*
+ * An accumulator for summing many unsigned integers. The running sum is kept
+ * as digits of JL_CSA_DIGIT_BITS bits, one per 64-bit word, so each word has 8
+ * bits of headroom: adding an operand adds its digits into the words
+ * independently, with no carry passed between them, and the loop is free to
+ * vectorize. Carries are resolved by csa_normalize, which the additions call
+ * themselves once JL_CSA_HEADROOM of them have gone by without one, and which
+ * reading the sum out calls too.
+ *
+ * A digit is 7 bytes, so the digits of a byte string are found at every
+ * seventh byte and no shifting is needed to split it.
+ */
+
+#define JL_CSA_DIGIT_BYTES 7
+#define JL_CSA_DIGIT_BITS (8 * JL_CSA_DIGIT_BYTES)
+#define JL_CSA_DIGIT_MASK (((uint64_t)1 << JL_CSA_DIGIT_BITS) - 1)
+
+// Additions a normalized sum can take before a word might overflow: 256 digits
+// of at most 2^56 - 1 each sum to less than 2^64.
+#define JL_CSA_HEADROOM 255
+
+/**
+ * @brief A sum in redundant form. Zero-initialized storage is a valid, empty
+ * accumulator, as is one set up by csa_init.
+ */
+typedef struct {
+  uint64_t *d;      // Digits, least significant first, each with headroom.
+  size_t n;         // Digits in use. The top one is zero after csa_normalize.
+  size_t alloc;     // Digits of storage.
+  unsigned pending; // Additions since the last csa_normalize.
+} jl_csa;
+
+void csa_init(jl_csa *a);
+
+void csa_free(jl_csa *a);
+
+void csa_clear(jl_csa *a);
+
+uint8_t csa_add_bstring(jl_csa *a, const uint8_t *x, size_t x_size);
+
+uint8_t csa_add_limbs(jl_csa *a, const jl_limb_t *x, size_t n);
+
+void csa_normalize(jl_csa *a);
+
+size_t csa_bstring_size(jl_csa *a);
+
+uint8_t csa_get_bstring(jl_csa *a, uint8_t *z, uint8_t *flags, size_t z_size);
+#endif
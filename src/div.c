@@ -0,0 +1,483 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "arena.h"
+#include "div.h"
+#include "limb.h"
+#include "perf.h"
+
+// Divisions with at most this many limbs of buffers (operands, results and
+// scratch) are done on the stack.
+#define JL_DIV_STACK_LIMBS 64
+
+static size_t div_dc_threshold = JL_DIV_DC_THRESHOLD;
+
+/**
+ * @brief Sets the quotient size, in limbs, at which divrem_limbs switches from
+ * the schoolbook basecase to divide and conquer. Values below
+ * JL_DIV_DC_MIN_LIMBS are raised to it. The build-time default is
+ * JL_DIV_DC_THRESHOLD.
+ */
+void set_div_dc_threshold(size_t n) {
+  div_dc_threshold = n < JL_DIV_DC_MIN_LIMBS ? JL_DIV_DC_MIN_LIMBS : n;
+}
+
+size_t get_div_dc_threshold(void) { return div_dc_threshold; }
+
+/*
+ * Division by invariant integers (Moller and Granlund, 2011).
+ *
+ * Every quotient limb is estimated from the top limbs of the divisor, which is
+ * shifted so its high bit is set. Instead of a hardware divide per limb, the
+ * estimate comes from a precomputed reciprocal, v = floor((B^2 - 1) / d) - B
+ * for one limb or floor((B^3 - 1) / (d1 B + d0)) - B for two, and a couple of
+ * multiplications.
+ */
+
+// floor((hi B + lo) / d), for hi < d. Only used to set up reciprocals.
+static jl_limb_t udiv_2by1(jl_limb_t hi, jl_limb_t lo, jl_limb_t d) {
+#if defined(__SIZEOF_INT128__)
+  return (jl_limb_t)((((unsigned __int128)hi << 64) | lo) / d);
+#else
+  jl_limb_t q = 0;
+  for (int i = 0; i < JL_LIMB_BITS; i++) {
+    const jl_limb_t top = hi >> (JL_LIMB_BITS - 1);
+    hi = (hi << 1) | (lo >> (JL_LIMB_BITS - 1));
+    lo <<= 1;
+    q <<= 1;
+    if (top || hi >= d) {
+      hi -= d;
+      q |= 1;
+    }
+  }
+  return q;
+#endif
+}
+
+// floor((B^2 - 1) / d) - B, for normalized d.
+static jl_limb_t reciprocal_2by1(jl_limb_t d) { return udiv_2by1(~d, ~0, d); }
+
+// floor((B^3 - 1) / (d1 B + d0)) - B, for normalized d1.
+static jl_limb_t reciprocal_3by2(jl_limb_t d1, jl_limb_t d0) {
+  jl_limb_t v = reciprocal_2by1(d1);
+  jl_limb_t p = d1 * v + d0;
+  if (p < d0) {
+    v--;
+    if (p >= d1) {
+      v--;
+      p -= d1;
+    }
+    p -= d1;
+  }
+
+  jl_limb_t t1;
+  const jl_limb_t t0 = mul_limb(v, d0, &t1);
+  p += t1;
+  if (p < t1) {
+    v--;
+    if (p > d1 || (p == d1 && t0 >= d0))
+      v--;
+  }
+
+  return v;
+}
+
+// Quotient of u1 B + u0 by normalized d, for u1 < d. Sets r to the remainder.
+static inline jl_limb_t div_2by1(jl_limb_t u1, jl_limb_t u0, jl_limb_t d,
+                                 jl_limb_t v, jl_limb_t *r) {
+  jl_limb_t q1, carry;
+  jl_limb_t q0 = mul_limb(v, u1, &q1);
+  q0 = addc_limb(q0, u0, 0, &carry);
+  q1 += u1 + carry + 1;
+
+  jl_limb_t rem = u0 - q1 * d;
+  if (rem > q0) {
+    q1--;
+    rem += d;
+  }
+  if (rem >= d) {
+    q1++;
+    rem -= d;
+  }
+
+  *r = rem;
+  return q1;
+}
+
+// Quotient of u2 B^2 + u1 B + u0 by normalized d1 B + d0, for u2 B + u1 <
+// d1 B + d0.
+static inline jl_limb_t div_3by2(jl_limb_t u2, jl_limb_t u1, jl_limb_t u0,
+                                 jl_limb_t d1, jl_limb_t d0, jl_limb_t v) {
+  jl_limb_t q1, carry, borrow;
+  jl_limb_t q0 = mul_limb(v, u2, &q1);
+  q0 = addc_limb(q0, u1, 0, &carry);
+  q1 += u2 + carry;
+
+  jl_limb_t r1 = u1 - q1 * d1;
+  jl_limb_t t1;
+  const jl_limb_t t0 = mul_limb(d0, q1, &t1);
+  // r = (r1 B + u0) - (t1 B + t0) - (d1 B + d0)
+  jl_limb_t r0 = subb_limb(u0, t0, 0, &borrow);
+  r1 = r1 - t1 - borrow;
+  r0 = subb_limb(r0, d0, 0, &borrow);
+  r1 = r1 - d1 - borrow;
+  q1++;
+
+  if (r1 >= q0) {
+    q1--;
+    r0 = addc_limb(r0, d0, 0, &carry);
+    r1 += d1 + carry;
+  }
+  if (r1 > d1 || (r1 == d1 && r0 >= d0))
+    q1++;
+
+  return q1;
+}
+
+/**
+ * @brief Divides the @p n limbs of @p x by the single limb @p d != 0, storing
+ * the @p n limb quotient in @p q.
+ *
+ * @p q may equal @p x.
+ *
+ * @return (jl_limb_t): The remainder.
+ */
+jl_limb_t divrem_1(jl_limb_t *q, const jl_limb_t *x, size_t n, jl_limb_t d) {
+  if (n == 0)
+    return 0;
+
+  const unsigned cnt = clz_limb(d);
+  d <<= cnt;
+  const jl_limb_t v = reciprocal_2by1(d);
+
+  jl_limb_t r = 0;
+  if (cnt == 0) {
+    for (size_t i = n; i-- > 0;)
+      q[i] = div_2by1(r, x[i], d, v, &r);
+    return r;
+  }
+
+  // Shift x left by cnt on the fly. x[i - 1] is read before q[i - 1] is
+  // written, so q may be x.
+  const unsigned tnc = JL_LIMB_BITS - cnt;
+  r = x[n - 1] >> tnc;
+  for (size_t i = n; i-- > 0;) {
+    const jl_limb_t u0 = (x[i] << cnt) | (i > 0 ? x[i - 1] >> tnc : 0);
+    q[i] = div_2by1(r, u0, d, v, &r);
+  }
+
+  return r >> cnt;
+}
+
+// Schoolbook division (Knuth's Algorithm D). Divides the nn limbs of np by
+// the dn >= 2 limbs of d, normalized, with v = reciprocal_3by2 of its top two
+// limbs. The low nn - dn limbs of the quotient go in q and the top one, 0 or
+// 1, is returned. The remainder is left in np[0, dn).
+static jl_limb_t div_basecase(jl_limb_t *q, jl_limb_t *np, size_t nn,
+                              const jl_limb_t *d, size_t dn, jl_limb_t v) {
+  const jl_limb_t d1 = d[dn - 1];
+  const jl_limb_t d0 = d[dn - 2];
+
+  const jl_limb_t qh = cmp_n(np + nn - dn, d, dn) >= 0;
+  if (qh)
+    sub_n(np + nn - dn, np + nn - dn, d, dn);
+
+  for (size_t i = nn - dn; i-- > 0;) {
+    // The partial remainder is w[0, dn], and w[dn] B + w[dn - 1] <= d1 B + d0.
+    jl_limb_t *w = np + i;
+    const jl_limb_t n2 = w[dn];
+    const jl_limb_t n1 = w[dn - 1];
+
+    jl_limb_t qi;
+    if (n2 == d1 && n1 == d0)
+      qi = ~(jl_limb_t)0;
+    else
+      qi = div_3by2(n2, n1, w[dn - 2], d1, d0, v);
+
+    // qi is at most two too large, so this adds back at most twice.
+    jl_limb_t top = n2 - submul_1(w, d, dn, qi);
+    while (top != 0) {
+      qi--;
+      top += add_n(w, w, d, dn);
+    }
+
+    q[i] = qi;
+  }
+
+  return qh;
+}
+
+// Burnikel-Ziegler. Divides the dn + qn limbs of np by the dn limbs of d,
+// for qn <= dn, with the same contract as div_basecase.
+//
+// For qn == dn, the quotient is found in two halves, each a division of
+// dn + qn / 2 limbs by d. For qn < dn, the top 2 qn limbs of np are divided
+// by the top qn limbs of d, which gives a quotient at most a little too large,
+// and the rest of d is then multiplied out and subtracted to fix it up.
+// Scratch takes dn + mul_limbs_itch(dn, dn) limbs.
+static jl_limb_t div_block(jl_limb_t *q, jl_limb_t *np, const jl_limb_t *d,
+                           size_t dn, size_t qn, jl_limb_t v,
+                           jl_limb_t *scratch) {
+  if (qn < div_dc_threshold)
+    return div_basecase(q, np, dn + qn, d, dn, v);
+
+  if (qn < dn) {
+    // d's top two limbs, and so v, are the same for the truncated divisor.
+    jl_limb_t qh = div_block(q, np + dn - qn, d + dn - qn, qn, qn, v, scratch);
+
+    jl_limb_t *t = scratch;
+    mul_limbs(t, q, qn, d, dn - qn, t + dn);
+    jl_limb_t cy = sub_n(np, np, t, dn);
+    if (qh)
+      cy += sub_n(np + qn, np + qn, d, dn - qn);
+
+    while (cy != 0) {
+      qh -= sub_1(q, q, qn, 1);
+      cy -= add_n(np, np, d, dn);
+    }
+    return qh;
+  }
+
+  const jl_limb_t qh = cmp_n(np + dn, d, dn) >= 0;
+  if (qh)
+    sub_n(np + dn, np + dn, d, dn);
+
+  const size_t lo = qn / 2;
+  const size_t hi = qn - lo;
+  div_block(q + lo, np + lo, d, dn, hi, v, scratch);
+  div_block(q, np, d, dn, lo, v, scratch);
+
+  return qh;
+}
+
+/**
+ * @brief Number of scratch limbs divrem_limbs needs to divide @p n limbs by
+ * @p dn limbs. The bound doesn't depend on the threshold.
+ */
+size_t divrem_limbs_itch(size_t n, size_t dn) {
+  if (dn < 2)
+    return 0;
+
+  return dn + n + 1 + dn + mul_limbs_itch(dn, dn);
+}
+
+/**
+ * @brief Divides the @p n limbs of @p x by the @p dn limbs of @p d, storing the
+ * @p n - @p dn + 1 limb quotient in @p q and the @p dn limb remainder in @p r.
+ *
+ * Requires @p n >= @p dn >= 1 and a nonzero top limb in @p d. Small quotients
+ * use schoolbook division with a 3-by-2 reciprocal; from the threshold (see
+ * set_div_dc_threshold) up, Burnikel-Ziegler recursion reduces the work to a
+ * few multiplications through mul_limbs. @p q and @p r may not overlap @p x,
+ * @p d, @p scratch or each other.
+ *
+ * @param[out] scratch (jl_limb_t*): At least divrem_limbs_itch(@p n, @p dn)
+ * limbs.
+ */
+void divrem_limbs(jl_limb_t *q, jl_limb_t *r, const jl_limb_t *x, size_t n,
+                  const jl_limb_t *d, size_t dn, jl_limb_t *scratch) {
+  if (dn == 1) {
+    r[0] = divrem_1(q, x, n, d[0]);
+    return;
+  }
+
+  // Normalize: shift both so the divisor's top bit is set. The extra limb on
+  // top of np is below the divisor's top limb, so the first quotient limb
+  // needs no special case.
+  const unsigned cnt = clz_limb(d[dn - 1]);
+  jl_limb_t *dd = scratch;
+  jl_limb_t *np = dd + dn;
+  scratch = np + n + 1;
+  if (cnt) {
+    lshift(dd, d, dn, cnt);
+    np[n] = lshift(np, x, n, cnt);
+  } else {
+    memcpy(dd, d, dn * sizeof(jl_limb_t));
+    memcpy(np, x, n * sizeof(jl_limb_t));
+    np[n] = 0;
+  }
+
+  const jl_limb_t v = reciprocal_3by2(dd[dn - 1], dd[dn - 2]);
+
+  // Quotient blocks of dn limbs from the top, the first one possibly short.
+  const size_t qn = n + 1 - dn;
+  size_t b = qn % dn ? qn % dn : dn;
+  for (size_t off = qn - b;; off -= dn, b = dn) {
+    div_block(q + off, np + off, dd, dn, b, v, scratch);
+    if (off == 0)
+      break;
+  }
+
+  if (cnt)
+    rshift(r, np, dn, cnt);
+  else
+    memcpy(r, np, dn * sizeof(jl_limb_t));
+}
+
+// divrem_bstrings without the NULL checks. Temporaries come from arena if it
+// isn't NULL, and from the stack or malloc otherwise.
+static uint8_t divrem_bstrings_nocheck(const uint8_t *x, const uint8_t *d,
+                                       uint8_t *q, uint8_t *r, uint8_t *flags,
+                                       size_t x_size, size_t d_size,
+                                       size_t q_size, size_t r_size,
+                                       jl_arena *arena) {
+  *flags = 0;
+
+  // Leading zero bytes don't count.
+  while (x_size > 0 && x[x_size - 1] == 0)
+    x_size--;
+  while (d_size > 0 && d[d_size - 1] == 0)
+    d_size--;
+
+  // Error check 3.
+  if (d_size == 0)
+    return 3;
+
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t d_n = limbs_for_bytes(d_size);
+
+  if (x_n < d_n) {
+    if (q != NULL)
+      memset(q, 0, q_size);
+    if (r != NULL) {
+      const size_t len = x_size < r_size ? x_size : r_size;
+      memcpy(r, x, len);
+      memset(r + len, 0, r_size - len);
+    }
+    return 0;
+  }
+
+  const size_t q_n = x_n - d_n + 1;
+  const size_t total = x_n + d_n + q_n + d_n + divrem_limbs_itch(x_n, d_n);
+
+  jl_limb_t stack[JL_DIV_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  size_t mark = 0;
+  if (arena != NULL) {
+    mark = arena_mark(arena);
+    buf = arena_alloc(arena, total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  } else if (total > JL_DIV_STACK_LIMBS) {
+    buf = malloc(total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  }
+
+  jl_limb_t *xl = buf;
+  jl_limb_t *dl = xl + x_n;
+  jl_limb_t *ql = dl + d_n;
+  jl_limb_t *rl = ql + q_n;
+  bytes_to_limbs(xl, x_n, x, x_size);
+  bytes_to_limbs(dl, d_n, d, d_size);
+
+  divrem_limbs(ql, rl, xl, x_n, dl, d_n, rl + d_n);
+
+  if (q != NULL) {
+    limbs_to_bytes(q, q_size, ql, q_n);
+    size_t top = q_n;
+    while (top > 0 && ql[top - 1] == 0)
+      top--;
+    // Significant bytes in the quotient.
+    const size_t q_bytes =
+        top == 0 ? 0
+                 : top * JL_LIMB_BYTES - clz_limb(ql[top - 1]) / 8;
+    if (q_bytes > q_size)
+      *flags |= 1;
+  }
+  if (r != NULL)
+    limbs_to_bytes(r, r_size, rl, d_n);
+
+  if (arena != NULL)
+    arena_release(arena, mark);
+  else if (buf != stack)
+    free(buf);
+
+  return 0;
+}
+
+/**
+ * @brief Divides @p x by @p d, and stores the quotient in @p q and the
+ * remainder in @p r.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p d, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p d is zero.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the quotient doesn't fit in @p q_size bytes, in which case
+ *        @p q holds its low @p q_size bytes.
+ *
+ * @param[in] x (uint8_t*): Dividend, little-endian.
+ * @param[in] d (uint8_t*): Divisor, little-endian.
+ * @param[out] q (uint8_t*): Quotient, little-endian, zero-padded to @p q_size
+ * bytes. May be NULL if only the remainder is wanted.
+ * @param[out] r (uint8_t*): Remainder, little-endian, zero-padded to @p
+ * r_size bytes. May be NULL if only the quotient is wanted. The remainder
+ * always fits in @p d_size bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param d_size[in] (size_t): Size of @p d.
+ * @param q_size[in] (size_t): Size of @p q.
+ * @param r_size[in] (size_t): Size of @p r.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t divrem_bstrings(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                        uint8_t *r, uint8_t *flags, size_t x_size,
+                        size_t d_size, size_t q_size, size_t r_size) {
+  // Error check 1.
+  if (x == NULL | d == NULL | flags == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_DIVREM, x_size > d_size ? x_size : d_size);
+  const uint8_t rc = divrem_bstrings_nocheck(x, d, q, r, flags, x_size, d_size,
+                                             q_size, r_size, NULL);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief Bytes of arena divrem_bstrings_arena needs to divide an @p x_size
+ * byte dividend by a @p d_size byte divisor. Exact when neither has leading
+ * zero bytes, and an upper bound otherwise.
+ */
+size_t divrem_bstrings_itch(size_t x_size, size_t d_size) {
+  const size_t x_n = limbs_for_bytes(x_size);
+  const size_t d_n = limbs_for_bytes(d_size);
+  if (d_n == 0 || x_n < d_n)
+    return 0;
+
+  const size_t q_n = x_n - d_n + 1;
+
+  return (x_n + d_n + q_n + d_n + divrem_limbs_itch(x_n, d_n)) *
+         sizeof(jl_limb_t);
+}
+
+/**
+ * @brief divrem_bstrings with every temporary taken from @p arena instead of
+ * the stack or heap. Same contract as divrem_bstrings, except that error code 2
+ * means @p arena has fewer than divrem_bstrings_itch(@p x_size, @p d_size)
+ * bytes free. Everything taken from @p arena is given back before returning.
+ */
+uint8_t divrem_bstrings_arena(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                              uint8_t *r, uint8_t *flags, size_t x_size,
+                              size_t d_size, size_t q_size, size_t r_size,
+                              jl_arena *arena) {
+  // Error check 1.
+  if (x == NULL | d == NULL | flags == NULL | arena == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_DIVREM, x_size > d_size ? x_size : d_size);
+  const uint8_t rc = divrem_bstrings_nocheck(x, d, q, r, flags, x_size, d_size,
+                                             q_size, r_size, arena);
+  JL_PERF_END();
+
+  return rc;
+}
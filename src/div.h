@@ -0,0 +1,41 @@
+#ifndef __JL_DIV_H__
+#define __JL_DIV_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "limb.h"
+
+// Quotient size, in limbs, at which division switches from the schoolbook
+// basecase to Burnikel-Ziegler recursion. Can also be changed at runtime.
+#ifndef JL_DIV_DC_THRESHOLD
+#define JL_DIV_DC_THRESHOLD 40
+#endif
+
+// The recursion never splits quotients smaller than this, whatever the
+// threshold is set to.
+#define JL_DIV_DC_MIN_LIMBS 4
+
+uint8_t divrem_bstrings(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                        uint8_t *r, uint8_t *flags, size_t x_size,
+                        size_t d_size, size_t q_size, size_t r_size);
+
+size_t divrem_bstrings_itch(size_t x_size, size_t d_size);
+
+uint8_t divrem_bstrings_arena(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                              uint8_t *r, uint8_t *flags, size_t x_size,
+                              size_t d_size, size_t q_size, size_t r_size,
+                              jl_arena *arena);
+
+jl_limb_t divrem_1(jl_limb_t *q, const jl_limb_t *x, size_t n, jl_limb_t d);
+
+void set_div_dc_threshold(size_t n);
+
+size_t get_div_dc_threshold(void);
+
+size_t divrem_limbs_itch(size_t n, size_t dn);
+
+void divrem_limbs(jl_limb_t *q, jl_limb_t *r, const jl_limb_t *x, size_t n,
+                  const jl_limb_t *d, size_t dn, jl_limb_t *scratch);
+#endif
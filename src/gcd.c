@@ -0,0 +1,652 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "bits.h"
+#include "gcd.h"
+#include "jl_int.h"
+#include "limb.h"
+
+/*
+ * The gcd loop keeps u >= v and, for the extended gcd, the cofactors su and sv
+ * of the first operand: u = su x + ... and v = sv x + ... (mod y). Each round
+ * takes one of three steps, the first that applies:
+ *
+ *  - Half-gcd, for operands of at least get_gcd_hgcd_threshold limbs and of
+ *    about the same size: hgcd reduces (u, v) to about half their size and
+ *    returns the matrix that did it, whose inverse updates the cofactors.
+ *  - Lehmer: the Euclid quotients that the top 62 bits of u and v fix (Knuth,
+ *    Algorithm L) are collected as a matrix of single limbs, and applied to
+ *    u, v and the cofactors in one pass each.
+ *  - A plain division step, when the top bits don't fix even one quotient.
+ *
+ * hgcd follows Möller, "On Schönhage's algorithm and subquadratic integer gcd
+ * computation" (2008). It works on operands of n limbs with s = n / 2 + 1: it
+ * reduces (a, b) while both stay at least B^s, and stops once |a - b| < B^s.
+ * The top halves are reduced first by recursion, and the matrix found is
+ * applied to the whole operands. Applying it is checked, and a matrix that
+ * would leave the bounds is dropped in favour of single steps, so every
+ * reduction is exact whatever the recursion returns.
+ */
+
+static size_t gcd_hgcd_threshold = JL_GCD_HGCD_THRESHOLD;
+
+/**
+ * @brief Sets the operand size, in limbs, from which gcd uses half-gcd
+ * recursion. Never below JL_GCD_HGCD_MIN_LIMBS. The build-time default is
+ * JL_GCD_HGCD_THRESHOLD.
+ */
+void set_gcd_hgcd_threshold(size_t n) {
+  gcd_hgcd_threshold = n < JL_GCD_HGCD_MIN_LIMBS ? JL_GCD_HGCD_MIN_LIMBS : n;
+}
+
+size_t get_gcd_hgcd_threshold(void) { return gcd_hgcd_threshold; }
+
+// A 2 x 2 matrix of nonnegative integers, m[0] m[1] over m[2] m[3], whose
+// determinant det is 1 or -1. (a, b) before a reduction is M (a, b) after it.
+typedef struct {
+  jl_int m[4];
+  int det;
+} hgcd_matrix;
+
+// Temporaries shared by everything below, so the loops don't allocate once
+// they have grown. rc collects the error code of every jl_int call.
+typedef struct {
+  jl_int t[4];
+  uint8_t rc;
+} gcd_tmp;
+
+static void matrix_init(hgcd_matrix *M) {
+  for (int i = 0; i < 4; i++)
+    int_init(&M->m[i]);
+  int_set_u64(&M->m[0], 1);
+  int_set_u64(&M->m[3], 1);
+  M->det = 1;
+}
+
+static void matrix_free(hgcd_matrix *M) {
+  for (int i = 0; i < 4; i++)
+    int_free(&M->m[i]);
+}
+
+// M = M N.
+static void matrix_mul(hgcd_matrix *M, const hgcd_matrix *N, gcd_tmp *tmp) {
+  jl_int *t = &tmp->t[0], *u = &tmp->t[1], *v = &tmp->t[2];
+  for (int r = 0; r < 4; r += 2) {
+    jl_int *a = &M->m[r], *b = &M->m[r + 1];
+    tmp->rc |= int_mul(t, a, &N->m[0]);
+    tmp->rc |= int_mul(v, b, &N->m[2]);
+    tmp->rc |= int_add(t, t, v);
+    tmp->rc |= int_mul(u, a, &N->m[1]);
+    tmp->rc |= int_mul(v, b, &N->m[3]);
+    tmp->rc |= int_add(u, u, v);
+    int_swap(a, t);
+    int_swap(b, u);
+  }
+  M->det *= N->det;
+}
+
+// (x, y) = det (m[3] x - m[1] y, m[0] y - m[2] x), the inverse of M applied
+// to (x, y), into (zx, zy). Neither output may be an input.
+static void matrix_apply_inverse(jl_int *zx, jl_int *zy, const hgcd_matrix *M,
+                                 const jl_int *x, const jl_int *y,
+                                 gcd_tmp *tmp) {
+  jl_int *t = &tmp->t[3];
+  tmp->rc |= int_mul(zx, &M->m[3], x);
+  tmp->rc |= int_mul(t, &M->m[1], y);
+  tmp->rc |= int_sub(zx, zx, t);
+  tmp->rc |= int_mul(zy, &M->m[0], y);
+  tmp->rc |= int_mul(t, &M->m[2], x);
+  tmp->rc |= int_sub(zy, zy, t);
+  if (M->det < 0) {
+    tmp->rc |= int_neg(zx, zx);
+    tmp->rc |= int_neg(zy, zy);
+  }
+}
+
+// The low 64 bits of x >> shift.
+static uint64_t bits_at(const jl_int *x, size_t shift) {
+  const jl_limb_t *xl = int_limbs(x);
+  const size_t i = shift / JL_LIMB_BITS;
+  const unsigned r = shift % JL_LIMB_BITS;
+  if (i >= x->n)
+    return 0;
+  uint64_t v = xl[i] >> r;
+  if (r != 0 && i + 1 < x->n)
+    v |= xl[i + 1] << (JL_LIMB_BITS - r);
+  return v;
+}
+
+// Knuth's Algorithm L on the top 62 bits of u >= v: the run of Euclid steps
+// the top bits alone decide, as c with (u', v') = (c[0] u + c[1] v, c[2] u +
+// c[3] v). Returns the number of steps, 0 if not even the first is certain.
+static int lehmer_matrix(const jl_int *u, const jl_int *v, int64_t c[4]) {
+  const size_t bits = int_bit_length(u);
+  const size_t shift = bits > 62 ? bits - 62 : 0;
+  int64_t uh = (int64_t)bits_at(u, shift), vh = (int64_t)bits_at(v, shift);
+  int64_t a = 1, b = 0, cc = 0, d = 1;
+  int steps = 0;
+  while (vh + cc > 0 && vh + d > 0) {
+    const int64_t q = (uh + a) / (vh + cc);
+    if (q != (uh + b) / (vh + d))
+      break;
+    int64_t t = a - q * cc;
+    a = cc;
+    cc = t;
+    t = b - q * d;
+    b = d;
+    d = t;
+    t = uh - q * vh;
+    uh = vh;
+    vh = t;
+    steps++;
+  }
+  c[0] = a;
+  c[1] = b;
+  c[2] = cc;
+  c[3] = d;
+  return steps;
+}
+
+// z = a x + b y, for a and b of opposite signs (or one zero), x >= y >= 0,
+// and a result known to be nonnegative. z may not be x or y.
+static void lin_comb(jl_int *z, const jl_int *x, const jl_int *y, int64_t a,
+                     int64_t b, gcd_tmp *tmp) {
+  const size_t n = x->n;
+  if (int_reserve(z, n + 1)) {
+    tmp->rc |= 2;
+    return;
+  }
+
+  jl_limb_t *zl = int_limbs(z);
+  const jl_limb_t *xl = int_limbs(x);
+  const jl_limb_t *yl = int_limbs(y);
+  if (a >= 0 && b <= 0) {
+    zl[n] = mul_1(zl, xl, n, (jl_limb_t)a);
+    const jl_limb_t borrow = submul_1(zl, yl, y->n, -(jl_limb_t)b);
+    sub_1(zl + y->n, zl + y->n, n + 1 - y->n, borrow);
+  } else {
+    memset(zl, 0, (n + 1) * sizeof(jl_limb_t));
+    zl[y->n] = mul_1(zl, yl, y->n, (jl_limb_t)b);
+    zl[n] -= submul_1(zl, xl, n, -(jl_limb_t)a);
+  }
+  z->n = n + 1;
+  z->neg = 0;
+  int_normalize(z);
+}
+
+// z = a x + b y on signed cofactors, for single-limb a and b. z may not be x
+// or y.
+static void small_comb(jl_int *z, const jl_int *x, const jl_int *y, int64_t a,
+                       int64_t b, gcd_tmp *tmp) {
+  jl_int *ta = &tmp->t[2], *tb = &tmp->t[3];
+  int_set_i64(ta, a);
+  int_set_i64(tb, b);
+  tmp->rc |= int_mul(z, x, ta);
+  tmp->rc |= int_mul(tb, y, tb);
+  tmp->rc |= int_add(z, z, tb);
+}
+
+// One step of Möller's reduction. If |a - b| >= B^s, the larger of a and b
+// is reduced modulo the smaller, leaving it at least B^s by keeping one more
+// multiple if needed, and M takes the quotient. Returns 0 without changing
+// anything if |a - b| < B^s, in which case (a, b) are fully reduced.
+static int hgcd_step(jl_int *a, jl_int *b, size_t s, hgcd_matrix *M,
+                     gcd_tmp *tmp) {
+  jl_int *q = &tmp->t[0], *r = &tmp->t[1];
+  tmp->rc |= int_sub(q, a, b);
+  if (q->n <= s || tmp->rc)
+    return 0;
+
+  const int swap = q->neg;
+  jl_int *big = swap ? b : a;
+  jl_int *small = swap ? a : b;
+  tmp->rc |= int_divrem(q, r, big, small);
+  if (r->n <= s) {
+    tmp->rc |= int_add(r, r, small);
+    int_set_u64(&tmp->t[2], 1);
+    tmp->rc |= int_sub(q, q, &tmp->t[2]);
+  }
+  int_swap(big, r);
+
+  // a = a' + q b' is M [[1, q], [0, 1]], and b = b' + q a' the transpose.
+  jl_int *p = &tmp->t[1];
+  const int from = swap ? 1 : 0;
+  for (int i = 0; i < 4; i += 2) {
+    tmp->rc |= int_mul(p, &M->m[i + from], q);
+    tmp->rc |= int_add(&M->m[i + 1 - from], &M->m[i + 1 - from], p);
+  }
+  return 1;
+}
+
+// A Lehmer run on (a, b) inside hgcd: taken only if both results stay at
+// least B^s. Returns 1 if it was taken.
+static int hgcd_lehmer_step(jl_int *a, jl_int *b, size_t s, hgcd_matrix *M,
+                            gcd_tmp *tmp) {
+  const int swap = int_cmp(a, b) < 0;
+  jl_int *u = swap ? b : a;
+  jl_int *v = swap ? a : b;
+  int64_t c[4];
+  const int steps = lehmer_matrix(u, v, c);
+  if (steps == 0)
+    return 0;
+
+  jl_int *x = &tmp->t[0], *y = &tmp->t[1];
+  lin_comb(x, u, v, c[0], c[1], tmp);
+  lin_comb(y, u, v, c[2], c[3], tmp);
+  if (x->n <= s || y->n <= s || tmp->rc)
+    return 0;
+  int_swap(u, x);
+  int_swap(v, y);
+
+  // (u, v) = L (u', v') with L = [[|d|, |b|], [|c|, |a|]], the inverse of c,
+  // transposed across the diagonal if u is b.
+  hgcd_matrix L;
+  matrix_init(&L);
+  const int64_t l[4] = {c[3], c[1], c[2], c[0]};
+  for (int i = 0; i < 4; i++) {
+    const int j = swap ? 3 - i : i;
+    int_set_u64(&L.m[j], (uint64_t)(l[i] < 0 ? -l[i] : l[i]));
+  }
+  L.det = steps % 2 ? -1 : 1;
+  matrix_mul(M, &L, tmp);
+  matrix_free(&L);
+  return 1;
+}
+
+static int hgcd(jl_int *a, jl_int *b, hgcd_matrix *M, gcd_tmp *tmp);
+
+// Runs hgcd on the limbs of a and b from p up, and applies the matrix it
+// finds to the whole of a and b if they stay at least B^s. Returns 1 if it
+// did.
+static int hgcd_reduce(jl_int *a, jl_int *b, size_t p, size_t s,
+                       hgcd_matrix *M, gcd_tmp *tmp) {
+  jl_int ah, bh, x, y;
+  int_init(&ah);
+  int_init(&bh);
+  int_init(&x);
+  int_init(&y);
+  const jl_int *src[2] = {a, b};
+  jl_int *dst[2] = {&ah, &bh};
+  for (int i = 0; i < 2; i++) {
+    const size_t n = src[i]->n > p ? src[i]->n - p : 0;
+    if (int_reserve(dst[i], n)) {
+      tmp->rc |= 2;
+    } else {
+      memcpy(int_limbs(dst[i]), int_limbs(src[i]) + p, n * sizeof(jl_limb_t));
+      dst[i]->n = n;
+    }
+  }
+
+  hgcd_matrix M1;
+  matrix_init(&M1);
+  int ok = !tmp->rc && hgcd(&ah, &bh, &M1, tmp);
+  if (ok) {
+    matrix_apply_inverse(&x, &y, &M1, a, b, tmp);
+    ok = !tmp->rc && !x.neg && !y.neg && x.n > s && y.n > s;
+  }
+  if (ok) {
+    int_swap(a, &x);
+    int_swap(b, &y);
+    matrix_mul(M, &M1, tmp);
+  }
+
+  matrix_free(&M1);
+  int_free(&ah);
+  int_free(&bh);
+  int_free(&x);
+  int_free(&y);
+  return ok;
+}
+
+// Reduces (a, b), both positive, in place as described at the top, and
+// multiplies M on the right by the matrix that did it. Returns 1 if anything
+// was reduced.
+static int hgcd(jl_int *a, jl_int *b, hgcd_matrix *M, gcd_tmp *tmp) {
+  const size_t n = a->n > b->n ? a->n : b->n;
+  const size_t s = n / 2 + 1;
+  if (a->n <= s || b->n <= s)
+    return 0;
+
+  int success = 0;
+  size_t threshold = gcd_hgcd_threshold;
+  if (threshold < JL_GCD_HGCD_MIN_LIMBS)
+    threshold = JL_GCD_HGCD_MIN_LIMBS;
+
+  if (n >= threshold) {
+    // The top half first, which takes the operands down to about 3 n / 4
+    // limbs; single steps to make sure of it; then the top of what's left,
+    // cut so its own s lands on ours.
+    success |= hgcd_reduce(a, b, n / 2, s, M, tmp);
+    const size_t n2 = 3 * n / 4 + 1;
+    while ((a->n > b->n ? a->n : b->n) > n2) {
+      if (!hgcd_step(a, b, s, M, tmp))
+        return success;
+      success = 1;
+    }
+    const size_t nn = a->n > b->n ? a->n : b->n;
+    if (nn > s + 2)
+      success |= hgcd_reduce(a, b, 2 * s - nn + 1, s, M, tmp);
+  }
+
+  while (!tmp->rc) {
+    if (!hgcd_lehmer_step(a, b, s, M, tmp) && !hgcd_step(a, b, s, M, tmp))
+      break;
+    success = 1;
+  }
+  return success;
+}
+
+// gcd(u, v) into u, for u, v >= 0, with su and sv the cofactors of u and v
+// updated along the way if ext is set. v ends zero.
+static uint8_t gcd_core(jl_int *u, jl_int *v, jl_int *su, jl_int *sv,
+                        int ext) {
+  gcd_tmp tmp;
+  for (int i = 0; i < 4; i++)
+    int_init(&tmp.t[i]);
+  tmp.rc = 0;
+  jl_int x, y;
+  int_init(&x);
+  int_init(&y);
+
+  size_t threshold = gcd_hgcd_threshold;
+  if (threshold < JL_GCD_HGCD_MIN_LIMBS)
+    threshold = JL_GCD_HGCD_MIN_LIMBS;
+
+  while (!tmp.rc) {
+    if (int_cmp(u, v) < 0) {
+      int_swap(u, v);
+      if (ext)
+        int_swap(su, sv);
+    }
+    if (v->n == 0)
+      break;
+
+    if (v->n >= threshold && v->n > u->n / 2 + 1) {
+      hgcd_matrix M;
+      matrix_init(&M);
+      const int reduced = hgcd(u, v, &M, &tmp);
+      if (reduced && ext) {
+        matrix_apply_inverse(&x, &y, &M, su, sv, &tmp);
+        int_swap(su, &x);
+        int_swap(sv, &y);
+      }
+      matrix_free(&M);
+      if (reduced)
+        continue;
+    }
+
+    int64_t c[4];
+    if (v->n >= 2 && lehmer_matrix(u, v, c)) {
+      lin_comb(&x, u, v, c[0], c[1], &tmp);
+      lin_comb(&y, u, v, c[2], c[3], &tmp);
+      int_swap(u, &x);
+      int_swap(v, &y);
+      if (ext) {
+        small_comb(&x, su, sv, c[0], c[1], &tmp);
+        small_comb(&y, su, sv, c[2], c[3], &tmp);
+        int_swap(su, &x);
+        int_swap(sv, &y);
+      }
+      continue;
+    }
+
+    // (u, v) = (v, u mod v), and (su, sv) = (sv, su - q sv).
+    tmp.rc |= int_divrem(&x, &y, u, v);
+    int_swap(u, v);
+    int_swap(v, &y);
+    if (ext) {
+      tmp.rc |= int_mul(&x, &x, sv);
+      tmp.rc |= int_sub(su, su, &x);
+      int_swap(su, sv);
+    }
+  }
+
+  const uint8_t rc = tmp.rc ? 2 : 0;
+  for (int i = 0; i < 4; i++)
+    int_free(&tmp.t[i]);
+  int_free(&x);
+  int_free(&y);
+  return rc;
+}
+
+/**
+ * @brief Stores the greatest common divisor of @p x and @p y in @p g, which is
+ * never negative, and zero only if both are. Any of the three may be the same
+ * jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p g, @p x, or @p y is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_gcd(jl_int *g, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (g == NULL | x == NULL | y == NULL)
+    return 1;
+
+  return int_gcdext(g, NULL, NULL, x, y);
+}
+
+/**
+ * @brief Extended gcd: @p g = gcd(@p x, @p y) = @p s @p x + @p t @p y. The
+ * cofactors are the ones of least size: |@p s| <= |@p y| / (2 @p g) and
+ * |@p t| <= |@p x| / (2 @p g) when neither operand divides the other; if @p y
+ * divides @p x, @p s is 0 (1 or -1 if @p y is 0), and likewise for @p t.
+ *
+ * @p s and @p t may be NULL if not wanted. All five may be the same or
+ * different jl_ints, except that the outputs must be distinct.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p g, @p x, or @p y is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_gcdext(jl_int *g, jl_int *s, jl_int *t, const jl_int *x,
+                   const jl_int *y) {
+  // Error check 1.
+  if (g == NULL | x == NULL | y == NULL)
+    return 1;
+
+  const int ext = s != NULL || t != NULL;
+  jl_int u, v, su, sv, w;
+  int_init(&u);
+  int_init(&v);
+  int_init(&su);
+  int_init(&sv);
+  int_init(&w);
+
+  uint8_t rc = int_abs(&u, x) | int_abs(&v, y);
+  int_set_u64(&su, 1);
+  if (rc == 0)
+    rc = gcd_core(&u, &v, &su, &sv, ext);
+
+  if (rc == 0 && ext) {
+    // u = su |x| (mod |y|); fold the sign of x in, then take the least s in
+    // absolute value, and t from it.
+    if (x->neg)
+      rc |= int_neg(&su, &su);
+    if (u.n == 0) {
+      su.n = 0;
+      su.neg = 0;
+      sv.n = 0;
+      sv.neg = 0;
+    } else if (y->n == 0) {
+      int_set_i64(&su, x->neg ? -1 : 1);
+      sv.n = 0;
+      sv.neg = 0;
+    } else {
+      // w = |y| / g; su in (-w / 2, w / 2].
+      rc |= int_abs(&v, y);
+      rc |= int_divrem(&w, NULL, &v, &u);
+      rc |= int_divrem(NULL, &su, &su, &w);
+      if (su.neg)
+        rc |= int_add(&su, &su, &w);
+      rc |= int_add(&v, &su, &su);
+      if (int_cmp(&v, &w) > 0)
+        rc |= int_sub(&su, &su, &w);
+
+      // t = (g - s x) / y, exactly.
+      rc |= int_mul(&v, &su, x);
+      rc |= int_sub(&v, &u, &v);
+      rc |= int_divrem(&sv, NULL, &v, y);
+    }
+  }
+
+  if (rc == 0) {
+    int_swap(g, &u);
+    if (s != NULL)
+      int_swap(s, &su);
+    if (t != NULL)
+      int_swap(t, &sv);
+  }
+
+  int_free(&u);
+  int_free(&v);
+  int_free(&su);
+  int_free(&sv);
+  int_free(&w);
+  return rc ? 2 : 0;
+}
+
+/**
+ * @brief Stores the inverse of @p x modulo @p m in @p z, in [0, |@p m|).
+ * Any of the three may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z, @p x, or @p m is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p m is zero, or @p x has no inverse modulo @p m. @p z is unchanged.
+ */
+uint8_t int_invert(jl_int *z, const jl_int *x, const jl_int *m) {
+  // Error check 1.
+  if (z == NULL | x == NULL | m == NULL)
+    return 1;
+
+  // Error check 3.
+  if (m->n == 0)
+    return 3;
+
+  jl_int g, s, am;
+  int_init(&g);
+  int_init(&s);
+  int_init(&am);
+
+  uint8_t rc = int_gcdext(&g, &s, NULL, x, m);
+  if (rc == 0 && !(g.n == 1 && int_limbs(&g)[0] == 1))
+    rc = 3;
+  if (rc == 0) {
+    rc |= int_abs(&am, m);
+    if (s.neg)
+      rc |= int_add(&s, &s, &am);
+    // |s| <= |m| / 2, so one addition is enough, except modulo 1.
+    if (int_cmp(&s, &am) >= 0)
+      rc |= int_sub(&s, &s, &am);
+    if (rc == 0)
+      int_swap(z, &s);
+  }
+
+  int_free(&g);
+  int_free(&s);
+  int_free(&am);
+  return rc;
+}
+
+/**
+ * @brief Stores the greatest common divisor of @p x and @p y in @p z.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the gcd doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): The gcd, in little-endian order.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] y_size (size_t): Size of @p y.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t gcd_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  jl_int a, b;
+  int_init(&a);
+  int_init(&b);
+  uint8_t rc = int_set_bstring(&a, x, 0, x_size) |
+               int_set_bstring(&b, y, 0, y_size);
+  if (rc == 0)
+    rc = int_gcd(&a, &a, &b);
+  if (rc == 0) {
+    int_get_bstring(&a, z, flags, z_size);
+    *flags &= 1;
+  }
+
+  int_free(&a);
+  int_free(&b);
+  return rc;
+}
+
+/**
+ * @brief Stores the inverse of @p x modulo @p m in @p z, in [0, @p m).
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p m, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p m is zero, or @p x has no inverse modulo @p m.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the inverse doesn't fit in @p z_size bytes, in which case
+ *        @p z holds its low @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] m (uint8_t*): The modulus, little-endian.
+ * @param[out] z (uint8_t*): The inverse, in little-endian order.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] m_size (size_t): Size of @p m.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t invert_bstrings(const uint8_t *x, const uint8_t *m, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t m_size,
+                        size_t z_size) {
+  // Error check 1.
+  if (x == NULL | m == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  jl_int a, b;
+  int_init(&a);
+  int_init(&b);
+  uint8_t rc = int_set_bstring(&a, x, 0, x_size) |
+               int_set_bstring(&b, m, 0, m_size);
+  if (rc == 0)
+    rc = int_invert(&a, &a, &b);
+  if (rc == 0) {
+    int_get_bstring(&a, z, flags, z_size);
+    *flags &= 1;
+  }
+
+  int_free(&a);
+  int_free(&b);
+  return rc;
+}
@@ -0,0 +1,39 @@
+#ifndef __JL_GCD_H__
+#define __JL_GCD_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "jl_int.h"
+#include "limb.h"
+
+// Operand size, in limbs, from which gcd switches from Lehmer's algorithm,
+// which takes O(n^2), to half-gcd recursion, which takes O(M(n) log n) through
+// mul_limbs. The same size ends the recursion. Can also be changed at runtime.
+#ifndef JL_GCD_HGCD_THRESHOLD
+#define JL_GCD_HGCD_THRESHOLD 300
+#endif
+
+// The recursion never works on operands smaller than this, whatever the
+// threshold is set to.
+#define JL_GCD_HGCD_MIN_LIMBS 8
+
+void set_gcd_hgcd_threshold(size_t n);
+
+size_t get_gcd_hgcd_threshold(void);
+
+uint8_t int_gcd(jl_int *g, const jl_int *x, const jl_int *y);
+
+uint8_t int_gcdext(jl_int *g, jl_int *s, jl_int *t, const jl_int *x,
+                   const jl_int *y);
+
+uint8_t int_invert(jl_int *z, const jl_int *x, const jl_int *m);
+
+uint8_t gcd_bstrings(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                     uint8_t *flags, size_t x_size, size_t y_size,
+                     size_t z_size);
+
+uint8_t invert_bstrings(const uint8_t *x, const uint8_t *m, uint8_t *z,
+                        uint8_t *flags, size_t x_size, size_t m_size,
+                        size_t z_size);
+#endif
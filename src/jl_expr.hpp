@@ -0,0 +1,271 @@
+#ifndef __JL_EXPR_HPP__
+#define __JL_EXPR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "add_sub_mul.h"
+#include "jl_int.h"
+}
+#include "jl_uint.hpp"
+
+/*
+ * Lazy sums of products for C++14 and later, header only. An expression such
+ * as
+ *
+ *   jl::accumulator acc;
+ *   acc = jl::ref(a) * jl::ref(b) - jl::ref(c) * jl::ref(d) + jl::ref(e);
+ *
+ * builds a small tree of references and is evaluated term by term into the
+ * one buffer of the accumulator: each product goes in through addmul_limbs or
+ * submul_limbs, so no full-size temporary is made for any term or partial
+ * sum. Operands are jl_int, jl::uint<Bits> or raw limbs, and are only
+ * referenced, so they must outlive the expression.
+ *
+ * The accumulator holds its value in two's complement, one limb wider than
+ * it needs, and widens itself before each term; reading the result out gives
+ * the sign and magnitude that int_get_bstring would.
+ */
+
+namespace jl {
+
+/**
+ * @brief A signed operand by reference: @p n limbs at @p p in increasing
+ * significance, negated if @p neg.
+ */
+struct limbs_view {
+  const jl_limb_t *p;
+  std::size_t n;
+  bool neg;
+
+  limbs_view operator-() const { return limbs_view{p, n, !neg}; }
+};
+
+inline limbs_view ref(const jl_limb_t *p, std::size_t n, bool neg = false) {
+  return limbs_view{p, n, neg};
+}
+
+inline limbs_view ref(const jl_int &x) {
+  return limbs_view{int_limbs(&x), x.n, x.neg != 0};
+}
+
+template <std::size_t Bits> limbs_view ref(const uint<Bits> &x) {
+  return limbs_view{x.limb, uint<Bits>::limbs, false};
+}
+
+/**
+ * @brief The product of two operands, negated if @p neg.
+ */
+struct product_term {
+  limbs_view x, y;
+  bool neg;
+
+  product_term operator-() const { return product_term{x, y, !neg}; }
+};
+
+/**
+ * @brief l + r. Subtraction is kept as the sum with a negated r.
+ */
+template <class L, class R> struct sum_expr {
+  L l;
+  R r;
+
+  typedef decltype(-std::declval<L>()) neg_l;
+  typedef decltype(-std::declval<R>()) neg_r;
+
+  sum_expr<neg_l, neg_r> operator-() const {
+    return sum_expr<neg_l, neg_r>{-l, -r};
+  }
+};
+
+namespace detail {
+
+template <class T> struct is_expr : std::false_type {};
+template <> struct is_expr<limbs_view> : std::true_type {};
+template <> struct is_expr<product_term> : std::true_type {};
+template <class L, class R>
+struct is_expr<sum_expr<L, R>> : std::true_type {};
+
+// sum_expr<L, R>, for expression types only, so that the operators below
+// leave every other + and - alone.
+template <class L, class R>
+using sum_of = typename std::enable_if<is_expr<L>::value && is_expr<R>::value,
+                                       sum_expr<L, R>>::type;
+
+} // namespace detail
+
+inline product_term operator*(const limbs_view &x, const limbs_view &y) {
+  return product_term{x, y, x.neg != y.neg};
+}
+
+template <class L, class R>
+detail::sum_of<L, R> operator+(const L &l, const R &r) {
+  return detail::sum_of<L, R>{l, r};
+}
+
+template <class L, class R>
+auto operator-(const L &l, const R &r)
+    -> detail::sum_of<L, decltype(-std::declval<R>())> {
+  return detail::sum_of<L, decltype(-r)>{l, -r};
+}
+
+/**
+ * @brief A signed running sum that expressions are added into in place.
+ */
+class accumulator {
+public:
+  accumulator() : w_(1, 0) {}
+
+  template <class E> accumulator &operator=(const E &e) {
+    w_.assign(1, 0);
+    apply(e);
+    return *this;
+  }
+
+  template <class E> accumulator &operator+=(const E &e) {
+    apply(e);
+    return *this;
+  }
+
+  template <class E> accumulator &operator-=(const E &e) {
+    apply(-e);
+    return *this;
+  }
+
+  bool negative() const { return w_.back() != 0; }
+
+  /**
+   * @brief Bytes needed to hold the magnitude. 0 for zero.
+   */
+  std::size_t bstring_size() const {
+    std::vector<jl_limb_t> m = magnitude();
+    std::size_t n = m.size();
+    while (n > 0 && m[n - 1] == 0)
+      n--;
+    if (n == 0)
+      return 0;
+    std::size_t size = n * JL_LIMB_BYTES;
+    for (jl_limb_t top = m[n - 1]; (top >> (JL_LIMB_BITS - 8)) == 0;
+         top <<= 8)
+      size--;
+    return size;
+  }
+
+  /**
+   * @brief Writes the magnitude to @p z, with the error codes and flags of
+   * int_get_bstring.
+   */
+  uint8_t get_bstring(uint8_t *z, uint8_t *flags, std::size_t z_size) const {
+    // Error check 1.
+    if (z == NULL || flags == NULL)
+      return 1;
+
+    std::vector<jl_limb_t> m = magnitude();
+    limbs_to_bytes(z, z_size, m.data(), m.size());
+    *flags = (bstring_size() > z_size) | (uint8_t)negative() << 1;
+    return 0;
+  }
+
+  /**
+   * @brief Copies the value into @p z. Error codes as for int_set.
+   */
+  uint8_t get(jl_int &z) const {
+    std::vector<jl_limb_t> m = magnitude();
+    std::size_t n = m.size();
+    while (n > 0 && m[n - 1] == 0)
+      n--;
+    if (int_reserve(&z, n))
+      return 2;
+
+    std::memcpy(int_limbs(&z), m.data(), n * sizeof(jl_limb_t));
+    z.n = n;
+    z.neg = n > 0 && negative();
+    return 0;
+  }
+
+  /**
+   * @brief The value modulo 2^Bits, as jl::uint arithmetic would leave it.
+   */
+  template <std::size_t Bits> uint<Bits> get_uint() const {
+    uint<Bits> z;
+    for (std::size_t i = 0; i < uint<Bits>::limbs; i++)
+      z.limb[i] = i < w_.size() ? w_[i] : w_.back();
+    return z;
+  }
+
+private:
+  // Two's complement, in increasing significance. The top limb is always all
+  // zeros or all ones, the sign.
+  std::vector<jl_limb_t> w_;
+  std::vector<jl_limb_t> scratch_;
+
+  // Widens to at least n limbs plus the sign limb and one to absorb a carry,
+  // so that adding a term of n limbs can't overflow.
+  void reserve(std::size_t n) {
+    if (w_.size() < n + 2)
+      w_.resize(n + 2, w_.back());
+  }
+
+  // Restores a sign limb on top after a term.
+  void settle() {
+    const jl_limb_t top = w_.back();
+    if (top != 0 && top != ~(jl_limb_t)0)
+      w_.push_back(top >> (JL_LIMB_BITS - 1) ? ~(jl_limb_t)0 : 0);
+  }
+
+  void apply(const limbs_view &v) {
+    if (v.n == 0)
+      return;
+    reserve(v.n);
+
+    jl_limb_t *w = w_.data();
+    const std::size_t w_n = w_.size();
+    if (v.neg)
+      sub_1(w + v.n, w + v.n, w_n - v.n, sub_n(w, w, v.p, v.n));
+    else
+      add_1(w + v.n, w + v.n, w_n - v.n, add_n(w, w, v.p, v.n));
+    settle();
+  }
+
+  void apply(const product_term &t) {
+    if (t.x.n == 0 || t.y.n == 0)
+      return;
+    reserve(t.x.n + t.y.n);
+
+    const std::size_t lo = t.x.n < t.y.n ? t.x.n : t.y.n;
+    if (lo >= get_mul_karatsuba_threshold())
+      scratch_.resize(addmul_limbs_itch(t.x.n, t.y.n));
+
+    if (t.neg)
+      submul_limbs(w_.data(), w_.size(), t.x.p, t.x.n, t.y.p, t.y.n,
+                   scratch_.data());
+    else
+      addmul_limbs(w_.data(), w_.size(), t.x.p, t.x.n, t.y.p, t.y.n,
+                   scratch_.data());
+    settle();
+  }
+
+  template <class L, class R> void apply(const sum_expr<L, R> &e) {
+    apply(e.l);
+    apply(e.r);
+  }
+
+  std::vector<jl_limb_t> magnitude() const {
+    std::vector<jl_limb_t> m(w_);
+    if (negative()) {
+      for (std::size_t i = 0; i < m.size(); i++)
+        m[i] = ~m[i];
+      add_1(m.data(), m.data(), m.size(), 1);
+    }
+    return m;
+  }
+};
+
+} // namespace jl
+
+#endif
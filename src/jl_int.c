@@ -0,0 +1,546 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "div.h"
+#include "jl_int.h"
+#include "limb.h"
+
+// Divisions needing at most this many limbs (quotient, remainder and scratch)
+// are done on the stack.
+#define JL_INT_STACK_LIMBS 64
+
+/**
+ * @brief Makes @p x a zero with inline storage. Every jl_int starts here.
+ */
+void int_init(jl_int *x) {
+  x->n = 0;
+  x->alloc = JL_INT_INLINE_LIMBS;
+  x->neg = 0;
+}
+
+/**
+ * @brief Releases any heap storage held by @p x and sets it to zero. @p x may
+ * be reused afterwards.
+ */
+void int_free(jl_int *x) {
+  if (x->alloc > JL_INT_INLINE_LIMBS)
+    free(x->d.heap);
+  int_init(x);
+}
+
+/**
+ * @brief Makes room for at least @p n limbs in @p x, keeping its value.
+ * Storage grows to at least twice its old size, so a run of growing results
+ * reallocates O(log n) times.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x is NULL.
+ *      2. Memory allocation failed. @p x is unchanged.
+ */
+uint8_t int_reserve(jl_int *x, size_t n) {
+  // Error check 1.
+  if (x == NULL)
+    return 1;
+
+  if (n <= x->alloc)
+    return 0;
+
+  const size_t alloc = n > 2 * x->alloc ? n : 2 * x->alloc;
+  jl_limb_t *p;
+  if (x->alloc > JL_INT_INLINE_LIMBS) {
+    p = realloc(x->d.heap, alloc * sizeof(jl_limb_t));
+  } else {
+    p = malloc(alloc * sizeof(jl_limb_t));
+    if (p != NULL)
+      memcpy(p, x->d.small, x->n * sizeof(jl_limb_t));
+  }
+  if (p == NULL)
+    return 2;
+
+  x->d.heap = p;
+  x->alloc = alloc;
+
+  return 0;
+}
+
+/**
+ * @brief Exchanges the values, and storage, of @p x and @p y.
+ */
+void int_swap(jl_int *x, jl_int *y) {
+  jl_int t = *x;
+  *x = *y;
+  *y = t;
+}
+
+void int_set_u64(jl_int *z, uint64_t v) {
+  int_limbs(z)[0] = v;
+  z->n = v != 0;
+  z->neg = 0;
+}
+
+void int_set_i64(jl_int *z, int64_t v) {
+  int_set_u64(z, v < 0 ? -(uint64_t)v : (uint64_t)v);
+  z->neg = v < 0;
+}
+
+/**
+ * @brief Copies @p x into @p z.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ */
+uint8_t int_set(jl_int *z, const jl_int *x) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  if (z == x)
+    return 0;
+
+  if (int_reserve(z, x->n))
+    return 2;
+
+  memcpy(int_limbs(z), int_limbs(x), x->n * sizeof(jl_limb_t));
+  z->n = x->n;
+  z->neg = x->neg;
+
+  return 0;
+}
+
+/**
+ * @brief Sets @p z to the magnitude in the byte string @p x, negated if @p neg
+ * is nonzero.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ *
+ * @param[out] z (jl_int*): The result.
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[in] neg (uint8_t): Nonzero for a negative result.
+ * @param[in] x_size (size_t): Size of @p x.
+ */
+uint8_t int_set_bstring(jl_int *z, const uint8_t *x, uint8_t neg,
+                        size_t x_size) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  while (x_size > 0 && x[x_size - 1] == 0)
+    x_size--;
+
+  const size_t n = limbs_for_bytes(x_size);
+  if (int_reserve(z, n))
+    return 2;
+
+  bytes_to_limbs(int_limbs(z), n, x, x_size);
+  z->n = n;
+  z->neg = n > 0 && neg;
+
+  return 0;
+}
+
+/**
+ * @brief Bytes needed to hold the magnitude of @p x. 0 for zero.
+ */
+size_t int_bstring_size(const jl_int *x) {
+  if (x->n == 0)
+    return 0;
+
+  return x->n * JL_LIMB_BYTES - clz_limb(int_limbs(x)[x->n - 1]) / 8;
+}
+
+/**
+ * @brief Writes the magnitude of @p x to @p z, zero-padded or truncated to @p
+ * z_size bytes.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, or @p flags is NULL.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the magnitude doesn't fit in @p z_size bytes, in which case
+ *        @p z holds its low @p z_size bytes.
+ *      1. Set if @p x is negative.
+ *
+ * @param[in] x (jl_int*): The value.
+ * @param[out] z (uint8_t*): The magnitude, in little-endian order.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] z_size (size_t): Size of @p z.
+ */
+uint8_t int_get_bstring(const jl_int *x, uint8_t *z, uint8_t *flags,
+                        size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  limbs_to_bytes(z, z_size, int_limbs(x), x->n);
+  *flags = (int_bstring_size(x) > z_size) | x->neg << 1;
+
+  return 0;
+}
+
+/**
+ * @return (int): -1, 0 or 1 as @p x is negative, zero or positive.
+ */
+int int_sgn(const jl_int *x) {
+  if (x->n == 0)
+    return 0;
+
+  return x->neg ? -1 : 1;
+}
+
+/**
+ * @return (int): 1 if |@p x| > |@p y|, -1 if |@p x| < |@p y|, 0 otherwise.
+ */
+int int_cmpabs(const jl_int *x, const jl_int *y) {
+  if (x->n != y->n)
+    return x->n > y->n ? 1 : -1;
+
+  return cmp_n(int_limbs(x), int_limbs(y), x->n);
+}
+
+/**
+ * @return (int): 1 if @p x > @p y, -1 if @p x < @p y, 0 otherwise.
+ */
+int int_cmp(const jl_int *x, const jl_int *y) {
+  if (x->neg != y->neg)
+    return x->neg ? -1 : 1;
+
+  const int c = int_cmpabs(x, y);
+  return x->neg ? -c : c;
+}
+
+/**
+ * @brief Stores -@p x in @p z. Error codes as for int_set.
+ */
+uint8_t int_neg(jl_int *z, const jl_int *x) {
+  const uint8_t rc = int_set(z, x);
+  if (rc == 0 && z->n > 0)
+    z->neg ^= 1;
+
+  return rc;
+}
+
+/**
+ * @brief Stores |@p x| in @p z. Error codes as for int_set.
+ */
+uint8_t int_abs(jl_int *z, const jl_int *x) {
+  const uint8_t rc = int_set(z, x);
+  if (rc == 0)
+    z->neg = 0;
+
+  return rc;
+}
+
+// |z| = |x| + |y|, with x->n >= y->n. Storage is looked up again after growing
+// z, since z may be x or y.
+static uint8_t add_abs(jl_int *z, const jl_int *x, const jl_int *y) {
+  const size_t xn = x->n;
+  const size_t yn = y->n;
+  if (int_reserve(z, xn + 1))
+    return 2;
+
+  const jl_limb_t *xl = int_limbs(x);
+  const jl_limb_t *yl = int_limbs(y);
+  jl_limb_t *zl = int_limbs(z);
+  jl_limb_t carry = add_n(zl, xl, yl, yn);
+  carry = add_1(zl + yn, xl + yn, xn - yn, carry);
+  zl[xn] = carry;
+  z->n = xn + (carry != 0);
+
+  return 0;
+}
+
+// |z| = |x| - |y|, with |x| > |y|.
+static uint8_t sub_abs(jl_int *z, const jl_int *x, const jl_int *y) {
+  const size_t xn = x->n;
+  const size_t yn = y->n;
+  if (int_reserve(z, xn))
+    return 2;
+
+  const jl_limb_t *xl = int_limbs(x);
+  const jl_limb_t *yl = int_limbs(y);
+  jl_limb_t *zl = int_limbs(z);
+  const jl_limb_t borrow = sub_n(zl, xl, yl, yn);
+  sub_1(zl + yn, xl + yn, xn - yn, borrow);
+  z->n = xn;
+
+  return 0;
+}
+
+// z = x + (-1)^y_neg |y|.
+static uint8_t add_signed(jl_int *z, const jl_int *x, const jl_int *y,
+                          uint8_t y_neg) {
+  uint8_t neg = x->neg;
+  uint8_t rc;
+  if (neg == y_neg) {
+    rc = x->n >= y->n ? add_abs(z, x, y) : add_abs(z, y, x);
+  } else {
+    const int c = int_cmpabs(x, y);
+    if (c == 0) {
+      z->n = 0;
+      z->neg = 0;
+      return 0;
+    }
+    if (c < 0)
+      neg = y_neg;
+    rc = c > 0 ? sub_abs(z, x, y) : sub_abs(z, y, x);
+  }
+  if (rc)
+    return rc;
+
+  z->neg = neg;
+  int_normalize(z);
+
+  return 0;
+}
+
+/**
+ * @brief Stores @p x + @p y in @p z, growing @p z as needed. Any of the three
+ * may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z, @p x, or @p y is NULL.
+ *      2. Memory allocation failed. @p z is unchanged.
+ */
+uint8_t int_add(jl_int *z, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  return add_signed(z, x, y, y->neg);
+}
+
+/**
+ * @brief Stores @p x - @p y in @p z, growing @p z as needed. Any of the three
+ * may be the same jl_int. Error codes as for int_add.
+ */
+uint8_t int_sub(jl_int *z, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  return add_signed(z, x, y, y->n > 0 && !y->neg);
+}
+
+/**
+ * @brief Stores @p x * @p y in @p z through mul_limbs, growing @p z as needed.
+ * Any of the three may be the same jl_int; when @p z is an operand the product
+ * is built in a temporary and swapped in. Products the schoolbook kernels
+ * handle take no scratch allocation. Error codes as for int_add.
+ */
+uint8_t int_mul(jl_int *z, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  if (x->n == 0 || y->n == 0) {
+    z->n = 0;
+    z->neg = 0;
+    return 0;
+  }
+
+  if (z == x || z == y) {
+    jl_int t;
+    int_init(&t);
+    const uint8_t rc = int_mul(&t, x, y);
+    if (rc == 0)
+      int_swap(z, &t);
+    int_free(&t);
+    return rc;
+  }
+
+  const size_t xn = x->n;
+  const size_t yn = y->n;
+  const size_t zn = xn + yn;
+  if (int_reserve(z, zn))
+    return 2;
+
+  // mul_limbs only touches scratch past the schoolbook sizes.
+  const size_t lo = xn < yn ? xn : yn;
+  const int small = x == y ? xn < get_sqr_karatsuba_threshold()
+                           : lo < get_mul_karatsuba_threshold();
+  jl_limb_t *scratch = NULL;
+  if (!small) {
+    scratch = malloc(mul_limbs_itch(xn, yn) * sizeof(jl_limb_t));
+    if (scratch == NULL)
+      return 2;
+  }
+
+  jl_limb_t *zl = int_limbs(z);
+  mul_limbs(zl, int_limbs(x), xn, int_limbs(y), yn, scratch);
+  free(scratch);
+
+  z->n = zn - (zl[zn - 1] == 0);
+  z->neg = x->neg ^ y->neg;
+
+  return 0;
+}
+
+// z += (-1)^p_neg |x y|, in place. z is widened by a limb past the larger of
+// itself and the product; if the magnitude subtracted was the larger, the
+// wrapped difference is negated back and the sign flips.
+static uint8_t addmul_signed(jl_int *z, const jl_int *x, const jl_int *y,
+                             uint8_t p_neg) {
+  if (x->n == 0 || y->n == 0)
+    return 0;
+
+  if (z == x || z == y) {
+    jl_int t;
+    int_init(&t);
+    uint8_t rc = int_set(&t, z);
+    if (rc == 0)
+      rc = addmul_signed(&t, x, y, p_neg);
+    if (rc == 0)
+      int_swap(z, &t);
+    int_free(&t);
+    return rc;
+  }
+
+  const size_t xn = x->n;
+  const size_t yn = y->n;
+  const size_t zn = z->n;
+  const size_t wn = (zn > xn + yn ? zn : xn + yn) + 1;
+  if (int_reserve(z, wn))
+    return 2;
+
+  const size_t lo = xn < yn ? xn : yn;
+  jl_limb_t *scratch = NULL;
+  if (lo >= get_mul_karatsuba_threshold()) {
+    scratch = malloc(addmul_limbs_itch(xn, yn) * sizeof(jl_limb_t));
+    if (scratch == NULL)
+      return 2;
+  }
+
+  jl_limb_t *zl = int_limbs(z);
+  memset(zl + zn, 0, (wn - zn) * sizeof(jl_limb_t));
+  if (zn == 0 || z->neg == p_neg) {
+    addmul_limbs(zl, wn, int_limbs(x), xn, int_limbs(y), yn, scratch);
+    z->neg = p_neg;
+  } else if (submul_limbs(zl, wn, int_limbs(x), xn, int_limbs(y), yn,
+                          scratch)) {
+    for (size_t i = 0; i < wn; i++)
+      zl[i] = ~zl[i];
+    add_1(zl, zl, wn, 1);
+    z->neg ^= 1;
+  }
+  free(scratch);
+
+  z->n = wn;
+  int_normalize(z);
+
+  return 0;
+}
+
+/**
+ * @brief Adds @p x * @p y to @p z in place, without forming the product
+ * separately at schoolbook sizes (see addmul_limbs). Any of the three may be
+ * the same jl_int. Error codes as for int_add.
+ */
+uint8_t int_addmul(jl_int *z, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  return addmul_signed(z, x, y, x->neg ^ y->neg);
+}
+
+/**
+ * @brief Subtracts @p x * @p y from @p z in place. Same contract as
+ * int_addmul.
+ */
+uint8_t int_submul(jl_int *z, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (z == NULL | x == NULL | y == NULL)
+    return 1;
+
+  return addmul_signed(z, x, y, !(x->neg ^ y->neg));
+}
+
+/**
+ * @brief Truncating division: @p q = @p x / @p y rounded toward zero, and @p r
+ * = @p x - @p q * @p y, which has the sign of @p x. Either output may be NULL,
+ * and either may be @p x or @p y, but not each other.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x or @p y is NULL, or both @p q and @p r are.
+ *      2. Memory allocation failed.
+ *      3. @p y is zero.
+ */
+uint8_t int_divrem(jl_int *q, jl_int *r, const jl_int *x, const jl_int *y) {
+  // Error check 1.
+  if (x == NULL | y == NULL | (q == NULL & r == NULL))
+    return 1;
+
+  // Error check 3.
+  if (y->n == 0)
+    return 3;
+
+  if (int_cmpabs(x, y) < 0) {
+    if (r != NULL && int_set(r, x))
+      return 2;
+    if (q != NULL) {
+      q->n = 0;
+      q->neg = 0;
+    }
+    return 0;
+  }
+
+  const size_t n = x->n;
+  const size_t dn = y->n;
+  const size_t qn = n - dn + 1;
+  const uint8_t q_neg = x->neg ^ y->neg;
+  const uint8_t r_neg = x->neg;
+
+  const size_t total = qn + dn + divrem_limbs_itch(n, dn);
+  jl_limb_t stack[JL_INT_STACK_LIMBS];
+  jl_limb_t *buf = stack;
+  if (total > JL_INT_STACK_LIMBS) {
+    buf = malloc(total * sizeof(jl_limb_t));
+    if (buf == NULL)
+      return 2;
+  }
+
+  // Both results are complete before either output is written, so the
+  // outputs may overwrite the operands.
+  divrem_limbs(buf, buf + qn, int_limbs(x), n, int_limbs(y), dn,
+               buf + qn + dn);
+
+  uint8_t rc = 0;
+  if (q != NULL) {
+    if (int_reserve(q, qn)) {
+      rc = 2;
+    } else {
+      memcpy(int_limbs(q), buf, qn * sizeof(jl_limb_t));
+      q->n = qn;
+      q->neg = q_neg;
+      int_normalize(q);
+    }
+  }
+  if (r != NULL && rc == 0) {
+    if (int_reserve(r, dn)) {
+      rc = 2;
+    } else {
+      memcpy(int_limbs(r), buf + qn, dn * sizeof(jl_limb_t));
+      r->n = dn;
+      r->neg = r_neg;
+      int_normalize(r);
+    }
+  }
+
+  if (buf != stack)
+    free(buf);
+
+  return rc;
+}
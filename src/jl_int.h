@@ -0,0 +1,96 @@
+#ifndef __JL_INT_H__
+#define __JL_INT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Limbs stored inside the handle itself. Values that fit never touch the heap.
+#ifndef JL_INT_INLINE_LIMBS
+#define JL_INT_INLINE_LIMBS 4
+#endif
+
+/**
+ * @brief An owning, signed integer of any size. The magnitude is kept as n
+ * limbs without leading zeros, in inline storage while it fits and on the heap
+ * after that. Storage only grows, geometrically, until int_free.
+ *
+ * The handle holds no pointers into itself, so it may be moved with memcpy.
+ * Use int_limbs to get at the magnitude.
+ */
+typedef struct {
+  size_t n;     // Limbs in the magnitude. 0 for zero.
+  size_t alloc; // Limbs of storage. JL_INT_INLINE_LIMBS while inline.
+  uint8_t neg;  // 1 if negative. Zero is never negative.
+  union {
+    jl_limb_t *heap;
+    jl_limb_t small[JL_INT_INLINE_LIMBS];
+  } d;
+} jl_int;
+
+/**
+ * @brief The magnitude of @p x, @p x->n limbs in increasing significance.
+ * Invalidated by anything that may grow @p x.
+ */
+static inline jl_limb_t *int_limbs(const jl_int *x) {
+  return x->alloc > JL_INT_INLINE_LIMBS ? x->d.heap
+                                        : (jl_limb_t *)x->d.small;
+}
+
+/**
+ * @brief Drops leading zero limbs from @p x, and the sign of a zero. For code
+ * that writes the limbs of @p x itself.
+ */
+static inline void int_normalize(jl_int *x) {
+  const jl_limb_t *xl = int_limbs(x);
+  while (x->n > 0 && xl[x->n - 1] == 0)
+    x->n--;
+  if (x->n == 0)
+    x->neg = 0;
+}
+
+void int_init(jl_int *x);
+
+void int_free(jl_int *x);
+
+uint8_t int_reserve(jl_int *x, size_t n);
+
+void int_swap(jl_int *x, jl_int *y);
+
+void int_set_u64(jl_int *z, uint64_t v);
+
+void int_set_i64(jl_int *z, int64_t v);
+
+uint8_t int_set(jl_int *z, const jl_int *x);
+
+uint8_t int_set_bstring(jl_int *z, const uint8_t *x, uint8_t neg,
+                        size_t x_size);
+
+size_t int_bstring_size(const jl_int *x);
+
+uint8_t int_get_bstring(const jl_int *x, uint8_t *z, uint8_t *flags,
+                        size_t z_size);
+
+int int_sgn(const jl_int *x);
+
+int int_cmp(const jl_int *x, const jl_int *y);
+
+int int_cmpabs(const jl_int *x, const jl_int *y);
+
+uint8_t int_neg(jl_int *z, const jl_int *x);
+
+uint8_t int_abs(jl_int *z, const jl_int *x);
+
+uint8_t int_add(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_sub(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_mul(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_addmul(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_submul(jl_int *z, const jl_int *x, const jl_int *y);
+
+uint8_t int_divrem(jl_int *q, jl_int *r, const jl_int *x, const jl_int *y);
+#endif
@@ -0,0 +1,285 @@
+#ifndef __JL_UINT_HPP__
+#define __JL_UINT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * jl::uint<Bits>, a fixed-width unsigned integer for C++14 and later, header
+ * only. The width is a template argument, so every loop below has a constant
+ * trip count and unrolls completely; there is no size dispatch, and a value
+ * small enough stays in registers. Everything is constexpr.
+ *
+ * Values wrap modulo 2^Bits. add, sub and mul return the same flags as
+ * add_bstrings, sub_bstrings and mul_bstrings called with three Bits / 8 byte
+ * operands, and from_bytes / to_bytes read and write the same little-endian
+ * byte strings, so results can be passed back and forth with the C functions.
+ */
+
+#if defined(__clang__)
+#define JL_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define JL_UNROLL _Pragma("GCC unroll 64")
+#else
+#define JL_UNROLL
+#endif
+
+namespace jl {
+
+namespace detail {
+
+// x + y + c, with the carry out in c.
+constexpr uint64_t addc(uint64_t x, uint64_t y, uint64_t &c) {
+  const uint64_t s = x + y;
+  const uint64_t t = s + c;
+  c = (s < x) | (t < s);
+  return t;
+}
+
+// x - y - b, with the borrow out in b.
+constexpr uint64_t subb(uint64_t x, uint64_t y, uint64_t &b) {
+  const uint64_t d = x - y;
+  const uint64_t t = d - b;
+  b = (x < y) | (d < b);
+  return t;
+}
+
+// The 128-bit product x y, high limb in hi.
+constexpr uint64_t mul(uint64_t x, uint64_t y, uint64_t &hi) {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 p = (unsigned __int128)x * y;
+  hi = (uint64_t)(p >> 64);
+  return (uint64_t)p;
+#else
+  const uint64_t x0 = x & 0xFFFFFFFF, x1 = x >> 32;
+  const uint64_t y0 = y & 0xFFFFFFFF, y1 = y >> 32;
+  const uint64_t p00 = x0 * y0, p01 = x0 * y1, p10 = x1 * y0, p11 = x1 * y1;
+  const uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+  hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+  return (mid << 32) | (p00 & 0xFFFFFFFF);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief An unsigned integer of Bits bits, a positive multiple of 64, held as
+ * Bits / 64 limbs in increasing significance. Trivially copyable; zero when
+ * default-constructed.
+ */
+template <std::size_t Bits> struct uint {
+  static_assert(Bits > 0 && Bits % 64 == 0, "Bits must be a multiple of 64");
+
+  static constexpr std::size_t limbs = Bits / 64;
+  static constexpr std::size_t bytes = Bits / 8;
+
+  uint64_t limb[limbs];
+
+  constexpr uint() : limb{} {}
+  constexpr uint(uint64_t v) : limb{v} {}
+
+  /**
+   * @brief The value of the @p size little-endian bytes at @p x, keeping the
+   * low Bits bits, as the C functions read their operands.
+   */
+  static constexpr uint from_bytes(const uint8_t *x, std::size_t size) {
+    uint z;
+    if (size > bytes)
+      size = bytes;
+    for (std::size_t i = 0; i < size; i++)
+      z.limb[i / 8] |= (uint64_t)x[i] << (8 * (i % 8));
+    return z;
+  }
+
+  /**
+   * @brief Writes the value to the @p size bytes at @p z, little-endian,
+   * truncated or zero-padded as the C functions write their results.
+   */
+  constexpr void to_bytes(uint8_t *z, std::size_t size) const {
+    for (std::size_t i = 0; i < size; i++)
+      z[i] = i < bytes ? (uint8_t)(limb[i / 8] >> (8 * (i % 8))) : 0;
+  }
+};
+
+/**
+ * @brief z = x + y mod 2^Bits. Returns 1 if that wrapped, 0 otherwise: the
+ * flags of add_bstrings on Bits / 8 byte operands.
+ */
+template <std::size_t Bits>
+constexpr uint8_t add(uint<Bits> &z, const uint<Bits> &x,
+                      const uint<Bits> &y) {
+  uint64_t c = 0;
+  JL_UNROLL
+  for (std::size_t i = 0; i < uint<Bits>::limbs; i++)
+    z.limb[i] = detail::addc(x.limb[i], y.limb[i], c);
+  return (uint8_t)c;
+}
+
+/**
+ * @brief z = x - y mod 2^Bits. Returns 1 if x < y, 0 otherwise: the flags of
+ * sub_bstrings on Bits / 8 byte operands.
+ */
+template <std::size_t Bits>
+constexpr uint8_t sub(uint<Bits> &z, const uint<Bits> &x,
+                      const uint<Bits> &y) {
+  uint64_t b = 0;
+  JL_UNROLL
+  for (std::size_t i = 0; i < uint<Bits>::limbs; i++)
+    z.limb[i] = detail::subb(x.limb[i], y.limb[i], b);
+  return (uint8_t)b;
+}
+
+/**
+ * @brief z = x y mod 2^Bits. Returns 0, the flags of mul_bstrings with a
+ * Bits / 8 byte product. Only the product limbs that land in z are formed.
+ */
+template <std::size_t Bits>
+constexpr uint8_t mul(uint<Bits> &z, const uint<Bits> &x,
+                      const uint<Bits> &y) {
+  constexpr std::size_t n = uint<Bits>::limbs;
+  uint64_t t[n] = {};
+  JL_UNROLL
+  for (std::size_t i = 0; i < n; i++) {
+    uint64_t carry = 0;
+    JL_UNROLL
+    for (std::size_t j = 0; i + j < n; j++) {
+      uint64_t hi = 0, c = 0;
+      uint64_t lo = detail::mul(x.limb[i], y.limb[j], hi);
+      lo = detail::addc(lo, carry, c);
+      hi += c;
+      c = 0;
+      t[i + j] = detail::addc(t[i + j], lo, c);
+      carry = hi + c;
+    }
+  }
+  JL_UNROLL
+  for (std::size_t i = 0; i < n; i++)
+    z.limb[i] = t[i];
+  return 0;
+}
+
+/**
+ * @brief The full 2 Bits bit product of x and y.
+ */
+template <std::size_t Bits>
+constexpr uint<2 * Bits> mul_wide(const uint<Bits> &x, const uint<Bits> &y) {
+  constexpr std::size_t n = uint<Bits>::limbs;
+  uint<2 * Bits> z;
+  JL_UNROLL
+  for (std::size_t i = 0; i < n; i++) {
+    uint64_t carry = 0;
+    JL_UNROLL
+    for (std::size_t j = 0; j < n; j++) {
+      uint64_t hi = 0, c = 0;
+      uint64_t lo = detail::mul(x.limb[i], y.limb[j], hi);
+      lo = detail::addc(lo, carry, c);
+      hi += c;
+      c = 0;
+      z.limb[i + j] = detail::addc(z.limb[i + j], lo, c);
+      carry = hi + c;
+    }
+    z.limb[i + n] = carry;
+  }
+  return z;
+}
+
+/**
+ * @brief -1, 0 or 1 as x is less than, equal to or greater than y.
+ */
+template <std::size_t Bits>
+constexpr int cmp(const uint<Bits> &x, const uint<Bits> &y) {
+  int r = 0;
+  JL_UNROLL
+  for (std::size_t i = 0; i < uint<Bits>::limbs; i++) {
+    if (x.limb[i] != y.limb[i])
+      r = x.limb[i] < y.limb[i] ? -1 : 1;
+  }
+  return r;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> operator+(const uint<Bits> &x, const uint<Bits> &y) {
+  uint<Bits> z;
+  add(z, x, y);
+  return z;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> operator-(const uint<Bits> &x, const uint<Bits> &y) {
+  uint<Bits> z;
+  sub(z, x, y);
+  return z;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> operator*(const uint<Bits> &x, const uint<Bits> &y) {
+  uint<Bits> z;
+  mul(z, x, y);
+  return z;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> &operator+=(uint<Bits> &x, const uint<Bits> &y) {
+  add(x, x, y);
+  return x;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> &operator-=(uint<Bits> &x, const uint<Bits> &y) {
+  sub(x, x, y);
+  return x;
+}
+
+template <std::size_t Bits>
+constexpr uint<Bits> &operator*=(uint<Bits> &x, const uint<Bits> &y) {
+  mul(x, x, y);
+  return x;
+}
+
+template <std::size_t Bits>
+constexpr bool operator==(const uint<Bits> &x, const uint<Bits> &y) {
+  uint64_t d = 0;
+  JL_UNROLL
+  for (std::size_t i = 0; i < uint<Bits>::limbs; i++)
+    d |= x.limb[i] ^ y.limb[i];
+  return d == 0;
+}
+
+template <std::size_t Bits>
+constexpr bool operator!=(const uint<Bits> &x, const uint<Bits> &y) {
+  return !(x == y);
+}
+
+// x < y exactly when x - y borrows.
+template <std::size_t Bits>
+constexpr bool operator<(const uint<Bits> &x, const uint<Bits> &y) {
+  uint64_t b = 0;
+  JL_UNROLL
+  for (std::size_t i = 0; i < uint<Bits>::limbs; i++)
+    detail::subb(x.limb[i], y.limb[i], b);
+  return b != 0;
+}
+
+template <std::size_t Bits>
+constexpr bool operator>(const uint<Bits> &x, const uint<Bits> &y) {
+  return y < x;
+}
+
+template <std::size_t Bits>
+constexpr bool operator<=(const uint<Bits> &x, const uint<Bits> &y) {
+  return !(y < x);
+}
+
+template <std::size_t Bits>
+constexpr bool operator>=(const uint<Bits> &x, const uint<Bits> &y) {
+  return !(x < y);
+}
+
+typedef uint<128> uint128;
+typedef uint<256> uint256;
+typedef uint<512> uint512;
+
+} // namespace jl
+
+#undef JL_UNROLL
+#endif
@@ -0,0 +1,697 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "div.h"
+#include "jl_int.h"
+#include "layout.h"
+#include "limb.h"
+#include "mul_par.h"
+#include "pool.h"
+
+const jl_layout jl_layout_le = {-1, -1, 1, 0};
+
+const jl_layout jl_layout_be = {1, 1, 1, 0};
+
+/*
+ * Sums and differences need no limbs of their own: the carry chain runs over
+ * the words where they lie, a limb's worth of bytes at a time, least
+ * significant first. Products and quotients unpack every operand into limbs
+ * once on the way in, and pack once on the way out, as the bstring functions
+ * do anyway. Either way, reading and writing through the layout is what spares
+ * the caller a reversed copy of each operand and of the result.
+ *
+ * Two layouts are a single byte string, and go a limb at a time: little-endian
+ * ones, and big-endian ones, whose limbs are read backwards from the end and
+ * byte-swapped. 8-byte words go a word at a time whatever their order and
+ * stride. Anything else goes a byte at a time.
+ */
+
+/**
+ * @brief Checks that @p layout describes something: order 1 or -1, endian 1,
+ * -1 or 0, a nonzero size, and a stride of 0 or at least the size.
+ *
+ *  - Error codes:
+ *      0. Valid.
+ *      1. @p layout is NULL.
+ *      3. @p layout is invalid.
+ */
+uint8_t layout_check(const jl_layout *layout) {
+  // Error check 1.
+  if (layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if ((layout->order != 1 && layout->order != -1) | layout->endian < -1 |
+      layout->endian > 1 | layout->size == 0 |
+      (layout->stride != 0 && layout->stride < layout->size))
+    return 3;
+
+  return 0;
+}
+
+/**
+ * @return (size_t): The number of @p layout words needed to hold @p bytes
+ * bytes.
+ */
+size_t layout_count(const jl_layout *layout, size_t bytes) {
+  return (bytes + layout->size - 1) / layout->size;
+}
+
+static inline size_t layout_stride(const jl_layout *layout) {
+  return layout->stride != 0 ? layout->stride : layout->size;
+}
+
+// 1 if the bytes of each word are least significant first.
+static inline int layout_little(const jl_layout *layout) {
+  return layout->endian < 0 || (layout->endian == 0 && !JL_BIG_ENDIAN_HOST);
+}
+
+// 1 if count words of layout are one little-endian byte string, -1 if they
+// are one big-endian byte string, and 0 otherwise.
+static int layout_contiguous(const jl_layout *layout, size_t count) {
+  if (count > 1 && layout_stride(layout) != layout->size)
+    return 0;
+
+  const int little = layout->size == 1 || layout_little(layout);
+  const int big = layout->size == 1 || !layout_little(layout);
+  if (little && (count <= 1 || layout->order < 0))
+    return 1;
+  if (big && (count <= 1 || layout->order > 0))
+    return -1;
+  return 0;
+}
+
+// Word w of x, counting from the least significant.
+static inline const uint8_t *word_at(const uint8_t *x, size_t w, size_t count,
+                                     const jl_layout *layout) {
+  return x + (layout->order < 0 ? w : count - 1 - w) * layout_stride(layout);
+}
+
+/**
+ * @brief Unpacks the @p count words of @p x, laid out as @p layout says, into
+ * @p n limbs, truncating or padding with zeros. @p layout must be valid (see
+ * layout_check).
+ */
+void layout_to_limbs(jl_limb_t *z, size_t n, const uint8_t *x, size_t count,
+                     const jl_layout *layout) {
+  const size_t size = layout->size;
+  const size_t bytes = count * size;
+  const int contiguous = layout_contiguous(layout, count);
+
+  if (contiguous > 0) {
+    bytes_to_limbs(z, n, x, bytes);
+    return;
+  }
+
+  size_t i = 0;
+  if (contiguous < 0) {
+    for (; i < n && (i + 1) * JL_LIMB_BYTES <= bytes; i++)
+      z[i] = bswap_limb(load_limb(x + bytes - (i + 1) * JL_LIMB_BYTES));
+    if (i < n && i * JL_LIMB_BYTES < bytes) {
+      // The top few bytes, at the very start.
+      jl_limb_t v = 0;
+      for (size_t j = 0; j < bytes - i * JL_LIMB_BYTES; j++)
+        v = v << 8 | x[j];
+      z[i++] = v;
+    }
+  } else if (size == JL_LIMB_BYTES) {
+    const int little = layout_little(layout);
+    for (; i < n && i < count; i++) {
+      const jl_limb_t v = load_limb(word_at(x, i, count, layout));
+      z[i] = little ? v : bswap_limb(v);
+    }
+  } else {
+    const int little = layout_little(layout);
+    jl_limb_t v = 0;
+    unsigned fill = 0;
+    for (size_t w = 0; w < count && i < n; w++) {
+      const uint8_t *p = word_at(x, w, count, layout);
+      for (size_t j = 0; j < size; j++) {
+        v |= (jl_limb_t)p[little ? j : size - 1 - j] << fill;
+        fill += 8;
+        if (fill == JL_LIMB_BITS) {
+          z[i++] = v;
+          v = 0;
+          fill = 0;
+          if (i == n)
+            break;
+        }
+      }
+    }
+    if (i < n && fill > 0)
+      z[i++] = v;
+  }
+  for (; i < n; i++)
+    z[i] = 0;
+}
+
+/**
+ * @brief Packs @p n limbs into the @p count words of @p z, laid out as @p
+ * layout says, truncating or padding with zeros. @p layout must be valid (see
+ * layout_check).
+ */
+void limbs_to_layout(uint8_t *z, size_t count, const jl_limb_t *x, size_t n,
+                     const jl_layout *layout) {
+  const size_t size = layout->size;
+  const size_t bytes = count * size;
+  const int contiguous = layout_contiguous(layout, count);
+
+  if (contiguous > 0) {
+    limbs_to_bytes(z, bytes, x, n);
+    return;
+  }
+
+  if (contiguous < 0) {
+    size_t i = 0;
+    for (; (i + 1) * JL_LIMB_BYTES <= bytes; i++)
+      store_limb(z + bytes - (i + 1) * JL_LIMB_BYTES,
+                 bswap_limb(i < n ? x[i] : 0));
+    jl_limb_t v = i < n ? x[i] : 0;
+    for (size_t j = bytes - i * JL_LIMB_BYTES; j > 0; j--) {
+      z[j - 1] = (uint8_t)v;
+      v >>= 8;
+    }
+  } else if (size == JL_LIMB_BYTES) {
+    const int little = layout_little(layout);
+    for (size_t w = 0; w < count; w++) {
+      const jl_limb_t v = w < n ? x[w] : 0;
+      store_limb((uint8_t *)word_at(z, w, count, layout),
+                 little ? v : bswap_limb(v));
+    }
+  } else {
+    const int little = layout_little(layout);
+    size_t k = 0;
+    for (size_t w = 0; w < count; w++) {
+      uint8_t *p = (uint8_t *)word_at(z, w, count, layout);
+      for (size_t j = 0; j < size; j++, k++) {
+        const size_t i = k / JL_LIMB_BYTES;
+        p[little ? j : size - 1 - j] =
+            i < n ? (uint8_t)(x[i] >> 8 * (k % JL_LIMB_BYTES)) : 0;
+      }
+    }
+  }
+}
+
+// Limb i of the count words of x, least significant first, that is bytes 8i to
+// 8i + 7 of its value, reading zeros past the end. contiguous is
+// layout_contiguous(layout, count).
+static jl_limb_t get_layout_limb(const uint8_t *x, size_t count, size_t i,
+                                 const jl_layout *layout, int contiguous) {
+  const size_t size = layout->size;
+  const size_t bytes = count * size;
+  const size_t k = i * JL_LIMB_BYTES;
+  if (k >= bytes)
+    return 0;
+  const size_t m = bytes - k < JL_LIMB_BYTES ? bytes - k : JL_LIMB_BYTES;
+
+  if (contiguous > 0)
+    return load_limb_partial(x + k, m);
+  if (contiguous < 0) {
+    if (m == JL_LIMB_BYTES)
+      return bswap_limb(load_limb(x + bytes - k - JL_LIMB_BYTES));
+    // The top few bytes, at the very start.
+    jl_limb_t v = 0;
+    for (size_t j = 0; j < m; j++)
+      v = v << 8 | x[j];
+    return v;
+  }
+
+  const int little = layout_little(layout);
+  if (size == JL_LIMB_BYTES) {
+    const jl_limb_t v = load_limb(word_at(x, i, count, layout));
+    return little ? v : bswap_limb(v);
+  }
+  jl_limb_t v = 0;
+  size_t w = k / size, b = k % size;
+  for (size_t j = 0; j < m; j++) {
+    v |= (jl_limb_t)word_at(x, w, count, layout)[little ? b : size - 1 - b]
+         << 8 * j;
+    if (++b == size) {
+      w++;
+      b = 0;
+    }
+  }
+  return v;
+}
+
+// Writes v to limb i of the count words of z, which must start inside them,
+// dropping the bytes past the end. contiguous is layout_contiguous(layout,
+// count).
+static void set_layout_limb(uint8_t *z, size_t count, size_t i, jl_limb_t v,
+                            const jl_layout *layout, int contiguous) {
+  const size_t size = layout->size;
+  const size_t bytes = count * size;
+  const size_t k = i * JL_LIMB_BYTES;
+  const size_t m = bytes - k < JL_LIMB_BYTES ? bytes - k : JL_LIMB_BYTES;
+
+  if (contiguous > 0) {
+    store_limb_partial(z + k, v, m);
+    return;
+  }
+  if (contiguous < 0) {
+    if (m == JL_LIMB_BYTES) {
+      store_limb(z + bytes - k - JL_LIMB_BYTES, bswap_limb(v));
+      return;
+    }
+    for (size_t j = m; j > 0; j--) {
+      z[j - 1] = (uint8_t)v;
+      v >>= 8;
+    }
+    return;
+  }
+
+  const int little = layout_little(layout);
+  if (size == JL_LIMB_BYTES) {
+    store_limb((uint8_t *)word_at(z, i, count, layout),
+               little ? v : bswap_limb(v));
+    return;
+  }
+  size_t w = k / size, b = k % size;
+  for (size_t j = 0; j < m; j++) {
+    ((uint8_t *)word_at(z, w, count, layout))[little ? b : size - 1 - b] =
+        (uint8_t)(v >> 8 * j);
+    if (++b == size) {
+      w++;
+      b = 0;
+    }
+  }
+}
+
+// 1 if the n limbs of x fit in bytes bytes.
+static int fits_bytes(const jl_limb_t *x, size_t n, size_t bytes) {
+  size_t i = bytes / JL_LIMB_BYTES;
+  if (i >= n)
+    return 1;
+  if (bytes % JL_LIMB_BYTES != 0 && x[i] >> 8 * (bytes % JL_LIMB_BYTES) != 0)
+    return 0;
+  for (i += bytes % JL_LIMB_BYTES != 0; i < n; i++)
+    if (x[i] != 0)
+      return 0;
+  return 1;
+}
+
+// n less the leading zero limbs of x.
+static size_t trim_limbs(const jl_limb_t *x, size_t n) {
+  while (n > 0 && x[n - 1] == 0)
+    n--;
+  return n;
+}
+
+// n limbs of temporaries: stack, which holds JL_LAYOUT_STACK_LIMBS, if they
+// fit, and malloc otherwise.
+static jl_limb_t *layout_buf(jl_limb_t *stack, size_t n) {
+  return n <= JL_LAYOUT_STACK_LIMBS ? stack : malloc(n * sizeof(jl_limb_t));
+}
+
+// The sum or difference, a limb at a time from the least significant, each
+// limb of z written only once that of x and y has been read.
+static void add_sub_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                           uint8_t *flags, size_t x_count, size_t y_count,
+                           size_t z_count, const jl_layout *layout, int sub) {
+  const size_t size = layout->size;
+  const size_t x_n = limbs_for_bytes(x_count * size);
+  const size_t y_n = limbs_for_bytes(y_count * size);
+  const size_t z_n = limbs_for_bytes(z_count * size);
+  const size_t n = x_n > y_n ? x_n : y_n;
+  const int x_c = layout_contiguous(layout, x_count);
+  const int y_c = layout_contiguous(layout, y_count);
+  const int z_c = layout_contiguous(layout, z_count);
+
+  // The limbs that are whole in all three go by pointer, where the layout
+  // allows.
+  size_t full = x_count < y_count ? x_count : y_count;
+  full = (full < z_count ? full : z_count) * size / JL_LIMB_BYTES;
+  jl_limb_t c = 0;
+  jl_limb_t s = 0;
+  size_t i = 0;
+  if (x_c > 0 && y_c > 0 && z_c > 0) {
+    for (; i < full; i++) {
+      const size_t k = i * JL_LIMB_BYTES;
+      const jl_limb_t xi = load_limb(x + k), yi = load_limb(y + k);
+      s = sub ? subb_limb(xi, yi, c, &c) : addc_limb(xi, yi, c, &c);
+      store_limb(z + k, s);
+    }
+  } else if (x_c < 0 && y_c < 0 && z_c < 0) {
+    const uint8_t *xp = x + x_count * size, *yp = y + y_count * size;
+    uint8_t *zp = z + z_count * size;
+    for (; i < full; i++) {
+      xp -= JL_LIMB_BYTES;
+      yp -= JL_LIMB_BYTES;
+      zp -= JL_LIMB_BYTES;
+      const jl_limb_t xi = bswap_limb(load_limb(xp));
+      const jl_limb_t yi = bswap_limb(load_limb(yp));
+      s = sub ? subb_limb(xi, yi, c, &c) : addc_limb(xi, yi, c, &c);
+      store_limb(zp, bswap_limb(s));
+    }
+  } else if (size == JL_LIMB_BYTES && full > 0) {
+    const int little = layout_little(layout);
+    const ptrdiff_t stride = (ptrdiff_t)layout_stride(layout);
+    const ptrdiff_t step = layout->order < 0 ? stride : -stride;
+    const uint8_t *xp = word_at(x, 0, x_count, layout);
+    const uint8_t *yp = word_at(y, 0, y_count, layout);
+    uint8_t *zp = (uint8_t *)word_at(z, 0, z_count, layout);
+    for (; i < full; i++, xp += step, yp += step, zp += step) {
+      jl_limb_t xi = load_limb(xp), yi = load_limb(yp);
+      if (!little) {
+        xi = bswap_limb(xi);
+        yi = bswap_limb(yi);
+      }
+      s = sub ? subb_limb(xi, yi, c, &c) : addc_limb(xi, yi, c, &c);
+      store_limb(zp, little ? s : bswap_limb(s));
+    }
+  }
+  for (; i < z_n; i++) {
+    const jl_limb_t xi = get_layout_limb(x, x_count, i, layout, x_c);
+    const jl_limb_t yi = get_layout_limb(y, y_count, i, layout, y_c);
+    s = sub ? subb_limb(xi, yi, c, &c) : addc_limb(xi, yi, c, &c);
+    set_layout_limb(z, z_count, i, s, layout, z_c);
+  }
+
+  // What didn't fit: the top of the last limb of z, and any limbs past it.
+  const size_t top = z_count * size % JL_LIMB_BYTES;
+  int over = top != 0 && s >> 8 * top != 0;
+  for (i = z_n; i < n && !over; i++) {
+    const jl_limb_t xi = get_layout_limb(x, x_count, i, layout, x_c);
+    const jl_limb_t yi = get_layout_limb(y, y_count, i, layout, y_c);
+    over = (sub ? subb_limb(xi, yi, c, &c) : addc_limb(xi, yi, c, &c)) != 0;
+  }
+  *flags = over || c != 0;
+}
+
+/**
+ * @brief Adds @p x and @p y, and stores the sum in @p z, all three laid out
+ * as @p layout says. Sizes are in words of @p layout. @p z may be @p x or @p
+ * y if it has at least as many words, and mustn't overlap them otherwise.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, @p flags, or @p layout is NULL.
+ *      3. @p layout is invalid (see layout_check).
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the sum doesn't fit in @p z_count words, in which case @p z
+ *        holds its low @p z_count words.
+ *
+ * @param[in] x (uint8_t*): The first word of @p x in memory.
+ * @param[in] y (uint8_t*): The first word of @p y in memory.
+ * @param[out] z (uint8_t*): The first word of @p z in memory.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_count (size_t): Words in @p x.
+ * @param[in] y_count (size_t): Words in @p y.
+ * @param[in] z_count (size_t): Words in @p z.
+ * @param[in] layout (jl_layout*): How the words and their bytes are ordered.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t add_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  add_sub_layout(x, y, z, flags, x_count, y_count, z_count, layout, 0);
+
+  return 0;
+}
+
+/**
+ * @brief Subtracts @p y from @p x, and stores the difference modulo 2^(8 @p
+ * z_count @p layout->size) in @p z. Bit 0 of @p flags is set if @p x < @p y,
+ * or if the difference doesn't fit. Otherwise the same contract as add_layout.
+ */
+uint8_t sub_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  add_sub_layout(x, y, z, flags, x_count, y_count, z_count, layout, 1);
+
+  return 0;
+}
+
+/**
+ * @brief Multiplies @p x and @p y, and stores the product in @p z, all three
+ * laid out as @p layout says, through mul_limbs (mul_limbs_par when the pool is
+ * running, as with mul_bstrings). Passing the same @p x and @p y squares. Same
+ * contract as add_layout otherwise, bit 0 of @p flags being set if the product
+ * doesn't fit, except that the operands are unpacked first, so @p z may
+ * overlap them in any way, and that error code 2 means memory allocation
+ * failed.
+ */
+uint8_t mul_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  const size_t size = layout->size;
+  const int square = x == y && x_count == y_count;
+  const size_t x_cap = limbs_for_bytes(x_count * size);
+  const size_t y_cap = square ? 0 : limbs_for_bytes(y_count * size);
+
+  jl_limb_t stack[JL_LAYOUT_STACK_LIMBS];
+  jl_limb_t *buf = layout_buf(stack, x_cap + y_cap);
+  if (buf == NULL)
+    return 2;
+
+  jl_limb_t *xl = buf;
+  jl_limb_t *yl = xl + x_cap;
+  layout_to_limbs(xl, x_cap, x, x_count, layout);
+  if (square)
+    yl = xl;
+  else
+    layout_to_limbs(yl, y_cap, y, y_count, layout);
+  // Leading zero words, as fixed-width wire formats have, cost nothing.
+  const size_t x_n = trim_limbs(xl, x_cap);
+  const size_t y_n = square ? x_n : trim_limbs(yl, y_cap);
+
+  uint8_t rc = 0;
+  if (x_n == 0 || y_n == 0) {
+    limbs_to_layout(z, z_count, xl, 0, layout);
+    *flags = 0;
+  } else {
+    const int par = get_pool_threads() > 1 &&
+                    (x_n < y_n ? x_n : y_n) >= get_mul_par_grain();
+    const size_t total =
+        x_n + y_n +
+        (par ? mul_limbs_par_itch(x_n, y_n) : mul_limbs_itch(x_n, y_n));
+    jl_limb_t work_stack[JL_LAYOUT_STACK_LIMBS];
+    jl_limb_t *zl = layout_buf(work_stack, total);
+    if (zl == NULL) {
+      rc = 2;
+    } else {
+      if (par)
+        mul_limbs_par(zl, xl, x_n, yl, y_n, zl + x_n + y_n);
+      else
+        mul_limbs(zl, xl, x_n, yl, y_n, zl + x_n + y_n);
+      limbs_to_layout(z, z_count, zl, x_n + y_n, layout);
+      *flags = !fits_bytes(zl, x_n + y_n, z_count * size);
+      if (zl != work_stack)
+        free(zl);
+    }
+  }
+
+  if (buf != stack)
+    free(buf);
+
+  return rc;
+}
+
+/**
+ * @brief Divides @p x by @p d, and stores the quotient in @p q and the
+ * remainder in @p r, all laid out as @p layout says, through divrem_limbs.
+ * Sizes are in words of @p layout.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p d, @p flags, or @p layout is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p layout is invalid (see layout_check).
+ *      4. @p d is zero.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the quotient doesn't fit in @p q_count words, in which case
+ *        @p q holds its low @p q_count words.
+ *
+ * @param[in] x (uint8_t*): The first word of the dividend in memory.
+ * @param[in] d (uint8_t*): The first word of the divisor in memory.
+ * @param[out] q (uint8_t*): The first word of the quotient in memory. May be
+ * NULL if only the remainder is wanted.
+ * @param[out] r (uint8_t*): The first word of the remainder in memory. May be
+ * NULL if only the quotient is wanted. The remainder always fits in @p d_count
+ * words.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_count (size_t): Words in @p x.
+ * @param[in] d_count (size_t): Words in @p d.
+ * @param[in] q_count (size_t): Words in @p q.
+ * @param[in] r_count (size_t): Words in @p r.
+ * @param[in] layout (jl_layout*): How the words and their bytes are ordered.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t divrem_layout(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                      uint8_t *r, uint8_t *flags, size_t x_count,
+                      size_t d_count, size_t q_count, size_t r_count,
+                      const jl_layout *layout) {
+  // Error check 1.
+  if (x == NULL | d == NULL | flags == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  const size_t size = layout->size;
+  const size_t x_cap = limbs_for_bytes(x_count * size);
+  const size_t d_cap = limbs_for_bytes(d_count * size);
+
+  jl_limb_t stack[JL_LAYOUT_STACK_LIMBS];
+  jl_limb_t *buf = layout_buf(stack, x_cap + d_cap);
+  if (buf == NULL)
+    return 2;
+
+  jl_limb_t *xl = buf;
+  jl_limb_t *dl = xl + x_cap;
+  layout_to_limbs(xl, x_cap, x, x_count, layout);
+  layout_to_limbs(dl, d_cap, d, d_count, layout);
+  const size_t x_n = trim_limbs(xl, x_cap);
+  const size_t d_n = trim_limbs(dl, d_cap);
+
+  uint8_t rc = 0;
+  *flags = 0;
+  if (d_n == 0) {
+    // Error check 4.
+    rc = 4;
+  } else if (x_n < d_n) {
+    if (q != NULL)
+      limbs_to_layout(q, q_count, xl, 0, layout);
+    if (r != NULL)
+      limbs_to_layout(r, r_count, xl, x_n, layout);
+  } else {
+    const size_t q_n = x_n - d_n + 1;
+    const size_t total = q_n + d_n + divrem_limbs_itch(x_n, d_n);
+    jl_limb_t work_stack[JL_LAYOUT_STACK_LIMBS];
+    jl_limb_t *ql = layout_buf(work_stack, total);
+    if (ql == NULL) {
+      rc = 2;
+    } else {
+      jl_limb_t *rl = ql + q_n;
+      divrem_limbs(ql, rl, xl, x_n, dl, d_n, rl + d_n);
+      if (q != NULL) {
+        limbs_to_layout(q, q_count, ql, q_n, layout);
+        *flags = !fits_bytes(ql, q_n, q_count * size);
+      }
+      if (r != NULL)
+        limbs_to_layout(r, r_count, rl, d_n, layout);
+      if (ql != work_stack)
+        free(ql);
+    }
+  }
+
+  if (buf != stack)
+    free(buf);
+
+  return rc;
+}
+
+/**
+ * @brief Sets @p z to the magnitude in the @p count words of @p x, laid out as
+ * @p layout says, negated if @p neg is nonzero. As mpz_import, without nails.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z, @p x, or @p layout is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p layout is invalid (see layout_check).
+ *
+ * @param[out] z (jl_int*): The result.
+ * @param[in] x (uint8_t*): The first word of @p x in memory.
+ * @param[in] neg (uint8_t): Nonzero for a negative result.
+ * @param[in] count (size_t): Words in @p x.
+ * @param[in] layout (jl_layout*): How the words and their bytes are ordered.
+ */
+uint8_t int_import(jl_int *z, const uint8_t *x, uint8_t neg, size_t count,
+                   const jl_layout *layout) {
+  // Error check 1.
+  if (z == NULL | x == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  const size_t n = limbs_for_bytes(count * layout->size);
+  if (int_reserve(z, n))
+    return 2;
+
+  layout_to_limbs(int_limbs(z), n, x, count, layout);
+  z->n = n;
+  z->neg = neg != 0;
+  int_normalize(z);
+
+  return 0;
+}
+
+/**
+ * @return (size_t): The number of @p layout words needed to hold the magnitude
+ * of @p x. 0 for zero.
+ */
+size_t int_export_count(const jl_int *x, const jl_layout *layout) {
+  return layout_count(layout, int_bstring_size(x));
+}
+
+/**
+ * @brief Writes the magnitude of @p x to the @p count words of @p z, laid out
+ * as @p layout says, zero-padded or truncated. As mpz_export, without nails,
+ * into a buffer of int_export_count words.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, @p flags, or @p layout is NULL.
+ *      3. @p layout is invalid (see layout_check).
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the magnitude doesn't fit in @p count words, in which case @p
+ *        z holds its low @p count words.
+ *      1. Set if @p x is negative.
+ *
+ * @param[in] x (jl_int*): The value.
+ * @param[out] z (uint8_t*): The first word of @p z in memory.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] count (size_t): Words in @p z.
+ * @param[in] layout (jl_layout*): How the words and their bytes are ordered.
+ */
+uint8_t int_export(const jl_int *x, uint8_t *z, uint8_t *flags, size_t count,
+                   const jl_layout *layout) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL | layout == NULL)
+    return 1;
+
+  // Error check 3.
+  if (layout_check(layout) != 0)
+    return 3;
+
+  limbs_to_layout(z, count, int_limbs(x), x->n, layout);
+  *flags = (int_export_count(x, layout) > count) | x->neg << 1;
+
+  return 0;
+}
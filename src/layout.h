@@ -0,0 +1,74 @@
+#ifndef __JL_LAYOUT_H__
+#define __JL_LAYOUT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "jl_int.h"
+#include "limb.h"
+
+/**
+ * @brief How an integer is laid out in memory, as with GMP's mpz_import and
+ * mpz_export: an array of words, each @p size bytes, @p stride bytes apart.
+ *
+ *  - order: 1 if the most significant word comes first, -1 if the least
+ *    significant one does.
+ *  - endian: 1 for big-endian bytes within each word, -1 for little-endian, 0
+ *    for the host's order.
+ *  - size: Bytes in each word, at least 1.
+ *  - stride: Bytes from the start of one word to the start of the next, 0 for
+ *    @p size. Any bytes in between are neither read nor written.
+ *
+ * The bstring functions take little-endian byte strings, which are {-1, -1, 1,
+ * 0}; big-endian ones, as on the wire, are {1, 1, 1, 0}.
+ */
+typedef struct {
+  int order;
+  int endian;
+  size_t size;
+  size_t stride;
+} jl_layout;
+
+// Operand sizes, in limbs, up to which the layout operations keep their
+// temporaries on the stack.
+#define JL_LAYOUT_STACK_LIMBS 64
+
+extern const jl_layout jl_layout_le;
+
+extern const jl_layout jl_layout_be;
+
+uint8_t layout_check(const jl_layout *layout);
+
+size_t layout_count(const jl_layout *layout, size_t bytes);
+
+void layout_to_limbs(jl_limb_t *z, size_t n, const uint8_t *x, size_t count,
+                     const jl_layout *layout);
+
+void limbs_to_layout(uint8_t *z, size_t count, const jl_limb_t *x, size_t n,
+                     const jl_layout *layout);
+
+uint8_t add_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout);
+
+uint8_t sub_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout);
+
+uint8_t mul_layout(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                   uint8_t *flags, size_t x_count, size_t y_count,
+                   size_t z_count, const jl_layout *layout);
+
+uint8_t divrem_layout(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                      uint8_t *r, uint8_t *flags, size_t x_count,
+                      size_t d_count, size_t q_count, size_t r_count,
+                      const jl_layout *layout);
+
+uint8_t int_import(jl_int *z, const uint8_t *x, uint8_t neg, size_t count,
+                   const jl_layout *layout);
+
+size_t int_export_count(const jl_int *x, const jl_layout *layout);
+
+uint8_t int_export(const jl_int *x, uint8_t *z, uint8_t *flags, size_t count,
+                   const jl_layout *layout);
+#endif
@@ -0,0 +1,215 @@
+#ifndef __JL_LIMB_H__
+#define __JL_LIMB_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief A machine word. Byte strings are processed one limb at a time where
+ * possible, and the multi-step algorithms work on arrays of limbs ordered by
+ * increasing significance.
+ */
+typedef uint64_t jl_limb_t;
+
+#define JL_LIMB_BYTES 8
+#define JL_LIMB_BITS 64
+
+#ifdef __has_builtin
+#define JL_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#define JL_HAS_BUILTIN(x) 0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define JL_BIG_ENDIAN_HOST 1
+#else
+#define JL_BIG_ENDIAN_HOST 0
+#endif
+
+/**
+ * @brief Read @p n <= 8 little-endian bytes starting at @p p into the low
+ * bytes of a limb. @p p needn't be aligned.
+ */
+static inline jl_limb_t load_limb_partial(const uint8_t *p, size_t n) {
+  jl_limb_t v = 0;
+#if JL_BIG_ENDIAN_HOST
+  for (size_t i = 0; i < n; i++)
+    v |= (jl_limb_t)p[i] << (8 * i);
+#else
+  memcpy(&v, p, n);
+#endif
+  return v;
+}
+
+/**
+ * @brief Write the low @p n <= 8 bytes of @p v to @p p in little-endian order.
+ * @p p needn't be aligned.
+ */
+static inline void store_limb_partial(uint8_t *p, jl_limb_t v, size_t n) {
+#if JL_BIG_ENDIAN_HOST
+  for (size_t i = 0; i < n; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+#else
+  memcpy(p, &v, n);
+#endif
+}
+
+static inline jl_limb_t load_limb(const uint8_t *p) {
+  return load_limb_partial(p, JL_LIMB_BYTES);
+}
+
+static inline void store_limb(uint8_t *p, jl_limb_t v) {
+  store_limb_partial(p, v, JL_LIMB_BYTES);
+}
+
+/**
+ * @brief Reverses the bytes of @p x.
+ */
+static inline jl_limb_t bswap_limb(jl_limb_t x) {
+#if JL_HAS_BUILTIN(__builtin_bswap64) || defined(__GNUC__)
+  return __builtin_bswap64(x);
+#else
+  x = (x & 0x00FF00FF00FF00FFull) << 8 | (x >> 8 & 0x00FF00FF00FF00FFull);
+  x = (x & 0x0000FFFF0000FFFFull) << 16 | (x >> 16 & 0x0000FFFF0000FFFFull);
+  return x << 32 | x >> 32;
+#endif
+}
+
+/**
+ * @brief Returns @p x + @p y + @p c_in mod 2^64, and sets @p c_out to the
+ * carry. @p c_in must be one or zero.
+ */
+static inline jl_limb_t addc_limb(jl_limb_t x, jl_limb_t y, jl_limb_t c_in,
+                                  jl_limb_t *c_out) {
+#if JL_HAS_BUILTIN(__builtin_addcll)
+  unsigned long long c;
+  jl_limb_t s = __builtin_addcll(x, y, c_in, &c);
+  *c_out = c;
+  return s;
+#elif defined(__SIZEOF_INT128__)
+  unsigned __int128 s = (unsigned __int128)x + y + c_in;
+  *c_out = (jl_limb_t)(s >> 64);
+  return (jl_limb_t)s;
+#else
+  jl_limb_t s = x + y;
+  jl_limb_t c = s < x;
+  s += c_in;
+  *c_out = c | (s < c_in);
+  return s;
+#endif
+}
+
+/**
+ * @brief Returns @p x - @p y - @p b_in mod 2^64, and sets @p b_out to the
+ * borrow. @p b_in must be one or zero.
+ */
+static inline jl_limb_t subb_limb(jl_limb_t x, jl_limb_t y, jl_limb_t b_in,
+                                  jl_limb_t *b_out) {
+#if JL_HAS_BUILTIN(__builtin_subcll)
+  unsigned long long b;
+  jl_limb_t d = __builtin_subcll(x, y, b_in, &b);
+  *b_out = b;
+  return d;
+#elif defined(__SIZEOF_INT128__)
+  unsigned __int128 d = (unsigned __int128)x - y - b_in;
+  *b_out = (jl_limb_t)(d >> 64) & 1;
+  return (jl_limb_t)d;
+#else
+  jl_limb_t d = x - y;
+  jl_limb_t b = x < y;
+  *b_out = b | (d < b_in);
+  return d - b_in;
+#endif
+}
+
+/**
+ * @brief Returns the low limb of @p x * @p y, and sets @p hi to the high limb.
+ */
+static inline jl_limb_t mul_limb(jl_limb_t x, jl_limb_t y, jl_limb_t *hi) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 p = (unsigned __int128)x * y;
+  *hi = (jl_limb_t)(p >> 64);
+  return (jl_limb_t)p;
+#else
+  const jl_limb_t x0 = x & 0xFFFFFFFF, x1 = x >> 32;
+  const jl_limb_t y0 = y & 0xFFFFFFFF, y1 = y >> 32;
+  const jl_limb_t p00 = x0 * y0, p01 = x0 * y1;
+  const jl_limb_t p10 = x1 * y0, p11 = x1 * y1;
+  // Middle column, can't overflow: (2^32 - 1) + 2 * (2^32 - 1)^2 < 2^64.
+  const jl_limb_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+  *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+  return (mid << 32) | (p00 & 0xFFFFFFFF);
+#endif
+}
+
+/**
+ * @brief Number of leading zero bits in @p x. @p x must be nonzero.
+ */
+static inline unsigned clz_limb(jl_limb_t x) {
+#if JL_HAS_BUILTIN(__builtin_clzll) || defined(__GNUC__)
+  return (unsigned)__builtin_clzll(x);
+#else
+  unsigned n = 0;
+  for (; !(x >> (JL_LIMB_BITS - 1)); x <<= 1)
+    n++;
+  return n;
+#endif
+}
+
+/**
+ * @brief Number of trailing zero bits in @p x. @p x must be nonzero.
+ */
+static inline unsigned ctz_limb(jl_limb_t x) {
+#if JL_HAS_BUILTIN(__builtin_ctzll) || defined(__GNUC__)
+  return (unsigned)__builtin_ctzll(x);
+#else
+  unsigned n = 0;
+  for (; !(x & 1); x >>= 1)
+    n++;
+  return n;
+#endif
+}
+
+/**
+ * @brief Unpack the little-endian byte string @p x into @p n limbs, padding
+ * with zeros past @p x_size bytes.
+ */
+static inline void bytes_to_limbs(jl_limb_t *z, size_t n, const uint8_t *x,
+                                  size_t x_size) {
+  size_t i = 0;
+  for (; i < n && (i + 1) * JL_LIMB_BYTES <= x_size; i++)
+    z[i] = load_limb(x + i * JL_LIMB_BYTES);
+  if (i < n && i * JL_LIMB_BYTES < x_size) {
+    z[i] = load_limb_partial(x + i * JL_LIMB_BYTES, x_size - i * JL_LIMB_BYTES);
+    i++;
+  }
+  for (; i < n; i++)
+    z[i] = 0;
+}
+
+/**
+ * @brief Pack @p n limbs into the little-endian byte string @p z, truncating
+ * or padding with zeros to exactly @p z_size bytes.
+ */
+static inline void limbs_to_bytes(uint8_t *z, size_t z_size, const jl_limb_t *x,
+                                  size_t n) {
+  size_t i = 0;
+  for (; i < n && (i + 1) * JL_LIMB_BYTES <= z_size; i++)
+    store_limb(z + i * JL_LIMB_BYTES, x[i]);
+  if (i < n && i * JL_LIMB_BYTES < z_size) {
+    store_limb_partial(z + i * JL_LIMB_BYTES, x[i], z_size - i * JL_LIMB_BYTES);
+    i++;
+  }
+  if (i * JL_LIMB_BYTES < z_size)
+    memset(z + i * JL_LIMB_BYTES, 0, z_size - i * JL_LIMB_BYTES);
+}
+
+/**
+ * @brief Number of limbs needed to hold @p size bytes.
+ */
+static inline size_t limbs_for_bytes(size_t size) {
+  return (size + JL_LIMB_BYTES - 1) / JL_LIMB_BYTES;
+}
+
+#endif
@@ -0,0 +1,383 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "div.h"
+#include "limb.h"
+#include "mont.h"
+#include "perf.h"
+
+/*
+ * Montgomery arithmetic.
+ *
+ * With R = B^n > N, a residue a is held as a R mod N, and the Montgomery
+ * product of a R and b R is a b R: the full product divided by R mod N. The
+ * division is exact once a multiple of N is added that clears the low n
+ * limbs, and that multiple is found one limb at a time from -N^-1 mod B. So
+ * a modular multiplication costs two n by n products and no division.
+ */
+
+// Workspace layout, in limbs, for a modulus of n limbs.
+static size_t mont_kernel_itch(size_t n) {
+  return 2 * n + 1 + mul_limbs_itch(n, n);
+}
+
+static size_t mont_powm_itch(size_t n) {
+  const size_t table = ((size_t)1 << (JL_POWM_MAX_WINDOW - 1)) * n;
+  const size_t reduce = 2 * n + (n + 1) + n + divrem_limbs_itch(2 * n, n);
+
+  return table + 2 * n + reduce;
+}
+
+// z = t R^-1 mod N, for t < N R of 2 n limbs. Clobbers t.
+static void redc(jl_limb_t *z, jl_limb_t *t, const jl_limb_t *mod, size_t n,
+                 jl_limb_t ninv) {
+  // Each step clears t[i], which then holds the step's carry out instead.
+  for (size_t i = 0; i < n; i++)
+    t[i] = addmul_1(t + i, mod, n, t[i] * ninv);
+
+  // The sum is below 2 N, so one subtraction is enough.
+  const jl_limb_t carry = add_n(z, t + n, t, n);
+  if (carry || cmp_n(z, mod, n) >= 0)
+    sub_n(z, z, mod, n);
+}
+
+// z = x y R^-1 mod N, for x, y < N, in one pass (CIOS, with the
+// multiplication and reduction rows fused). t holds n + 1 limbs.
+static void mont_mul_cios(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                          const jl_limb_t *mod, size_t n, jl_limb_t ninv,
+                          jl_limb_t *t) {
+  memset(t, 0, (n + 1) * sizeof(jl_limb_t));
+
+  for (size_t i = 0; i < n; i++) {
+    // t = (t + x_i y + m N) / B, where m makes the sum divisible by B.
+    const jl_limb_t xi = x[i];
+    jl_limb_t hi, lo;
+
+    lo = mul_limb(xi, y[0], &hi);
+    jl_limb_t s = t[0] + lo;
+    jl_limb_t c1 = hi + (s < lo);
+    const jl_limb_t m = s * ninv;
+    lo = mul_limb(m, mod[0], &hi);
+    jl_limb_t c2 = hi + (s + lo < lo);
+
+    for (size_t j = 1; j < n; j++) {
+      lo = mul_limb(xi, y[j], &hi);
+      lo += c1;
+      hi += lo < c1;
+      s = t[j] + lo;
+      c1 = hi + (s < lo);
+
+      lo = mul_limb(m, mod[j], &hi);
+      lo += c2;
+      hi += lo < c2;
+      s += lo;
+      c2 = hi + (s < lo);
+
+      t[j - 1] = s;
+    }
+
+    // t < 2 N throughout, so the top is a single bit.
+    s = t[n] + c1;
+    jl_limb_t top = s < c1;
+    s += c2;
+    top += s < c2;
+    t[n - 1] = s;
+    t[n] = top;
+  }
+
+  if (t[n] || cmp_n(t, mod, n) >= 0)
+    sub_n(z, t, mod, n);
+  else
+    memcpy(z, t, n * sizeof(jl_limb_t));
+}
+
+/**
+ * @brief Stores the Montgomery product x y R^-1 mod N in @p z, for @p x, @p y
+ * < N of ctx->n limbs. Below JL_MONT_REDC_THRESHOLD limbs this is a single
+ * fused multiply-reduce pass; above it, mul_limbs followed by a reduction.
+ *
+ * @p z may equal @p x or @p y.
+ */
+void mont_mul_limbs(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                    jl_mont_ctx *ctx) {
+  const size_t n = ctx->n;
+  jl_limb_t *t = ctx->work;
+
+  if (n < JL_MONT_REDC_THRESHOLD) {
+    mont_mul_cios(z, x, y, ctx->mod, n, ctx->ninv, t);
+    return;
+  }
+
+  mul_limbs(t, x, n, y, n, t + 2 * n + 1);
+  redc(z, t, ctx->mod, n, ctx->ninv);
+}
+
+/**
+ * @brief Stores x^2 R^-1 mod N in @p z, for @p x < N of ctx->n limbs. Like
+ * mont_mul_limbs, but through sqr_limbs above JL_MONT_REDC_THRESHOLD limbs.
+ *
+ * @p z may equal @p x.
+ */
+void mont_sqr_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx) {
+  const size_t n = ctx->n;
+  jl_limb_t *t = ctx->work;
+
+  if (n < JL_MONT_REDC_THRESHOLD) {
+    mont_mul_cios(z, x, x, ctx->mod, n, ctx->ninv, t);
+    return;
+  }
+
+  sqr_limbs(t, x, n, t + 2 * n + 1);
+  redc(z, t, ctx->mod, n, ctx->ninv);
+}
+
+/**
+ * @brief Converts @p x < N into Montgomery form, x R mod N.
+ */
+void mont_to_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx) {
+  mont_mul_limbs(z, x, ctx->r2, ctx);
+}
+
+/**
+ * @brief Converts @p x out of Montgomery form, x R^-1 mod N.
+ */
+void mont_from_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx) {
+  const size_t n = ctx->n;
+  jl_limb_t *t = ctx->work;
+
+  memcpy(t, x, n * sizeof(jl_limb_t));
+  memset(t + n, 0, n * sizeof(jl_limb_t));
+  redc(z, t, ctx->mod, n, ctx->ninv);
+}
+
+/**
+ * @brief Sets up @p ctx for arithmetic mod @p mod: computes R mod N, R^2 mod N
+ * and -N^-1 mod B, and allocates all the scratch later calls need. Release it
+ * with mont_ctx_free.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p ctx or @p mod is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p mod is even or zero.
+ *
+ * @param[out] ctx (jl_mont_ctx*): The context to fill in.
+ * @param[in] mod (uint8_t*): The modulus N, little-endian.
+ * @param mod_size[in] (size_t): Size of @p mod.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t mont_ctx_init(jl_mont_ctx *ctx, const uint8_t *mod, size_t mod_size) {
+  // Error check 1.
+  if (ctx == NULL | mod == NULL)
+    return 1;
+
+  while (mod_size > 0 && mod[mod_size - 1] == 0)
+    mod_size--;
+
+  // Error check 3.
+  if (mod_size == 0 || !(mod[0] & 1))
+    return 3;
+
+  const size_t n = limbs_for_bytes(mod_size);
+  const size_t work = mont_kernel_itch(n) + mont_powm_itch(n);
+  // R^2 mod N is B^2n divided by N, which needs its own buffers once.
+  const size_t setup = (2 * n + 1) + (n + 2) + divrem_limbs_itch(2 * n + 1, n);
+  const size_t total = 3 * n + (work > setup ? work : setup);
+
+  jl_limb_t *buf = malloc(total * sizeof(jl_limb_t));
+  if (buf == NULL)
+    return 2;
+
+  ctx->n = n;
+  ctx->scratch = buf;
+  ctx->mod = buf;
+  ctx->r1 = ctx->mod + n;
+  ctx->r2 = ctx->r1 + n;
+  ctx->work = ctx->r2 + n;
+  bytes_to_limbs(ctx->mod, n, mod, mod_size);
+
+  // N is its own inverse mod 8; each Newton step doubles the correct bits.
+  jl_limb_t inv = ctx->mod[0];
+  for (int i = 0; i < 5; i++)
+    inv *= 2 - ctx->mod[0] * inv;
+  ctx->ninv = -inv;
+
+  jl_limb_t *b2n = ctx->work;
+  jl_limb_t *q = b2n + 2 * n + 1;
+  memset(b2n, 0, 2 * n * sizeof(jl_limb_t));
+  b2n[2 * n] = 1;
+  divrem_limbs(q, ctx->r2, b2n, 2 * n + 1, ctx->mod, n, q + n + 2);
+
+  // R mod N = R^2 R^-1 mod N.
+  mont_from_limbs(ctx->r1, ctx->r2, ctx);
+
+  return 0;
+}
+
+/**
+ * @brief Releases what mont_ctx_init allocated. @p ctx may then be
+ * initialized again.
+ */
+void mont_ctx_free(jl_mont_ctx *ctx) {
+  if (ctx == NULL)
+    return;
+
+  free(ctx->scratch);
+  ctx->scratch = NULL;
+  ctx->mod = ctx->r1 = ctx->r2 = ctx->work = NULL;
+  ctx->n = 0;
+}
+
+// Bit i of the little-endian byte string e.
+static inline unsigned exp_bit(const uint8_t *e, size_t i) {
+  return (e[i / 8] >> (i % 8)) & 1;
+}
+
+// Window size for an exponent of the given number of bits, balancing the
+// 2^(k - 1) table entries against about bits / (k + 1) multiplications.
+static unsigned powm_window(size_t bits) {
+  static const size_t limits[JL_POWM_MAX_WINDOW - 1] = {7, 25, 81, 241, 673};
+  unsigned k = 1;
+  while (k < JL_POWM_MAX_WINDOW && bits > limits[k - 1])
+    k++;
+
+  return k;
+}
+
+// z = x mod N for a little-endian byte string x of any length, n limbs at a
+// time from the top, using only the context's workspace.
+static void powm_reduce(jl_limb_t *z, const uint8_t *x, size_t x_size,
+                        jl_mont_ctx *ctx, jl_limb_t *buf) {
+  const size_t n = ctx->n;
+  const size_t chunk = n * JL_LIMB_BYTES;
+  jl_limb_t *q = buf + 2 * n;
+  jl_limb_t *scratch = q + n + 1;
+
+  memset(z, 0, n * sizeof(jl_limb_t));
+  size_t off = x_size - x_size % chunk;
+  size_t len = x_size % chunk;
+  if (len == 0 && x_size > 0) {
+    off -= chunk;
+    len = chunk;
+  }
+  for (;;) {
+    // buf = z B^n + x[off, off + len), and z < N, so z = buf mod N fits.
+    bytes_to_limbs(buf, n, x + off, len);
+    memcpy(buf + n, z, n * sizeof(jl_limb_t));
+    divrem_limbs(q, z, buf, 2 * n, ctx->mod, n, scratch);
+    if (off == 0)
+      break;
+    off -= chunk;
+    len = chunk;
+  }
+}
+
+static uint8_t powm_bstrings_nocheck(jl_mont_ctx *ctx, const uint8_t *x,
+                                     const uint8_t *e, uint8_t *z,
+                                     size_t x_size, size_t e_size,
+                                     size_t z_size) {
+  const size_t n = ctx->n;
+  jl_limb_t *table = ctx->work + mont_kernel_itch(n);
+  jl_limb_t *acc = table + ((size_t)1 << (JL_POWM_MAX_WINDOW - 1)) * n;
+  jl_limb_t *x2 = acc + n;
+  jl_limb_t *reduce = x2 + n;
+
+  while (e_size > 0 && e[e_size - 1] == 0)
+    e_size--;
+  size_t bits = 8 * e_size;
+  while (bits > 0 && !exp_bit(e, bits - 1))
+    bits--;
+
+  if (bits == 0) {
+    mont_from_limbs(acc, ctx->r1, ctx);
+    limbs_to_bytes(z, z_size, acc, n);
+    return 0;
+  }
+
+  // table[i] = x^(2i + 1), in Montgomery form.
+  const unsigned k = powm_window(bits);
+  powm_reduce(acc, x, x_size, ctx, reduce);
+  mont_to_limbs(table, acc, ctx);
+  if (k > 1) {
+    mont_sqr_limbs(x2, table, ctx);
+    for (size_t i = 1; i < ((size_t)1 << (k - 1)); i++)
+      mont_mul_limbs(table + i * n, table + (i - 1) * n, x2, ctx);
+  }
+
+  // The top bit is set, so the first window starts the accumulator.
+  int started = 0;
+  size_t i = bits;
+  while (i > 0) {
+    if (!exp_bit(e, i - 1)) {
+      mont_sqr_limbs(acc, acc, ctx);
+      i--;
+      continue;
+    }
+
+    // The window is bits [j, i), trimmed so bit j is set.
+    size_t j = i > k ? i - k : 0;
+    while (!exp_bit(e, j))
+      j++;
+    size_t w = 0;
+    for (size_t b = i; b > j; b--)
+      w = (w << 1) | exp_bit(e, b - 1);
+
+    if (started) {
+      for (size_t b = j; b < i; b++)
+        mont_sqr_limbs(acc, acc, ctx);
+      mont_mul_limbs(acc, acc, table + (w >> 1) * n, ctx);
+    } else {
+      memcpy(acc, table + (w >> 1) * n, n * sizeof(jl_limb_t));
+      started = 1;
+    }
+    i = j;
+  }
+
+  mont_from_limbs(acc, acc, ctx);
+  limbs_to_bytes(z, z_size, acc, n);
+
+  return 0;
+}
+
+/**
+ * @brief Computes x^e mod N, for the modulus N of @p ctx, and stores it in @p
+ * z. Uses left-to-right sliding windows over Montgomery products, with the
+ * window size picked from the length of @p e. Nothing is allocated; all the
+ * space comes from @p ctx.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p ctx, @p x, @p e, @p z, or @p flags is NULL.
+ *
+ * @param[in] ctx (jl_mont_ctx*): A context from mont_ctx_init.
+ * @param[in] x (uint8_t*): The base, little-endian, of any size.
+ * @param[in] e (uint8_t*): The exponent, little-endian. x^0 is 1 mod N.
+ * @param[out] z (uint8_t*): The result, little-endian, truncated or zero-padded
+ * to @p z_size bytes. Anything the size of N fits.
+ * @param[out] flags (uint8_t*): Reserved, always set to 0.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param e_size[in] (size_t): Size of @p e.
+ * @param z_size[in] (size_t): Size of @p z.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t powm_bstrings(jl_mont_ctx *ctx, const uint8_t *x, const uint8_t *e,
+                      uint8_t *z, uint8_t *flags, size_t x_size, size_t e_size,
+                      size_t z_size) {
+  // Error check 1.
+  if (ctx == NULL | x == NULL | e == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  *flags = 0;
+
+  JL_PERF_BEGIN(JL_PERF_POWM, ctx->n * sizeof(jl_limb_t));
+  const uint8_t rc =
+      powm_bstrings_nocheck(ctx, x, e, z, x_size, e_size, z_size);
+  JL_PERF_END();
+
+  return rc;
+}
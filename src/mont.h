@@ -0,0 +1,54 @@
+#ifndef __JL_MONT_H__
+#define __JL_MONT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Moduli of at least this many limbs multiply through mul_limbs and a
+// separate reduction instead of the fused CIOS kernel.
+#ifndef JL_MONT_REDC_THRESHOLD
+#define JL_MONT_REDC_THRESHOLD 192
+#endif
+
+// Largest sliding window powm uses. The context reserves room for the
+// 2^(JL_POWM_MAX_WINDOW - 1) odd powers that needs.
+#define JL_POWM_MAX_WINDOW 6
+
+/**
+ * @brief Everything Montgomery arithmetic needs for one odd modulus N,
+ * computed once by mont_ctx_init: R = B^n, R^2 mod N, -N^-1 mod B, and all the
+ * scratch space mont_mul_limbs, mont_sqr_limbs and powm_bstrings use, so none
+ * of them allocate.
+ *
+ * The scratch makes a context unsafe to share between threads.
+ */
+typedef struct {
+  size_t n;           // Limbs in N.
+  jl_limb_t *mod;     // N.
+  jl_limb_t *r1;      // R mod N, i.e. 1 in Montgomery form.
+  jl_limb_t *r2;      // R^2 mod N.
+  jl_limb_t ninv;     // -N^-1 mod B.
+  jl_limb_t *scratch; // One allocation holding everything above and the
+                      // workspace.
+  jl_limb_t *work;    // The workspace.
+} jl_mont_ctx;
+
+uint8_t mont_ctx_init(jl_mont_ctx *ctx, const uint8_t *mod, size_t mod_size);
+
+void mont_ctx_free(jl_mont_ctx *ctx);
+
+void mont_mul_limbs(jl_limb_t *z, const jl_limb_t *x, const jl_limb_t *y,
+                    jl_mont_ctx *ctx);
+
+void mont_sqr_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx);
+
+void mont_to_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx);
+
+void mont_from_limbs(jl_limb_t *z, const jl_limb_t *x, jl_mont_ctx *ctx);
+
+uint8_t powm_bstrings(jl_mont_ctx *ctx, const uint8_t *x, const uint8_t *e,
+                      uint8_t *z, uint8_t *flags, size_t x_size, size_t e_size,
+                      size_t z_size);
+#endif
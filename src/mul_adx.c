@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "limb.h"
+#include "mul_adx.h"
+
+#if JL_HAVE_ADX_ASM
+
+/*
+ * Row kernels for CPUs with BMI2 and ADX. MULX multiplies without touching the
+ * flags, and ADCX and ADOX add with carry through CF and OF only, so addmul_1
+ * keeps two independent carry chains in flight: OF carries each product's high
+ * limb into the next low limb, and CF carries the sum into z.
+ *
+ * The loop counters move with LEA and test with JRCXZ, neither of which
+ * touches the flags, so both chains survive the loop. Limbs are indexed from
+ * the end with a negative index; n % 4 of them go one at a time, the rest four
+ * at a time. Only call these after cpu_features() has reported JL_CPU_BMI2 and
+ * JL_CPU_ADX.
+ */
+
+/**
+ * @brief mul_1 for BMI2/ADX CPUs. Same contract as mul_1.
+ */
+jl_limb_t mul_1_adx(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y) {
+  jl_limb_t lo, hi, carry = 0;
+  intptr_t i = -(intptr_t)n;
+  intptr_t rem = -(intptr_t)(n & 3);
+  const intptr_t blocks = -(intptr_t)(n >> 2);
+  z += n;
+  x += n;
+
+  __asm__("xor %k[lo], %k[lo]\n\t" // Clear CF.
+          "jrcxz 3f\n"
+          "1:\n\t"
+          "mulx (%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adcx %[c], %[lo]\n\t"
+          "mov %[lo], (%[z],%[i],8)\n\t"
+          "mov %[hi], %[c]\n\t"
+          "lea 1(%[i]), %[i]\n\t"
+          "lea 1(%%rcx), %%rcx\n\t"
+          "jrcxz 3f\n\t"
+          "jmp 1b\n"
+          "3:\n\t"
+          "mov %[blocks], %%rcx\n\t"
+          "jrcxz 5f\n"
+          "4:\n\t"
+          "mulx (%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adcx %[c], %[lo]\n\t"
+          "mov %[lo], (%[z],%[i],8)\n\t"
+          "mulx 8(%[x],%[i],8), %[lo], %[c]\n\t"
+          "adcx %[hi], %[lo]\n\t"
+          "mov %[lo], 8(%[z],%[i],8)\n\t"
+          "mulx 16(%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adcx %[c], %[lo]\n\t"
+          "mov %[lo], 16(%[z],%[i],8)\n\t"
+          "mulx 24(%[x],%[i],8), %[lo], %[c]\n\t"
+          "adcx %[hi], %[lo]\n\t"
+          "mov %[lo], 24(%[z],%[i],8)\n\t"
+          "lea 4(%[i]), %[i]\n\t"
+          "lea 1(%%rcx), %%rcx\n\t"
+          "jrcxz 5f\n\t"
+          "jmp 4b\n"
+          "5:\n\t"
+          "mov $0, %k[lo]\n\t"
+          "adcx %[lo], %[c]\n\t"
+          : [lo] "=&r"(lo), [hi] "=&r"(hi), [c] "+&r"(carry), [i] "+&r"(i),
+            "+c"(rem)
+          : [x] "r"(x), [z] "r"(z), [blocks] "r"(blocks), "d"(y)
+          : "cc", "memory");
+
+  return carry;
+}
+
+/**
+ * @brief addmul_1 for BMI2/ADX CPUs. Same contract as addmul_1.
+ */
+jl_limb_t addmul_1_adx(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                       jl_limb_t y) {
+  jl_limb_t lo, hi, carry = 0;
+  intptr_t i = -(intptr_t)n;
+  intptr_t rem = -(intptr_t)(n & 3);
+  const intptr_t blocks = -(intptr_t)(n >> 2);
+  z += n;
+  x += n;
+
+  __asm__("xor %k[lo], %k[lo]\n\t" // Clear CF and OF.
+          "jrcxz 3f\n"
+          "1:\n\t"
+          "mulx (%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adox %[c], %[lo]\n\t"
+          "adcx (%[z],%[i],8), %[lo]\n\t"
+          "mov %[lo], (%[z],%[i],8)\n\t"
+          "mov %[hi], %[c]\n\t"
+          "lea 1(%[i]), %[i]\n\t"
+          "lea 1(%%rcx), %%rcx\n\t"
+          "jrcxz 3f\n\t"
+          "jmp 1b\n"
+          "3:\n\t"
+          "mov %[blocks], %%rcx\n\t"
+          "jrcxz 5f\n"
+          "4:\n\t"
+          "mulx (%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adox %[c], %[lo]\n\t"
+          "adcx (%[z],%[i],8), %[lo]\n\t"
+          "mov %[lo], (%[z],%[i],8)\n\t"
+          "mulx 8(%[x],%[i],8), %[lo], %[c]\n\t"
+          "adox %[hi], %[lo]\n\t"
+          "adcx 8(%[z],%[i],8), %[lo]\n\t"
+          "mov %[lo], 8(%[z],%[i],8)\n\t"
+          "mulx 16(%[x],%[i],8), %[lo], %[hi]\n\t"
+          "adox %[c], %[lo]\n\t"
+          "adcx 16(%[z],%[i],8), %[lo]\n\t"
+          "mov %[lo], 16(%[z],%[i],8)\n\t"
+          "mulx 24(%[x],%[i],8), %[lo], %[c]\n\t"
+          "adox %[hi], %[lo]\n\t"
+          "adcx 24(%[z],%[i],8), %[lo]\n\t"
+          "mov %[lo], 24(%[z],%[i],8)\n\t"
+          "lea 4(%[i]), %[i]\n\t"
+          "lea 1(%%rcx), %%rcx\n\t"
+          "jrcxz 5f\n\t"
+          "jmp 4b\n"
+          "5:\n\t"
+          "mov $0, %k[lo]\n\t"
+          "adox %[lo], %[c]\n\t"
+          "adcx %[lo], %[c]\n\t"
+          : [lo] "=&r"(lo), [hi] "=&r"(hi), [c] "+&r"(carry), [i] "+&r"(i),
+            "+c"(rem)
+          : [x] "r"(x), [z] "r"(z), [blocks] "r"(blocks), "d"(y)
+          : "cc", "memory");
+
+  return carry;
+}
+
+/**
+ * @brief mul_basecase for BMI2/ADX CPUs, calling the rows above directly.
+ * Same contract as mul_basecase.
+ */
+void mul_basecase_adx(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                      const jl_limb_t *y, size_t y_n) {
+  if (y_n == 0) {
+    memset(z, 0, x_n * sizeof(jl_limb_t));
+    return;
+  }
+
+  z[x_n] = mul_1_adx(z, x, x_n, y[0]);
+  for (size_t j = 1; j < y_n; j++)
+    z[x_n + j] = addmul_1_adx(z + j, x, x_n, y[j]);
+}
+
+#endif
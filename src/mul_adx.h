@@ -0,0 +1,27 @@
+#ifndef __JL_MUL_ADX_H__
+#define __JL_MUL_ADX_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// The BMI2/ADX kernels are GNU inline assembly, so they only exist on x86-64
+// with GCC or Clang. Define JL_NO_ASM to leave them out anyway.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) &&       \
+    !defined(JL_NO_ASM)
+#define JL_HAVE_ADX_ASM 1
+#else
+#define JL_HAVE_ADX_ASM 0
+#endif
+
+#if JL_HAVE_ADX_ASM
+jl_limb_t mul_1_adx(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t y);
+
+jl_limb_t addmul_1_adx(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                       jl_limb_t y);
+
+void mul_basecase_adx(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                      const jl_limb_t *y, size_t y_n);
+#endif
+#endif
@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "limb.h"
+#include "mul_par.h"
+#include "ntt.h"
+#include "pool.h"
+
+/*
+ * Products on the thread pool. Down to the grain, and at most
+ * JL_MUL_PAR_DEPTH levels deep, a balanced product is split as in Karatsuba
+ * into three half-size products that run as tasks, and an unbalanced one into
+ * two, by halving the longer operand. Below that each task is an ordinary
+ * mul_limbs. Products big enough for the NTT go to mul_ntt_par instead, which
+ * parallelizes the transforms rather than adding a Karatsuba level on top.
+ *
+ * Every task has its own slice of the scratch, so a node needs its own
+ * temporaries plus the sum of its children's needs. par_itch follows the same
+ * recursion, taking the larger of what a node needs split and as a leaf; that
+ * doesn't depend on the grain, the thresholds or the number of threads.
+ */
+
+static size_t mul_par_grain = JL_MUL_PAR_GRAIN;
+
+/**
+ * @brief Sets the operand size, in limbs, below which mul_limbs_par stops
+ * splitting products into tasks. Values below 2 are raised to 2. The
+ * build-time default is JL_MUL_PAR_GRAIN.
+ */
+void set_mul_par_grain(size_t n) { mul_par_grain = n < 2 ? 2 : n; }
+
+size_t get_mul_par_grain(void) { return mul_par_grain; }
+
+static size_t par_itch(size_t x_n, size_t y_n, unsigned depth) {
+  if (x_n < y_n) {
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  const int balanced = 2 * y_n > x_n + 1;
+  size_t itch = mul_limbs_itch(x_n, y_n);
+  if (balanced && y_n >= JL_MUL_NTT_MIN_LIMBS) {
+    const size_t ntt = mul_ntt_par_itch(x_n, y_n);
+    itch = ntt > itch ? ntt : itch;
+  }
+  if (depth == JL_MUL_PAR_DEPTH || y_n == 0 || x_n < 2)
+    return itch;
+
+  const size_t h = (x_n + 1) / 2;
+  size_t split;
+  if (balanced)
+    split = 4 * h + 2 * par_itch(h, h, depth + 1) +
+            par_itch(x_n - h, y_n - h, depth + 1);
+  else
+    split = x_n - h + y_n + par_itch(h, y_n, depth + 1) +
+            par_itch(x_n - h, y_n, depth + 1);
+
+  return split > itch ? split : itch;
+}
+
+typedef struct {
+  jl_limb_t *z;
+  const jl_limb_t *x;
+  size_t x_n;
+  const jl_limb_t *y;
+  size_t y_n;
+  jl_limb_t *scratch;
+  unsigned depth;
+} mul_par_args;
+
+static void mul_par_rec(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                        const jl_limb_t *y, size_t y_n, jl_limb_t *scratch,
+                        unsigned depth);
+
+static void mul_par_task(void *arg) {
+  const mul_par_args *a = arg;
+  mul_par_rec(a->z, a->x, a->x_n, a->y, a->y_n, a->scratch, a->depth);
+}
+
+// x_n >= y_n > ceil(x_n / 2). The same split as mul_karatsuba_balanced, with
+// x0 y0 and x1 y1 as tasks and the middle product on this thread.
+static void mul_par_karatsuba(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                              const jl_limb_t *y, size_t y_n,
+                              jl_limb_t *scratch, unsigned depth) {
+  const size_t h = (x_n + 1) / 2;
+  const size_t x1_n = x_n - h;
+  const size_t y1_n = y_n - h;
+
+  jl_limb_t *dx = scratch;
+  jl_limb_t *dy = dx + h;
+  jl_limb_t *t = dy + h;
+  jl_limb_t *s0 = t + 2 * h;
+  jl_limb_t *s1 = s0 + par_itch(h, h, depth + 1);
+  jl_limb_t *s2 = s1 + par_itch(h, h, depth + 1);
+
+  // Sign of (x0 - x1)(y0 - y1). A square's middle term is a square too.
+  int neg = abs_sub_n(dx, x, h, x + h, x1_n);
+  if (x == y && x_n == y_n) {
+    dy = dx;
+    neg = 0;
+  } else {
+    neg ^= abs_sub_n(dy, y, h, y + h, y1_n);
+  }
+
+  const mul_par_args lo = {z, x, h, y, h, s0, depth + 1};
+  const mul_par_args hi = {z + 2 * h, x + h, x1_n, y + h, y1_n, s2, depth + 1};
+  jl_task t_lo, t_hi;
+  pool_spawn(&t_lo, mul_par_task, (void *)&lo);
+  pool_spawn(&t_hi, mul_par_task, (void *)&hi);
+  mul_par_rec(t, dx, h, dy, h, s1, depth + 1);
+  pool_join(&t_hi);
+  pool_join(&t_lo);
+
+  karatsuba_combine(z, t, h, x_n + y_n, neg);
+}
+
+// x_n >= 2 y_n - 1. With x = x1 B^h + x0, x0 y goes straight into z as a task
+// and x1 y into scratch, which is then added in at B^h.
+static void mul_par_halves(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                           const jl_limb_t *y, size_t y_n, jl_limb_t *scratch,
+                           unsigned depth) {
+  const size_t h = (x_n + 1) / 2;
+  const size_t x1_n = x_n - h;
+
+  jl_limb_t *t = scratch;
+  jl_limb_t *s0 = t + x1_n + y_n;
+  jl_limb_t *s1 = s0 + par_itch(h, y_n, depth + 1);
+
+  const mul_par_args lo = {z, x, h, y, y_n, s0, depth + 1};
+  jl_task t_lo;
+  pool_spawn(&t_lo, mul_par_task, (void *)&lo);
+  mul_par_rec(t, x + h, x1_n, y, y_n, s1, depth + 1);
+  pool_join(&t_lo);
+
+  // z holds h + y_n limbs of x0 y; t fills in the rest.
+  jl_limb_t carry = add_n(z + h, z + h, t, y_n);
+  add_1(z + h + y_n, t + y_n, x1_n, carry);
+}
+
+static void mul_par_rec(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                        const jl_limb_t *y, size_t y_n, jl_limb_t *scratch,
+                        unsigned depth) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  const int balanced = 2 * y_n > x_n + 1;
+  if (balanced && y_n >= get_mul_ntt_threshold())
+    mul_ntt_par(z, x, x_n, y, y_n, scratch);
+  else if (depth == JL_MUL_PAR_DEPTH || y_n == 0 ||
+           (balanced ? y_n < mul_par_grain : x_n < 2 * mul_par_grain))
+    mul_limbs(z, x, x_n, y, y_n, scratch);
+  else if (balanced)
+    mul_par_karatsuba(z, x, x_n, y, y_n, scratch, depth);
+  else
+    mul_par_halves(z, x, x_n, y, y_n, scratch, depth);
+}
+
+/**
+ * @brief Number of scratch limbs mul_limbs_par needs for an @p x_n by @p y_n
+ * limb product. Larger than mul_limbs_itch, since tasks that run at the same
+ * time can't share scratch.
+ */
+size_t mul_limbs_par_itch(size_t x_n, size_t y_n) {
+  return par_itch(x_n, y_n, 0);
+}
+
+/**
+ * @brief mul_limbs spread over the thread pool (see set_pool_threads and
+ * set_mul_par_grain). Runs exactly as mul_limbs while the pool is stopped.
+ * Several threads may call this at once; they share the pool's threads rather
+ * than each adding their own.
+ *
+ * @p z may not overlap @p x, @p y or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_limbs_par_itch(@p x_n, @p
+ * y_n) limbs.
+ */
+void mul_limbs_par(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                   const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (get_pool_threads() <= 1)
+    mul_limbs(z, x, x_n, y, y_n, scratch);
+  else
+    mul_par_rec(z, x, x_n, y, y_n, scratch, 0);
+}
+
+/**
+ * @brief Number of scratch limbs sqr_limbs_par needs for an @p n limb square.
+ */
+size_t sqr_limbs_par_itch(size_t n) { return mul_limbs_par_itch(n, n); }
+
+/**
+ * @brief sqr_limbs spread over the thread pool. Same contract as
+ * mul_limbs_par.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_limbs_par_itch(@p n) limbs.
+ */
+void sqr_limbs_par(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                   jl_limb_t *scratch) {
+  mul_limbs_par(z, x, n, x, n, scratch);
+}
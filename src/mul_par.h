@@ -0,0 +1,32 @@
+#ifndef __JL_MUL_PAR_H__
+#define __JL_MUL_PAR_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Operand size, in limbs, below which mul_limbs_par stops splitting products
+// into tasks. Can also be changed at runtime.
+#ifndef JL_MUL_PAR_GRAIN
+#define JL_MUL_PAR_GRAIN 800
+#endif
+
+// Most times mul_limbs_par splits a product, i.e. at most 3^4 tasks per
+// product. The scratch bound is sized for this depth.
+#define JL_MUL_PAR_DEPTH 4
+
+void set_mul_par_grain(size_t n);
+
+size_t get_mul_par_grain(void);
+
+size_t mul_limbs_par_itch(size_t x_n, size_t y_n);
+
+void mul_limbs_par(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                   const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+
+size_t sqr_limbs_par_itch(size_t n);
+
+void sqr_limbs_par(jl_limb_t *z, const jl_limb_t *x, size_t n,
+                   jl_limb_t *scratch);
+#endif
@@ -0,0 +1,567 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "limb.h"
+#include "ntt.h"
+#include "pool.h"
+
+// Transforms of at most this many points run breadth-first; larger ones split
+// in half and recurse, so every level below this size works in cache.
+#define JL_NTT_BLOCK 1024
+
+static size_t mul_ntt_threshold = JL_MUL_NTT_THRESHOLD;
+
+/**
+ * @brief Sets the operand size, in limbs, at which mul_limbs switches from
+ * Toom-4 to the NTT. Values below JL_MUL_NTT_MIN_LIMBS are raised to it. The
+ * build-time default is JL_MUL_NTT_THRESHOLD.
+ */
+void set_mul_ntt_threshold(size_t n) {
+  mul_ntt_threshold = n < JL_MUL_NTT_MIN_LIMBS ? JL_MUL_NTT_MIN_LIMBS : n;
+}
+
+size_t get_mul_ntt_threshold(void) { return mul_ntt_threshold; }
+
+/*
+ * Arithmetic mod p.
+ *
+ * Each prime is c 2^k + 1 < 2^63 with k >= 55, so every power of two length up
+ * to 2^55 has a root of unity, and p1 p2 p3 > 2^183 is larger than any
+ * coefficient of a convolution of 64 bit limbs that long (n 2^128). Products
+ * are reduced with Montgomery's method, R = 2^64. Transform data is kept in
+ * normal form and twiddles in Montgomery form, so mont_mul(a, w R) = a w.
+ */
+
+typedef struct {
+  jl_limb_t p;    // The prime.
+  jl_limb_t g;    // A generator of (Z/pZ)*.
+  jl_limb_t pinv; // -p^-1 mod 2^64.
+  jl_limb_t r1;   // R mod p.
+  jl_limb_t r2;   // R^2 mod p.
+} ntt_prime;
+
+static const jl_limb_t ntt_primes[3][2] = {
+    {4179340454199820289ULL, 3}, // 29 2^57 + 1
+    {2485986994308513793ULL, 5}, // 69 2^55 + 1
+    {1945555039024054273ULL, 5}, // 27 2^56 + 1
+};
+
+static inline jl_limb_t add_mod(jl_limb_t a, jl_limb_t b, jl_limb_t p) {
+  const jl_limb_t s = a + b;
+  return s >= p ? s - p : s;
+}
+
+static inline jl_limb_t sub_mod(jl_limb_t a, jl_limb_t b, jl_limb_t p) {
+  return a >= b ? a - b : a + p - b;
+}
+
+// a b R^-1 mod p, for a, b < p.
+static inline jl_limb_t mont_mul(jl_limb_t a, jl_limb_t b,
+                                 const ntt_prime *P) {
+  jl_limb_t hi, m_hi;
+  const jl_limb_t lo = mul_limb(a, b, &hi);
+  const jl_limb_t m = lo * P->pinv;
+  mul_limb(m, P->p, &m_hi);
+  // lo + low(m p) is 0 mod 2^64 and carries unless lo is 0.
+  const jl_limb_t u = hi + m_hi + (lo != 0);
+  return u >= P->p ? u - P->p : u;
+}
+
+static void ntt_prime_init(ntt_prime *P, int i) {
+  P->p = ntt_primes[i][0];
+  P->g = ntt_primes[i][1];
+
+  jl_limb_t inv = P->p; // Correct to 3 bits; each Newton step doubles that.
+  for (int j = 0; j < 5; j++)
+    inv *= 2 - P->p * inv;
+  P->pinv = -inv;
+
+  P->r1 = (0 - P->p) % P->p;
+  P->r2 = P->r1;
+  for (int j = 0; j < 64; j++)
+    P->r2 = add_mod(P->r2, P->r2, P->p);
+}
+
+// a^e mod p, in normal form.
+static jl_limb_t pow_mod(jl_limb_t a, jl_limb_t e, const ntt_prime *P) {
+  jl_limb_t aR = mont_mul(a, P->r2, P);
+  jl_limb_t xR = P->r1;
+  for (; e; e >>= 1) {
+    if (e & 1)
+      xR = mont_mul(xR, aR, P);
+    aR = mont_mul(aR, aR, P);
+  }
+
+  return mont_mul(xR, 1, P);
+}
+
+// a^-1 mod p, in normal form.
+static jl_limb_t inv_mod(jl_limb_t a, const ntt_prime *P) {
+  return pow_mod(a, P->p - 2, P);
+}
+
+/*
+ * Transforms.
+ *
+ * The forward transform is decimation in frequency and leaves its output in
+ * bit-reversed order; the inverse is decimation in time and takes its input
+ * in that order, so neither needs a permutation pass. A sub-transform of n
+ * points inside one of length L uses the twiddles w^(j L / n), i.e. table
+ * entries at a stride. The table holds w^j R for j < L / 2 only; the inverse
+ * transform gets w^-j from w^-j = -w^(L/2 - j).
+ */
+
+// Butterflies j0 <= j < j1 of a stage of half-length h.
+static void dif_butterflies(jl_limb_t *a, size_t h, size_t j0, size_t j1,
+                            const jl_limb_t *tw, size_t stride,
+                            const ntt_prime *P) {
+  for (size_t j = j0; j < j1; j++) {
+    const jl_limb_t u = a[j];
+    const jl_limb_t v = a[j + h];
+    a[j] = add_mod(u, v, P->p);
+    a[j + h] = mont_mul(sub_mod(u, v, P->p), tw[j * stride], P);
+  }
+}
+
+// The same for the inverse transform, where half is L / 2.
+static void dit_butterflies(jl_limb_t *a, size_t h, size_t j0, size_t j1,
+                            const jl_limb_t *tw, size_t stride, size_t half,
+                            const ntt_prime *P) {
+  jl_limb_t u, t;
+  size_t j = j0;
+  if (j == 0 && j1 > 0) {
+    u = a[0];
+    t = a[h];
+    a[0] = add_mod(u, t, P->p);
+    a[h] = sub_mod(u, t, P->p);
+    j = 1;
+  }
+  for (; j < j1; j++) {
+    u = a[j];
+    // t = -a[j + h] w^-(j stride)
+    t = mont_mul(a[j + h], tw[half - j * stride], P);
+    a[j] = sub_mod(u, t, P->p);
+    a[j + h] = add_mod(u, t, P->p);
+  }
+}
+
+static void dif_stage(jl_limb_t *a, size_t h, const jl_limb_t *tw,
+                      size_t stride, const ntt_prime *P) {
+  dif_butterflies(a, h, 0, h, tw, stride, P);
+}
+
+static void dit_stage(jl_limb_t *a, size_t h, const jl_limb_t *tw,
+                      size_t stride, size_t half, const ntt_prime *P) {
+  dit_butterflies(a, h, 0, h, tw, stride, half, P);
+}
+
+// Forward transform of the n points at a, with stride = L / n.
+static void ntt_dif(jl_limb_t *a, size_t n, const jl_limb_t *tw, size_t stride,
+                    const ntt_prime *P) {
+  if (n <= JL_NTT_BLOCK) {
+    for (size_t h = n / 2; h >= 1; h /= 2, stride *= 2)
+      for (size_t b = 0; b < n; b += 2 * h)
+        dif_stage(a + b, h, tw, stride, P);
+    return;
+  }
+
+  dif_stage(a, n / 2, tw, stride, P);
+  ntt_dif(a, n / 2, tw, 2 * stride, P);
+  ntt_dif(a + n / 2, n / 2, tw, 2 * stride, P);
+}
+
+// Inverse transform (without the 1 / L) of the n points at a, with stride =
+// L / n. half is L / 2.
+static void ntt_dit(jl_limb_t *a, size_t n, const jl_limb_t *tw, size_t stride,
+                    size_t half, const ntt_prime *P) {
+  if (n <= JL_NTT_BLOCK) {
+    for (size_t h = 1, s = stride * (n / 2); h < n; h *= 2, s /= 2)
+      for (size_t b = 0; b < n; b += 2 * h)
+        dit_stage(a + b, h, tw, s, half, P);
+    return;
+  }
+
+  ntt_dit(a, n / 2, tw, 2 * stride, half, P);
+  ntt_dit(a + n / 2, n / 2, tw, 2 * stride, half, P);
+  dit_stage(a, n / 2, tw, stride, half, P);
+}
+
+/*
+ * Parallel transforms, for mul_ntt_par. Above NTT_PAR_POINTS points the two
+ * half-size sub-transforms run as separate pool tasks, and so do the halves of
+ * the stage that joins them, down to NTT_PAR_POINTS / 2 butterflies each.
+ * Smaller transforms are left to ntt_dif and ntt_dit.
+ */
+
+#define NTT_PAR_POINTS 8192
+
+typedef struct {
+  jl_limb_t *a;
+  size_t n;      // Points in the transform.
+  size_t j0, j1; // Butterflies of the stage with h = n / 2.
+  const jl_limb_t *tw;
+  size_t stride;
+  size_t half;
+  const ntt_prime *P;
+} ntt_part;
+
+static void dif_stage_par(const ntt_part *p);
+static void dit_stage_par(const ntt_part *p);
+static void ntt_dif_par(jl_limb_t *a, size_t n, const jl_limb_t *tw,
+                        size_t stride, const ntt_prime *P);
+static void ntt_dit_par(jl_limb_t *a, size_t n, const jl_limb_t *tw,
+                        size_t stride, size_t half, const ntt_prime *P);
+
+static void dif_stage_task(void *arg) { dif_stage_par(arg); }
+
+static void dit_stage_task(void *arg) { dit_stage_par(arg); }
+
+static void ntt_dif_task(void *arg) {
+  const ntt_part *p = arg;
+  ntt_dif_par(p->a, p->n, p->tw, p->stride, p->P);
+}
+
+static void ntt_dit_task(void *arg) {
+  const ntt_part *p = arg;
+  ntt_dit_par(p->a, p->n, p->tw, p->stride, p->half, p->P);
+}
+
+static void dif_stage_par(const ntt_part *p) {
+  if (p->j1 - p->j0 <= NTT_PAR_POINTS / 2) {
+    dif_butterflies(p->a, p->n / 2, p->j0, p->j1, p->tw, p->stride, p->P);
+    return;
+  }
+
+  ntt_part lo = *p, hi = *p;
+  lo.j1 = hi.j0 = p->j0 + (p->j1 - p->j0) / 2;
+  jl_task t;
+  pool_spawn(&t, dif_stage_task, &hi);
+  dif_stage_par(&lo);
+  pool_join(&t);
+}
+
+static void dit_stage_par(const ntt_part *p) {
+  if (p->j1 - p->j0 <= NTT_PAR_POINTS / 2) {
+    dit_butterflies(p->a, p->n / 2, p->j0, p->j1, p->tw, p->stride, p->half,
+                    p->P);
+    return;
+  }
+
+  ntt_part lo = *p, hi = *p;
+  lo.j1 = hi.j0 = p->j0 + (p->j1 - p->j0) / 2;
+  jl_task t;
+  pool_spawn(&t, dit_stage_task, &hi);
+  dit_stage_par(&lo);
+  pool_join(&t);
+}
+
+static void ntt_dif_par(jl_limb_t *a, size_t n, const jl_limb_t *tw,
+                        size_t stride, const ntt_prime *P) {
+  if (n < NTT_PAR_POINTS) {
+    ntt_dif(a, n, tw, stride, P);
+    return;
+  }
+
+  const ntt_part stage = {a, n, 0, n / 2, tw, stride, 0, P};
+  dif_stage_par(&stage);
+
+  const ntt_part hi = {a + n / 2, n / 2, 0, 0, tw, 2 * stride, 0, P};
+  jl_task t;
+  pool_spawn(&t, ntt_dif_task, (void *)&hi);
+  ntt_dif_par(a, n / 2, tw, 2 * stride, P);
+  pool_join(&t);
+}
+
+static void ntt_dit_par(jl_limb_t *a, size_t n, const jl_limb_t *tw,
+                        size_t stride, size_t half, const ntt_prime *P) {
+  if (n < NTT_PAR_POINTS) {
+    ntt_dit(a, n, tw, stride, half, P);
+    return;
+  }
+
+  const ntt_part hi = {a + n / 2, n / 2, 0, 0, tw, 2 * stride, half, P};
+  jl_task t;
+  pool_spawn(&t, ntt_dit_task, (void *)&hi);
+  ntt_dit_par(a, n / 2, tw, 2 * stride, half, P);
+  pool_join(&t);
+
+  const ntt_part stage = {a, n, 0, n / 2, tw, stride, half, P};
+  dit_stage_par(&stage);
+}
+
+// Fills tw with w^j R for j < L / 2, where w is a primitive L-th root.
+static void ntt_twiddles(jl_limb_t *tw, size_t L, const ntt_prime *P) {
+  const jl_limb_t w = pow_mod(P->g, (P->p - 1) / L, P);
+  const jl_limb_t wR = mont_mul(w, P->r2, P);
+  jl_limb_t t = P->r1;
+  for (size_t j = 0; j < L / 2; j++) {
+    tw[j] = t;
+    t = mont_mul(t, wR, P);
+  }
+}
+
+// a = x mod p, zero-padded to L points.
+static void ntt_load(jl_limb_t *a, size_t L, const jl_limb_t *x, size_t x_n,
+                     const ntt_prime *P) {
+  for (size_t i = 0; i < x_n; i++)
+    a[i] = x[i] % P->p;
+  memset(a + x_n, 0, (L - x_n) * sizeof(jl_limb_t));
+}
+
+// a = the forward transform of x mod p, zero-padded to L points.
+static void ntt_forward(jl_limb_t *a, const jl_limb_t *tw, size_t L,
+                        const jl_limb_t *x, size_t x_n, const ntt_prime *P,
+                        int par) {
+  ntt_load(a, L, x, x_n, P);
+  if (par)
+    ntt_dif_par(a, L, tw, 1, P);
+  else
+    ntt_dif(a, L, tw, 1, P);
+}
+
+typedef struct {
+  jl_limb_t *fx, *fy, *tw;
+  size_t L;
+  const jl_limb_t *x;
+  size_t x_n;
+  const jl_limb_t *y;
+  size_t y_n;
+  const ntt_prime *P;
+} ntt_conv;
+
+static void ntt_forward_task(void *arg) {
+  const ntt_conv *c = arg;
+  ntt_forward(c->fy, c->tw, c->L, c->y, c->y_n, c->P, 1);
+}
+
+// The cyclic convolution of x and y mod p, in fx. Clobbers fy. When x is y,
+// fy is left alone and the one transform is squared. With par set, the
+// transforms run on the pool, x's and y's side by side.
+static void ntt_convolve(const ntt_conv *c, int par) {
+  jl_limb_t *fx = c->fx, *fy = c->fy, *tw = c->tw;
+  const size_t L = c->L;
+  const ntt_prime *P = c->P;
+
+  ntt_twiddles(tw, L, P);
+
+  if (c->x == c->y && c->x_n == c->y_n) {
+    ntt_forward(fx, tw, L, c->x, c->x_n, P, par);
+    fy = fx;
+  } else if (par) {
+    jl_task t;
+    pool_spawn(&t, ntt_forward_task, (void *)c);
+    ntt_forward(fx, tw, L, c->x, c->x_n, P, par);
+    pool_join(&t);
+  } else {
+    ntt_forward(fx, tw, L, c->x, c->x_n, P, par);
+    ntt_forward(fy, tw, L, c->y, c->y_n, P, par);
+  }
+
+  // mont_mul(mont_mul(a, b), L^-1 R^2) = a b / L.
+  const jl_limb_t l_inv = P->p - (P->p - 1) / L;
+  const jl_limb_t scale = mont_mul(mont_mul(l_inv, P->r2, P), P->r2, P);
+  for (size_t i = 0; i < L; i++)
+    fx[i] = mont_mul(mont_mul(fx[i], fy[i], P), scale, P);
+
+  if (par)
+    ntt_dit_par(fx, L, tw, 1, L / 2, P);
+  else
+    ntt_dit(fx, L, tw, 1, L / 2, P);
+}
+
+static void ntt_convolve_task(void *arg) { ntt_convolve(arg, 1); }
+
+static size_t ntt_length(size_t n) {
+  size_t L = 1;
+  while (L < n)
+    L *= 2;
+
+  return L;
+}
+
+/**
+ * @brief Number of scratch limbs mul_ntt needs for an @p x_n by @p y_n limb
+ * product: two transforms and a twiddle table of the padded length, and the
+ * residues mod the first two primes.
+ */
+size_t mul_ntt_itch(size_t x_n, size_t y_n) {
+  if (x_n == 0 || y_n == 0)
+    return 0;
+
+  const size_t out = x_n + y_n - 1;
+  const size_t L = ntt_length(out);
+
+  return 2 * L + L / 2 + 2 * out;
+}
+
+// z = the out + 1 limb integer whose coefficients mod P[i] are r[i],
+// recombined by the CRT.
+static void ntt_crt(jl_limb_t *z, size_t out, jl_limb_t *const r[3],
+                    const ntt_prime P[3]) {
+  // Garner: c = v1 + v2 p1 + v3 p1 p2, with
+  //    v1 = r1,
+  //    v2 = (r2 - v1) / p1 mod p2,
+  //    v3 = (r3 - v1 - v2 p1) / (p1 p2) mod p3.
+  const jl_limb_t p1 = P[0].p;
+  const jl_limb_t p2 = P[1].p;
+  const jl_limb_t p3 = P[2].p;
+  const jl_limb_t inv12R = mont_mul(inv_mod(p1 % p2, &P[1]), P[1].r2, &P[1]);
+  const jl_limb_t inv123R = mont_mul(
+      inv_mod(mont_mul(mont_mul(p1 % p3, P[2].r2, &P[2]), p2 % p3, &P[2]),
+              &P[2]),
+      P[2].r2, &P[2]);
+  const jl_limb_t p1R3 = mont_mul(p1 % p3, P[2].r2, &P[2]);
+  jl_limb_t p12[2];
+  p12[0] = mul_limb(p1, p2, &p12[1]);
+
+  // Coefficient k lands on limbs k, k + 1 and k + 2 of z; acc holds what's
+  // pending above limb k.
+  jl_limb_t acc[3] = {0, 0, 0};
+  for (size_t k = 0; k < out; k++) {
+    const jl_limb_t v1 = r[0][k];
+    const jl_limb_t v2 =
+        mont_mul(sub_mod(r[1][k], v1 % p2, p2), inv12R, &P[1]);
+    const jl_limb_t t = sub_mod(r[2][k], v1 % p3, p3);
+    const jl_limb_t v3 =
+        mont_mul(sub_mod(t, mont_mul(v2 % p3, p1R3, &P[2]), p3), inv123R, &P[2]);
+
+    // c = v1 + v2 p1 + v3 p1 p2, three limbs.
+    jl_limb_t c[3], hi, lo, carry;
+    c[0] = mul_limb(v2, p1, &c[1]);
+    c[0] = addc_limb(c[0], v1, 0, &carry);
+    c[1] += carry;
+    lo = mul_limb(v3, p12[0], &hi);
+    c[0] = addc_limb(c[0], lo, 0, &carry);
+    c[1] = addc_limb(c[1], hi, carry, &carry);
+    c[2] = carry;
+    lo = mul_limb(v3, p12[1], &hi);
+    c[1] = addc_limb(c[1], lo, 0, &carry);
+    c[2] += hi + carry;
+
+    acc[0] = addc_limb(acc[0], c[0], 0, &carry);
+    acc[1] = addc_limb(acc[1], c[1], carry, &carry);
+    acc[2] = acc[2] + c[2] + carry;
+
+    z[k] = acc[0];
+    acc[0] = acc[1];
+    acc[1] = acc[2];
+    acc[2] = 0;
+  }
+  z[out] = acc[0];
+}
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z, by convolving their limbs with a number-theoretic transform mod three
+ * primes and recombining the residues with the CRT (Garner's algorithm).
+ *
+ * The primes are done one after another through the same two transform
+ * buffers, so only the residues of the first two are held while the third is
+ * computed. Transform lengths are powers of two; operands must satisfy
+ * @p x_n + @p y_n <= 2^55. If @p x is @p y, one transform per prime is
+ * saved.
+ *
+ * @p z may not overlap @p x, @p y or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_ntt_itch(@p x_n, @p y_n)
+ * limbs.
+ */
+void mul_ntt(jl_limb_t *z, const jl_limb_t *x, size_t x_n, const jl_limb_t *y,
+             size_t y_n, jl_limb_t *scratch) {
+  if (x_n == 0 || y_n == 0) {
+    memset(z, 0, (x_n + y_n) * sizeof(jl_limb_t));
+    return;
+  }
+
+  const size_t out = x_n + y_n - 1;
+  const size_t L = ntt_length(out);
+
+  jl_limb_t *fx = scratch;
+  jl_limb_t *fy = fx + L;
+  jl_limb_t *tw = fy + L;
+  jl_limb_t *res[2] = {tw + L / 2, tw + L / 2 + out};
+
+  ntt_prime P[3];
+  for (int i = 0; i < 3; i++) {
+    ntt_prime_init(&P[i], i);
+    const ntt_conv c = {fx, fy, tw, L, x, x_n, y, y_n, &P[i]};
+    ntt_convolve(&c, 0);
+    if (i < 2)
+      memcpy(res[i], fx, out * sizeof(jl_limb_t));
+  }
+
+  jl_limb_t *const r[3] = {res[0], res[1], fx};
+  ntt_crt(z, out, r, P);
+}
+
+/**
+ * @brief Number of scratch limbs mul_ntt_par needs for an @p x_n by @p y_n
+ * limb product: two transforms and a twiddle table for each prime.
+ */
+size_t mul_ntt_par_itch(size_t x_n, size_t y_n) {
+  if (x_n == 0 || y_n == 0)
+    return 0;
+
+  const size_t L = ntt_length(x_n + y_n - 1);
+
+  return 3 * (2 * L + L / 2);
+}
+
+/**
+ * @brief mul_ntt on the thread pool (see set_pool_threads). The three primes
+ * each get their own buffers and run as separate tasks, and within each, the
+ * two operands are transformed side by side and transforms of more than
+ * NTT_PAR_POINTS points are split into tasks recursively. Same result and
+ * contract as mul_ntt; with the pool stopped it just runs serially in more
+ * memory.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_ntt_par_itch(@p x_n, @p y_n)
+ * limbs.
+ */
+void mul_ntt_par(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                 const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (x_n == 0 || y_n == 0) {
+    memset(z, 0, (x_n + y_n) * sizeof(jl_limb_t));
+    return;
+  }
+
+  const size_t out = x_n + y_n - 1;
+  const size_t L = ntt_length(out);
+
+  ntt_prime P[3];
+  ntt_conv c[3];
+  jl_task t[2];
+  for (int i = 0; i < 3; i++) {
+    ntt_prime_init(&P[i], i);
+    jl_limb_t *fx = scratch + i * (2 * L + L / 2);
+    c[i] = (ntt_conv){fx, fx + L, fx + 2 * L, L, x, x_n, y, y_n, &P[i]};
+  }
+  pool_spawn(&t[0], ntt_convolve_task, &c[1]);
+  pool_spawn(&t[1], ntt_convolve_task, &c[2]);
+  ntt_convolve(&c[0], 1);
+  pool_join(&t[0]);
+  pool_join(&t[1]);
+
+  jl_limb_t *const r[3] = {c[0].fx, c[1].fx, c[2].fx};
+  ntt_crt(z, out, r, P);
+}
+
+/**
+ * @brief Number of scratch limbs sqr_ntt needs for an @p n limb square.
+ */
+size_t sqr_ntt_itch(size_t n) { return mul_ntt_itch(n, n); }
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z with the NTT: two
+ * transforms per prime instead of three.
+ *
+ * @p z may not overlap @p x or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_ntt_itch(@p n) limbs.
+ */
+void sqr_ntt(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t *scratch) {
+  mul_ntt(z, x, n, x, n, scratch);
+}
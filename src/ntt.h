@@ -0,0 +1,36 @@
+#ifndef __JL_NTT_H__
+#define __JL_NTT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Operand size, in limbs, at which mul_limbs moves from Toom-4 to the NTT.
+// Can also be changed at runtime.
+#ifndef JL_MUL_NTT_THRESHOLD
+#define JL_MUL_NTT_THRESHOLD 3500
+#endif
+
+// The NTT threshold is never set below this many limbs, so smaller products
+// don't have to budget scratch for a transform.
+#define JL_MUL_NTT_MIN_LIMBS 64
+
+void set_mul_ntt_threshold(size_t n);
+
+size_t get_mul_ntt_threshold(void);
+
+size_t mul_ntt_itch(size_t x_n, size_t y_n);
+
+void mul_ntt(jl_limb_t *z, const jl_limb_t *x, size_t x_n, const jl_limb_t *y,
+             size_t y_n, jl_limb_t *scratch);
+
+size_t sqr_ntt_itch(size_t n);
+
+void sqr_ntt(jl_limb_t *z, const jl_limb_t *x, size_t n, jl_limb_t *scratch);
+
+size_t mul_ntt_par_itch(size_t x_n, size_t y_n);
+
+void mul_ntt_par(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+                 const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+#endif
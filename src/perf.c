@@ -0,0 +1,201 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "perf.h"
+
+#if JL_HAVE_PERF
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// What each of the four counters of a jl_perf_probe counts, in order.
+static const uint64_t perf_events[4] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+static jl_perf_stats perf_table[JL_PERF_OPS][JL_PERF_BUCKETS];
+
+// The counters of the calling thread, opened on its first instrumented call
+// as one group, so a single read returns all four.
+static __thread int perf_fds[4] = {-1, -1, -1, -1};
+static __thread int perf_state = 0; // 0 untried, 1 open, -1 unavailable.
+static __thread unsigned perf_depth = 0;
+
+static pthread_key_t perf_key;
+static pthread_once_t perf_key_once = PTHREAD_ONCE_INIT;
+
+static void perf_close(void *arg) {
+  (void)arg;
+  for (int i = 3; i >= 0; i--) {
+    if (perf_fds[i] >= 0)
+      close(perf_fds[i]);
+    perf_fds[i] = -1;
+  }
+}
+
+// Closes a thread's counters when it exits.
+static void perf_make_key(void) { pthread_key_create(&perf_key, perf_close); }
+
+static int perf_open(void) {
+  for (int i = 0; i < 4; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = perf_events[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    perf_fds[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1,
+                               i ? perf_fds[0] : -1, 0);
+    if (perf_fds[i] < 0) {
+      perf_close(NULL);
+      return -1;
+    }
+  }
+
+  pthread_once(&perf_key_once, perf_make_key);
+  pthread_setspecific(perf_key, perf_fds);
+  return 1;
+}
+
+static void perf_read(uint64_t v[4]) {
+  uint64_t buf[5] = {0};
+  if (perf_state != 1 || read(perf_fds[0], buf, sizeof(buf)) != sizeof(buf))
+    memset(buf, 0, sizeof(buf));
+  memcpy(v, buf + 1, 4 * sizeof(uint64_t));
+}
+#endif
+
+/**
+ * @brief Starts probe @p p for a call of operation @p op (a JL_PERF_*) on
+ * operands of up to @p size bytes. Does nothing inside another probe.
+ */
+void perf_begin(jl_perf_probe *p, unsigned op, size_t size) {
+  p->live = 0;
+#if JL_HAVE_PERF
+  if (perf_depth++ != 0 || op >= JL_PERF_OPS)
+    return;
+  if (perf_state == 0)
+    perf_state = perf_open();
+
+  p->op = op;
+  p->bucket = perf_bucket(size);
+  p->live = 1;
+  perf_read(p->start);
+#else
+  (void)op;
+  (void)size;
+#endif
+}
+
+/**
+ * @brief Ends probe @p p and adds what was counted since perf_begin to the
+ * table.
+ */
+void perf_end(const jl_perf_probe *p) {
+#if JL_HAVE_PERF
+  perf_depth--;
+  if (!p->live)
+    return;
+
+  uint64_t end[4];
+  perf_read(end);
+
+  jl_perf_stats *s = &perf_table[p->op][p->bucket];
+  __atomic_add_fetch(&s->calls, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&s->cycles, end[0] - p->start[0], __ATOMIC_RELAXED);
+  __atomic_add_fetch(&s->instructions, end[1] - p->start[1], __ATOMIC_RELAXED);
+  __atomic_add_fetch(&s->branch_misses, end[2] - p->start[2],
+                     __ATOMIC_RELAXED);
+  __atomic_add_fetch(&s->llc_misses, end[3] - p->start[3], __ATOMIC_RELAXED);
+#else
+  (void)p;
+#endif
+}
+
+/**
+ * @brief The bucket operands of @p size bytes are counted in.
+ */
+size_t perf_bucket(size_t size) {
+  size_t b = 0;
+  while (size > 1 && b + 1 < JL_PERF_BUCKETS) {
+    size >>= 1;
+    b++;
+  }
+  return b;
+}
+
+/**
+ * @brief 1 if the calling thread's counters are open, or can be opened now; 0
+ * if only calls will be counted, or the library was built without JL_PERF.
+ */
+int perf_counting(void) {
+#if JL_HAVE_PERF
+  if (perf_state == 0)
+    perf_state = perf_open();
+  return perf_state == 1;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Copies the totals for operation @p op and size bucket @p bucket into
+ * @p s.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p s is NULL.
+ *      2. Built without JL_PERF. @p s is zeroed.
+ *      3. @p op or @p bucket is out of range.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t get_perf_stats(jl_perf_stats *s, unsigned op, size_t bucket) {
+  // Error check 1.
+  if (s == NULL)
+    return 1;
+
+  memset(s, 0, sizeof(*s));
+
+#if JL_HAVE_PERF
+  if (op >= JL_PERF_OPS || bucket >= JL_PERF_BUCKETS)
+    return 3;
+
+  const jl_perf_stats *t = &perf_table[op][bucket];
+  s->calls = __atomic_load_n(&t->calls, __ATOMIC_RELAXED);
+  s->cycles = __atomic_load_n(&t->cycles, __ATOMIC_RELAXED);
+  s->instructions = __atomic_load_n(&t->instructions, __ATOMIC_RELAXED);
+  s->branch_misses = __atomic_load_n(&t->branch_misses, __ATOMIC_RELAXED);
+  s->llc_misses = __atomic_load_n(&t->llc_misses, __ATOMIC_RELAXED);
+  return 0;
+#else
+  return op >= JL_PERF_OPS || bucket >= JL_PERF_BUCKETS ? 3 : 2;
+#endif
+}
+
+/**
+ * @brief Zeroes every total. Calls in flight on other threads may still add
+ * to the table afterwards.
+ */
+void reset_perf_stats(void) {
+#if JL_HAVE_PERF
+  for (size_t i = 0; i < JL_PERF_OPS; i++) {
+    for (size_t b = 0; b < JL_PERF_BUCKETS; b++) {
+      jl_perf_stats *t = &perf_table[i][b];
+      __atomic_store_n(&t->calls, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&t->cycles, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&t->instructions, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&t->branch_misses, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&t->llc_misses, 0, __ATOMIC_RELAXED);
+    }
+  }
+#endif
+}
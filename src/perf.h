@@ -0,0 +1,86 @@
+#ifndef __JL_PERF_H__
+#define __JL_PERF_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Optional hardware counters around the public entry points. Built with
+ * JL_PERF defined, each call of an entry point reads the calling thread's
+ * cycle, instruction, branch-miss and last-level-cache-miss counters
+ * (perf_event_open, so Linux only) on the way in and out, and adds the
+ * difference to a table kept per operation and per power-of-two operand size.
+ * Calls nested inside another instrumented call are counted only in the outer
+ * one. Work the call hands to the thread pool isn't counted.
+ *
+ * Without JL_PERF the probes compile to nothing, and get_perf_stats reports
+ * error 2.
+ */
+
+#if defined(JL_PERF) && defined(__linux__)
+#define JL_HAVE_PERF 1
+#else
+#define JL_HAVE_PERF 0
+#endif
+
+// Operations the table is kept for.
+#define JL_PERF_ADD 0       // add_bstrings.
+#define JL_PERF_SUB 1       // sub_bstrings.
+#define JL_PERF_MUL 2       // mul_bstrings, mul_bstrings_arena.
+#define JL_PERF_SQR 3       // sqr_bstrings, sqr_bstrings_arena.
+#define JL_PERF_DIVREM 4    // divrem_bstrings, divrem_bstrings_arena.
+#define JL_PERF_POWM 5      // powm_bstrings.
+#define JL_PERF_TO_BASE 6   // to_base, to_decimal, to_base_arena.
+#define JL_PERF_FROM_BASE 7 // from_base, from_decimal, from_base_arena.
+#define JL_PERF_OPS 8
+
+// Bucket b holds operands of 2^b to 2^(b + 1) - 1 bytes, the last everything
+// bigger. The size is that of the larger operand.
+#define JL_PERF_BUCKETS 48
+
+/**
+ * @brief Totals for one operation and size bucket. The counters stay zero if
+ * the kernel wouldn't open them (no PMU, or perf_event_paranoid too high);
+ * calls are counted regardless.
+ */
+typedef struct {
+  uint64_t calls;
+  uint64_t cycles;
+  uint64_t instructions;
+  uint64_t branch_misses;
+  uint64_t llc_misses;
+} jl_perf_stats;
+
+/**
+ * @brief Counter readings taken on the way into an entry point. Only the
+ * JL_PERF_BEGIN and JL_PERF_END macros should need one.
+ */
+typedef struct {
+  uint64_t start[4];
+  unsigned op;
+  size_t bucket;
+  int live;
+} jl_perf_probe;
+
+#if JL_HAVE_PERF
+#define JL_PERF_BEGIN(op, size)                                                \
+  jl_perf_probe perf_probe_;                                                   \
+  perf_begin(&perf_probe_, op, size)
+#define JL_PERF_END() perf_end(&perf_probe_)
+#else
+#define JL_PERF_BEGIN(op, size) ((void)0)
+#define JL_PERF_END() ((void)0)
+#endif
+
+void perf_begin(jl_perf_probe *p, unsigned op, size_t size);
+
+void perf_end(const jl_perf_probe *p);
+
+size_t perf_bucket(size_t size);
+
+int perf_counting(void);
+
+uint8_t get_perf_stats(jl_perf_stats *s, unsigned op, size_t bucket);
+
+void reset_perf_stats(void);
+#endif
@@ -0,0 +1,228 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+#if JL_HAVE_THREADS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+ * A fork-join pool shared by every caller in the process. A pool of n threads
+ * has n - 1 workers; the nth is whichever thread is waiting in pool_join,
+ * which runs tasks too instead of blocking. Each worker has a deque: it pushes
+ * and pops its own tasks at the bottom, newest first, and idle threads steal
+ * from the top, oldest (so largest) first. Threads outside the pool share one
+ * more deque.
+ *
+ * So however many threads call in at once, no more than n - 1 extra threads
+ * ever run, and once n tasks are already queued, pool_spawn runs new ones on
+ * the spot rather than queueing more work than there are threads to take it.
+ */
+
+#if JL_HAVE_THREADS
+
+#define POOL_DEQUE_SIZE 256
+
+typedef struct {
+  pthread_mutex_t lock;
+  size_t top;    // Next task to steal.
+  size_t bottom; // One past the newest task.
+  jl_task *tasks[POOL_DEQUE_SIZE];
+} task_deque;
+
+static size_t pool_threads = 0;
+static task_deque *deques = NULL; // pool_threads of them, the last shared.
+static pthread_t *workers = NULL;
+static size_t queued = 0; // Tasks in all deques. Accessed atomically.
+static int stopping = 0;
+static pthread_mutex_t sleep_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sleep_cond = PTHREAD_COND_INITIALIZER;
+
+// The deque of the calling thread: its own for a worker, the shared one
+// otherwise.
+static __thread size_t worker_id = SIZE_MAX;
+
+static size_t own_deque(void) {
+  return worker_id < pool_threads ? worker_id : pool_threads - 1;
+}
+
+static int deque_push(task_deque *d, jl_task *t) {
+  int pushed = 0;
+  pthread_mutex_lock(&d->lock);
+  if (d->bottom - d->top < POOL_DEQUE_SIZE) {
+    d->tasks[d->bottom++ % POOL_DEQUE_SIZE] = t;
+    pushed = 1;
+  }
+  pthread_mutex_unlock(&d->lock);
+  return pushed;
+}
+
+static jl_task *deque_pop(task_deque *d, int steal) {
+  jl_task *t = NULL;
+  pthread_mutex_lock(&d->lock);
+  if (d->bottom > d->top)
+    t = steal ? d->tasks[d->top++ % POOL_DEQUE_SIZE]
+              : d->tasks[--d->bottom % POOL_DEQUE_SIZE];
+  pthread_mutex_unlock(&d->lock);
+  if (t != NULL)
+    __atomic_sub_fetch(&queued, 1, __ATOMIC_ACQ_REL);
+  return t;
+}
+
+// The newest task of deque self, or failing that the oldest of any other.
+static jl_task *find_task(size_t self) {
+  if (__atomic_load_n(&queued, __ATOMIC_ACQUIRE) == 0)
+    return NULL;
+
+  jl_task *t = deque_pop(&deques[self], 0);
+  for (size_t k = 1; t == NULL && k < pool_threads; k++)
+    t = deque_pop(&deques[(self + k) % pool_threads], 1);
+  return t;
+}
+
+static void run_task(jl_task *t) {
+  t->fn(t->arg);
+  __atomic_store_n(&t->done, 1, __ATOMIC_RELEASE);
+}
+
+static void *worker_main(void *arg) {
+  worker_id = (size_t)(uintptr_t)arg;
+
+  for (;;) {
+    jl_task *t = find_task(worker_id);
+    if (t != NULL) {
+      run_task(t);
+      continue;
+    }
+
+    pthread_mutex_lock(&sleep_lock);
+    while (__atomic_load_n(&queued, __ATOMIC_ACQUIRE) == 0 && !stopping)
+      pthread_cond_wait(&sleep_cond, &sleep_lock);
+    const int stop = stopping;
+    pthread_mutex_unlock(&sleep_lock);
+    if (stop)
+      return NULL;
+  }
+}
+
+static void pool_stop(size_t started) {
+  pthread_mutex_lock(&sleep_lock);
+  stopping = 1;
+  pthread_cond_broadcast(&sleep_cond);
+  pthread_mutex_unlock(&sleep_lock);
+
+  for (size_t i = 0; i < started; i++)
+    pthread_join(workers[i], NULL);
+  for (size_t i = 0; i < pool_threads; i++)
+    pthread_mutex_destroy(&deques[i].lock);
+
+  free(workers);
+  free(deques);
+  workers = NULL;
+  deques = NULL;
+  pool_threads = 0;
+  stopping = 0;
+}
+#endif
+
+/**
+ * @brief Resizes the pool to @p n threads, counting the one waiting on the
+ * result, so @p n - 1 are started. 0 or 1 stops the pool, after which every
+ * task runs where it is spawned; that is the default. Not safe to call while
+ * any task is in flight.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      2. A thread or its memory couldn't be had. The pool is left stopped.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t set_pool_threads(size_t n) {
+#if JL_HAVE_THREADS
+  if (pool_threads > 1)
+    pool_stop(pool_threads - 1);
+  if (n <= 1)
+    return 0;
+
+  deques = calloc(n, sizeof(task_deque));
+  workers = malloc((n - 1) * sizeof(pthread_t));
+  if (deques == NULL || workers == NULL) {
+    free(deques);
+    free(workers);
+    deques = NULL;
+    workers = NULL;
+    return 2;
+  }
+
+  for (size_t i = 0; i < n; i++)
+    pthread_mutex_init(&deques[i].lock, NULL);
+  pool_threads = n;
+
+  for (size_t i = 0; i + 1 < n; i++) {
+    if (pthread_create(&workers[i], NULL, worker_main, (void *)(uintptr_t)i)) {
+      pool_stop(i);
+      return 2;
+    }
+  }
+#endif
+  return 0;
+}
+
+/**
+ * @brief The number of threads in the pool, or 0 if it is stopped.
+ */
+size_t get_pool_threads(void) {
+#if JL_HAVE_THREADS
+  return pool_threads;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Starts fn(@p arg) as task @p t, which pool_join(@p t) must then wait
+ * for. Runs it before returning if the pool is stopped or already has a queued
+ * task for every thread.
+ */
+void pool_spawn(jl_task *t, void (*fn)(void *arg), void *arg) {
+  t->fn = fn;
+  t->arg = arg;
+  t->done = 0;
+
+#if JL_HAVE_THREADS
+  if (pool_threads > 1 &&
+      __atomic_load_n(&queued, __ATOMIC_ACQUIRE) < pool_threads) {
+    // Counted before it's visible, so a thief never takes queued below 0.
+    __atomic_add_fetch(&queued, 1, __ATOMIC_ACQ_REL);
+    if (deque_push(&deques[own_deque()], t)) {
+      pthread_mutex_lock(&sleep_lock);
+      pthread_cond_signal(&sleep_cond);
+      pthread_mutex_unlock(&sleep_lock);
+      return;
+    }
+    __atomic_sub_fetch(&queued, 1, __ATOMIC_ACQ_REL);
+  }
+#endif
+
+  fn(arg);
+  t->done = 1;
+}
+
+/**
+ * @brief Returns once task @p t has finished, running queued tasks, its own
+ * first, while it waits.
+ */
+void pool_join(jl_task *t) {
+#if JL_HAVE_THREADS
+  while (!__atomic_load_n(&t->done, __ATOMIC_ACQUIRE)) {
+    jl_task *other = find_task(own_deque());
+    if (other != NULL)
+      run_task(other);
+    else
+      sched_yield();
+  }
+#endif
+}
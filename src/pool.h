@@ -0,0 +1,34 @@
+#ifndef __JL_POOL_H__
+#define __JL_POOL_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+// The pool runs on POSIX threads. Without them, or with JL_NO_THREADS
+// defined, set_pool_threads does nothing and every task runs where it is
+// spawned.
+#if !defined(JL_NO_THREADS) && (defined(__unix__) || defined(__APPLE__))
+#define JL_HAVE_THREADS 1
+#else
+#define JL_HAVE_THREADS 0
+#endif
+
+/**
+ * @brief One call of fn(arg), spawned with pool_spawn and waited for with
+ * pool_join. Lives with the caller, usually on its stack, until the join
+ * returns.
+ */
+typedef struct {
+  void (*fn)(void *arg);
+  void *arg;
+  int done; // Set once fn has returned. Accessed atomically.
+} jl_task;
+
+uint8_t set_pool_threads(size_t n);
+
+size_t get_pool_threads(void);
+
+void pool_spawn(jl_task *t, void (*fn)(void *arg), void *arg);
+
+void pool_join(jl_task *t);
+#endif
@@ -0,0 +1,593 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "arena.h"
+#include "div.h"
+#include "limb.h"
+#include "perf.h"
+#include "radix.h"
+
+static size_t radix_dc_threshold = JL_RADIX_DC_THRESHOLD;
+
+/**
+ * @brief Sets the size, in limbs, below which from_base and to_base convert
+ * digit by digit. Values below 2 are raised to 2. The build-time default is
+ * JL_RADIX_DC_THRESHOLD.
+ */
+void set_radix_dc_threshold(size_t n) { radix_dc_threshold = n < 2 ? 2 : n; }
+
+size_t get_radix_dc_threshold(void) { return radix_dc_threshold; }
+
+static const char radix_digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+/*
+ * Conversions work in big digits: bb = base^k, the largest power of the base
+ * that fits in a limb, so one limb operation moves k digits.
+ *
+ * Large numbers are split in half around a power P[j] = bb^(2^j), i.e.
+ * base^(k 2^j), which are computed once per call by repeated squaring. From
+ * digits, x = hi P[j] + lo takes one multiplication; to digits, x / P[j] and
+ * x mod P[j] take one division. Both go through the subquadratic tiers, so a
+ * conversion costs O(log n) multiplications of up to n limbs.
+ */
+
+typedef struct {
+  unsigned base;
+  unsigned k;   // Digits per limb.
+  jl_limb_t bb; // base^k.
+} radix_info;
+
+typedef struct {
+  jl_limb_t *p[JL_LIMB_BITS];
+  size_t n[JL_LIMB_BITS];
+  size_t count;
+} radix_powers;
+
+static void radix_info_init(radix_info *r, unsigned base) {
+  r->base = base;
+  r->k = 0;
+  r->bb = 1;
+  while (r->bb <= ~(jl_limb_t)0 / base) {
+    r->bb *= base;
+    r->k++;
+  }
+}
+
+// Value of the digit c, or 36 if it isn't one.
+static unsigned digit_value(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'z')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A' + 10;
+
+  return 36;
+}
+
+static size_t trim(const jl_limb_t *x, size_t n) {
+  while (n > 0 && x[n - 1] == 0)
+    n--;
+
+  return n;
+}
+
+// Limbs the power table takes with count entries; entry j has at most 2^j
+// limbs, and is squared into the room after it.
+static size_t radix_powers_limbs(size_t count) {
+  return ((size_t)1 << count) + 1;
+}
+
+static size_t radix_powers_itch(size_t count) {
+  return count > 1 ? sqr_limbs_itch((size_t)1 << (count - 2)) : 0;
+}
+
+// Fills in the first count powers bb^(2^j) at buf.
+static void radix_powers_init(radix_powers *pw, size_t count, jl_limb_t bb,
+                              jl_limb_t *buf, jl_limb_t *scratch) {
+  pw->count = count;
+  pw->p[0] = buf;
+  pw->p[0][0] = bb;
+  pw->n[0] = 1;
+  for (size_t j = 1; j < count; j++) {
+    pw->p[j] = pw->p[j - 1] + ((size_t)1 << (j - 1));
+    sqr_limbs(pw->p[j], pw->p[j - 1], pw->n[j - 1], scratch);
+    pw->n[j] = trim(pw->p[j], 2 * pw->n[j - 1]);
+  }
+}
+
+/*
+ * Digits to limbs.
+ */
+
+// z = the len digits at s, Horner's rule a big digit at a time. Returns the
+// limb count. z has room for len / k + 2 limbs.
+static size_t from_basecase(jl_limb_t *z, const char *s, size_t len,
+                            const radix_info *r) {
+  size_t zn = 0;
+  size_t chunk = len % r->k ? len % r->k : r->k;
+  for (size_t i = 0; i < len; i += chunk, chunk = r->k) {
+    jl_limb_t val = 0, mult = 1;
+    for (size_t j = 0; j < chunk; j++) {
+      val = val * r->base + digit_value(s[i + j]);
+      mult *= r->base;
+    }
+
+    if (zn == 0) {
+      z[0] = val;
+      zn = val != 0;
+      continue;
+    }
+    jl_limb_t carry = mul_1(z, z, zn, mult);
+    carry += add_1(z, z, zn, val);
+    if (carry)
+      z[zn++] = carry;
+  }
+
+  return zn;
+}
+
+// Follows the longer, low half of each split down; the high half is never
+// longer, and reuses the same space after it.
+static size_t from_dc_itch(size_t len, const radix_info *r) {
+  size_t itch = 0;
+  while (len >= r->k * radix_dc_threshold) {
+    size_t lo_len = r->k;
+    while (2 * lo_len < len)
+      lo_len *= 2;
+    const size_t m = len / r->k + 4;
+    itch += m + mul_limbs_itch(m, m);
+    len = lo_len;
+  }
+
+  return itch;
+}
+
+static size_t from_dc(jl_limb_t *z, const char *s, size_t len,
+                      const radix_info *r, const radix_powers *pw,
+                      jl_limb_t *scratch) {
+  if (len < r->k * radix_dc_threshold)
+    return from_basecase(z, s, len, r);
+
+  // The low part gets the largest power of two big digits below len.
+  size_t j = 0;
+  while (j + 1 < pw->count && (r->k << (j + 1)) < len)
+    j++;
+  const size_t lo_len = r->k << j;
+  const size_t hi_len = len - lo_len;
+
+  jl_limb_t *hi = scratch;
+  jl_limb_t *lo = hi + hi_len / r->k + 2;
+  scratch = lo + lo_len / r->k + 2;
+
+  const size_t hn = from_dc(hi, s, hi_len, r, pw, scratch);
+  const size_t ln = from_dc(lo, s + hi_len, lo_len, r, pw, scratch);
+
+  if (hn == 0) {
+    memcpy(z, lo, ln * sizeof(jl_limb_t));
+    return ln;
+  }
+
+  // z = hi P[j] + lo, and lo < P[j].
+  const size_t zn = hn + pw->n[j];
+  mul_limbs(z, hi, hn, pw->p[j], pw->n[j], scratch);
+  const jl_limb_t carry = add_n(z, z, lo, ln);
+  add_1(z + ln, z + ln, zn - ln, carry);
+
+  return trim(z, zn);
+}
+
+/*
+ * Limbs to digits.
+ */
+
+// Writes exactly ndig digits of x < base^ndig at s, a big digit at a time
+// from the bottom. t holds xn limbs.
+static void to_basecase(char *s, size_t ndig, const jl_limb_t *x, size_t xn,
+                        const radix_info *r, jl_limb_t *t) {
+  memcpy(t, x, xn * sizeof(jl_limb_t));
+  size_t tn = trim(t, xn);
+
+  size_t pos = ndig;
+  while (pos > 0) {
+    jl_limb_t rem = 0;
+    if (tn > 0) {
+      rem = divrem_1(t, t, tn, r->bb);
+      tn = trim(t, tn);
+    }
+    for (unsigned i = 0; i < r->k && pos > 0; i++) {
+      s[--pos] = radix_digits[rem % r->base];
+      rem /= r->base;
+    }
+  }
+}
+
+static size_t to_dc_itch(size_t xn) {
+  // The remainder of the top split can be nearly as long as x, since x needn't
+  // be near the power above it; below that each level is bounded by half the
+  // power it divides by.
+  size_t itch = xn + 2 * xn + 4 + divrem_limbs_itch(xn + 1, xn + 1);
+  for (size_t m = xn + 1; m > 2; m = m / 2 + 1)
+    itch += 2 * m + 2 + divrem_limbs_itch(m, m);
+
+  return itch;
+}
+
+// Writes exactly k 2^j digits of x < P[j] at s.
+static void to_dc(char *s, size_t j, const jl_limb_t *x, size_t xn,
+                  const radix_info *r, const radix_powers *pw,
+                  jl_limb_t *scratch) {
+  xn = trim(x, xn);
+  if (j == 0 || xn < radix_dc_threshold) {
+    to_basecase(s, r->k << j, x, xn, r, scratch);
+    return;
+  }
+
+  // x = q P[j - 1] + r; q gives the top half of the digits, r the bottom.
+  const jl_limb_t *p = pw->p[j - 1];
+  const size_t pn = pw->n[j - 1];
+  const size_t half = r->k << (j - 1);
+  if (xn < pn) {
+    to_dc(s, j - 1, x, 0, r, pw, scratch);
+    to_dc(s + half, j - 1, x, xn, r, pw, scratch);
+    return;
+  }
+
+  const size_t qn = xn - pn + 1;
+  jl_limb_t *q = scratch;
+  jl_limb_t *rem = q + qn;
+  scratch = rem + pn;
+  divrem_limbs(q, rem, x, xn, p, pn, scratch);
+
+  to_dc(s, j - 1, q, qn, r, pw, scratch);
+  to_dc(s + half, j - 1, rem, pn, r, pw, scratch);
+}
+
+// Takes total bytes for a conversion's temporaries from arena if it isn't
+// NULL, and from malloc otherwise.
+static void *radix_alloc(jl_arena *arena, size_t total) {
+  return arena != NULL ? arena_alloc(arena, total) : malloc(total);
+}
+
+// Number of powers a from_base of s_len digits uses.
+static size_t from_base_count(size_t s_len, const radix_info *r) {
+  size_t count = 1;
+  while (count < JL_LIMB_BITS && (r->k << count) < s_len)
+    count++;
+
+  return count;
+}
+
+// Bytes of temporaries a from_base of s_len digits uses: the result, the
+// powers, and scratch for whichever of building the powers and converting
+// needs more.
+static size_t from_base_bytes(size_t s_len, const radix_info *r) {
+  const size_t count = from_base_count(s_len, r);
+  const size_t p_itch = radix_powers_itch(count);
+  const size_t c_itch = from_dc_itch(s_len, r);
+
+  return (s_len / r->k + 2 + radix_powers_limbs(count) +
+          (p_itch > c_itch ? p_itch : c_itch)) *
+         sizeof(jl_limb_t);
+}
+
+static uint8_t from_base_nocheck(const char *s, uint8_t *z, uint8_t *flags,
+                                 size_t s_len, size_t z_size, unsigned base,
+                                 jl_arena *arena) {
+  *flags = 0;
+
+  // Error check 3.
+  if (base < 2 || base > 36 || s_len == 0)
+    return 3;
+  for (size_t i = 0; i < s_len; i++)
+    if (digit_value(s[i]) >= base)
+      return 3;
+
+  // Leading zeros cost nothing to skip.
+  while (s_len > 1 && s[0] == '0') {
+    s++;
+    s_len--;
+  }
+
+  radix_info r;
+  radix_info_init(&r, base);
+
+  const size_t mark = arena != NULL ? arena_mark(arena) : 0;
+  jl_limb_t *buf = radix_alloc(arena, from_base_bytes(s_len, &r));
+  if (buf == NULL)
+    return 2;
+
+  const size_t count = from_base_count(s_len, &r);
+  jl_limb_t *zl = buf;
+  jl_limb_t *p_buf = zl + s_len / r.k + 2;
+  jl_limb_t *scratch = p_buf + radix_powers_limbs(count);
+
+  radix_powers pw;
+  radix_powers_init(&pw, count, r.bb, p_buf, scratch);
+  const size_t zn = from_dc(zl, s, s_len, &r, &pw, scratch);
+
+  limbs_to_bytes(z, z_size, zl, zn);
+  const size_t z_bytes =
+      zn == 0 ? 0 : zn * JL_LIMB_BYTES - clz_limb(zl[zn - 1]) / 8;
+  if (z_bytes > z_size)
+    *flags |= 1;
+
+  if (arena != NULL)
+    arena_release(arena, mark);
+  else
+    free(buf);
+
+  return 0;
+}
+
+/**
+ * @brief Parses the @p s_len digits at @p s in base @p base, most significant
+ * first, and stores the value in @p z. Digits past 9 are letters, in either
+ * case. Long inputs are split in half recursively, so the cost is that of a
+ * few large multiplications rather than quadratic.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p s, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p base isn't in [2, 36], @p s_len is 0, or @p s has a character
+ *        that isn't a digit in @p base.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the value doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in] s (char*): The digits. Needn't be NUL-terminated.
+ * @param[out] z (uint8_t*): The value, little-endian, zero-padded to @p
+ * z_size bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param s_len[in] (size_t): Number of digits at @p s.
+ * @param z_size[in] (size_t): Size of @p z.
+ * @param base[in] (unsigned): The base, 2 to 36.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t from_base(const char *s, uint8_t *z, uint8_t *flags, size_t s_len,
+                  size_t z_size, unsigned base) {
+  // Error check 1.
+  if (s == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_FROM_BASE, s_len);
+  const uint8_t rc = from_base_nocheck(s, z, flags, s_len, z_size, base, NULL);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief from_base with @p base 10.
+ */
+uint8_t from_decimal(const char *s, uint8_t *z, uint8_t *flags, size_t s_len,
+                     size_t z_size) {
+  return from_base(s, z, flags, s_len, z_size, 10);
+}
+
+/**
+ * @brief Bytes of arena from_base_arena needs to parse @p s_len digits in base
+ * @p base, or 0 if @p base isn't in [2, 36]. Exact when the digits have no
+ * leading zeros, and an upper bound otherwise.
+ */
+size_t from_base_itch(size_t s_len, unsigned base) {
+  if (base < 2 || base > 36)
+    return 0;
+
+  radix_info r;
+  radix_info_init(&r, base);
+
+  return from_base_bytes(s_len, &r);
+}
+
+/**
+ * @brief from_base with every temporary taken from @p arena instead of the
+ * heap. Same contract as from_base, except that error code 2 means @p arena
+ * has fewer than from_base_itch(@p s_len, @p base) bytes free. Everything
+ * taken from @p arena is given back before returning.
+ */
+uint8_t from_base_arena(const char *s, uint8_t *z, uint8_t *flags,
+                        size_t s_len, size_t z_size, unsigned base,
+                        jl_arena *arena) {
+  // Error check 1.
+  if (s == NULL | z == NULL | flags == NULL | arena == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_FROM_BASE, s_len);
+  const uint8_t rc = from_base_nocheck(s, z, flags, s_len, z_size, base, arena);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief An upper bound on the number of digits to_base writes for an @p
+ * x_size byte number in base @p base, or 0 if @p base isn't in [2, 36].
+ */
+size_t to_base_size(size_t x_size, unsigned base) {
+  if (base < 2 || base > 36)
+    return 0;
+
+  unsigned bits = 0;
+  while ((2u << bits) <= base)
+    bits++;
+
+  return (8 * x_size + bits - 1) / bits + 1;
+}
+
+// Number of powers a to_base of an xn limb number may use. P[j] >=
+// 2^(b 2^j), with b the bit length of bb less one, so it's enough once that
+// passes x.
+static size_t to_base_count(size_t xn, const radix_info *r) {
+  const unsigned b = JL_LIMB_BITS - 1 - clz_limb(r->bb);
+  size_t count = 1;
+  while (((size_t)b << (count - 1)) < JL_LIMB_BITS * xn)
+    count++;
+
+  return count;
+}
+
+// Bytes of temporaries a to_base of an xn limb number uses: x, the powers,
+// scratch, and the digits padded to the largest power it could need, in
+// whole limbs.
+static size_t to_base_bytes(size_t xn, const radix_info *r) {
+  const size_t count = to_base_count(xn, r);
+  const size_t p_itch = radix_powers_itch(count);
+  const size_t c_itch = to_dc_itch(xn);
+
+  return (xn + radix_powers_limbs(count) +
+          (p_itch > c_itch ? p_itch : c_itch) +
+          limbs_for_bytes(r->k << (count - 1))) *
+         sizeof(jl_limb_t);
+}
+
+static uint8_t to_base_nocheck(const uint8_t *x, char *s, size_t *s_len,
+                               size_t x_size, size_t s_size, unsigned base,
+                               jl_arena *arena) {
+  // Error check 3.
+  if (base < 2 || base > 36)
+    return 3;
+
+  while (x_size > 0 && x[x_size - 1] == 0)
+    x_size--;
+
+  if (x_size == 0) {
+    *s_len = 1;
+    if (s_size < 1)
+      return 4;
+    s[0] = '0';
+    return 0;
+  }
+
+  radix_info r;
+  radix_info_init(&r, base);
+
+  const size_t xn = limbs_for_bytes(x_size);
+  const size_t mark = arena != NULL ? arena_mark(arena) : 0;
+  jl_limb_t *buf = radix_alloc(arena, to_base_bytes(xn, &r));
+  if (buf == NULL)
+    return 2;
+
+  const size_t count = to_base_count(xn, &r);
+  const size_t p_itch = radix_powers_itch(count);
+  const size_t c_itch = to_dc_itch(xn);
+  jl_limb_t *xl = buf;
+  jl_limb_t *p_buf = xl + xn;
+  jl_limb_t *scratch = p_buf + radix_powers_limbs(count);
+  char *digits = (char *)(scratch + (p_itch > c_itch ? p_itch : c_itch));
+  bytes_to_limbs(xl, xn, x, x_size);
+
+  radix_powers pw;
+  radix_powers_init(&pw, count, r.bb, p_buf, scratch);
+
+  // The smallest power above x fixes the padded digit count.
+  size_t j = 0;
+  while (pw.n[j] < xn || pw.n[j] == xn && cmp_n(pw.p[j], xl, xn) <= 0)
+    j++;
+  const size_t ndig = r.k << j;
+
+  to_dc(digits, j, xl, xn, &r, &pw, scratch);
+
+  size_t lead = 0;
+  while (lead + 1 < ndig && digits[lead] == '0')
+    lead++;
+
+  uint8_t rc = 0;
+  *s_len = ndig - lead;
+  if (*s_len > s_size)
+    rc = 4;
+  else
+    memcpy(s, digits + lead, *s_len);
+
+  if (arena != NULL)
+    arena_release(arena, mark);
+  else
+    free(buf);
+
+  return rc;
+}
+
+/**
+ * @brief Writes @p x in base @p base, most significant digit first and
+ * without leading zeros, at @p s. Digits past 9 are lowercase letters. Zero is
+ * written as "0". Large inputs are split in half recursively by division, so
+ * the cost is that of a few large divisions rather than quadratic.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p s, or @p s_len is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p base isn't in [2, 36].
+ *      4. @p s_size is too small. Nothing is written to @p s, and @p s_len is
+ *        set to the size needed.
+ *
+ * @param[in] x (uint8_t*): The value, little-endian.
+ * @param[out] s (char*): The digits. No NUL is appended. to_base_size gives a
+ * size that's always enough.
+ * @param[out] s_len (size_t*): The number of digits written.
+ * @param x_size[in] (size_t): Size of @p x.
+ * @param s_size[in] (size_t): Size of @p s.
+ * @param base[in] (unsigned): The base, 2 to 36.
+ *
+ * @return An error code. See Error codes in the description.
+ */
+uint8_t to_base(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                size_t s_size, unsigned base) {
+  // Error check 1.
+  if (x == NULL | s == NULL | s_len == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_TO_BASE, x_size);
+  const uint8_t rc = to_base_nocheck(x, s, s_len, x_size, s_size, base, NULL);
+  JL_PERF_END();
+
+  return rc;
+}
+
+/**
+ * @brief to_base with @p base 10.
+ */
+uint8_t to_decimal(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                   size_t s_size) {
+  return to_base(x, s, s_len, x_size, s_size, 10);
+}
+
+/**
+ * @brief Bytes of arena to_base_arena needs to write an @p x_size byte number
+ * in base @p base, or 0 if @p base isn't in [2, 36]. Exact when @p x has no
+ * leading zero bytes, and an upper bound otherwise.
+ */
+size_t to_base_itch(size_t x_size, unsigned base) {
+  if (base < 2 || base > 36)
+    return 0;
+
+  radix_info r;
+  radix_info_init(&r, base);
+
+  return to_base_bytes(limbs_for_bytes(x_size), &r);
+}
+
+/**
+ * @brief to_base with every temporary taken from @p arena instead of the heap.
+ * Same contract as to_base, except that error code 2 means @p arena has fewer
+ * than to_base_itch(@p x_size, @p base) bytes free. Everything taken from @p
+ * arena is given back before returning.
+ */
+uint8_t to_base_arena(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                      size_t s_size, unsigned base, jl_arena *arena) {
+  // Error check 1.
+  if (x == NULL | s == NULL | s_len == NULL | arena == NULL)
+    return 1;
+
+  JL_PERF_BEGIN(JL_PERF_TO_BASE, x_size);
+  const uint8_t rc = to_base_nocheck(x, s, s_len, x_size, s_size, base, arena);
+  JL_PERF_END();
+
+  return rc;
+}
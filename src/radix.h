@@ -0,0 +1,44 @@
+#ifndef __JL_RADIX_H__
+#define __JL_RADIX_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "limb.h"
+
+// Size, in limbs, below which conversions run digit by digit instead of
+// splitting in half. Can also be changed at runtime.
+#ifndef JL_RADIX_DC_THRESHOLD
+#define JL_RADIX_DC_THRESHOLD 30
+#endif
+
+void set_radix_dc_threshold(size_t n);
+
+size_t get_radix_dc_threshold(void);
+
+uint8_t from_base(const char *s, uint8_t *z, uint8_t *flags, size_t s_len,
+                  size_t z_size, unsigned base);
+
+uint8_t from_decimal(const char *s, uint8_t *z, uint8_t *flags, size_t s_len,
+                     size_t z_size);
+
+size_t to_base_size(size_t x_size, unsigned base);
+
+uint8_t to_base(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                size_t s_size, unsigned base);
+
+uint8_t to_decimal(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                   size_t s_size);
+
+size_t from_base_itch(size_t s_len, unsigned base);
+
+uint8_t from_base_arena(const char *s, uint8_t *z, uint8_t *flags,
+                        size_t s_len, size_t z_size, unsigned base,
+                        jl_arena *arena);
+
+size_t to_base_itch(size_t x_size, unsigned base);
+
+uint8_t to_base_arena(const uint8_t *x, char *s, size_t *s_len, size_t x_size,
+                      size_t s_size, unsigned base, jl_arena *arena);
+#endif
@@ -0,0 +1,340 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+#include "jl_int.h"
+#include "limb.h"
+#include "root.h"
+
+/*
+ * floor(x^(1/k)) by Newton's iteration on integers,
+ *
+ *   z' = floor(((k - 1) z + floor(x / z^(k - 1))) / k),
+ *
+ * which for any z > 0 gives z' >= floor(x^(1/k)), and from any z above the
+ * root gives z' < z. So starting above the root, the first z' >= z is found
+ * right after the root.
+ *
+ * The start comes from the root of the top half of x: if the root has m bits,
+ * y = floor((x >> k h)^(1/k)) for h = m / 2 is right to about m / 2 bits, and
+ * (y + 1) << h is above the root. One step takes that to within a few units
+ * of the root, and usually onto it. Each level works at twice the precision of
+ * the one below, so the whole costs a small multiple of the last level's: a
+ * division (built on mul_limbs) and a power of the root.
+ */
+
+// z = x^e, for e >= 1. z may not be x.
+static uint8_t pow_u64(jl_int *z, const jl_int *x, uint64_t e) {
+  uint8_t rc = int_set(z, x);
+  for (int i = 62 - clz_limb(e); i >= 0 && rc == 0; i--) {
+    rc |= int_mul(z, z, z);
+    if (e >> i & 1)
+      rc |= int_mul(z, z, x);
+  }
+  return rc;
+}
+
+// floor(v^(1/k)) for v > 0 and k below the bit length of v, a bit at a time.
+static uint64_t root_u64(uint64_t v, uint64_t k) {
+  uint64_t z = 0;
+  for (int i = (int)((63 - clz_limb(v)) / k); i >= 0; i--) {
+    const uint64_t c = z | (uint64_t)1 << i;
+    // c^k, stopping once it's past v; c < 2^33, so this can't wrap.
+    unsigned __int128 p = 1;
+    for (uint64_t j = 0; j < k && p <= v; j++)
+      p *= c;
+    if (p <= v)
+      z = c;
+  }
+  return z;
+}
+
+// Newton's iteration from z, which is above floor(x^(1/k)), down to it, with
+// p = z^k on the way out. After each step z is at or above the root, and is
+// the root if z^k <= x, which a power checks without the division a further
+// step would take. A square root is at most a couple above by then, and walks
+// down the rest with (z - 1)^2 = z^2 - 2 z + 1.
+static uint8_t newton(jl_int *z, jl_int *p, const jl_int *x, uint64_t k) {
+  jl_int t, u, c;
+  int_init(&t);
+  int_init(&u);
+  int_init(&c);
+
+  uint8_t rc = 0;
+  for (;;) {
+    if (k == 2) {
+      rc |= int_divrem(&t, NULL, x, z);
+    } else {
+      rc |= pow_u64(&u, z, k - 1);
+      rc |= int_divrem(&t, NULL, x, &u);
+    }
+    int_set_u64(&c, k - 1);
+    rc |= int_mul(&u, z, &c);
+    rc |= int_add(&t, &t, &u);
+    int_set_u64(&c, k);
+    rc |= int_divrem(&t, NULL, &t, &c);
+    if (rc != 0)
+      break;
+    if (int_cmp(&t, z) >= 0) {
+      rc |= pow_u64(p, z, k);
+      break;
+    }
+
+    int_swap(z, &t);
+    rc |= pow_u64(p, z, k);
+    if (rc != 0 || int_cmp(p, x) <= 0)
+      break;
+    if (k == 2) {
+      int_set_u64(&c, 1);
+      do {
+        rc |= int_add(&u, z, z);
+        rc |= int_sub(&u, &u, &c);
+        rc |= int_sub(p, p, &u);
+        rc |= int_sub(z, z, &c);
+      } while (rc == 0 && int_cmp(p, x) > 0);
+      break;
+    }
+  }
+
+  int_free(&t);
+  int_free(&u);
+  int_free(&c);
+  return rc;
+}
+
+// z = floor(x^(1/k)) and p = z^k, for x > 0 and k >= 2. Neither output may be
+// x.
+static uint8_t root_rec(jl_int *z, jl_int *p, const jl_int *x, uint64_t k) {
+  // x < 2^b <= 2^k, so the root is 1.
+  const size_t b = int_bit_length(x);
+  if (b <= k) {
+    int_set_u64(z, 1);
+    int_set_u64(p, 1);
+    return 0;
+  }
+  if (x->n == 1) {
+    int_set_u64(z, root_u64(int_limbs(x)[0], k));
+    return pow_u64(p, z, k);
+  }
+
+  const size_t m = (b + k - 1) / k;
+  const size_t h = m / 2;
+  jl_int t;
+  int_init(&t);
+  uint8_t rc = int_rshift(&t, x, k * h);
+  if (rc == 0)
+    rc = root_rec(z, p, &t, k);
+  int_free(&t);
+  if (rc != 0)
+    return rc;
+
+  int_set_u64(p, 1);
+  rc = int_add(z, z, p);
+  if (rc == 0)
+    rc = int_lshift(z, z, h);
+  if (rc == 0)
+    rc = newton(z, p, x, k);
+  return rc;
+}
+
+/**
+ * @brief Stores floor(sqrt(@p x)) in @p s. The two may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p s or @p x is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p x is negative. @p s is unchanged.
+ */
+uint8_t int_sqrt(jl_int *s, const jl_int *x) {
+  // Error check 1.
+  if (s == NULL | x == NULL)
+    return 1;
+
+  return int_sqrtrem(s, NULL, x);
+}
+
+/**
+ * @brief Stores s = floor(sqrt(@p x)) in @p s and @p x - s^2 in @p r, which
+ * is at most 2 s.
+ *
+ * @p r may be NULL if not wanted. The outputs must be distinct, but either
+ * may be @p x.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p s or @p x is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p x is negative. The outputs are unchanged.
+ */
+uint8_t int_sqrtrem(jl_int *s, jl_int *r, const jl_int *x) {
+  // Error check 1.
+  if (s == NULL | x == NULL)
+    return 1;
+
+  // Error check 3.
+  if (x->neg)
+    return 3;
+
+  jl_int z, t;
+  int_init(&z);
+  int_init(&t);
+  uint8_t rc = 0;
+  if (x->n > 0)
+    rc = root_rec(&z, &t, x, 2);
+  if (rc == 0 && r != NULL)
+    rc = int_sub(&t, x, &t);
+  if (rc == 0) {
+    if (r != NULL)
+      int_swap(r, &t);
+    int_swap(s, &z);
+  }
+
+  int_free(&z);
+  int_free(&t);
+  return rc;
+}
+
+/**
+ * @brief Stores the integer part of the @p k-th root of @p x in @p z: the
+ * root of |@p x| with the sign of @p x, so rounded towards zero. @p z and @p
+ * x may be the same jl_int.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p z or @p x is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p k is zero, or even and @p x is negative. @p z is unchanged.
+ */
+uint8_t int_root(jl_int *z, const jl_int *x, uint64_t k) {
+  // Error check 1.
+  if (z == NULL | x == NULL)
+    return 1;
+
+  // Error check 3.
+  if (k == 0 || (x->neg && k % 2 == 0))
+    return 3;
+
+  if (k == 1)
+    return int_set(z, x);
+
+  jl_int a, y, p;
+  int_init(&a);
+  int_init(&y);
+  int_init(&p);
+  uint8_t rc = int_abs(&a, x);
+  if (rc == 0 && a.n > 0)
+    rc = root_rec(&y, &p, &a, k);
+  if (rc == 0) {
+    y.neg = x->neg && y.n > 0;
+    int_swap(z, &y);
+  }
+
+  int_free(&a);
+  int_free(&y);
+  int_free(&p);
+  return rc;
+}
+
+/**
+ * @brief Stores s = floor(sqrt(@p x)) in @p s, and @p x - s^2 in @p r.
+ *
+ * The root always fits in half of @p x_size bytes, rounded up, and the
+ * remainder in one byte more.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p s, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the root doesn't fit in @p s_size bytes, in which case @p s
+ *        holds its low @p s_size bytes.
+ *      1. The same for the remainder and @p r_size.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] s (uint8_t*): The root, little-endian, zero-padded to @p s_size
+ * bytes.
+ * @param[out] r (uint8_t*): The remainder, little-endian, zero-padded to @p
+ * r_size bytes. May be NULL if not wanted.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] s_size (size_t): Size of @p s.
+ * @param[in] r_size (size_t): Size of @p r.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t sqrtrem_bstrings(const uint8_t *x, uint8_t *s, uint8_t *r,
+                         uint8_t *flags, size_t x_size, size_t s_size,
+                         size_t r_size) {
+  // Error check 1.
+  if (x == NULL | s == NULL | flags == NULL)
+    return 1;
+
+  jl_int a, b;
+  int_init(&a);
+  int_init(&b);
+  uint8_t rc = int_set_bstring(&a, x, 0, x_size);
+  if (rc == 0)
+    rc = int_sqrtrem(&a, r != NULL ? &b : NULL, &a);
+  if (rc == 0) {
+    int_get_bstring(&a, s, flags, s_size);
+    uint8_t f = *flags & 1;
+    if (r != NULL) {
+      int_get_bstring(&b, r, flags, r_size);
+      f |= (*flags & 1) << 1;
+    }
+    *flags = f;
+  }
+
+  int_free(&a);
+  int_free(&b);
+  return rc;
+}
+
+/**
+ * @brief Stores floor(@p x^(1/@p k)) in @p z.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed.
+ *      3. @p k is zero.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Set if the root doesn't fit in @p z_size bytes, in which case @p z
+ *        holds its low @p z_size bytes.
+ *
+ * @param[in] x (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (uint8_t*): The root, little-endian, zero-padded to @p z_size
+ * bytes.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[in] k (uint64_t): The degree of the root.
+ * @param[in] x_size (size_t): Size of @p x.
+ * @param[in] z_size (size_t): Size of @p z.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t root_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                      uint64_t k, size_t x_size, size_t z_size) {
+  // Error check 1.
+  if (x == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  jl_int a;
+  int_init(&a);
+  uint8_t rc = int_set_bstring(&a, x, 0, x_size);
+  if (rc == 0)
+    rc = int_root(&a, &a, k);
+  if (rc == 0) {
+    int_get_bstring(&a, z, flags, z_size);
+    *flags &= 1;
+  }
+
+  int_free(&a);
+  return rc;
+}
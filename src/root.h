@@ -0,0 +1,21 @@
+#ifndef __JL_ROOT_H__
+#define __JL_ROOT_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "jl_int.h"
+
+uint8_t int_sqrt(jl_int *s, const jl_int *x);
+
+uint8_t int_sqrtrem(jl_int *s, jl_int *r, const jl_int *x);
+
+uint8_t int_root(jl_int *z, const jl_int *x, uint64_t k);
+
+uint8_t sqrtrem_bstrings(const uint8_t *x, uint8_t *s, uint8_t *r,
+                         uint8_t *flags, size_t x_size, size_t s_size,
+                         size_t r_size);
+
+uint8_t root_bstrings(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                      uint64_t k, size_t x_size, size_t z_size);
+#endif
@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_par.h"
+#include "add_sub_mul.h"
+#include "limb.h"
+#include "mul_par.h"
+#include "pool.h"
+#include "stream.h"
+
+static size_t stream_chunk = JL_STREAM_CHUNK;
+
+/**
+ * @brief Sets how many bytes of each operand the file operations read at a
+ * time. Rounded down to whole limbs, and never below one. The build-time
+ * default is JL_STREAM_CHUNK.
+ */
+void set_stream_chunk(size_t n) {
+  n -= n % JL_LIMB_BYTES;
+  stream_chunk = n < JL_LIMB_BYTES ? JL_LIMB_BYTES : n;
+}
+
+size_t get_stream_chunk(void) { return stream_chunk; }
+
+// Reads up to n bytes of x into buf, and zeroes the rest of the n. Returns the
+// bytes read, or SIZE_MAX on a read error.
+static size_t read_chunk(FILE *x, uint8_t *buf, size_t n) {
+  const size_t got = fread(buf, 1, n, x);
+  if (got < n && ferror(x))
+    return SIZE_MAX;
+  memset(buf + got, 0, n - got);
+  return got;
+}
+
+// x + y or x - y a chunk at a time, through add_bytes_par or sub_bytes_par,
+// which take the carry or borrow of the chunk before.
+static uint8_t add_files_nocheck(FILE *x, FILE *y, FILE *z, uint8_t *flags,
+                                 uint64_t *z_size, int sub) {
+  const size_t chunk = stream_chunk;
+  uint8_t *buf = malloc(2 * chunk);
+  if (buf == NULL)
+    return 2;
+
+  uint8_t *xb = buf;
+  uint8_t *yb = buf + chunk;
+  jl_limb_t carry = 0;
+  uint64_t total = 0;
+  uint8_t rc = 0;
+  for (;;) {
+    const size_t x_got = read_chunk(x, xb, chunk);
+    const size_t y_got = read_chunk(y, yb, chunk);
+    if (x_got == SIZE_MAX || y_got == SIZE_MAX) {
+      rc = 3;
+      break;
+    }
+    const size_t n = x_got > y_got ? x_got : y_got;
+    if (n == 0)
+      break;
+
+    // The sum goes over x, which isn't read again.
+    carry = sub ? sub_bytes_par(xb, yb, xb, n, carry)
+                : add_bytes_par(xb, yb, xb, n, carry);
+    if (fwrite(xb, 1, n, z) != n) {
+      rc = 3;
+      break;
+    }
+    total += n;
+    if (n < chunk)
+      break;
+  }
+  free(buf);
+
+  if (z_size != NULL)
+    *z_size = total;
+  *flags = (uint8_t)carry;
+
+  return rc;
+}
+
+/**
+ * @brief Adds the integers in the streams @p x and @p y, read to the end, and
+ * writes the sum to @p z. The sum is as long as the longer operand; a carry
+ * out of its top byte is reported in @p flags rather than written.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, @p z, or @p flags is NULL.
+ *      2. Memory allocation failed. Nothing was written, unless it was the
+ *        scratch for a short last chunk, after the rest of the product.
+ *      3. Reading or writing a stream failed. @p z holds the sum up to the
+ *        last whole chunk.
+ *
+ *  - Flags (bit index, significance increasing):
+ *      0. Carry bit. Set if the sum doesn't fit in the bytes written.
+ *
+ * @param[in] x (FILE*): Opened for reading, at the least significant byte.
+ * @param[in] y (FILE*): Opened for reading, at the least significant byte.
+ * @param[out] z (FILE*): Opened for writing. Must not be @p x or @p y.
+ * @param[out] flags (uint8_t*): See Flags in the description.
+ * @param[out] z_size (uint64_t*): The bytes written to @p z. May be NULL.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t add_files(FILE *x, FILE *y, FILE *z, uint8_t *flags,
+                  uint64_t *z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  return add_files_nocheck(x, y, z, flags, z_size, 0);
+}
+
+/**
+ * @brief Subtracts the integer in the stream @p y from that in @p x, and
+ * writes the difference to @p z, as long as the longer operand. If @p x < @p
+ * y, bit 0 of @p flags is set and @p z holds the difference modulo 2^(8 times
+ * its length), as with sub_bstrings. Otherwise the same contract as add_files.
+ */
+uint8_t sub_files(FILE *x, FILE *y, FILE *z, uint8_t *flags,
+                  uint64_t *z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL | flags == NULL)
+    return 1;
+
+  return add_files_nocheck(x, y, z, flags, z_size, 1);
+}
+
+/**
+ * @brief Multiplies the integer in the stream @p x by the byte string @p y,
+ * and writes the whole product to @p z: the length of @p x plus @p y_size
+ * bytes.
+ *
+ * @p x is read a chunk of get_stream_chunk bytes at a time, or as long as @p
+ * y if that's longer, so that each chunk product is balanced. Each chunk is
+ * multiplied by @p y with mul_limbs (mul_limbs_par when the pool is running),
+ * the top @p y_size bytes of the previous chunk product are added in, and the
+ * low part, which nothing later reaches, is written out. Memory use is a few
+ * times the chunk size, whatever the length of @p x.
+ *
+ *  - Error codes:
+ *      0. Success.
+ *      1. @p x, @p y, or @p z is NULL.
+ *      2. Memory allocation failed. Nothing was written, unless it was the
+ *        scratch for a short last chunk, after the rest of the product.
+ *      3. Reading or writing a stream failed.
+ *
+ * @param[in] x (FILE*): Opened for reading, at the least significant byte.
+ * @param[in] y (uint8_t*): Points to an array of bytes in little-endian
+ * order.
+ * @param[out] z (FILE*): Opened for writing. Must not be @p x.
+ * @param[in] y_size (size_t): Size of @p y.
+ * @param[out] z_size (uint64_t*): The bytes written to @p z. May be NULL.
+ *
+ * @return (uint8_t): An error code. See description for details.
+ */
+uint8_t mul_file_bstring(FILE *x, const uint8_t *y, FILE *z, size_t y_size,
+                         uint64_t *z_size) {
+  // Error check 1.
+  if (x == NULL | y == NULL | z == NULL)
+    return 1;
+
+  // A zero-length y is the one limb 0, so the loop below needn't know.
+  const size_t y_n = y_size ? limbs_for_bytes(y_size) : 1;
+  size_t c_n = stream_chunk / JL_LIMB_BYTES;
+  if (c_n < y_n)
+    c_n = y_n;
+  const size_t chunk = c_n * JL_LIMB_BYTES;
+
+  const int par = get_pool_threads() > 1 && y_n >= get_mul_par_grain();
+  const size_t itch =
+      par ? mul_limbs_par_itch(c_n, y_n) : mul_limbs_itch(c_n, y_n);
+  const size_t total = y_n + c_n + (c_n + y_n) + y_n + itch;
+  // xb holds a chunk of x on the way in, and of the product on the way out.
+  jl_limb_t *buf = malloc(total * sizeof(jl_limb_t) + 2 * chunk);
+  if (buf == NULL)
+    return 2;
+
+  jl_limb_t *yl = buf;
+  jl_limb_t *xl = yl + y_n;
+  jl_limb_t *pl = xl + c_n;
+  jl_limb_t *cl = pl + c_n + y_n;
+  jl_limb_t *scratch = cl + y_n;
+  uint8_t *xb = (uint8_t *)(buf + total);
+  bytes_to_limbs(yl, y_n, y, y_size);
+  memset(cl, 0, y_n * sizeof(jl_limb_t));
+
+  uint64_t written = 0;
+  uint8_t rc = 0;
+  for (;;) {
+    const size_t got = read_chunk(x, xb, chunk);
+    if (got == SIZE_MAX) {
+      rc = 3;
+      break;
+    }
+    if (got == 0)
+      break;
+
+    // The carry from the chunk before is below B^y_n, and so is the top
+    // half of this chunk's product plus that carry.
+    const size_t x_n = limbs_for_bytes(got);
+    bytes_to_limbs(xl, x_n, xb, got);
+    // Neither itch grows steadily with x_n, so a short last chunk may need
+    // more scratch than a whole one.
+    jl_limb_t *s = scratch;
+    if (x_n < c_n) {
+      const size_t need =
+          par ? mul_limbs_par_itch(x_n, y_n) : mul_limbs_itch(x_n, y_n);
+      if (need > itch && (s = malloc(need * sizeof(jl_limb_t))) == NULL) {
+        rc = 2;
+        break;
+      }
+    }
+    if (par)
+      mul_limbs_par(pl, xl, x_n, yl, y_n, s);
+    else
+      mul_limbs(pl, xl, x_n, yl, y_n, s);
+    if (s != scratch)
+      free(s);
+    add_1(pl + y_n, pl + y_n, x_n, add_n(pl, pl, cl, y_n));
+
+    if (got < chunk) {
+      // The last chunk, whose product is the rest of the result.
+      const size_t n = got + y_size;
+      limbs_to_bytes(xb, n, pl, x_n + y_n);
+      if (fwrite(xb, 1, n, z) != n)
+        rc = 3;
+      else
+        written += n;
+      y_size = 0;
+      break;
+    }
+
+    limbs_to_bytes(xb, chunk, pl, c_n);
+    if (fwrite(xb, 1, chunk, z) != chunk) {
+      rc = 3;
+      break;
+    }
+    written += chunk;
+    memcpy(cl, pl + c_n, y_n * sizeof(jl_limb_t));
+  }
+
+  // x ended on a chunk boundary; the carry is the top of the product.
+  if (rc == 0 && y_size > 0) {
+    limbs_to_bytes(xb, y_size, cl, y_n);
+    if (fwrite(xb, 1, y_size, z) != y_size)
+      rc = 3;
+    else
+      written += y_size;
+  }
+  free(buf);
+
+  if (z_size != NULL)
+    *z_size = written;
+
+  return rc;
+}
@@ -0,0 +1,39 @@
+#ifndef __JL_STREAM_H__
+#define __JL_STREAM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+/*
+ * Arithmetic on integers kept in files, as little-endian byte strings running
+ * from the current position of each stream to its end. The least significant
+ * byte comes first, so carries and borrows run in the same direction as the
+ * file is read: each operation makes one sequential pass, a chunk at a time,
+ * and holds only a few chunks in memory however long the operands are. The
+ * result is written to another stream from its current position.
+ *
+ * mul_file_bstring multiplies a file by an operand that fits in memory. A
+ * product of two operands that both need to stay on disk isn't supported.
+ */
+
+// Bytes read from each operand per pass of the loop. Can also be changed at
+// runtime.
+#ifndef JL_STREAM_CHUNK
+#define JL_STREAM_CHUNK (1 << 20)
+#endif
+
+void set_stream_chunk(size_t n);
+
+size_t get_stream_chunk(void);
+
+uint8_t add_files(FILE *x, FILE *y, FILE *z, uint8_t *flags,
+                  uint64_t *z_size);
+
+uint8_t sub_files(FILE *x, FILE *y, FILE *z, uint8_t *flags,
+                  uint64_t *z_size);
+
+uint8_t mul_file_bstring(FILE *x, const uint8_t *y, FILE *z, size_t y_size,
+                         uint64_t *z_size);
+#endif
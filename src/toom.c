@@ -0,0 +1,391 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "add_sub_mul.h"
+#include "limb.h"
+#include "toom.h"
+
+// Neither tier splits operands smaller than this, whatever the thresholds say,
+// so every recursive product is strictly smaller than its parent.
+#define JL_TOOM_MIN_LIMBS 8
+
+static size_t mul_toom3_threshold = JL_MUL_TOOM3_THRESHOLD;
+static size_t mul_toom4_threshold = JL_MUL_TOOM4_THRESHOLD;
+
+/**
+ * @brief Sets the operand size, in limbs, at which mul_limbs switches from
+ * Karatsuba to Toom-3. The build-time default is JL_MUL_TOOM3_THRESHOLD.
+ */
+void set_mul_toom3_threshold(size_t n) {
+  mul_toom3_threshold = n < JL_TOOM_MIN_LIMBS ? JL_TOOM_MIN_LIMBS : n;
+}
+
+size_t get_mul_toom3_threshold(void) { return mul_toom3_threshold; }
+
+/**
+ * @brief Sets the operand size, in limbs, at which mul_limbs switches from
+ * Toom-3 to Toom-4. The build-time default is JL_MUL_TOOM4_THRESHOLD.
+ */
+void set_mul_toom4_threshold(size_t n) {
+  mul_toom4_threshold = n < JL_TOOM_MIN_LIMBS ? JL_TOOM_MIN_LIMBS : n;
+}
+
+size_t get_mul_toom4_threshold(void) { return mul_toom4_threshold; }
+
+/*
+ * Signed slots.
+ *
+ * Evaluating at negative points and interpolating both produce negative
+ * intermediates. Rather than carry a sign next to every magnitude, they live
+ * in fixed-width two's complement slots of w limbs: add_n, sub_n and submul_1
+ * are already correct mod B^w, halving is an arithmetic shift, and exact
+ * division by an odd constant is multiplication by its inverse mod B^w. The
+ * slots are two limbs wider than any coefficient, so no intermediate comes
+ * near the sign bit.
+ */
+
+// z = -z
+static void neg_slot(jl_limb_t *z, size_t w) {
+  jl_limb_t borrow = 0;
+  for (size_t i = 0; i < w; i++)
+    z[i] = subb_limb(0, z[i], borrow, &borrow);
+}
+
+// z = z / 2^bits, rounding toward -inf. 0 < bits < 64.
+static void rshift_slot(jl_limb_t *z, size_t w, unsigned bits) {
+  for (size_t i = 0; i + 1 < w; i++)
+    z[i] = (z[i] >> bits) | (z[i + 1] << (JL_LIMB_BITS - bits));
+  z[w - 1] = (jl_limb_t)((int64_t)z[w - 1] >> bits);
+}
+
+// z = z / d, for odd d known to divide z.
+static void divexact_slot(jl_limb_t *z, size_t w, jl_limb_t d) {
+  // d is its own inverse mod 8; each Newton step doubles the correct bits.
+  jl_limb_t inv = d;
+  for (int i = 0; i < 5; i++)
+    inv *= 2 - d * inv;
+
+  jl_limb_t borrow = 0;
+  for (size_t i = 0; i < w; i++) {
+    const jl_limb_t s = z[i];
+    const jl_limb_t l = s - borrow;
+    borrow = l > s;
+    const jl_limb_t q = l * inv;
+    z[i] = q;
+    jl_limb_t hi;
+    mul_limb(q, d, &hi);
+    borrow += hi;
+  }
+}
+
+// z += s B^off, where s is a nonnegative slot and the sum fits in z_n limbs.
+static void add_slot(jl_limb_t *z, size_t z_n, size_t off, const jl_limb_t *s,
+                     size_t w) {
+  if (off >= z_n)
+    return;
+
+  const size_t len = z_n - off < w ? z_n - off : w;
+  jl_limb_t carry = add_n(z + off, z + off, s, len);
+  add_1(z + off + len, z + off + len, z_n - off - len, carry);
+}
+
+/*
+ * Evaluation.
+ *
+ * x is split into m pieces of k limbs, x = sum x_i B^(ik). The top pieces may
+ * be short, or empty when x_n is barely past (m - 1) k.
+ */
+
+static size_t piece_len(size_t n, size_t k, size_t i) {
+  if (n <= i * k)
+    return 0;
+
+  return n - i * k < k ? n - i * k : k;
+}
+
+// e = sum of a^i x_i over even i, o = the same over odd i. Both are k + 1
+// limbs, enough for any point up to 3 with m <= 4.
+static void eval_even_odd(jl_limb_t *e, jl_limb_t *o, const jl_limb_t *x,
+                          size_t x_n, size_t k, unsigned m, jl_limb_t a) {
+  memset(e, 0, (k + 1) * sizeof(jl_limb_t));
+  memset(o, 0, (k + 1) * sizeof(jl_limb_t));
+
+  jl_limb_t pow = 1;
+  for (unsigned i = 0; i < m; i++, pow *= a) {
+    jl_limb_t *v = (i & 1) ? o : e;
+    const size_t len = piece_len(x_n, k, i);
+    jl_limb_t carry = addmul_1(v, x + i * k, len, pow);
+    add_1(v + len, v + len, k + 1 - len, carry);
+  }
+}
+
+// z = |e - o|. Returns 1 if e < o.
+static int abs_diff(jl_limb_t *z, const jl_limb_t *e, const jl_limb_t *o,
+                    size_t n) {
+  if (cmp_n(e, o, n) < 0) {
+    sub_n(z, o, e, n);
+    return 1;
+  }
+
+  sub_n(z, e, o, n);
+  return 0;
+}
+
+// slot = x y, zero-extended to w limbs.
+static void mul_slot(jl_limb_t *slot, size_t w, const jl_limb_t *x, size_t x_n,
+                     const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (x == y && x_n == y_n)
+    sqr_limbs(slot, x, x_n, scratch);
+  else
+    mul_limbs(slot, x, x_n, y, y_n, scratch);
+  memset(slot + x_n + y_n, 0, (w - x_n - y_n) * sizeof(jl_limb_t));
+}
+
+// Fills r_pos = x(a) y(a) and r_neg = x(-a) y(-a), both signed slots of
+// 2k + 2 limbs. buf holds 6 (k + 1) limbs. When x is y, only x is evaluated
+// and the values are squared.
+static void eval_mul_pm(jl_limb_t *r_pos, jl_limb_t *r_neg, const jl_limb_t *x,
+                        size_t x_n, const jl_limb_t *y, size_t y_n, size_t k,
+                        unsigned m, jl_limb_t a, jl_limb_t *buf,
+                        jl_limb_t *scratch) {
+  jl_limb_t *xe = buf, *xo = xe + k + 1;
+  jl_limb_t *ye = xo + k + 1, *yo = ye + k + 1;
+  jl_limb_t *xv = yo + k + 1, *yv = xv + k + 1;
+
+  eval_even_odd(xe, xo, x, x_n, k, m, a);
+
+  if (x == y && x_n == y_n) {
+    add_n(xv, xe, xo, k + 1);
+    sqr_limbs(r_pos, xv, k + 1, scratch);
+    if (r_neg != NULL) {
+      abs_diff(xv, xe, xo, k + 1);
+      sqr_limbs(r_neg, xv, k + 1, scratch);
+    }
+    return;
+  }
+
+  eval_even_odd(ye, yo, y, y_n, k, m, a);
+
+  add_n(xv, xe, xo, k + 1);
+  add_n(yv, ye, yo, k + 1);
+  mul_limbs(r_pos, xv, k + 1, yv, k + 1, scratch);
+
+  if (r_neg == NULL)
+    return;
+
+  const int neg = abs_diff(xv, xe, xo, k + 1) ^ abs_diff(yv, ye, yo, k + 1);
+  mul_limbs(r_neg, xv, k + 1, yv, k + 1, scratch);
+  if (neg)
+    neg_slot(r_neg, 2 * k + 2);
+}
+
+/**
+ * @brief Number of scratch limbs mul_toom3 needs for an @p x_n by @p y_n limb
+ * product, including everything its recursive calls to mul_limbs need.
+ */
+size_t mul_toom3_itch(size_t x_n, size_t y_n) {
+  const size_t n = x_n > y_n ? x_n : y_n;
+  const size_t k = (n + 2) / 3;
+
+  return 5 * (2 * k + 2) + 6 * (k + 1) + mul_limbs_itch(k + 1, k + 1);
+}
+
+/**
+ * @brief Number of scratch limbs mul_toom4 needs for an @p x_n by @p y_n limb
+ * product, including everything its recursive calls to mul_limbs need.
+ */
+size_t mul_toom4_itch(size_t x_n, size_t y_n) {
+  const size_t n = x_n > y_n ? x_n : y_n;
+  const size_t k = (n + 3) / 4;
+
+  return 7 * (2 * k + 2) + 6 * (k + 1) + mul_limbs_itch(k + 1, k + 1);
+}
+
+/**
+ * @brief Number of scratch limbs sqr_toom3 needs for an @p n limb square.
+ */
+size_t sqr_toom3_itch(size_t n) { return mul_toom3_itch(n, n); }
+
+/**
+ * @brief Number of scratch limbs sqr_toom4 needs for an @p n limb square.
+ */
+size_t sqr_toom4_itch(size_t n) { return mul_toom4_itch(n, n); }
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z using Toom-3: both operands are split into 3 pieces, evaluated at 0, 1,
+ * -1, 2 and infinity, multiplied pointwise through mul_limbs, and
+ * interpolated back.
+ *
+ * Works for any sizes, but only pays off when the operands are large and
+ * within about 2:1 of each other. If @p x is @p y, the pointwise products are
+ * squares and each point is evaluated once. @p z may not overlap @p x, @p y
+ * or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_toom3_itch(@p x_n, @p y_n)
+ * limbs.
+ */
+void mul_toom3(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  const size_t k = (x_n + 2) / 3;
+  const size_t w = 2 * k + 2;
+
+  jl_limb_t *r0 = scratch;
+  jl_limb_t *r1 = r0 + w;
+  jl_limb_t *rm1 = r1 + w;
+  jl_limb_t *r2 = rm1 + w;
+  jl_limb_t *rinf = r2 + w;
+  jl_limb_t *buf = rinf + w;
+  scratch = buf + 6 * (k + 1);
+
+  mul_slot(r0, w, x, piece_len(x_n, k, 0), y, piece_len(y_n, k, 0), scratch);
+  mul_slot(rinf, w, x + 2 * k, piece_len(x_n, k, 2), y + 2 * k,
+           piece_len(y_n, k, 2), scratch);
+  eval_mul_pm(r1, rm1, x, x_n, y, y_n, k, 3, 1, buf, scratch);
+  eval_mul_pm(r2, NULL, x, x_n, y, y_n, k, 3, 2, buf, scratch);
+
+  // With r(t) = c0 + c1 t + c2 t^2 + c3 t^3 + c4 t^4, c0 = r(0), c4 = r(inf):
+  sub_n(rm1, r1, rm1, w);
+  rshift_slot(rm1, w, 1); // c1 + c3
+  sub_n(r1, r1, rm1, w);  // c0 + c2 + c4
+  sub_n(r1, r1, r0, w);
+  sub_n(r1, r1, rinf, w); // c2
+  sub_n(r2, r2, r0, w);
+  submul_1(r2, r1, w, 4);
+  submul_1(r2, rinf, w, 16);
+  rshift_slot(r2, w, 1); // c1 + 4 c3
+  sub_n(r2, r2, rm1, w);
+  divexact_slot(r2, w, 3); // c3
+  sub_n(rm1, rm1, r2, w);  // c1
+
+  const size_t z_n = x_n + y_n;
+  memset(z, 0, z_n * sizeof(jl_limb_t));
+  add_slot(z, z_n, 0, r0, w);
+  add_slot(z, z_n, k, rm1, w);
+  add_slot(z, z_n, 2 * k, r1, w);
+  add_slot(z, z_n, 3 * k, r2, w);
+  add_slot(z, z_n, 4 * k, rinf, w);
+}
+
+/**
+ * @brief Stores the full @p x_n + @p y_n limb product of @p x and @p y in @p
+ * z using Toom-4: both operands are split into 4 pieces, evaluated at 0, 1,
+ * -1, 2, -2, 3 and infinity, multiplied pointwise through mul_limbs, and
+ * interpolated back.
+ *
+ * Works for any sizes, but only pays off when the operands are large and
+ * within about 2:1 of each other. If @p x is @p y, the pointwise products are
+ * squares and each point is evaluated once. @p z may not overlap @p x, @p y
+ * or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least mul_toom4_itch(@p x_n, @p y_n)
+ * limbs.
+ */
+void mul_toom4(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch) {
+  if (x_n < y_n) {
+    const jl_limb_t *tp = x;
+    x = y;
+    y = tp;
+    size_t tn = x_n;
+    x_n = y_n;
+    y_n = tn;
+  }
+
+  const size_t k = (x_n + 3) / 4;
+  const size_t w = 2 * k + 2;
+
+  jl_limb_t *r0 = scratch;
+  jl_limb_t *r1 = r0 + w;
+  jl_limb_t *rm1 = r1 + w;
+  jl_limb_t *r2 = rm1 + w;
+  jl_limb_t *rm2 = r2 + w;
+  jl_limb_t *r3 = rm2 + w;
+  jl_limb_t *rinf = r3 + w;
+  jl_limb_t *buf = rinf + w;
+  scratch = buf + 6 * (k + 1);
+
+  mul_slot(r0, w, x, piece_len(x_n, k, 0), y, piece_len(y_n, k, 0), scratch);
+  mul_slot(rinf, w, x + 3 * k, piece_len(x_n, k, 3), y + 3 * k,
+           piece_len(y_n, k, 3), scratch);
+  eval_mul_pm(r1, rm1, x, x_n, y, y_n, k, 4, 1, buf, scratch);
+  eval_mul_pm(r2, rm2, x, x_n, y, y_n, k, 4, 2, buf, scratch);
+  eval_mul_pm(r3, NULL, x, x_n, y, y_n, k, 4, 3, buf, scratch);
+
+  // With r(t) = c0 + c1 t + ... + c6 t^6, c0 = r(0), c6 = r(inf):
+  sub_n(rm1, r1, rm1, w);
+  rshift_slot(rm1, w, 1); // c1 + c3 + c5
+  sub_n(r1, r1, rm1, w);  // c0 + c2 + c4 + c6
+  sub_n(rm2, r2, rm2, w);
+  rshift_slot(rm2, w, 2);  // c1 + 4 c3 + 16 c5
+  submul_1(r2, rm2, w, 2); // c0 + 4 c2 + 16 c4 + 64 c6
+  sub_n(r1, r1, r0, w);
+  sub_n(r1, r1, rinf, w); // c2 + c4
+  sub_n(r2, r2, r0, w);
+  submul_1(r2, rinf, w, 64);
+  rshift_slot(r2, w, 2); // c2 + 4 c4
+  sub_n(r2, r2, r1, w);
+  divexact_slot(r2, w, 3); // c4
+  sub_n(r1, r1, r2, w);    // c2
+  sub_n(r3, r3, r0, w);
+  submul_1(r3, r1, w, 9);
+  submul_1(r3, r2, w, 81);
+  submul_1(r3, rinf, w, 729);
+  divexact_slot(r3, w, 3); // c1 + 9 c3 + 81 c5
+  sub_n(rm2, rm2, rm1, w);
+  divexact_slot(rm2, w, 3); // c3 + 5 c5
+  sub_n(r3, r3, rm1, w);
+  rshift_slot(r3, w, 3); // c3 + 10 c5
+  sub_n(r3, r3, rm2, w);
+  divexact_slot(r3, w, 5);  // c5
+  submul_1(rm2, r3, w, 5);  // c3
+  sub_n(rm1, rm1, rm2, w);
+  sub_n(rm1, rm1, r3, w); // c1
+
+  const size_t z_n = x_n + y_n;
+  memset(z, 0, z_n * sizeof(jl_limb_t));
+  add_slot(z, z_n, 0, r0, w);
+  add_slot(z, z_n, k, rm1, w);
+  add_slot(z, z_n, 2 * k, r1, w);
+  add_slot(z, z_n, 3 * k, rm2, w);
+  add_slot(z, z_n, 4 * k, r2, w);
+  add_slot(z, z_n, 5 * k, r3, w);
+  add_slot(z, z_n, 6 * k, rinf, w);
+}
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z using Toom-3: five
+ * pointwise squares of about @p n / 3 limbs, through sqr_limbs.
+ *
+ * @p z may not overlap @p x or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_toom3_itch(@p n) limbs.
+ */
+void sqr_toom3(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch) {
+  mul_toom3(z, x, n, x, n, scratch);
+}
+
+/**
+ * @brief Stores the 2 @p n limb square of @p x in @p z using Toom-4: seven
+ * pointwise squares of about @p n / 4 limbs, through sqr_limbs.
+ *
+ * @p z may not overlap @p x or @p scratch.
+ *
+ * @param[out] scratch (jl_limb_t*): At least sqr_toom4_itch(@p n) limbs.
+ */
+void sqr_toom4(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch) {
+  mul_toom4(z, x, n, x, n, scratch);
+}
@@ -0,0 +1,46 @@
+#ifndef __JL_TOOM_H__
+#define __JL_TOOM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "limb.h"
+
+// Operand sizes, in limbs, at which mul_limbs moves up to Toom-3 and Toom-4.
+// Can also be changed at runtime.
+#ifndef JL_MUL_TOOM3_THRESHOLD
+#define JL_MUL_TOOM3_THRESHOLD 250
+#endif
+
+#ifndef JL_MUL_TOOM4_THRESHOLD
+#define JL_MUL_TOOM4_THRESHOLD 350
+#endif
+
+void set_mul_toom3_threshold(size_t n);
+
+size_t get_mul_toom3_threshold(void);
+
+void set_mul_toom4_threshold(size_t n);
+
+size_t get_mul_toom4_threshold(void);
+
+size_t mul_toom3_itch(size_t x_n, size_t y_n);
+
+size_t mul_toom4_itch(size_t x_n, size_t y_n);
+
+void mul_toom3(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+
+void mul_toom4(jl_limb_t *z, const jl_limb_t *x, size_t x_n,
+               const jl_limb_t *y, size_t y_n, jl_limb_t *scratch);
+
+size_t sqr_toom3_itch(size_t n);
+
+size_t sqr_toom4_itch(size_t n);
+
+void sqr_toom3(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch);
+
+void sqr_toom4(jl_limb_t *z, const jl_limb_t *x, size_t n,
+               jl_limb_t *scratch);
+#endif
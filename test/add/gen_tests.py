@@ -101,7 +101,7 @@ def generate_hfile() -> str:
     guard_end = "#endif"
 
     # Includes
-    include_global = ["vector"]
+    include_global = ["cstdint", "vector"]
     include_local = []
 
     local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
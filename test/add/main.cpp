@@ -1,5 +1,6 @@
 #include "cases.h"
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <stdint.h>
@@ -7,7 +8,9 @@
 #include <vector>
 
 extern "C" {
+#include "../../src/add_par.h"
 #include "../../src/add_sub_mul.h"
+#include "../../src/pool.h"
 #include "../testutils.h"
 }
 
@@ -90,7 +93,7 @@ int run_testcase_add(size_t case_id, size_t *duration) {
   return success;
 }
 
-void run_all_testcases_add() {
+void run_all_testcases_add(const char *name) {
   const size_t num_cases =
       std::max({cases_x.size(), cases_y.size(), cases_z.size()});
 
@@ -99,7 +102,7 @@ void run_all_testcases_add() {
     printf("=");
   printf("\n");
   printf("TESTING\n");
-  printf("\tFunction: \"add_bstrings\"\n");
+  printf("\tFunction: \"%s\"\n", name);
   for (int i = 0; i < 72; i++)
     printf("-");
   printf("\n");
@@ -134,6 +137,30 @@ void run_all_testcases_add() {
 }
 
 int main() {
-  run_all_testcases_add();
+  run_all_testcases_add("add_bstrings");
+
+  // Cut every carry chain into limb-sized chunks on a pool.
+  set_pool_threads(4);
+  set_add_par_grain(8);
+  run_all_testcases_add("add_bstrings (4 threads)");
+
+  // A carry that has to run through every chunk: both operands as long, so
+  // that the whole chain goes through add_bytes_par, with a byte to spare in
+  // z and without.
+  std::vector<uint8_t> x(4099, 0xFF), y(x.size(), 0);
+  y[0] = 1;
+  for (size_t extra = 0; extra < 2; extra++) {
+    std::vector<uint8_t> z(x.size() + extra, 0xAA);
+    uint8_t flags = 0;
+    add_bstrings(x.data(), y.data(), z.data(), &flags, x.size(), y.size(),
+                 z.size());
+    if ((flags & 1) != !extra || (extra && z.back() != 1) ||
+        std::count(z.begin(), z.begin() + x.size(), 0) != (long)x.size())
+      printf("Failed: add_bstrings (4 threads) carry through %zu bytes\n",
+             x.size());
+  }
+  set_add_par_grain(JL_ADD_PAR_GRAIN);
+  set_pool_threads(0);
+
   return 0;
 };
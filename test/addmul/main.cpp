@@ -0,0 +1,234 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/jl_int.h"
+#include "../testutils.h"
+}
+#include "../../src/jl_expr.hpp"
+
+// The fused products against the same sums taken the long way, through
+// int_mul and int_add. Each run is repeated with the Karatsuba threshold
+// lowered, so that products past the schoolbook sizes are covered too.
+
+static uint64_t rnd_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+// Random bytes, or all ones, to run carries the length of the value.
+static std::vector<uint8_t> random_bytes(size_t size) {
+  std::vector<uint8_t> x(size);
+  const bool ones = rnd() % 4 == 0;
+  for (size_t i = 0; i < size; i++)
+    x[i] = ones ? 0xFF : (uint8_t)rnd();
+  return x;
+}
+
+static void random_int(jl_int *z, size_t max_size) {
+  std::vector<uint8_t> x = random_bytes(rnd() % (max_size + 1));
+  int_set_bstring(z, x.data(), rnd() % 2, x.size());
+}
+
+static bool same(const jl_int *x, const jl_int *y) {
+  return int_cmp(x, y) == 0 && x->neg == y->neg;
+}
+
+// addmul_bstrings and submul_bstrings, with z's bytes compared to the exact
+// result modulo 2^(8 z_size).
+static bool run_testcase_bstrings(size_t max_size) {
+  const size_t x_size = rnd() % (max_size + 1);
+  const size_t y_size = rnd() % (max_size + 1);
+  const size_t z_size = rnd() % (x_size + y_size + 16);
+  std::vector<uint8_t> x = random_bytes(x_size), y = random_bytes(y_size);
+  std::vector<uint8_t> z0 = random_bytes(z_size);
+  const int sub = rnd() % 2;
+
+  jl_int xi, yi, zi;
+  int_init(&xi);
+  int_init(&yi);
+  int_init(&zi);
+  int_set_bstring(&xi, x.data(), 0, x_size);
+  int_set_bstring(&yi, y.data(), 0, y_size);
+  int_set_bstring(&zi, z0.data(), 0, z_size);
+  int_mul(&xi, &xi, &yi);
+  if (sub)
+    int_sub(&zi, &zi, &xi);
+  else
+    int_add(&zi, &zi, &xi);
+
+  std::vector<uint8_t> expected(z_size);
+  uint8_t flags;
+  int_get_bstring(&zi, expected.data(), &flags, z_size);
+  const uint8_t expected_flag = sub ? zi.neg : flags & 1;
+  if (zi.neg) {
+    // Two's complement of the magnitude, as the wrapped difference.
+    unsigned c = 1;
+    for (size_t i = 0; i < z_size; i++) {
+      c += (uint8_t)~expected[i];
+      expected[i] = (uint8_t)c;
+      c >>= 8;
+    }
+  }
+  int_free(&xi);
+  int_free(&yi);
+  int_free(&zi);
+
+  std::vector<uint8_t> z(z0);
+  // data() of an empty vector may be NULL, which is an error.
+  uint8_t dummy = 0;
+  const uint8_t *xp = x_size ? x.data() : &dummy;
+  const uint8_t *yp = y_size ? y.data() : &dummy;
+  uint8_t *zp = z_size ? z.data() : &dummy;
+  const uint8_t rc =
+      sub ? submul_bstrings(xp, yp, zp, &flags, x_size, y_size, z_size)
+          : addmul_bstrings(xp, yp, zp, &flags, x_size, y_size, z_size);
+
+  return rc == 0 && flags == expected_flag && z == expected;
+}
+
+// int_addmul and int_submul on signed values, sometimes into an operand.
+static bool run_testcase_int(size_t max_size) {
+  jl_int x, y, z, p, expected;
+  int_init(&x);
+  int_init(&y);
+  int_init(&z);
+  int_init(&p);
+  int_init(&expected);
+  random_int(&x, max_size);
+  random_int(&y, max_size);
+  random_int(&z, 2 * max_size);
+  const int sub = rnd() % 2;
+  const int alias = rnd() % 3;
+
+  jl_int *out = alias == 1 ? &x : alias == 2 ? &y : &z;
+  int_mul(&p, &x, &y);
+  if (sub)
+    int_sub(&expected, out, &p);
+  else
+    int_add(&expected, out, &p);
+
+  const uint8_t rc = sub ? int_submul(out, &x, &y) : int_addmul(out, &x, &y);
+  const bool ok = rc == 0 && same(out, &expected);
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&z);
+  int_free(&p);
+  int_free(&expected);
+  return ok;
+}
+
+// a b - c d + e - f, through an accumulator and through jl_int, then
+// subtracted back out again.
+static bool run_testcase_expr(size_t max_size) {
+  jl_int v[6], t, expected;
+  for (int i = 0; i < 6; i++) {
+    int_init(&v[i]);
+    random_int(&v[i], max_size);
+  }
+  int_init(&t);
+  int_init(&expected);
+
+  int_mul(&expected, &v[0], &v[1]);
+  int_mul(&t, &v[2], &v[3]);
+  int_sub(&expected, &expected, &t);
+  int_add(&expected, &expected, &v[4]);
+  int_sub(&expected, &expected, &v[5]);
+
+  jl::accumulator acc;
+  acc = jl::ref(v[0]) * jl::ref(v[1]) - jl::ref(v[2]) * jl::ref(v[3]) +
+        jl::ref(v[4]) - jl::ref(v[5]);
+  acc.get(t);
+  bool ok = same(&t, &expected);
+
+  const size_t size = int_bstring_size(&expected);
+  std::vector<uint8_t> z(size + 1), w(size + 1);
+  uint8_t flags, acc_flags;
+  int_get_bstring(&expected, z.data(), &flags, size + 1);
+  acc.get_bstring(w.data(), &acc_flags, size + 1);
+  ok &= acc.bstring_size() == size && z == w && acc_flags == flags;
+  if (size > 0) {
+    int_get_bstring(&expected, z.data(), &flags, size - 1);
+    acc.get_bstring(w.data(), &acc_flags, size - 1);
+    ok &= acc_flags == flags && memcmp(z.data(), w.data(), size - 1) == 0;
+  }
+
+  acc -= jl::ref(v[0]) * jl::ref(v[1]) - jl::ref(v[2]) * jl::ref(v[3]);
+  acc += jl::ref(v[5]) - jl::ref(v[4]);
+  acc.get(t);
+  ok &= t.n == 0 && !acc.negative();
+
+  for (int i = 0; i < 6; i++)
+    int_free(&v[i]);
+  int_free(&t);
+  int_free(&expected);
+  return ok;
+}
+
+// The low bits of the accumulator agree with jl::uint, which wraps.
+static bool run_testcase_uint() {
+  jl::uint256 a(rnd()), b(rnd()), c(rnd()), d(rnd());
+  for (size_t i = 1; i < jl::uint256::limbs; i++) {
+    a.limb[i] = rnd();
+    b.limb[i] = rnd();
+    c.limb[i] = rnd();
+    d.limb[i] = rnd();
+  }
+  jl::accumulator acc;
+  acc = jl::ref(a) * jl::ref(b) - jl::ref(c) * jl::ref(d) - jl::ref(a);
+  return acc.get_uint<256>() == a * b - c * d - a;
+}
+
+static void run_all_testcases(const char *name, bool (*run)(size_t),
+                              size_t max_size) {
+  const size_t num_cases = 1000;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  const size_t threshold = get_mul_karatsuba_threshold();
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    set_mul_karatsuba_threshold(i % 2 ? 4 : threshold);
+    if (run(max_size))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+  set_mul_karatsuba_threshold(threshold);
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+}
+
+static bool run_uint(size_t) { return run_testcase_uint(); }
+
+int main() {
+  run_all_testcases("addmul_bstrings/submul_bstrings", run_testcase_bstrings,
+                    400);
+  run_all_testcases("int_addmul/int_submul", run_testcase_int, 400);
+  run_all_testcases("jl::accumulator", run_testcase_expr, 300);
+  run_all_testcases("jl::accumulator::get_uint", run_uint, 0);
+  return 0;
+}
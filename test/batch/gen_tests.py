@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+
+# Run this in its directory to generate test cases.
+
+import random
+import os
+import sys
+
+
+# Each case is one batch. Elements are little-endian byte strings stored back
+# to back, as pack_batch takes them; results are n = ceil(size / 8) limbs wide
+# (2n for products).
+
+
+def to_list(b: bytes) -> str:
+    if len(b) == 0:
+        return "{}"
+    return f"{'{'}0x{', 0x'.join(f'{v:02X}' for v in b)}{'}'}"
+
+
+def join_le(values: list[int], size: int) -> bytes:
+    return b''.join(v.to_bytes(size, 'little') for v in values)
+
+
+def case_str(xs: list[int], ys: list[int], size: int) -> tuple:
+    n = (size + 7) // 8
+    mask = 2**(64 * n) - 1
+    sums = [(x + y) & mask for x, y in zip(xs, ys)]
+    carries = [(x + y) >> (64 * n) for x, y in zip(xs, ys)]
+    diffs = [(x - y) & mask for x, y in zip(xs, ys)]
+    borrows = [int(x < y) for x, y in zip(xs, ys)]
+    prods = [x * y for x, y in zip(xs, ys)]
+    return (str(size),
+            to_list(join_le(xs, size)),
+            to_list(join_le(ys, size)),
+            to_list(join_le(sums, 8 * n)),
+            to_list(bytes(carries)),
+            to_list(join_le(diffs, 8 * n)),
+            to_list(bytes(borrows)),
+            to_list(join_le(prods, 16 * n)))
+
+
+def generate_cfile() -> str:
+    cases = []
+
+    # Random batches. Counts either side of the 4 and 8 lane registers, so
+    # every kernel has leftover lanes.
+    for size in [1, 7, 8, 9, 16, 24, 32, 64, 100]:
+        for count in [1, 3, 4, 5, 8, 9, 17, 64, 131]:
+            xs = [random.randint(0, 256**size - 1) for i in range(count)]
+            ys = [random.randint(0, 256**size - 1) for i in range(count)]
+            cases.append(case_str(xs, ys, size))
+
+    # Carries and borrows through every limb, mixed with lanes that have none.
+    for size in [8, 16, 32, 64]:
+        top = 256**size - 1
+        xs = [top, 0, top, 1, top, top - 1, 0, top, top]
+        ys = [1, 1, top, 1, 0, 1, 0, top - 1, 2]
+        cases.append(case_str(xs, ys, size))
+        cases.append(case_str(ys, xs, size))
+
+    headers = ["vector"]
+    local_headers = [h_file_name]
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in local_headers])
+    header_str = '\n'.join([f"#include<{h}>" for h in headers])
+
+    outputs = []
+    for j, (casetype, name) in enumerate(
+            [("std::vector<size_t>", "cases_size"),
+             ("std::vector<std::vector<uint8_t>>", "cases_x"),
+             ("std::vector<std::vector<uint8_t>>", "cases_y"),
+             ("std::vector<std::vector<uint8_t>>", "cases_sum"),
+             ("std::vector<std::vector<uint8_t>>", "cases_carry"),
+             ("std::vector<std::vector<uint8_t>>", "cases_diff"),
+             ("std::vector<std::vector<uint8_t>>", "cases_borrow"),
+             ("std::vector<std::vector<uint8_t>>", "cases_prod")]):
+        cl = ',\n'.join([c[j] for c in cases])
+        outputs.append(f"{casetype} {name} = {'{'}{cl}{'};'}")
+
+    contents = '\n'.join([local_header_str, header_str] + outputs)
+    return contents
+
+
+def generate_hfile() -> str:
+    # Guard
+    header_gaurd = "__JL_TESTBATCH_CASES_H__"
+    guard_begin = f"#ifndef {header_gaurd}"  + "\n" + f"#define {header_gaurd}"
+    guard_end = "#endif"
+
+    # Includes
+    include_global = ["cstddef", "cstdint", "vector"]
+    include_local = []
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
+    global_header_str = '\n'.join([f"#include<{h}>" for h in include_global])
+
+    # Variables
+    header_vars_map = {
+            'extern std::vector<size_t>': ['cases_size'],
+            'extern std::vector<std::vector<uint8_t>>': [
+                'cases_x', 'cases_y', 'cases_sum', 'cases_carry',
+                'cases_diff', 'cases_borrow', 'cases_prod'],
+    }
+
+    header_vars_list = []
+    for k, v in header_vars_map.items():
+        for name in v:
+            header_vars_list.append(f"{k} {name};")
+    header_vars = "\n".join(header_vars_list)
+
+    contents = "\n".join([guard_begin,
+                               local_header_str, global_header_str,
+                               header_vars,
+                               guard_end])
+    return contents
+
+
+if __name__ == '__main__':
+    c_file_name = "cases.cpp"
+    h_file_name = "cases.h"
+
+    c_file_contents = generate_cfile()
+    h_file_contents = generate_hfile()
+
+    with open(c_file_name, 'w') as f:
+      f.write(c_file_contents)
+    with open(h_file_name, 'w') as f:
+      f.write(h_file_contents)
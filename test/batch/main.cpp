@@ -0,0 +1,237 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/batch.h"
+#include "../../src/cpu.h"
+#include "../testutils.h"
+}
+
+enum batch_op { BATCH_ADD, BATCH_SUB, BATCH_MUL };
+
+void on_failure(size_t case_id, size_t lane, const std::vector<uint8_t> &z,
+                const std::vector<uint8_t> &z_test, size_t z_size) {
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\t\tsize    : %lu\n", cases_size[case_id]);
+  printf("\t\tlanes   : %lu\n", cases_carry[case_id].size());
+  printf("\t\tlane    : %lu\n", lane);
+  printf("\tResults\n");
+  printf("\t\tExpected: ");
+  printhex_le(z.data() + lane * z_size, z_size * 8);
+  printf("\n");
+  printf("\t\tComputed: ");
+  printhex_le(z_test.data() + lane * z_size, z_size * 8);
+  printf("\n");
+}
+
+int run_testcase_batch(size_t case_id, size_t *duration, batch_op op) {
+  // Case.
+  const size_t size = cases_size[case_id];
+  const size_t count = cases_carry[case_id].size();
+  const size_t n = (size + JL_LIMB_BYTES - 1) / JL_LIMB_BYTES;
+  const std::vector<uint8_t> &z = op == BATCH_ADD   ? cases_sum[case_id]
+                                  : op == BATCH_SUB ? cases_diff[case_id]
+                                                    : cases_prod[case_id];
+  const std::vector<uint8_t> &f = op == BATCH_ADD ? cases_carry[case_id]
+                                                  : cases_borrow[case_id];
+  const size_t z_n = op == BATCH_MUL ? 2 * n : n;
+  // Test.
+  std::vector<jl_limb_t> x_soa(n * count), y_soa(n * count);
+  std::vector<jl_limb_t> z_soa(z_n * count);
+  std::vector<uint8_t> z_test(z.size(), 0);
+  std::vector<uint8_t> f_test(count, 0xff);
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  pack_batch(x_soa.data(), cases_x[case_id].data(), size, n, count);
+  pack_batch(y_soa.data(), cases_y[case_id].data(), size, n, count);
+  if (op == BATCH_ADD)
+    add_batch(z_soa.data(), x_soa.data(), y_soa.data(), f_test.data(), n,
+              count);
+  else if (op == BATCH_SUB)
+    sub_batch(z_soa.data(), x_soa.data(), y_soa.data(), f_test.data(), n,
+              count);
+  else
+    mul_batch(z_soa.data(), x_soa.data(), y_soa.data(), n, count);
+  unpack_batch(z_test.data(), z_soa.data(), z_n * JL_LIMB_BYTES, z_n, count);
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       count); // Normalize (ns per element).
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t z_size = z_n * JL_LIMB_BYTES;
+    bool ok = std::equal(z.begin() + i * z_size, z.begin() + (i + 1) * z_size,
+                         z_test.begin() + i * z_size);
+    if (op != BATCH_MUL)
+      ok = ok && f[i] == f_test[i];
+    if (!ok) {
+      on_failure(case_id, i, z, z_test, z_size);
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+void run_all_testcases_batch(const char *name, batch_op op) {
+  const size_t num_cases = cases_size.size();
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_batch(i, &duration, op);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per element processed: %lu\n", avg_duration);
+}
+
+void run_all_batch_ops(const char *kernels) {
+  char name[64];
+  snprintf(name, sizeof(name), "add_batch (%s)", kernels);
+  run_all_testcases_batch(name, BATCH_ADD);
+  snprintf(name, sizeof(name), "sub_batch (%s)", kernels);
+  run_all_testcases_batch(name, BATCH_SUB);
+  snprintf(name, sizeof(name), "mul_batch (%s)", kernels);
+  run_all_testcases_batch(name, BATCH_MUL);
+}
+
+typedef uint8_t (*bstring_fn)(const uint8_t *, const uint8_t *, uint8_t *,
+                              uint8_t *, size_t, size_t, size_t);
+
+// Throughput of one batch of count elements of size bytes against the same
+// elements run one at a time through the byte-string function, in ns per
+// element. The two must agree.
+void compare_throughput(const char *name, batch_op op, bstring_fn scalar,
+                        size_t size, size_t count) {
+  const size_t n = (size + JL_LIMB_BYTES - 1) / JL_LIMB_BYTES;
+  const size_t z_n = op == BATCH_MUL ? 2 * n : n;
+  const size_t z_size = z_n * JL_LIMB_BYTES;
+  const int reps = 20;
+
+  std::vector<uint8_t> x(size * count), y(size * count);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = rand();
+    y[i] = rand();
+  }
+  std::vector<jl_limb_t> x_soa(n * count), y_soa(n * count);
+  std::vector<jl_limb_t> z_soa(z_n * count);
+  std::vector<uint8_t> flags(count);
+  pack_batch(x_soa.data(), x.data(), size, n, count);
+  pack_batch(y_soa.data(), y.data(), size, n, count);
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < reps; r++) {
+    if (op == BATCH_ADD)
+      add_batch(z_soa.data(), x_soa.data(), y_soa.data(), flags.data(), n,
+                count);
+    else if (op == BATCH_SUB)
+      sub_batch(z_soa.data(), x_soa.data(), y_soa.data(), flags.data(), n,
+                count);
+    else
+      mul_batch(z_soa.data(), x_soa.data(), y_soa.data(), n, count);
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  std::vector<uint8_t> z(z_size * count);
+  for (int r = 0; r < reps; r++)
+    for (size_t i = 0; i < count; i++) {
+      uint8_t f = 0;
+      scalar(x.data() + i * size, y.data() + i * size, z.data() + i * z_size,
+             &f, size, size, z_size);
+    }
+  auto t3 = std::chrono::high_resolution_clock::now();
+
+  // sub_bstrings leaves x - y + 2^(8 z_size) for x < y, like sub_batch.
+  std::vector<uint8_t> z_test(z_size * count);
+  unpack_batch(z_test.data(), z_soa.data(), z_size, z_n, count);
+  if (z != z_test)
+    printf("Failed: %s disagrees with the scalar loop\n", name);
+
+  const double batch_ns =
+      std::chrono::duration<double, std::nano>(t2 - t1).count() /
+      (reps * count);
+  const double scalar_ns =
+      std::chrono::duration<double, std::nano>(t3 - t2).count() /
+      (reps * count);
+  printf("\t%-10s %4lu bytes x %5lu: %8.2f ns per element batched, %8.2f "
+         "in a scalar loop\n",
+         name, size, count, batch_ns, scalar_ns);
+}
+
+void run_throughput(const char *kernels) {
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("THROUGHPUT (%s)\n", kernels);
+  for (size_t size : {16, 32, 64}) {
+    compare_throughput("add_batch", BATCH_ADD, add_bstrings, size, 4096);
+    compare_throughput("sub_batch", BATCH_SUB, sub_bstrings, size, 4096);
+    compare_throughput("mul_batch", BATCH_MUL, mul_bstrings, size, 4096);
+  }
+}
+
+int main() {
+  const unsigned kernels = get_batch_kernels();
+  const char *name = kernels & JL_CPU_AVX512F ? "AVX-512"
+                     : kernels & JL_CPU_AVX2  ? "AVX2"
+                                              : "portable";
+  run_all_batch_ops(name);
+  run_throughput(name);
+
+  // Every narrower kernel the CPU also supports.
+  if ((kernels & JL_CPU_AVX512F) && (cpu_features() & JL_CPU_AVX2)) {
+    set_batch_kernels(JL_CPU_AVX2);
+    run_all_batch_ops("AVX2");
+    run_throughput("AVX2");
+  }
+  if (kernels != 0) {
+    set_batch_kernels(0);
+    run_all_batch_ops("portable");
+    run_throughput("portable");
+    set_batch_kernels(kernels);
+  }
+
+  return 0;
+};
@@ -0,0 +1,411 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/bits.h"
+#include "../../src/cpu.h"
+#include "../../src/jl_int.h"
+#include "../testutils.h"
+}
+
+// The byte string operations against one-bit-at-a-time references, with both
+// the portable and the AVX2 kernels, in place and not, with outputs shorter
+// and longer than the result. The jl_int operations against native int64_t
+// arithmetic where the operands fit, and against identities that tie them to
+// addition and division where they don't.
+
+static uint64_t rnd_state = 0xA0761D6478BD642Full;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+static std::vector<uint8_t> random_bytes(size_t size) {
+  std::vector<uint8_t> x(size);
+  for (size_t i = 0; i < size; i++)
+    x[i] = (uint8_t)rnd();
+  // Sparse or dense runs, and zeros at the top.
+  if (size > 0 && rnd() % 3 == 0) {
+    const size_t at = rnd() % size;
+    memset(x.data() + at, rnd() % 2 ? 0xFF : 0, rnd() % (size - at));
+  }
+  if (size > 0 && rnd() % 3 == 0) {
+    const size_t n = rnd() % 8 % (size + 1);
+    memset(x.data() + size - n, 0, n);
+  }
+  return x;
+}
+
+// Never NULL, so that empty operands aren't taken for missing ones.
+static uint8_t *data(std::vector<uint8_t> &x) {
+  static uint8_t none;
+  return x.empty() ? &none : x.data();
+}
+
+static const uint8_t *data(const std::vector<uint8_t> &x) {
+  return data(const_cast<std::vector<uint8_t> &>(x));
+}
+
+static int bit(const std::vector<uint8_t> &x, uint64_t i) {
+  return i / 8 < x.size() ? x[i / 8] >> (i % 8) & 1 : 0;
+}
+
+static bool same(const uint8_t *x, const uint8_t *y, size_t n) {
+  return n == 0 || memcmp(x, y, n) == 0;
+}
+
+static bool check_logic(size_t max_size) {
+  const std::vector<uint8_t> x = random_bytes(rnd() % max_size);
+  const std::vector<uint8_t> y = random_bytes(rnd() % max_size);
+  const size_t z_size = rnd() % max_size;
+  const size_t l = x.size() > y.size() ? x.size() : y.size();
+  bool ok = true;
+  for (int op = 0; op < 3; op++) {
+    std::vector<uint8_t> e(l > z_size ? l : z_size, 0);
+    for (size_t i = 0; i < 8 * l; i++) {
+      const int a = bit(x, i), b = bit(y, i);
+      if (op == 0 ? a & b : op == 1 ? a | b : a ^ b)
+        e[i / 8] |= (uint8_t)(1 << (i % 8));
+    }
+    bool lost = false;
+    for (size_t i = z_size; i < e.size(); i++)
+      lost |= e[i] != 0;
+
+    uint8_t (*fn)(const uint8_t *, const uint8_t *, uint8_t *, uint8_t *,
+                  size_t, size_t, size_t) =
+        op == 0 ? and_bstrings : op == 1 ? or_bstrings : xor_bstrings;
+    std::vector<uint8_t> z(z_size + 1, 0xAA);
+    uint8_t flags;
+    ok &= fn(data(x), data(y), data(z), &flags, x.size(), y.size(),
+             z_size) == 0;
+    ok &= flags == lost && same(data(z), data(e), z_size) &&
+          z[z_size] == 0xAA;
+
+    // In place, into x.
+    std::vector<uint8_t> w = x;
+    fn(data(w), data(y), data(w), &flags, w.size(), y.size(), w.size());
+    ok &= same(data(w), data(e), w.size());
+  }
+  return ok;
+}
+
+static bool check_shift(size_t max_size) {
+  const std::vector<uint8_t> x = random_bytes(rnd() % max_size);
+  const uint64_t cnt = rnd() % 3 == 0 ? rnd() % 64 : rnd() % (8 * max_size);
+  const size_t z_size = rnd() % 2 ? x.size() : rnd() % max_size;
+  bool ok = true;
+
+  // Left.
+  std::vector<uint8_t> e(z_size, 0);
+  bool lost = false;
+  for (uint64_t i = 0; i < 8 * x.size(); i++) {
+    if (!bit(x, i))
+      continue;
+    if (i + cnt < 8 * z_size)
+      e[(i + cnt) / 8] |= (uint8_t)(1 << ((i + cnt) % 8));
+    else
+      lost = true;
+  }
+  std::vector<uint8_t> z(z_size + 1, 0xAA);
+  uint8_t flags;
+  ok &= lshift_bstrings(data(x), data(z), &flags, cnt, x.size(), z_size) ==
+        0;
+  ok &= flags == lost && same(data(z), data(e), z_size) &&
+        z[z_size] == 0xAA;
+  if (z_size == x.size()) {
+    std::vector<uint8_t> w = x;
+    lshift_bstrings(data(w), data(w), &flags, cnt, w.size(), w.size());
+    ok &= w == e;
+  }
+
+  // Right.
+  std::fill(e.begin(), e.end(), 0);
+  lost = false;
+  bool inexact = false;
+  for (uint64_t i = 0; i < 8 * x.size(); i++) {
+    if (!bit(x, i))
+      continue;
+    if (i < cnt)
+      inexact = true;
+    else if (i - cnt < 8 * z_size)
+      e[(i - cnt) / 8] |= (uint8_t)(1 << ((i - cnt) % 8));
+    else
+      lost = true;
+  }
+  std::fill(z.begin(), z.end(), 0xAA);
+  ok &= rshift_bstrings(data(x), data(z), &flags, cnt, x.size(), z_size) ==
+        0;
+  ok &= flags == (lost | inexact << 1) &&
+        same(data(z), data(e), z_size) && z[z_size] == 0xAA;
+  if (z_size == x.size()) {
+    std::vector<uint8_t> w = x;
+    rshift_bstrings(data(w), data(w), &flags, cnt, w.size(), w.size());
+    ok &= w == e;
+  }
+  return ok;
+}
+
+static bool check_scan(size_t max_size) {
+  std::vector<uint8_t> x = random_bytes(rnd() % max_size);
+  uint64_t pop = 0, lz = 8 * x.size(), tz = 8 * x.size();
+  for (uint64_t i = 0; i < 8 * x.size(); i++) {
+    if (!bit(x, i))
+      continue;
+    pop++;
+    lz = 8 * x.size() - i - 1;
+    if (tz == 8 * x.size())
+      tz = i;
+  }
+  bool ok = popcount_bstrings(data(x), x.size()) == pop &&
+            clz_bstrings(data(x), x.size()) == lz &&
+            ctz_bstrings(data(x), x.size()) == tz;
+
+  if (!x.empty()) {
+    const uint64_t b = rnd() % (8 * x.size());
+    const int was = bit(x, b);
+    ok &= tstbit_bstrings(data(x), x.size(), b) == was;
+    ok &= setbit_bstrings(data(x), x.size(), b) == 0 &&
+          tstbit_bstrings(data(x), x.size(), b) == 1;
+    ok &= clrbit_bstrings(data(x), x.size(), b) == 0 &&
+          tstbit_bstrings(data(x), x.size(), b) == 0;
+    ok &= popcount_bstrings(data(x), x.size()) == pop - was;
+  }
+  ok &= tstbit_bstrings(data(x), x.size(), 8 * x.size()) == 0 &&
+        setbit_bstrings(data(x), x.size(), 8 * x.size()) == 3;
+  return ok;
+}
+
+static void random_int(jl_int *z, size_t size) {
+  const std::vector<uint8_t> x = random_bytes(size);
+  int_set_bstring(z, data(x), rnd() % 2, size);
+}
+
+static bool check_int_small() {
+  const int64_t a = (int64_t)rnd() >> (rnd() % 64);
+  const int64_t b = (int64_t)rnd() >> (rnd() % 64);
+  const unsigned c = rnd() % 70;
+  jl_int x, y, z, e;
+  int_init(&x);
+  int_init(&y);
+  int_init(&z);
+  int_init(&e);
+  int_set_i64(&x, a);
+  int_set_i64(&y, b);
+
+  bool ok = true;
+  int_and(&z, &x, &y);
+  int_set_i64(&e, a & b);
+  ok &= int_cmp(&z, &e) == 0;
+  int_or(&z, &x, &y);
+  int_set_i64(&e, a | b);
+  ok &= int_cmp(&z, &e) == 0;
+  int_xor(&z, &x, &y);
+  int_set_i64(&e, a ^ b);
+  ok &= int_cmp(&z, &e) == 0;
+  int_com(&z, &x);
+  int_set_i64(&e, ~a);
+  ok &= int_cmp(&z, &e) == 0;
+  int_rshift(&z, &x, c);
+  int_set_i64(&e, c < 64 ? a >> c : a >> 63);
+  ok &= int_cmp(&z, &e) == 0;
+  ok &= int_tstbit(&x, c) == (c < 64 ? a >> c & 1 : a < 0);
+  ok &= int_popcount(&x) ==
+        (a < 0 ? UINT64_MAX : (uint64_t)__builtin_popcountll(a));
+
+  int_set(&z, &x);
+  int_setbit(&z, c % 63);
+  int_set_i64(&e, a | (int64_t)1 << (c % 63));
+  ok &= int_cmp(&z, &e) == 0;
+  int_set(&z, &x);
+  int_clrbit(&z, c % 63);
+  int_set_i64(&e, a & ~((int64_t)1 << (c % 63)));
+  ok &= int_cmp(&z, &e) == 0;
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&z);
+  int_free(&e);
+  return ok;
+}
+
+static bool check_int(size_t max_size) {
+  jl_int x, y, a, b, t, p;
+  int_init(&x);
+  int_init(&y);
+  int_init(&a);
+  int_init(&b);
+  int_init(&t);
+  int_init(&p);
+  random_int(&x, rnd() % max_size);
+  random_int(&y, rnd() % max_size);
+  const uint64_t c = rnd() % (8 * max_size);
+  bool ok = true;
+
+  // x + y = (x ^ y) + 2 (x & y), and x | y = (x ^ y) + (x & y).
+  int_xor(&a, &x, &y);
+  int_and(&b, &x, &y);
+  int_add(&t, &a, &b);
+  int_add(&p, &t, &b);
+  int_add(&a, &x, &y);
+  ok &= int_cmp(&p, &a) == 0;
+  int_or(&a, &x, &y);
+  ok &= int_cmp(&t, &a) == 0;
+
+  // ~~x = x and x & ~x = 0, in place.
+  int_com(&a, &x);
+  int_and(&b, &x, &a);
+  int_com(&a, &a);
+  ok &= int_cmp(&a, &x) == 0 && b.n == 0;
+
+  // x << c = x 2^c, and x >> c rounds x 2^-c down.
+  int_set_u64(&p, 1);
+  int_lshift(&p, &p, c);
+  int_lshift(&a, &x, c);
+  int_mul(&t, &x, &p);
+  ok &= int_cmp(&a, &t) == 0;
+  int_rshift(&a, &x, c);
+  int_divrem(&t, &b, &x, &p);
+  if (b.neg) {
+    int_set_u64(&b, 1);
+    int_sub(&t, &t, &b);
+  }
+  ok &= int_cmp(&a, &t) == 0;
+  int_set(&b, &x);
+  int_rshift(&b, &b, c);
+  ok &= int_cmp(&a, &b) == 0;
+
+  // Bit c is the parity of x >> c.
+  ok &= int_tstbit(&x, c) == (a.n > 0 && (int_limbs(&a)[0] & 1));
+
+  // Setting and clearing it.
+  int_set(&a, &x);
+  int_setbit(&a, c);
+  ok &= int_tstbit(&a, c) == 1;
+  int_clrbit(&a, c);
+  ok &= int_tstbit(&a, c) == 0;
+  int_set(&b, &x);
+  if (int_tstbit(&x, c))
+    int_clrbit(&b, c);
+  ok &= int_cmp(&a, &b) == 0;
+
+  if (!x.neg)
+    ok &= int_popcount(&x) == popcount_n(int_limbs(&x), x.n);
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&a);
+  int_free(&b);
+  int_free(&t);
+  int_free(&p);
+  return ok;
+}
+
+// Setting or clearing bit c adds or takes away 2^c, if it changes it at all.
+// Bits far past the top of x, which only ever read as its sign, cost nothing.
+static bool check_int_bits(size_t max_size) {
+  jl_int x, a, e, p;
+  int_init(&x);
+  int_init(&a);
+  int_init(&e);
+  int_init(&p);
+  random_int(&x, rnd() % max_size);
+  const uint64_t c = rnd() % (8 * max_size + 128);
+  const int set = int_tstbit(&x, c);
+  bool ok = true;
+
+  int_set_u64(&p, 1);
+  int_lshift(&p, &p, c);
+  int_set(&a, &x);
+  ok &= int_setbit(&a, c) == 0;
+  if (set)
+    int_set(&e, &x);
+  else
+    int_add(&e, &x, &p);
+  ok &= int_cmp(&a, &e) == 0;
+  int_set(&a, &x);
+  ok &= int_clrbit(&a, c) == 0;
+  if (set)
+    int_sub(&e, &x, &p);
+  else
+    int_set(&e, &x);
+  ok &= int_cmp(&a, &e) == 0;
+
+  const uint64_t far = ((uint64_t)1 << 40) + c;
+  int_set(&a, &x);
+  const size_t alloc = a.alloc;
+  if (x.neg)
+    ok &= int_setbit(&a, far) == 0 && int_tstbit(&a, far) == 1;
+  else
+    ok &= int_clrbit(&a, far) == 0 && int_tstbit(&a, far) == 0;
+  ok &= int_cmp(&a, &x) == 0 && a.alloc == alloc;
+
+  int_free(&x);
+  int_free(&a);
+  int_free(&e);
+  int_free(&p);
+  return ok;
+}
+
+static bool run_testcase(size_t i) {
+  const size_t max_size = i % 4 == 0 ? 700 : 70;
+  return check_logic(max_size) && check_shift(max_size) &&
+         check_scan(max_size) && check_int_small() && check_int(max_size) &&
+         check_int_bits(max_size);
+}
+
+int main() {
+  const size_t num_cases = 1000;
+
+  int passed = 0;
+  for (int k = 0; k < 2; k++) {
+    set_bits_kernels(k == 0 ? 0 : JL_CPU_AVX2);
+
+    printf("\n");
+    for (int i = 0; i < 72; i++)
+      printf("=");
+    printf("\n");
+    printf("TESTING\n");
+    printf("\tFunction: \"bit operations\" (%s kernels)\n",
+           get_bits_kernels() ? "AVX2" : "portable");
+    for (int i = 0; i < 72; i++)
+      printf("-");
+    printf("\n");
+
+    passed = 0;
+    for (size_t i = 0; i < num_cases; i++) {
+      if (run_testcase(i))
+        passed++;
+      else
+        printf("Failed test case %d.\n", (int)i);
+    }
+
+    uint8_t flags;
+    jl_int x;
+    int_init(&x);
+    if (and_bstrings(NULL, NULL, NULL, &flags, 0, 0, 0) != 1 ||
+        lshift_bstrings(NULL, (uint8_t *)"", &flags, 0, 0, 0) != 1 ||
+        xor_bstrings(&flags, &flags, &flags, NULL, 1, 1, 1) != 1 ||
+        clrbit_bstrings(NULL, 0, 0) != 1 || int_lshift(NULL, &x, 1) != 1 ||
+        int_xor(&x, NULL, &x) != 1) {
+      passed--;
+      printf("Failed error checks.\n");
+    }
+
+    for (int i = 0; i < 72; i++)
+      printf("-");
+    printf("\n");
+    printf("RESULTS\n");
+    printf("\tPassed: %d / %lu\n", passed, num_cases);
+    printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+  }
+  set_bits_kernels(cpu_features());
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/csa.h"
+#include "../testutils.h"
+}
+
+// Running sums through a jl_csa against the same sums taken with add_bstrings
+// into a buffer wide enough never to overflow. Each case adds more terms than
+// JL_CSA_HEADROOM, so the accumulator has to normalize on its own along the
+// way, and some terms are all ones to fill the headroom as fast as possible.
+
+static uint64_t rnd_state = 0xD1B54A32D192ED03ull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+static void fill(uint8_t *x, size_t size, bool ones) {
+  for (size_t i = 0; i < size; i++)
+    x[i] = ones ? 0xFF : (uint8_t)rnd();
+}
+
+static bool run_testcase(size_t max_size) {
+  const size_t terms = JL_CSA_HEADROOM + 1 + rnd() % (2 * JL_CSA_HEADROOM);
+  const bool ones = rnd() % 3 == 0;
+  const size_t wide = max_size + 8;
+  std::vector<uint8_t> sum(wide, 0), t(wide), x(max_size + 1);
+  uint8_t flags;
+
+  jl_csa a, b;
+  csa_init(&a);
+  csa_init(&b);
+  bool ok = true;
+  for (size_t i = 0; i < terms; i++) {
+    const size_t size = rnd() % (max_size + 1);
+    fill(x.data(), size, ones);
+    add_bstrings(sum.data(), x.data(), t.data(), &flags, wide, size, wide);
+    sum.swap(t);
+
+    ok &= csa_add_bstring(&a, x.data(), size) == 0;
+
+    // The same term as limbs, zero-padded to whole limbs.
+    std::vector<jl_limb_t> xl((size + 7) / 8 + 1);
+    bytes_to_limbs(xl.data(), xl.size(), x.data(), size);
+    ok &= csa_add_limbs(&b, xl.data(), xl.size() - rnd() % 2) == 0;
+
+    // Reading out part way through doesn't disturb the sum.
+    if (rnd() % 64 == 0)
+      ok &= csa_bstring_size(&a) <= wide;
+  }
+
+  size_t size = wide;
+  while (size > 0 && sum[size - 1] == 0)
+    size--;
+  ok &= csa_bstring_size(&a) == size && csa_bstring_size(&b) == size;
+
+  std::vector<uint8_t> z(wide + 3);
+  ok &= csa_get_bstring(&a, z.data(), &flags, z.size()) == 0 && flags == 0;
+  ok &= memcmp(z.data(), sum.data(), wide) == 0 && z[wide] == 0 &&
+        z[wide + 2] == 0;
+  csa_get_bstring(&b, z.data(), &flags, z.size());
+  ok &= flags == 0 && memcmp(z.data(), sum.data(), wide) == 0;
+
+  // Truncated.
+  if (size > 0) {
+    memset(z.data(), 0xAA, z.size());
+    csa_get_bstring(&a, z.data(), &flags, size - 1);
+    ok &= flags == 1 && memcmp(z.data(), sum.data(), size - 1) == 0 &&
+          z[size - 1] == 0xAA;
+  }
+
+  csa_clear(&a);
+  ok &= csa_bstring_size(&a) == 0;
+  csa_free(&a);
+  csa_free(&b);
+  return ok;
+}
+
+int main() {
+  const size_t num_cases = 200;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"csa_add_bstring\"\n");
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (run_testcase(i % 2 ? 200 : 13))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+
+  uint8_t flags;
+  jl_csa a;
+  csa_init(&a);
+  if (csa_add_bstring(NULL, (const uint8_t *)"", 0) != 1 ||
+      csa_add_bstring(&a, NULL, 0) != 1 ||
+      csa_get_bstring(&a, NULL, &flags, 0) != 1 ||
+      csa_get_bstring(&a, (uint8_t *)&flags, NULL, 1) != 1) {
+    passed--;
+    printf("Failed error checks.\n");
+  }
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+
+  return 0;
+}
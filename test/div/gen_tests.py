@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+# Run this in its directory to generate test cases.
+
+import random
+import os
+
+
+def to_list(r: int) -> str:
+    s = f"{r:X}"
+    if len(s) % 2 == 1:
+        s = '0' + s
+    l = [s[i:i + 2] for i in range(0,len(s),2)]
+    return f"{'{'}0x{', 0x'.join(l)}{'}'}"
+
+
+def case_str(x: int, d: int) -> tuple[str, str, str, str]:
+    q, r = divmod(x, d)
+    return to_list(x), to_list(d), to_list(q), to_list(r)
+
+
+def generate_cfile() -> str:
+    cases = []
+
+    # Random cases.
+    for i in range(300):
+        x_size = 20
+        d_size = 10
+
+        x = random.randint(8**x_size, 8**(x_size + 1))
+        d = random.randint(8**d_size, 8**(d_size + 1))
+
+        cases.append(case_str(x, d))
+
+    # Random multi-limb cases, including sizes that aren't a multiple of 8 and
+    # divisors longer than the dividend.
+    for i in range(200):
+        x_size = random.randint(1, 80)
+        d_size = random.randint(1, 64)
+
+        x = random.randint(0, 256**x_size - 1)
+        d = random.randint(1, 256**d_size - 1)
+
+        cases.append(case_str(x, d))
+
+    # Large cases, past the divide and conquer threshold.
+    for i in range(20):
+        d_size = random.randint(100, 2000)
+        x_size = d_size + random.randint(0, 3000)
+
+        x = random.randint(1, 256**x_size - 1)
+        d = random.randint(256**(d_size - 1), 256**d_size - 1)
+
+        cases.append(case_str(x, d))
+
+    # Edge cases: all ones, powers of two, and quotient digits near B - 1.
+    for i in range(1,10,1):
+        cases.append(case_str(256**(8 * i) - 1, 256**(4 * i) - 1))
+        cases.append(case_str(256**(8 * i), 2**(32 * i - 1)))
+        cases.append(case_str(2**(64 * 2 * i) - 2**(64 * i), 2**(64 * i) - 1))
+        cases.append(case_str(8**i, 8**i))
+        cases.append(case_str(8**i - 1, 8**i))
+
+    headers = ["vector"]
+    local_headers = [h_file_name]
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in local_headers])
+    header_str = '\n'.join([f"#include<{h}>" for h in headers])
+
+    casetype = "std::vector<std::vector<uint8_t>>"
+
+    outputs = []
+    for j, name in enumerate(['cases_x', 'cases_d', 'cases_q', 'cases_r']):
+        cl = ',\n'.join([c[j] for c in cases])
+        outputs.append(f"{casetype} {name} = {'{'}{cl}{'};'}")
+
+    contents = '\n'.join([local_header_str, header_str] + outputs)
+    return contents
+
+
+def generate_hfile() -> str:
+    # Guard
+    header_gaurd = "__JL_TESTDIV_CASES_H__"
+    guard_begin = f"#ifndef {header_gaurd}"  + "\n" + f"#define {header_gaurd}"
+    guard_end = "#endif"
+
+    # Includes
+    include_global = ["cstdint", "vector"]
+    include_local = []
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
+    global_header_str = '\n'.join([f"#include<{h}>" for h in include_global])
+
+    # Variables
+    header_vars_map = {
+            'extern std::vector<std::vector<uint8_t>>': ['cases_x', 'cases_d', 'cases_q', 'cases_r']
+    }
+
+    header_vars_list = []
+    for k, v in header_vars_map.items():
+        for name in v:
+            header_vars_list.append(f"{k} {name};")
+    header_vars = "\n".join(header_vars_list)
+
+    contents = "\n".join([guard_begin,
+                               local_header_str, global_header_str, 
+                               header_vars,
+                               guard_end])
+    return contents
+
+
+if __name__ == '__main__':
+    c_file_name = "cases.cpp"
+    h_file_name = "cases.h"
+
+    c_file_contents = generate_cfile()
+    h_file_contents = generate_hfile()
+
+    with open(c_file_name, 'w') as f:
+      f.write(c_file_contents)
+    with open(h_file_name, 'w') as f:
+      f.write(h_file_contents)
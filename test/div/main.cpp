@@ -0,0 +1,225 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/div.h"
+#include "../testutils.h"
+}
+
+void preprocess_case(size_t case_id) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &d = cases_d[case_id];
+  // x, d in BE.
+  std::reverse(x.begin(), x.end());
+  std::reverse(d.begin(), d.end());
+  // x, d in LE.
+}
+
+void postprocess_case(size_t case_id, std::vector<uint8_t> &q_test,
+                      std::vector<uint8_t> &r_test) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &d = cases_d[case_id];
+  // x, d, q_test, r_test in LE.
+  std::reverse(x.begin(), x.end());
+  std::reverse(d.begin(), d.end());
+  std::reverse(q_test.begin(), q_test.end());
+  std::reverse(r_test.begin(), r_test.end());
+  // x, d, q, r, q_test, r_test in BE.
+}
+
+void on_bad_rc(size_t case_id, int rc) {
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("Indeterminate test case: %lu.\n", case_id);
+  printf("\tError code %d returned.\n", rc);
+}
+
+void print_aligned(const char *label, std::vector<uint8_t> &v,
+                   size_t max_size) {
+  printf("\t\t%s: ", label);
+  for (int i = 0; i < max_size - v.size(); i++) {
+    printf("   ");
+  }
+  printhex_be(v.data(), v.size() * 8);
+  printf("\n");
+}
+
+void on_failure(size_t case_id, std::vector<uint8_t> &q_test,
+                std::vector<uint8_t> &r_test) {
+  std::vector<uint8_t> x = cases_x[case_id];
+  std::vector<uint8_t> d = cases_d[case_id];
+  std::vector<uint8_t> q = cases_q[case_id];
+  std::vector<uint8_t> r = cases_r[case_id];
+
+  const size_t max_size = std::max({x.size(), d.size()});
+
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\tDividing x / d\n");
+  printf("\t\tx_size  : %lu\n", x.size());
+  printf("\t\td_size  : %lu\n", d.size());
+  print_aligned("x       ", x, max_size);
+  print_aligned("d       ", d, max_size);
+  printf("\tResults\n");
+  print_aligned("Expected q", q, max_size);
+  print_aligned("Computed q", q_test, max_size);
+  print_aligned("Expected r", r, max_size);
+  print_aligned("Computed r", r_test, max_size);
+}
+
+typedef uint8_t (*div_fn)(const uint8_t *, const uint8_t *, uint8_t *,
+                          uint8_t *, uint8_t *, size_t, size_t, size_t,
+                          size_t);
+
+int run_testcase_div(size_t case_id, size_t *duration, div_fn div) {
+  // Case.
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &d = cases_d[case_id];
+  std::vector<uint8_t> &q = cases_q[case_id];
+  std::vector<uint8_t> &r = cases_r[case_id];
+  // Test.
+  std::vector<uint8_t> q_test(q.size(), 0);
+  std::vector<uint8_t> r_test(r.size(), 0);
+
+  // 1. Preprocess
+  // 2. Trial
+  // 3. Postprocess
+  // 4. Report
+
+  preprocess_case(case_id);
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  uint8_t flags = 0;
+  int rc = div(x.data(), d.data(), q_test.data(), r_test.data(), &flags,
+               x.size(), d.size(), q_test.size(), r_test.size());
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       x.size()); // Normalize (ns per byte processed).
+
+  postprocess_case(case_id, q_test, r_test);
+
+  if (rc) {
+    on_bad_rc(case_id, rc);
+    return -1;
+  }
+
+  // The expected quotient is exactly q.size() bytes, so it always fits.
+  bool success = q == q_test && r == r_test && flags == 0;
+  if (!success) {
+    on_failure(case_id, q_test, r_test);
+  }
+
+  return success;
+}
+
+void run_all_testcases_div(const char *name, div_fn div) {
+  const size_t num_cases = std::max({cases_x.size(), cases_d.size(),
+                                     cases_q.size(), cases_r.size()});
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_div(i, &duration, div);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    } else if (rc == 2) {
+      // ND.
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per byte processed: %lu\n", avg_duration);
+}
+
+// Runs divrem_bstrings_arena in an arena of exactly divrem_bstrings_itch
+// bytes, which must be enough, and must all be given back (error code 5 if
+// not).
+uint8_t div_via_arena(const uint8_t *x, const uint8_t *d, uint8_t *q,
+                      uint8_t *r, uint8_t *flags, size_t x_size, size_t d_size,
+                      size_t q_size, size_t r_size) {
+  const size_t itch = divrem_bstrings_itch(x_size, d_size);
+  std::vector<jl_limb_t> buf(itch / sizeof(jl_limb_t) + 1);
+  jl_arena arena;
+  arena_init(&arena, buf.data(), itch);
+  uint8_t rc = divrem_bstrings_arena(x, d, q, r, flags, x_size, d_size, q_size,
+                                     r_size, &arena);
+  if (rc == 0 && arena.used != 0)
+    rc = 5;
+  return rc;
+}
+
+int main() {
+  run_all_testcases_div("divrem_bstrings", divrem_bstrings);
+  run_all_testcases_div("divrem_bstrings_arena", div_via_arena);
+
+  // Push the divide and conquer path down onto the test sizes.
+  set_div_dc_threshold(JL_DIV_DC_MIN_LIMBS);
+  run_all_testcases_div("divrem_bstrings (low threshold)", divrem_bstrings);
+  run_all_testcases_div("divrem_bstrings_arena (low threshold)",
+                        div_via_arena);
+  set_div_dc_threshold(JL_DIV_DC_THRESHOLD);
+
+  // Division by zero, and a quotient that doesn't fit.
+  uint8_t x[2] = {0x34, 0x12};
+  uint8_t zero[1] = {0};
+  uint8_t one[1] = {1};
+  uint8_t q[1], r[1];
+  uint8_t flags = 0;
+  if (divrem_bstrings(x, zero, q, r, &flags, 2, 1, 1, 1) != 3)
+    printf("Failed: division by zero not reported\n");
+  if (divrem_bstrings(x, one, q, r, &flags, 2, 1, 1, 1) != 0 || q[0] != 0x34 ||
+      r[0] != 0 || !(flags & 1))
+    printf("Failed: truncated quotient not flagged\n");
+
+  // An arena a limb short of the itch is reported, and left as it was.
+  std::vector<uint8_t> big(4096, 0xff);
+  std::vector<uint8_t> big_q(2048), big_r(2048);
+  const size_t itch = divrem_bstrings_itch(4096, 2048);
+  std::vector<jl_limb_t> buf(itch / sizeof(jl_limb_t));
+  jl_arena arena;
+  arena_init(&arena, buf.data(), itch - sizeof(jl_limb_t));
+  if (divrem_bstrings_arena(big.data(), big.data(), big_q.data(), big_r.data(),
+                            &flags, 4096, 2048, 2048, 2048, &arena) != 2 ||
+      arena.used != 0)
+    printf("Failed: short arena not reported\n");
+
+  return 0;
+};
@@ -0,0 +1,252 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/gcd.h"
+#include "../../src/jl_int.h"
+#include "../testutils.h"
+}
+
+// gcd, gcdext and invert against Euclid's algorithm written out with
+// int_divrem, on random operands and on operands built with a known common
+// factor. Consecutive Fibonacci-like numbers give runs of small quotients, and
+// operands of very different sizes a large first one. Half the cases lower
+// the half-gcd threshold to its minimum so that the recursion is exercised on
+// small operands.
+
+static uint64_t rnd_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+static void random_int(jl_int *z, size_t size) {
+  std::vector<uint8_t> x(size);
+  for (size_t i = 0; i < size; i++)
+    x[i] = (uint8_t)rnd();
+  // Sometimes long runs of ones or zeros.
+  if (size > 0 && rnd() % 4 == 0)
+    memset(x.data(), rnd() % 2 ? 0xFF : 0, rnd() % size);
+  int_set_bstring(z, x.data(), rnd() % 2, size);
+}
+
+static void euclid(jl_int *g, const jl_int *x, const jl_int *y) {
+  jl_int a, b, r;
+  int_init(&a);
+  int_init(&b);
+  int_init(&r);
+  int_abs(&a, x);
+  int_abs(&b, y);
+  while (b.n > 0) {
+    int_divrem(NULL, &r, &a, &b);
+    int_swap(&a, &b);
+    int_swap(&b, &r);
+  }
+  int_swap(g, &a);
+  int_free(&a);
+  int_free(&b);
+  int_free(&r);
+}
+
+static bool is_one(const jl_int *x) {
+  return x->n == 1 && !x->neg && int_limbs(x)[0] == 1;
+}
+
+static bool check(const jl_int *x, const jl_int *y) {
+  jl_int g, e, s, t, u, v;
+  int_init(&g);
+  int_init(&e);
+  int_init(&s);
+  int_init(&t);
+  int_init(&u);
+  int_init(&v);
+
+  bool ok = int_gcd(&g, x, y) == 0;
+  euclid(&e, x, y);
+  ok &= int_cmp(&g, &e) == 0;
+
+  // s x + t y = g, with the least cofactors.
+  ok &= int_gcdext(&g, &s, &t, x, y) == 0 && int_cmp(&g, &e) == 0;
+  int_mul(&u, &s, x);
+  int_mul(&v, &t, y);
+  int_add(&u, &u, &v);
+  ok &= int_cmp(&u, &g) == 0;
+  if (g.n > 0 && x->n > 0 && y->n > 0) {
+    int_abs(&u, y);
+    int_divrem(&u, NULL, &u, &g);
+    int_abs(&v, &s);
+    int_add(&v, &v, &v);
+    ok &= int_cmp(&v, &u) <= 0;
+    int_abs(&u, x);
+    int_divrem(&u, NULL, &u, &g);
+    int_abs(&v, &t);
+    int_add(&v, &v, &v);
+    ok &= int_cmp(&v, &u) <= 0 || u.n == 1 && int_limbs(&u)[0] == 1;
+  }
+
+  // x z = 1 (mod y) exactly when g is 1.
+  const uint8_t rc = int_invert(&s, x, y);
+  if (y->n == 0 || !is_one(&g)) {
+    ok &= rc == 3;
+  } else {
+    ok &= rc == 0 && !s.neg && int_cmpabs(&s, y) < 0;
+    int_mul(&u, &s, x);
+    int_abs(&v, y);
+    int_divrem(NULL, &u, &u, &v);
+    if (u.neg)
+      int_add(&u, &u, &v);
+    ok &= is_one(&u) || (is_one(&v) && u.n == 0);
+  }
+
+  int_free(&g);
+  int_free(&e);
+  int_free(&s);
+  int_free(&t);
+  int_free(&u);
+  int_free(&v);
+  return ok;
+}
+
+static bool run_testcase(size_t i) {
+  set_gcd_hgcd_threshold(i % 2 ? 0 : JL_GCD_HGCD_THRESHOLD);
+  const size_t max_size = i % 3 == 0 ? 3000 : 300;
+
+  jl_int x, y, f;
+  int_init(&x);
+  int_init(&y);
+  int_init(&f);
+  switch (i % 4) {
+  case 0:
+    random_int(&x, rnd() % max_size);
+    random_int(&y, rnd() % max_size);
+    break;
+  case 1: {
+    // A common factor.
+    random_int(&f, 1 + rnd() % (max_size / 2));
+    random_int(&x, rnd() % (max_size / 2));
+    random_int(&y, rnd() % (max_size / 2));
+    int_mul(&x, &x, &f);
+    int_mul(&y, &y, &f);
+    break;
+  }
+  case 2: {
+    // x = a x + y from small a, backwards through Euclid.
+    random_int(&x, 1 + rnd() % 8);
+    random_int(&y, 1 + rnd() % 8);
+    int_abs(&x, &x);
+    int_abs(&y, &y);
+    while (int_bstring_size(&x) < max_size) {
+      int_set_u64(&f, 1 + rnd() % (rnd() % 8 == 0 ? 1000000 : 3));
+      int_mul(&f, &f, &x);
+      int_add(&f, &f, &y);
+      int_swap(&x, &y);
+      int_swap(&x, &f);
+    }
+    break;
+  }
+  default:
+    random_int(&x, rnd() % max_size);
+    random_int(&y, rnd() % 20);
+    break;
+  }
+
+  bool ok = check(&x, &y) && check(&y, &x);
+
+  // Outputs that are also inputs.
+  int_mul(&f, &x, &y);
+  ok &= int_gcd(&x, &x, &f) == 0;
+  int_abs(&f, &x);
+  ok &= int_cmp(&x, &f) == 0;
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&f);
+  return ok;
+}
+
+static bool run_small_cases() {
+  jl_int x, y, z;
+  int_init(&x);
+  int_init(&y);
+  int_init(&z);
+  bool ok = true;
+
+  int_gcd(&z, &x, &y);
+  ok &= z.n == 0;
+  int_set_i64(&x, -12);
+  int_gcdext(&z, &x, &y, &x, &y);
+  ok &= int_sgn(&z) == 1 && int_limbs(&z)[0] == 12 && int_sgn(&x) == -1 &&
+        y.n == 0;
+
+  int_set_i64(&x, 3);
+  int_set_i64(&y, -7);
+  ok &= int_invert(&z, &x, &y) == 0 && int_limbs(&z)[0] == 5;
+  int_set_i64(&x, 6);
+  int_set_i64(&y, 9);
+  ok &= int_invert(&z, &x, &y) == 3;
+
+  // gcd(30000, 65572) = 4, and 48^-1 = 25956 (mod 65573).
+  const uint8_t a[] = {0x30, 0x75}, b[] = {0x24, 0x00, 0x01};
+  const uint8_t b1[] = {0x25, 0x00, 0x01};
+  uint8_t c[2], flags;
+  ok &= gcd_bstrings(a, b, c, &flags, 2, 3, 2) == 0 && flags == 0 &&
+        c[0] == 4 && c[1] == 0;
+  ok &= invert_bstrings(a, b, c, &flags, 2, 3, 2) == 3;
+  ok &= invert_bstrings(a, b1, c, &flags, 1, 3, 2) == 0 && flags == 0 &&
+        c[0] == 0x64 && c[1] == 0x65;
+  ok &= invert_bstrings(a, b1, c, &flags, 1, 3, 1) == 0 && flags == 1 &&
+        c[0] == 0x64;
+
+  ok &= int_gcd(NULL, &x, &y) == 1 && int_gcdext(&z, NULL, NULL, NULL, &y) == 1 &&
+        int_invert(&z, &x, NULL) == 1 &&
+        gcd_bstrings(a, NULL, c, &flags, 2, 3, 2) == 1;
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&z);
+  return ok;
+}
+
+int main() {
+  const size_t num_cases = 200;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"int_gcdext\"\n");
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (run_testcase(i))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+  set_gcd_hgcd_threshold(JL_GCD_HGCD_THRESHOLD);
+
+  if (!run_small_cases()) {
+    passed--;
+    printf("Failed small cases and error checks.\n");
+  }
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+
+  return 0;
+}
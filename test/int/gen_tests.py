@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+
+# Run this in its directory to generate test cases.
+
+import random
+import os
+
+
+def to_list(r: int) -> str:
+    s = f"{abs(r):X}"
+    if len(s) % 2 == 1:
+        s = '0' + s
+    l = [s[i:i + 2] for i in range(0,len(s),2)]
+    return f"{'{'}0x{', 0x'.join(l)}{'}'}"
+
+
+def tdivrem(x: int, y: int) -> tuple[int, int]:
+    q = abs(x) // abs(y)
+    if (x < 0) != (y < 0):
+        q = -q
+    return q, x - q * y
+
+
+NAMES = ['x', 'y', 'sum', 'diff', 'prod', 'quot', 'rem']
+
+
+def case_str(x: int, y: int) -> list[int]:
+    q, r = tdivrem(x, y) if y != 0 else (0, 0)
+    return [x, y, x + y, x - y, x * y, q, r]
+
+
+def rand_signed(size: int) -> int:
+    return random.choice([1, -1]) * random.randint(0, 256**size - 1)
+
+
+def generate_cfile() -> str:
+    cases = []
+
+    # Random cases, mostly within the inline storage, some well past it.
+    for i in range(300):
+        x_size = random.choice([random.randint(0, 32), random.randint(0, 600)])
+        y_size = random.choice([x_size, random.randint(0, 32),
+                                random.randint(0, 600)])
+        cases.append(case_str(rand_signed(x_size), rand_signed(y_size)))
+
+    # Cancellation: x + (-x), and x - y with y just below or above x.
+    for i in range(50):
+        x = rand_signed(random.randint(1, 100))
+        cases.append(case_str(x, -x))
+        cases.append(case_str(x, x - 1))
+        cases.append(case_str(x, x + 1))
+
+    # Carries out of the inline storage.
+    for i in range(1, 10):
+        m = 256**(8 * i) - 1
+        cases.append(case_str(m, 1))
+        cases.append(case_str(-m, -1))
+        cases.append(case_str(m + 1, 1))
+        cases.append(case_str(m, m))
+
+    headers = ["vector"]
+    local_headers = [h_file_name]
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in local_headers])
+    header_str = '\n'.join([f"#include<{h}>" for h in headers])
+
+    outputs = []
+    for j, name in enumerate(NAMES):
+        cl = ',\n'.join([to_list(c[j]) for c in cases])
+        outputs.append(f"std::vector<std::vector<uint8_t>> cases_{name} = "
+                       f"{'{'}{cl}{'};'}")
+        nl = ', '.join(['1' if c[j] < 0 else '0' for c in cases])
+        outputs.append(f"std::vector<uint8_t> cases_{name}_neg = "
+                       f"{'{'}{nl}{'};'}")
+
+    contents = '\n'.join([local_header_str, header_str] + outputs)
+    return contents
+
+
+def generate_hfile() -> str:
+    # Guard
+    header_gaurd = "__JL_TESTINT_CASES_H__"
+    guard_begin = f"#ifndef {header_gaurd}"  + "\n" + f"#define {header_gaurd}"
+    guard_end = "#endif"
+
+    # Includes
+    include_global = ["cstdint", "vector"]
+    include_local = []
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
+    global_header_str = '\n'.join([f"#include<{h}>" for h in include_global])
+
+    # Variables
+    header_vars_map = {
+            'extern std::vector<std::vector<uint8_t>>':
+                [f"cases_{name}" for name in NAMES],
+            'extern std::vector<uint8_t>':
+                [f"cases_{name}_neg" for name in NAMES],
+    }
+
+    header_vars_list = []
+    for k, v in header_vars_map.items():
+        for name in v:
+            header_vars_list.append(f"{k} {name};")
+    header_vars = "\n".join(header_vars_list)
+
+    contents = "\n".join([guard_begin,
+                               local_header_str, global_header_str, 
+                               header_vars,
+                               guard_end])
+    return contents
+
+
+if __name__ == '__main__':
+    c_file_name = "cases.cpp"
+    h_file_name = "cases.h"
+
+    c_file_contents = generate_cfile()
+    h_file_contents = generate_hfile()
+
+    with open(c_file_name, 'w') as f:
+      f.write(c_file_contents)
+    with open(h_file_name, 'w') as f:
+      f.write(h_file_contents)
@@ -0,0 +1,218 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/jl_int.h"
+#include "../testutils.h"
+}
+
+enum int_op { OP_ADD, OP_SUB, OP_MUL, OP_DIVREM };
+
+// Loads a big-endian magnitude and sign into a jl_int.
+int load_int(jl_int *z, const std::vector<uint8_t> &x, uint8_t neg) {
+  std::vector<uint8_t> le(x.rbegin(), x.rend());
+  return int_set_bstring(z, le.data(), neg, le.size());
+}
+
+// Reads a jl_int back as a big-endian magnitude of size bytes. Returns the
+// flags int_get_bstring reports.
+uint8_t store_int(const jl_int *x, std::vector<uint8_t> &z, size_t size) {
+  uint8_t flags = 0;
+  z.assign(size, 0);
+  int_get_bstring(x, z.data(), &flags, z.size());
+  std::reverse(z.begin(), z.end());
+  return flags;
+}
+
+void on_bad_rc(size_t case_id, int rc) {
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("Indeterminate test case: %lu.\n", case_id);
+  printf("\tError code %d returned.\n", rc);
+}
+
+void print_signed(const char *label, std::vector<uint8_t> &v, uint8_t neg) {
+  printf("\t\t%s: %c", label, neg ? '-' : '+');
+  printhex_be(v.data(), v.size() * 8);
+  printf("\n");
+}
+
+void on_failure(size_t case_id, const char *what, std::vector<uint8_t> &z,
+                uint8_t z_neg, std::vector<uint8_t> &result,
+                uint8_t result_neg) {
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\tComputing %s\n", what);
+  print_signed("x       ", cases_x[case_id], cases_x_neg[case_id]);
+  print_signed("y       ", cases_y[case_id], cases_y_neg[case_id]);
+  printf("\tResults\n");
+  print_signed("Expected", z, z_neg);
+  print_signed("Computed", result, result_neg);
+}
+
+// Checks a result against the expected magnitude and sign.
+bool check_result(size_t case_id, const char *what, const jl_int *result,
+                  std::vector<uint8_t> &z, uint8_t z_neg) {
+  std::vector<uint8_t> z_test;
+  const uint8_t flags = store_int(result, z_test, z.size());
+  const uint8_t neg = (flags >> 1) & 1;
+  const bool success = z_test == z && neg == z_neg && !(flags & 1);
+  if (!success)
+    on_failure(case_id, what, z, z_neg, z_test, neg);
+  return success;
+}
+
+int run_testcase_int(size_t case_id, int_op op, bool in_place,
+                     size_t *duration) {
+  jl_int x, y, z, r;
+  int_init(&x);
+  int_init(&y);
+  int_init(&z);
+  int_init(&r);
+
+  int rc = load_int(&x, cases_x[case_id], cases_x_neg[case_id]);
+  rc |= load_int(&y, cases_y[case_id], cases_y_neg[case_id]);
+
+  // In place, the result overwrites x.
+  jl_int *out = in_place ? &x : &z;
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  bool skip = false;
+  if (rc == 0) {
+    switch (op) {
+    case OP_ADD:
+      rc = int_add(out, &x, &y);
+      break;
+    case OP_SUB:
+      rc = int_sub(out, &x, &y);
+      break;
+    case OP_MUL:
+      rc = int_mul(out, &x, &y);
+      break;
+    case OP_DIVREM:
+      skip = y.n == 0;
+      rc = skip ? int_divrem(out, &r, &x, &y) != 3 : int_divrem(out, &r, &x, &y);
+      break;
+    }
+  }
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  const size_t size = cases_x[case_id].size() + cases_y[case_id].size();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       size); // Normalize (ns per byte of operands).
+
+  bool success = true;
+  if (rc) {
+    on_bad_rc(case_id, rc);
+  } else if (!skip) {
+    switch (op) {
+    case OP_ADD:
+      success = check_result(case_id, "x + y", out, cases_sum[case_id],
+                             cases_sum_neg[case_id]);
+      break;
+    case OP_SUB:
+      success = check_result(case_id, "x - y", out, cases_diff[case_id],
+                             cases_diff_neg[case_id]);
+      break;
+    case OP_MUL:
+      success = check_result(case_id, "x * y", out, cases_prod[case_id],
+                             cases_prod_neg[case_id]);
+      break;
+    case OP_DIVREM:
+      success = check_result(case_id, "x / y", out, cases_quot[case_id],
+                             cases_quot_neg[case_id]) &&
+                check_result(case_id, "x % y", &r, cases_rem[case_id],
+                             cases_rem_neg[case_id]);
+      break;
+    }
+  }
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&z);
+  int_free(&r);
+
+  if (rc)
+    return -1;
+
+  return success;
+}
+
+void run_all_testcases_int(const char *name, int_op op, bool in_place) {
+  const size_t num_cases = std::max({cases_x.size(), cases_y.size()});
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_int(i, op, in_place, &duration);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    } else if (rc == 2) {
+      // ND.
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per byte processed: %lu\n", avg_duration);
+}
+
+int main() {
+  run_all_testcases_int("int_add", OP_ADD, false);
+  run_all_testcases_int("int_sub", OP_SUB, false);
+  run_all_testcases_int("int_mul", OP_MUL, false);
+  run_all_testcases_int("int_divrem", OP_DIVREM, false);
+  run_all_testcases_int("int_add (in place)", OP_ADD, true);
+  run_all_testcases_int("int_sub (in place)", OP_SUB, true);
+  run_all_testcases_int("int_mul (in place)", OP_MUL, true);
+  run_all_testcases_int("int_divrem (in place)", OP_DIVREM, true);
+
+  // Small values stay in the inline storage.
+  jl_int a, b;
+  int_init(&a);
+  int_init(&b);
+  int_set_i64(&a, INT64_MIN);
+  int_set_u64(&b, UINT64_MAX);
+  int_mul(&a, &a, &b);
+  if (a.alloc != JL_INT_INLINE_LIMBS || int_sgn(&a) != -1)
+    printf("Failed: small product left the inline storage\n");
+  int_free(&a);
+  int_free(&b);
+
+  return 0;
+};
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/jl_int.h"
+#include "../../src/layout.h"
+#include "../testutils.h"
+}
+
+// Lays random values out every way a jl_layout can say, a byte at a time as
+// the definition goes, and checks the layout functions against the
+// little-endian byte string and jl_int functions on the same values.
+
+static uint64_t rnd_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+static std::vector<uint8_t> random_bytes(size_t size) {
+  std::vector<uint8_t> x(size);
+  for (size_t i = 0; i < size; i++)
+    x[i] = (uint8_t)rnd();
+  // Leading zeros, as fixed-width formats have.
+  if (size > 0 && rnd() % 3 == 0)
+    std::fill(x.begin() + rnd() % size, x.end(), 0);
+  return x;
+}
+
+static jl_layout random_layout() {
+  static const size_t sizes[] = {1, 1, 2, 3, 4, 5, 8, 8, 9, 16};
+  jl_layout l;
+  l.order = rnd() % 2 ? 1 : -1;
+  l.endian = (int)(rnd() % 3) - 1;
+  l.size = sizes[rnd() % 10];
+  l.stride = rnd() % 2 ? 0 : l.size + rnd() % 4;
+  return l;
+}
+
+static bool host_little() {
+  const uint16_t one = 1;
+  uint8_t b;
+  memcpy(&b, &one, 1);
+  return b == 1;
+}
+
+// Where byte k of the value goes among count words of l.
+static size_t place(const jl_layout &l, size_t count, size_t k) {
+  const size_t w = k / l.size, j = k % l.size;
+  const size_t stride = l.stride ? l.stride : l.size;
+  const bool little = l.endian < 0 || (l.endian == 0 && host_little());
+  return (l.order < 0 ? w : count - 1 - w) * stride +
+         (little ? j : l.size - 1 - j);
+}
+
+static size_t span(const jl_layout &l, size_t count) {
+  const size_t stride = l.stride ? l.stride : l.size;
+  return count == 0 ? 0 : (count - 1) * stride + l.size;
+}
+
+// The value in the little-endian v, truncated or padded to count words of l,
+// over what's in z.
+static void lay_out(std::vector<uint8_t> &z, const std::vector<uint8_t> &v,
+                    const jl_layout &l, size_t count) {
+  z.resize(span(l, count), 0xAA);
+  for (size_t k = 0; k < count * l.size; k++)
+    z[place(l, count, k)] = k < v.size() ? v[k] : 0;
+}
+
+static std::vector<uint8_t> laid_out(const std::vector<uint8_t> &v,
+                                     const jl_layout &l, size_t count) {
+  std::vector<uint8_t> z;
+  lay_out(z, v, l, count);
+  return z;
+}
+
+static uint8_t *data(std::vector<uint8_t> &x) {
+  static uint8_t none;
+  return x.empty() ? &none : x.data();
+}
+
+static std::vector<uint8_t> int_bytes(const jl_int *x, size_t size) {
+  std::vector<uint8_t> z(size);
+  uint8_t flags;
+  int_get_bstring(x, data(z), &flags, size);
+  return z;
+}
+
+static bool check_limbs(const jl_layout &l) {
+  const size_t count = rnd() % 40;
+  const std::vector<uint8_t> v = random_bytes(count * l.size);
+  std::vector<uint8_t> x = laid_out(v, l, count);
+  const size_t n = rnd() % 2 ? limbs_for_bytes(v.size()) : rnd() % 8;
+
+  std::vector<jl_limb_t> got(n + 1, 0x5555), want(n + 1, 0x5555);
+  layout_to_limbs(got.data(), n, data(x), count, &l);
+  bytes_to_limbs(want.data(), n, v.data(), v.size());
+  bool ok = got == want;
+
+  // And back, leaving the bytes between words alone.
+  std::vector<uint8_t> z(span(l, count), 0xAA);
+  std::vector<uint8_t> e = z;
+  const size_t vn = limbs_for_bytes(v.size());
+  std::vector<jl_limb_t> vl(vn + 1);
+  bytes_to_limbs(vl.data(), vn, v.data(), v.size());
+  const size_t m = rnd() % (vn + 1);
+  limbs_to_layout(data(z), count, vl.data(), m, &l);
+  std::vector<uint8_t> w(v.begin(), v.begin() + std::min(v.size(), 8 * m));
+  lay_out(e, w, l, count);
+  ok &= z == e;
+  return ok;
+}
+
+static bool check_int(const jl_layout &l) {
+  const size_t count = rnd() % 40;
+  const std::vector<uint8_t> v = random_bytes(count * l.size);
+  std::vector<uint8_t> x = laid_out(v, l, count);
+  const uint8_t neg = rnd() % 2;
+
+  jl_int a, b;
+  int_init(&a);
+  int_init(&b);
+  bool ok = int_import(&a, data(x), neg, count, &l) == 0;
+  int_set_bstring(&b, v.data(), neg, v.size());
+  ok &= int_cmp(&a, &b) == 0;
+
+  const size_t need = int_export_count(&a, &l);
+  ok &= need <= count && (need == 0 || need * l.size >= int_bstring_size(&a));
+  ok &= need == 0 || (need - 1) * l.size < int_bstring_size(&a);
+  const size_t z_count = rnd() % 2 ? need : rnd() % (count + 2);
+  std::vector<uint8_t> z(span(l, z_count), 0xAA);
+  std::vector<uint8_t> e = z;
+  uint8_t flags;
+  ok &= int_export(&a, data(z), &flags, z_count, &l) == 0;
+  lay_out(e, v, l, z_count);
+  ok &= z == e && flags == ((need > z_count) | (a.n > 0 && neg) << 1);
+
+  int_free(&a);
+  int_free(&b);
+  return ok;
+}
+
+// Low size bytes of x - y, two's complement.
+static std::vector<uint8_t> difference(const jl_int *x, const jl_int *y,
+                                       size_t size) {
+  jl_int d;
+  int_init(&d);
+  int_sub(&d, x, y);
+  std::vector<uint8_t> z = int_bytes(&d, size);
+  if (d.neg) {
+    unsigned c = 1;
+    for (size_t i = 0; i < size; i++) {
+      c += (uint8_t)~z[i];
+      z[i] = (uint8_t)c;
+      c >>= 8;
+    }
+  }
+  int_free(&d);
+  return z;
+}
+
+static bool check_arith(const jl_layout &l, size_t max_count) {
+  const size_t x_count = rnd() % max_count;
+  const size_t y_count = rnd() % max_count;
+  const size_t z_count = rnd() % 2 ? x_count + y_count : rnd() % max_count;
+  const std::vector<uint8_t> xv = random_bytes(x_count * l.size);
+  const std::vector<uint8_t> yv = random_bytes(y_count * l.size);
+  std::vector<uint8_t> x = laid_out(xv, l, x_count);
+  std::vector<uint8_t> y = laid_out(yv, l, y_count);
+  const size_t z_bytes = z_count * l.size;
+
+  jl_int a, b, c, r;
+  int_init(&a);
+  int_init(&b);
+  int_init(&c);
+  int_init(&r);
+  int_set_bstring(&a, xv.data(), 0, xv.size());
+  int_set_bstring(&b, yv.data(), 0, yv.size());
+  bool ok = true;
+  uint8_t flags;
+
+  std::vector<uint8_t> z(span(l, z_count), 0xAA);
+  std::vector<uint8_t> e = z;
+  int_add(&c, &a, &b);
+  ok &= add_layout(data(x), data(y), data(z), &flags, x_count, y_count,
+                   z_count, &l) == 0;
+  lay_out(e, int_bytes(&c, z_bytes), l, z_count);
+  ok &= z == e && flags == (int_bstring_size(&c) > z_bytes);
+
+  int_sub(&c, &a, &b);
+  ok &= sub_layout(data(x), data(y), data(z), &flags, x_count, y_count,
+                   z_count, &l) == 0;
+  lay_out(e, difference(&a, &b, z_bytes), l, z_count);
+  ok &= z == e && flags == (c.neg || int_bstring_size(&c) > z_bytes);
+
+  // Sums and differences in place, into x with a word to spare.
+  std::vector<uint8_t> v = laid_out(xv, l, x_count);
+  v.resize(span(l, x_count + 1), 0xAA);
+  int_add(&c, &a, &b);
+  ok &= add_layout(data(v), data(y), data(v), &flags, x_count, y_count,
+                   x_count + 1, &l) == 0;
+  lay_out(e, int_bytes(&c, (x_count + 1) * l.size), l, x_count + 1);
+  ok &= v == e;
+  ok &= sub_layout(data(v), data(v), data(v), &flags, x_count + 1, x_count + 1,
+                   x_count + 1, &l) == 0;
+  lay_out(e, {}, l, x_count + 1);
+  ok &= v == e && flags == 0;
+
+  int_mul(&c, &a, &b);
+  ok &= mul_layout(data(x), data(y), data(z), &flags, x_count, y_count,
+                   z_count, &l) == 0;
+  lay_out(e, int_bytes(&c, z_bytes), l, z_count);
+  ok &= z == e && flags == (int_bstring_size(&c) > z_bytes);
+
+  // Squaring, and in place.
+  int_mul(&c, &a, &a);
+  std::vector<uint8_t> w = laid_out(xv, l, x_count);
+  ok &= mul_layout(data(w), data(w), data(w), &flags, x_count, x_count,
+                   x_count, &l) == 0;
+  lay_out(e, int_bytes(&c, x_count * l.size), l, x_count);
+  ok &= w == e;
+
+  // Division, by y with its top word set so it isn't zero.
+  if (y_count > 0) {
+    std::vector<uint8_t> dv = yv;
+    dv.back() |= 1;
+    std::vector<uint8_t> d = laid_out(dv, l, y_count);
+    int_set_bstring(&b, dv.data(), 0, dv.size());
+    int_divrem(&c, &r, &a, &b);
+    std::vector<uint8_t> q(span(l, z_count), 0xAA);
+    std::vector<uint8_t> rem(span(l, y_count), 0xAA);
+    std::vector<uint8_t> eq = q, er = rem;
+    ok &= divrem_layout(data(x), data(d), data(q), data(rem), &flags, x_count,
+                        y_count, z_count, y_count, &l) == 0;
+    lay_out(eq, int_bytes(&c, z_bytes), l, z_count);
+    lay_out(er, int_bytes(&r, y_count * l.size), l, y_count);
+    ok &= q == eq && rem == er && flags == (int_bstring_size(&c) > z_bytes);
+  }
+  std::vector<uint8_t> zero(span(l, y_count + 1), 0);
+  ok &= divrem_layout(data(x), data(zero), data(z), NULL, &flags, x_count,
+                      y_count + 1, z_count, 0, &l) == 4;
+
+  int_free(&a);
+  int_free(&b);
+  int_free(&c);
+  int_free(&r);
+  return ok;
+}
+
+// Big-endian byte strings, as on the wire, against the little-endian
+// functions on reversed copies.
+static bool check_be(size_t max_size) {
+  std::vector<uint8_t> x = random_bytes(1 + rnd() % max_size);
+  std::vector<uint8_t> y = random_bytes(1 + rnd() % max_size);
+  const size_t z_size = x.size() + y.size();
+  std::vector<uint8_t> z(z_size), e(z_size);
+  uint8_t flags;
+  bool ok = mul_layout(x.data(), y.data(), z.data(), &flags, x.size(),
+                       y.size(), z_size, &jl_layout_be) == 0;
+
+  std::reverse(x.begin(), x.end());
+  std::reverse(y.begin(), y.end());
+  mul_bstrings(x.data(), y.data(), e.data(), &flags, x.size(), y.size(),
+               z_size);
+  std::reverse(e.begin(), e.end());
+  ok &= z == e;
+  return ok;
+}
+
+static bool run_testcase(size_t i) {
+  const jl_layout l = random_layout();
+  const size_t max_count = i % 8 == 0 ? 200 : 20;
+  return check_limbs(l) && check_int(l) && check_arith(l, max_count) &&
+         check_be(i % 8 == 0 ? 3000 : 100);
+}
+
+int main() {
+  const size_t num_cases = 2000;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"layout operations\"\n");
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (run_testcase(i))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+
+  // Invalid layouts.
+  const jl_layout bad[] = {{0, 1, 1, 0}, {1, 2, 1, 0}, {1, 1, 0, 0},
+                           {-1, -1, 4, 3}};
+  uint8_t b[16] = {0}, flags;
+  jl_int x;
+  int_init(&x);
+  bool ok = layout_check(NULL) == 1 &&
+            layout_check(&jl_layout_le) == 0 &&
+            layout_check(&jl_layout_be) == 0;
+  for (const jl_layout &l : bad)
+    ok &= layout_check(&l) == 3 &&
+          add_layout(b, b, b, &flags, 1, 1, 1, &l) == 3 &&
+          divrem_layout(b, b, b, b, &flags, 1, 1, 1, 1, &l) == 3 &&
+          int_import(&x, b, 0, 1, &l) == 3;
+  ok &= mul_layout(b, NULL, b, &flags, 1, 1, 1, &jl_layout_be) == 1 &&
+        add_layout(b, b, b, NULL, 1, 1, 1, &jl_layout_le) == 1 &&
+        int_export(&x, b, &flags, 1, NULL) == 1;
+  if (!ok) {
+    passed--;
+    printf("Failed error checks.\n");
+  }
+  int_free(&x);
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+
+  return 0;
+}
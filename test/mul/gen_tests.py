@@ -51,7 +51,35 @@ def generate_cfile() -> str:
         c2.append(t2)
         c3.append(t3)
 
-    
+
+    # Random multi-limb cases, including sizes that aren't a multiple of 8.
+    for i in range(100):
+        x_size = random.randint(1, 64)
+        y_size = random.randint(1, 64)
+
+        x = random.randint(1, 256**x_size - 1)
+        y = random.randint(1, 256**y_size - 1)
+
+        t1, t2, t3 = case_str(x, y)
+
+        c1.append(t1)
+        c2.append(t2)
+        c3.append(t3)
+
+    # Large cases, past the Karatsuba threshold, balanced and unbalanced.
+    for i in range(20):
+        x_size = random.randint(100, 2000)
+        y_size = random.choice([x_size, random.randint(100, 2000)])
+
+        x = random.randint(1, 256**x_size - 1)
+        y = random.randint(1, 256**y_size - 1)
+
+        t1, t2, t3 = case_str(x, y)
+
+        c1.append(t1)
+        c2.append(t2)
+        c3.append(t3)
+
     # Edge cases.
     for i in range(2,10,1):
         x = 8**i
@@ -104,7 +132,7 @@ def generate_hfile() -> str:
     guard_end = "#endif"
 
     # Includes
-    include_global = ["vector"]
+    include_global = ["cstdint", "vector"]
     include_local = []
 
     local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
@@ -1,5 +1,6 @@
 #include "cases.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -9,6 +10,11 @@
 
 extern "C" {
 #include "../../src/add_sub_mul.h"
+#include "../../src/layout.h"
+#include "../../src/mul_par.h"
+#include "../../src/ntt.h"
+#include "../../src/pool.h"
+#include "../../src/toom.h"
 #include "../testutils.h"
 }
 
@@ -83,7 +89,13 @@ void on_failure(size_t case_id, std::vector<uint8_t> &result) { // Cases data.
   printf("\n");
 }
 
-int run_testcase_mul_8(size_t case_id, size_t *duration) {
+typedef uint8_t (*mul_fn)(const uint8_t *, const uint8_t *, uint8_t *,
+                          uint8_t *, size_t, size_t, size_t);
+
+// With big_endian, mul takes and gives the cases as they are, most significant
+// byte first, and nothing is reversed.
+int run_testcase_mul(size_t case_id, size_t *duration, mul_fn mul,
+                     bool big_endian) {
   // Case.
   std::vector<uint8_t> &x = cases_x[case_id];
   std::vector<uint8_t> &y = cases_y[case_id];
@@ -96,14 +108,15 @@ int run_testcase_mul_8(size_t case_id, size_t *duration) {
   // 3. Postprocess
   // 4. Report
 
-  preprocess_case(case_id);
+  if (!big_endian)
+    preprocess_case(case_id);
 
   // Start stopclock.
   auto t1 = std::chrono::high_resolution_clock::now();
 
   uint8_t carry = 0;
-  int rc = mul_bstrings_8_gradeschool(x.data(), y.data(), z_test.data(), &carry,
-                                      x.size(), y.size(), z_test.size());
+  int rc = mul(x.data(), y.data(), z_test.data(), &carry, x.size(), y.size(),
+               z_test.size());
 
   // End stopclock and get duration.
   auto t2 = std::chrono::high_resolution_clock::now();
@@ -111,7 +124,8 @@ int run_testcase_mul_8(size_t case_id, size_t *duration) {
       (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
        z.size()); // Normalize (ns per byte processed).
 
-  postprocess_case(case_id, z_test);
+  if (!big_endian)
+    postprocess_case(case_id, z_test);
 
   if (rc) {
     on_bad_rc(case_id, rc);
@@ -127,26 +141,41 @@ int run_testcase_mul_8(size_t case_id, size_t *duration) {
   return success;
 }
 
-void run_all_testcases_mul() {
-  const size_t num_cases =
-      std::max({cases_x.size(), cases_y.size(), cases_z.size()});
-
+void print_header(const char *name) {
   printf("\n");
   for (int i = 0; i < 72; i++)
     printf("=");
   printf("\n");
   printf("TESTING\n");
-  printf("\tFunction: \"mul_bstrings_8_gradeschool\"\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+}
+
+void print_results(int passed, int failed, size_t num_cases) {
   for (int i = 0; i < 72; i++)
     printf("-");
   printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+}
+
+void run_all_testcases_mul(const char *name, mul_fn mul,
+                           bool big_endian = false) {
+  const size_t num_cases =
+      std::max({cases_x.size(), cases_y.size(), cases_z.size()});
+
+  print_header(name);
 
   int passed = 0;
   int failed = 0;
   size_t duration = 0;
   size_t total_duration = 0;
   for (size_t i = 0; i < num_cases; i++) {
-    int rc = run_testcase_mul_8(i, &duration);
+    int rc = run_testcase_mul(i, &duration, mul, big_endian);
     total_duration += duration;
     if (rc == 1)
       passed++;
@@ -159,19 +188,97 @@ void run_all_testcases_mul() {
 
   size_t avg_duration = total_duration / num_cases;
 
-  for (int i = 0; i < 72; i++)
-    printf("-");
-  printf("\n");
-  printf("RESULTS\n");
-  printf("\tPassed: %d / %lu\n", passed, num_cases);
-  printf("\tFailed: %d / %lu\n", failed, num_cases);
-  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  print_results(passed, failed, num_cases);
   printf("\n");
   printf("\tAvg. ns per byte processed: %lu\n", avg_duration);
 }
 
+// Runs mul_bstrings_arena in an arena of exactly mul_bstrings_itch bytes, which
+// must be enough, and must all be given back (error code 5 if not).
+uint8_t mul_via_arena(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                      uint8_t *flags, size_t x_size, size_t y_size,
+                      size_t z_size) {
+  const size_t itch = mul_bstrings_itch(x_size, y_size);
+  std::vector<jl_limb_t> buf(itch / sizeof(jl_limb_t) + 1);
+  jl_arena arena;
+  arena_init(&arena, buf.data(), itch);
+  uint8_t rc =
+      mul_bstrings_arena(x, y, z, flags, x_size, y_size, z_size, &arena);
+  if (rc == 0 && arena.used != 0)
+    rc = 5;
+  return rc;
+}
+
+uint8_t mul_big_endian(const uint8_t *x, const uint8_t *y, uint8_t *z,
+                       uint8_t *flags, size_t x_size, size_t y_size,
+                       size_t z_size) {
+  return mul_layout(x, y, z, flags, x_size, y_size, z_size, &jl_layout_be);
+}
+
 int main() {
-  run_all_testcases_mul();
+  run_all_testcases_mul("mul_bstrings_8_gradeschool",
+                        mul_bstrings_8_gradeschool);
+  run_all_testcases_mul("mul_bstrings_karatsuba", mul_bstrings_karatsuba);
+  run_all_testcases_mul("mul_bstrings_ntt", mul_bstrings_ntt);
+  run_all_testcases_mul("mul_bstrings", mul_bstrings);
+  run_all_testcases_mul("mul_bstrings_arena", mul_via_arena);
+  run_all_testcases_mul("mul_layout (big-endian)", mul_big_endian, true);
+
+  // Push every tier of mul_bstrings down onto the test sizes.
+  set_mul_karatsuba_threshold(2);
+  set_mul_toom3_threshold(8);
+  set_mul_toom4_threshold(16);
+  set_mul_ntt_threshold(JL_MUL_NTT_MIN_LIMBS);
+  run_all_testcases_mul("mul_bstrings (low thresholds)", mul_bstrings);
+  run_all_testcases_mul("mul_bstrings_arena (low thresholds)", mul_via_arena);
+  set_mul_karatsuba_threshold(JL_MUL_KARATSUBA_THRESHOLD);
+  set_mul_toom3_threshold(JL_MUL_TOOM3_THRESHOLD);
+  set_mul_toom4_threshold(JL_MUL_TOOM4_THRESHOLD);
+  set_mul_ntt_threshold(JL_MUL_NTT_THRESHOLD);
+
+  // Split the same products into tasks on a pool, down to two limbs.
+  set_pool_threads(4);
+  set_mul_par_grain(2);
+  run_all_testcases_mul("mul_bstrings (4 threads)", mul_bstrings);
+  run_all_testcases_mul("mul_bstrings_arena (4 threads)", mul_via_arena);
+  set_mul_ntt_threshold(JL_MUL_NTT_MIN_LIMBS);
+  run_all_testcases_mul("mul_bstrings (4 threads, low NTT threshold)",
+                        mul_bstrings);
+
+  // A product big enough for the NTT to split its transforms, against the
+  // serial result.
+  {
+    print_header("mul_bstrings (4 threads, split NTT)");
+    std::vector<uint8_t> a(24000), b(20000);
+    for (size_t i = 0; i < a.size(); i++)
+      a[i] = (uint8_t)(i * 7919 + (i >> 5));
+    for (size_t i = 0; i < b.size(); i++)
+      b[i] = (uint8_t)(i * 104729 + (i >> 3));
+    std::vector<uint8_t> par(a.size() + b.size()), ser(par.size());
+    uint8_t flags_par = 0, flags_ser = 0;
+    mul_bstrings(a.data(), b.data(), par.data(), &flags_par, a.size(),
+                 b.size(), par.size());
+    set_pool_threads(0);
+    mul_bstrings_karatsuba(a.data(), b.data(), ser.data(), &flags_ser,
+                           a.size(), b.size(), ser.size());
+    const bool success = flags_par == flags_ser && par == ser;
+    if (!success)
+      printf("Failed: %zu x %zu bytes against mul_bstrings_karatsuba.\n",
+             a.size(), b.size());
+    print_results(success, !success, 1);
+  }
+  set_mul_ntt_threshold(JL_MUL_NTT_THRESHOLD);
+  set_mul_par_grain(JL_MUL_PAR_GRAIN);
+
+  // The portable kernels, if the CPU picked faster ones at load time.
+  const unsigned kernels = get_limb_kernels();
+  if (kernels != 0) {
+    set_limb_kernels(0);
+    run_all_testcases_mul("mul_bstrings_8_gradeschool (portable kernels)",
+                          mul_bstrings_8_gradeschool);
+    run_all_testcases_mul("mul_bstrings (portable kernels)", mul_bstrings);
+    set_limb_kernels(kernels);
+  }
 
   std::vector<uint8_t> x{0x12};
   std::vector<uint8_t> y{0x32};
@@ -0,0 +1,163 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/div.h"
+#include "../../src/mont.h"
+#include "../../src/perf.h"
+#include "../../src/radix.h"
+#include "../testutils.h"
+}
+
+// Built with JL_PERF: every instrumented entry point should land one call in
+// the bucket of its larger operand, and nothing else.
+
+static uint64_t calls(unsigned op, size_t bucket) {
+  jl_perf_stats s;
+  get_perf_stats(&s, op, bucket);
+  return s.calls;
+}
+
+// Total calls of op over every bucket.
+static uint64_t all_calls(unsigned op) {
+  uint64_t n = 0;
+  for (size_t b = 0; b < JL_PERF_BUCKETS; b++)
+    n += calls(op, b);
+  return n;
+}
+
+static bool check_buckets() {
+  return perf_bucket(0) == 0 && perf_bucket(1) == 0 && perf_bucket(2) == 1 &&
+         perf_bucket(3) == 1 && perf_bucket(4096) == 12 &&
+         perf_bucket(4095) == 11 &&
+         perf_bucket((size_t)1 << 60) == JL_PERF_BUCKETS - 1;
+}
+
+static bool check_add_sub() {
+  std::vector<uint8_t> x(100, 0x5A), y(300, 0xA5), z(301);
+  uint8_t flags;
+  reset_perf_stats();
+  add_bstrings(x.data(), y.data(), z.data(), &flags, 100, 3, 101);
+  sub_bstrings(x.data(), y.data(), z.data(), &flags, 100, 300, 300);
+  return calls(JL_PERF_ADD, 6) == 1 && all_calls(JL_PERF_ADD) == 1 &&
+         calls(JL_PERF_SUB, 8) == 1 && all_calls(JL_PERF_SUB) == 1;
+}
+
+static bool check_mul_sqr() {
+  std::vector<uint8_t> x(1000, 0x37), z(2000);
+  uint8_t flags;
+  reset_perf_stats();
+  mul_bstrings(x.data(), x.data(), z.data(), &flags, 1000, 10, 1010);
+  sqr_bstrings(x.data(), z.data(), &flags, 64, 128);
+  return calls(JL_PERF_MUL, 9) == 1 && all_calls(JL_PERF_MUL) == 1 &&
+         calls(JL_PERF_SQR, 6) == 1 && all_calls(JL_PERF_SQR) == 1;
+}
+
+static bool check_divrem_powm() {
+  std::vector<uint8_t> x(40, 0x91), d(8, 0x13), q(40), r(8);
+  uint8_t flags;
+  reset_perf_stats();
+  divrem_bstrings(x.data(), d.data(), q.data(), r.data(), &flags, 40, 8, 40,
+                  8);
+
+  std::vector<uint8_t> mod(32, 0xEF), z(32);
+  jl_mont_ctx ctx;
+  if (mont_ctx_init(&ctx, mod.data(), mod.size()))
+    return false;
+  powm_bstrings(&ctx, x.data(), d.data(), z.data(), &flags, 40, 8, 32);
+  mont_ctx_free(&ctx);
+
+  return calls(JL_PERF_DIVREM, 5) == 1 && all_calls(JL_PERF_DIVREM) == 1 &&
+         calls(JL_PERF_POWM, 5) == 1 && all_calls(JL_PERF_POWM) == 1;
+}
+
+// to_decimal and from_decimal go through to_base and from_base, and count once.
+static bool check_radix() {
+  std::vector<uint8_t> x(16, 0x77), z(16);
+  std::vector<char> s(to_base_size(16, 10));
+  size_t s_len;
+  uint8_t flags;
+  reset_perf_stats();
+  to_decimal(x.data(), s.data(), &s_len, 16, s.size());
+  from_decimal("12345", z.data(), &flags, 5, 16);
+  return calls(JL_PERF_TO_BASE, 4) == 1 && all_calls(JL_PERF_TO_BASE) == 1 &&
+         calls(JL_PERF_FROM_BASE, 2) == 1 && all_calls(JL_PERF_FROM_BASE) == 1;
+}
+
+// Rejected calls never reach a probe.
+static bool check_errors() {
+  uint8_t flags;
+  jl_perf_stats s;
+  reset_perf_stats();
+  add_bstrings(NULL, NULL, NULL, &flags, 1, 1, 1);
+  mul_bstrings(NULL, NULL, NULL, &flags, 1, 1, 1);
+  return all_calls(JL_PERF_ADD) == 0 && all_calls(JL_PERF_MUL) == 0 &&
+         get_perf_stats(NULL, JL_PERF_ADD, 0) == 1 &&
+         get_perf_stats(&s, JL_PERF_OPS, 0) == 3 &&
+         get_perf_stats(&s, JL_PERF_ADD, JL_PERF_BUCKETS) == 3 &&
+         get_perf_stats(&s, JL_PERF_ADD, 0) == 0;
+}
+
+// Where the kernel lets us count, a big product takes cycles and instructions.
+static bool check_counters() {
+  if (!perf_counting()) {
+    printf("\tCounters unavailable; only calls are counted.\n");
+    return true;
+  }
+
+  std::vector<uint8_t> x(1 << 16, 0xC3), z(1 << 17);
+  uint8_t flags;
+  reset_perf_stats();
+  mul_bstrings(x.data(), x.data(), z.data(), &flags, x.size(), x.size(),
+               z.size());
+  jl_perf_stats s;
+  get_perf_stats(&s, JL_PERF_MUL, 16);
+  return s.calls == 1 && s.cycles > 0 && s.instructions > 1000;
+}
+
+int main() {
+  static const struct {
+    const char *name;
+    bool (*check)();
+  } checks[] = {
+      {"perf_bucket", check_buckets},
+      {"add_bstrings/sub_bstrings", check_add_sub},
+      {"mul_bstrings/sqr_bstrings", check_mul_sqr},
+      {"divrem_bstrings/powm_bstrings", check_divrem_powm},
+      {"to_decimal/from_decimal", check_radix},
+      {"error paths", check_errors},
+      {"counters", check_counters},
+  };
+  const size_t num_cases = sizeof(checks) / sizeof(checks[0]);
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"get_perf_stats\"\n");
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (checks[i].check())
+      passed++;
+    else
+      printf("Failed test case \"%s\".\n", checks[i].name);
+  }
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+
+  return 0;
+}
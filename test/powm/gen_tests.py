@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+
+# Run this in its directory to generate test cases.
+
+import random
+import os
+
+
+def to_list(r: int) -> str:
+    s = f"{r:X}"
+    if len(s) % 2 == 1:
+        s = '0' + s
+    l = [s[i:i + 2] for i in range(0,len(s),2)]
+    return f"{'{'}0x{', 0x'.join(l)}{'}'}"
+
+
+def case_str(x: int, e: int, m: int) -> tuple[str, str, str, str]:
+    z = pow(x, e, m)
+    return to_list(x), to_list(e), to_list(m), to_list(z)
+
+
+def generate_cfile() -> str:
+    cases = []
+
+    # Random cases, with the base both below and well above the modulus.
+    for i in range(200):
+        m_size = random.randint(1, 40)
+        x_size = random.choice([m_size, random.randint(1, 3 * m_size)])
+        e_size = random.randint(0, 40)
+
+        m = random.randint(0, 256**m_size - 1) | 1
+        x = random.randint(0, 256**x_size - 1)
+        e = random.randint(0, 256**e_size - 1)
+
+        cases.append(case_str(x, e, m))
+
+    # Production-sized moduli, 2048 to 8192 bits, including past the
+    # reduction threshold.
+    for bits in [2048, 3072, 4096, 8192, 12288, 16384]:
+        m = random.getrandbits(bits) | 1 | (1 << (bits - 1))
+        x = random.getrandbits(bits) % m
+        e = random.getrandbits(bits)
+
+        cases.append(case_str(x, e, m))
+
+    # Edge cases: e = 0, e = 1, x = 0, x = m - 1, m = 1, all-ones moduli.
+    for i in range(1, 10, 1):
+        m = 256**(8 * i) - 1
+        cases.append(case_str(12345, 0, m))
+        cases.append(case_str(12345, 1, m))
+        cases.append(case_str(0, 8**i, m))
+        cases.append(case_str(m - 1, 8**i + 1, m))
+        cases.append(case_str(8**i, 8**i, 1))
+
+    headers = ["vector"]
+    local_headers = [h_file_name]
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in local_headers])
+    header_str = '\n'.join([f"#include<{h}>" for h in headers])
+
+    casetype = "std::vector<std::vector<uint8_t>>"
+
+    outputs = []
+    for j, name in enumerate(['cases_x', 'cases_e', 'cases_m', 'cases_z']):
+        cl = ',\n'.join([c[j] for c in cases])
+        outputs.append(f"{casetype} {name} = {'{'}{cl}{'};'}")
+
+    contents = '\n'.join([local_header_str, header_str] + outputs)
+    return contents
+
+
+def generate_hfile() -> str:
+    # Guard
+    header_gaurd = "__JL_TESTPOWM_CASES_H__"
+    guard_begin = f"#ifndef {header_gaurd}"  + "\n" + f"#define {header_gaurd}"
+    guard_end = "#endif"
+
+    # Includes
+    include_global = ["cstdint", "vector"]
+    include_local = []
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
+    global_header_str = '\n'.join([f"#include<{h}>" for h in include_global])
+
+    # Variables
+    header_vars_map = {
+            'extern std::vector<std::vector<uint8_t>>': ['cases_x', 'cases_e', 'cases_m', 'cases_z']
+    }
+
+    header_vars_list = []
+    for k, v in header_vars_map.items():
+        for name in v:
+            header_vars_list.append(f"{k} {name};")
+    header_vars = "\n".join(header_vars_list)
+
+    contents = "\n".join([guard_begin,
+                               local_header_str, global_header_str, 
+                               header_vars,
+                               guard_end])
+    return contents
+
+
+if __name__ == '__main__':
+    c_file_name = "cases.cpp"
+    h_file_name = "cases.h"
+
+    c_file_contents = generate_cfile()
+    h_file_contents = generate_hfile()
+
+    with open(c_file_name, 'w') as f:
+      f.write(c_file_contents)
+    with open(h_file_name, 'w') as f:
+      f.write(h_file_contents)
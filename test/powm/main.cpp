@@ -0,0 +1,182 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/mont.h"
+#include "../testutils.h"
+}
+
+void preprocess_case(size_t case_id) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &e = cases_e[case_id];
+  std::vector<uint8_t> &m = cases_m[case_id];
+  // x, e, m in BE.
+  std::reverse(x.begin(), x.end());
+  std::reverse(e.begin(), e.end());
+  std::reverse(m.begin(), m.end());
+  // x, e, m in LE.
+}
+
+void postprocess_case(size_t case_id, std::vector<uint8_t> &result) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &e = cases_e[case_id];
+  std::vector<uint8_t> &m = cases_m[case_id];
+  // x, e, m, z_test in LE.
+  std::reverse(x.begin(), x.end());
+  std::reverse(e.begin(), e.end());
+  std::reverse(m.begin(), m.end());
+  std::reverse(result.begin(), result.end());
+  // x, e, m, z, z_test in BE.
+}
+
+void on_bad_rc(size_t case_id, int rc) {
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("Indeterminate test case: %lu.\n", case_id);
+  printf("\tError code %d returned.\n", rc);
+}
+
+void print_aligned(const char *label, std::vector<uint8_t> &v,
+                   size_t max_size) {
+  printf("\t\t%s: ", label);
+  for (int i = 0; i < max_size - v.size(); i++) {
+    printf("   ");
+  }
+  printhex_be(v.data(), v.size() * 8);
+  printf("\n");
+}
+
+void on_failure(size_t case_id, std::vector<uint8_t> &result) {
+  std::vector<uint8_t> x = cases_x[case_id];
+  std::vector<uint8_t> e = cases_e[case_id];
+  std::vector<uint8_t> m = cases_m[case_id];
+  std::vector<uint8_t> z = cases_z[case_id];
+
+  const size_t max_size = std::max({x.size(), e.size(), m.size()});
+
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\tComputing x^e mod m\n");
+  printf("\t\tx_size  : %lu\n", x.size());
+  printf("\t\te_size  : %lu\n", e.size());
+  printf("\t\tm_size  : %lu\n", m.size());
+  print_aligned("x       ", x, max_size);
+  print_aligned("e       ", e, max_size);
+  print_aligned("m       ", m, max_size);
+  printf("\tResults\n");
+  print_aligned("Expected", z, max_size);
+  print_aligned("Computed", result, max_size);
+}
+
+int run_testcase_powm(size_t case_id, size_t *duration) {
+  // Case.
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &e = cases_e[case_id];
+  std::vector<uint8_t> &m = cases_m[case_id];
+  std::vector<uint8_t> &z = cases_z[case_id];
+  // Test.
+  std::vector<uint8_t> z_test(z.size(), 0);
+
+  // 1. Preprocess
+  // 2. Trial
+  // 3. Postprocess
+  // 4. Report
+
+  preprocess_case(case_id);
+
+  jl_mont_ctx ctx;
+  int rc = mont_ctx_init(&ctx, m.data(), m.size());
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  uint8_t flags = 0;
+  if (rc == 0)
+    rc = powm_bstrings(&ctx, x.data(), e.data(), z_test.data(), &flags,
+                       x.size(), e.size(), z_test.size());
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       m.size()); // Normalize (ns per byte of modulus).
+
+  mont_ctx_free(&ctx);
+  postprocess_case(case_id, z_test);
+
+  if (rc) {
+    on_bad_rc(case_id, rc);
+    return -1;
+  }
+
+  bool success = z == z_test;
+  if (!success) {
+    on_failure(case_id, z_test);
+  }
+
+  return success;
+}
+
+void run_all_testcases_powm(const char *name) {
+  const size_t num_cases = std::max({cases_x.size(), cases_e.size(),
+                                     cases_m.size(), cases_z.size()});
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_powm(i, &duration);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    } else if (rc == 2) {
+      // ND.
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per byte processed: %lu\n", avg_duration);
+}
+
+int main() {
+  run_all_testcases_powm("powm_bstrings");
+
+  // An even modulus has no Montgomery form.
+  uint8_t even[1] = {10};
+  jl_mont_ctx ctx;
+  if (mont_ctx_init(&ctx, even, 1) != 3)
+    printf("Failed: even modulus not reported\n");
+
+  return 0;
+};
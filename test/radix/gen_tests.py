@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+
+# Run this in its directory to generate test cases.
+
+import random
+import os
+import sys
+
+DIGITS = "0123456789abcdefghijklmnopqrstuvwxyz"
+
+
+def to_list(r: int) -> str:
+    s = f"{r:X}"
+    if len(s) % 2 == 1:
+        s = '0' + s
+    l = [s[i:i + 2] for i in range(0,len(s),2)]
+    return f"{'{'}0x{', 0x'.join(l)}{'}'}"
+
+
+def to_digits(r: int, base: int) -> str:
+    if base == 10:
+        return str(r)
+    if r == 0:
+        return "0"
+    d = []
+    while r:
+        r, m = divmod(r, base)
+        d.append(DIGITS[m])
+    return ''.join(reversed(d))
+
+
+def case_str(x: int, base: int) -> tuple[str, str, str]:
+    return to_list(x), f"\"{to_digits(x, base)}\"", str(base)
+
+
+def generate_cfile() -> str:
+    cases = []
+
+    # Random decimal cases, short and long enough to split many times.
+    for i in range(150):
+        x_size = random.choice([random.randint(0, 64), random.randint(0, 4000)])
+        cases.append(case_str(random.randint(0, 256**x_size - 1), 10))
+
+    # Other bases.
+    for i in range(150):
+        x_size = random.randint(0, 1200)
+        base = random.randint(2, 36)
+        cases.append(case_str(random.randint(0, 256**x_size - 1), base))
+
+    # Powers of the base and their neighbours, where the digit count steps.
+    for base in [2, 3, 7, 10, 16, 36]:
+        for k in [1, 19, 20, 38, 600, 1217, 5000]:
+            for d in [-1, 0, 1]:
+                cases.append(case_str(max(base**k + d, 0), base))
+
+    # All ones.
+    for x_size in [1, 8, 9, 100, 1000, 3000]:
+        cases.append(case_str(256**x_size - 1, 10))
+
+    headers = ["string", "vector"]
+    local_headers = [h_file_name]
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in local_headers])
+    header_str = '\n'.join([f"#include<{h}>" for h in headers])
+
+    outputs = []
+    for j, (casetype, name) in enumerate(
+            [("std::vector<std::vector<uint8_t>>", "cases_x"),
+             ("std::vector<std::string>", "cases_s"),
+             ("std::vector<unsigned>", "cases_base")]):
+        cl = ',\n'.join([c[j] for c in cases])
+        outputs.append(f"{casetype} {name} = {'{'}{cl}{'};'}")
+
+    contents = '\n'.join([local_header_str, header_str] + outputs)
+    return contents
+
+
+def generate_hfile() -> str:
+    # Guard
+    header_gaurd = "__JL_TESTRADIX_CASES_H__"
+    guard_begin = f"#ifndef {header_gaurd}"  + "\n" + f"#define {header_gaurd}"
+    guard_end = "#endif"
+
+    # Includes
+    include_global = ["cstdint", "string", "vector"]
+    include_local = []
+
+    local_header_str = '\n'.join([f"#include\"{lh}\"" for lh in include_local])
+    global_header_str = '\n'.join([f"#include<{h}>" for h in include_global])
+
+    # Variables
+    header_vars_map = {
+            'extern std::vector<std::vector<uint8_t>>': ['cases_x'],
+            'extern std::vector<std::string>': ['cases_s'],
+            'extern std::vector<unsigned>': ['cases_base'],
+    }
+
+    header_vars_list = []
+    for k, v in header_vars_map.items():
+        for name in v:
+            header_vars_list.append(f"{k} {name};")
+    header_vars = "\n".join(header_vars_list)
+
+    contents = "\n".join([guard_begin,
+                               local_header_str, global_header_str, 
+                               header_vars,
+                               guard_end])
+    return contents
+
+
+if __name__ == '__main__':
+    if hasattr(sys, "set_int_max_str_digits"):
+        sys.set_int_max_str_digits(0)
+
+    c_file_name = "cases.cpp"
+    h_file_name = "cases.h"
+
+    c_file_contents = generate_cfile()
+    h_file_contents = generate_hfile()
+
+    with open(c_file_name, 'w') as f:
+      f.write(c_file_contents)
+    with open(h_file_name, 'w') as f:
+      f.write(h_file_contents)
@@ -0,0 +1,196 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../../src/radix.h"
+#include "../testutils.h"
+}
+
+void preprocess_case(size_t case_id) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  // x in BE.
+  std::reverse(x.begin(), x.end());
+  // x in LE.
+}
+
+void postprocess_case(size_t case_id) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  // x in LE.
+  std::reverse(x.begin(), x.end());
+  // x in BE.
+}
+
+void on_bad_rc(size_t case_id, int rc) {
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("Indeterminate test case: %lu.\n", case_id);
+  printf("\tError code %d returned.\n", rc);
+}
+
+void on_failure(size_t case_id, const std::string &s_test,
+                std::vector<uint8_t> &x_test) {
+  std::vector<uint8_t> x = cases_x[case_id];
+  std::string &s = cases_s[case_id];
+
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\tConverting in base %u\n", cases_base[case_id]);
+  printf("\t\tx_size  : %lu\n", x.size());
+  printf("\t\ts_len   : %lu\n", s.size());
+  printf("\t\tx       : ");
+  printhex_be(x.data(), x.size() * 8);
+  printf("\n");
+  printf("\t\ts       : %s\n", s.c_str());
+  printf("\tResults\n");
+  printf("\t\tComputed: %s\n", s_test.c_str());
+  printf("\t\tComputed: ");
+  std::reverse(x_test.begin(), x_test.end());
+  printhex_be(x_test.data(), x_test.size() * 8);
+  printf("\n");
+}
+
+int run_testcase_radix(size_t case_id, size_t *duration, bool use_arena) {
+  // Case.
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::string &s = cases_s[case_id];
+  unsigned base = cases_base[case_id];
+  // Test.
+  std::vector<char> s_test(to_base_size(x.size(), base), 0);
+  std::vector<uint8_t> x_test(x.size(), 0);
+
+  // 1. Preprocess
+  // 2. Trial
+  // 3. Postprocess
+  // 4. Report
+
+  preprocess_case(case_id);
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  size_t s_len = 0;
+  uint8_t flags = 0;
+  int rc;
+  if (use_arena) {
+    // Exactly the larger of the two itches, which must all be given back
+    // (error code 5 if not).
+    const size_t itch = std::max(to_base_itch(x.size(), base),
+                                 from_base_itch(s.size(), base));
+    std::vector<jl_limb_t> buf(itch / sizeof(jl_limb_t) + 1);
+    jl_arena arena;
+    arena_init(&arena, buf.data(), itch);
+    rc = to_base_arena(x.data(), s_test.data(), &s_len, x.size(),
+                       s_test.size(), base, &arena);
+    if (rc == 0)
+      rc = from_base_arena(s.data(), x_test.data(), &flags, s.size(),
+                           x_test.size(), base, &arena);
+    if (rc == 0 && arena.used != 0)
+      rc = 5;
+  } else {
+    rc = to_base(x.data(), s_test.data(), &s_len, x.size(), s_test.size(),
+                 base);
+    if (rc == 0)
+      rc = from_base(s.data(), x_test.data(), &flags, s.size(), x_test.size(),
+                     base);
+  }
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       s.size()); // Normalize (ns per digit).
+
+  postprocess_case(case_id);
+
+  if (rc) {
+    on_bad_rc(case_id, rc);
+    return -1;
+  }
+
+  std::reverse(x_test.begin(), x_test.end());
+  const std::string s_str(s_test.data(), s_len);
+  bool success = s_str == s && x_test == x && flags == 0;
+  if (!success) {
+    std::reverse(x_test.begin(), x_test.end());
+    on_failure(case_id, s_str, x_test);
+  }
+
+  return success;
+}
+
+void run_all_testcases_radix(const char *name, bool use_arena) {
+  const size_t num_cases =
+      std::max({cases_x.size(), cases_s.size(), cases_base.size()});
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_radix(i, &duration, use_arena);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    } else if (rc == 2) {
+      // ND.
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per digit processed: %lu\n", avg_duration);
+}
+
+int main() {
+  run_all_testcases_radix("to_base/from_base", false);
+  run_all_testcases_radix("to_base_arena/from_base_arena", true);
+
+  // Split down to the smallest blocks, so the recursion runs on every case.
+  const size_t threshold = get_radix_dc_threshold();
+  set_radix_dc_threshold(2);
+  run_all_testcases_radix("to_base/from_base (threshold 2)", false);
+  run_all_testcases_radix("to_base_arena/from_base_arena (threshold 2)", true);
+  set_radix_dc_threshold(threshold);
+
+  // Bad digits, and an output buffer that's too small.
+  uint8_t z[8];
+  uint8_t flags;
+  if (from_decimal("12a4", z, &flags, 4, sizeof(z)) != 3)
+    printf("Failed: bad digit not reported\n");
+  char s[4];
+  size_t s_len = 0;
+  const uint8_t x[2] = {0x10, 0x27}; // 10000.
+  if (to_decimal(x, s, &s_len, sizeof(x), sizeof(s)) != 4 || s_len != 5)
+    printf("Failed: short buffer not reported\n");
+
+  return 0;
+};
@@ -0,0 +1,207 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/jl_int.h"
+#include "../../src/root.h"
+#include "../testutils.h"
+}
+
+// Roots checked by their defining bounds, z^k <= |x| < (z + 1)^k, on random
+// operands, on perfect powers and their neighbours, where Newton's iteration
+// has to stop exactly, and on degrees from 2 up to past the size of x.
+
+static uint64_t rnd_state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+static void random_int(jl_int *z, size_t size) {
+  std::vector<uint8_t> x(size);
+  for (size_t i = 0; i < size; i++)
+    x[i] = (uint8_t)rnd();
+  if (size > 0 && rnd() % 4 == 0)
+    memset(x.data(), rnd() % 2 ? 0xFF : 0, rnd() % size);
+  int_set_bstring(z, x.data(), 0, size);
+}
+
+static void power(jl_int *z, const jl_int *x, uint64_t k) {
+  int_set_u64(z, 1);
+  for (uint64_t i = 0; i < k; i++)
+    int_mul(z, z, x);
+}
+
+// z^k <= |x| < (z + 1)^k.
+static bool is_root(const jl_int *z, const jl_int *x, uint64_t k) {
+  jl_int a, p, one, w;
+  int_init(&a);
+  int_init(&p);
+  int_init(&one);
+  int_init(&w);
+  int_abs(&a, x);
+  bool ok = int_sgn(z) == int_sgn(x) || z->n == 0;
+  int_abs(&w, z);
+  power(&p, &w, k);
+  ok &= int_cmp(&p, &a) <= 0;
+  int_set_u64(&one, 1);
+  int_add(&w, &w, &one);
+  power(&p, &w, k);
+  ok &= int_cmp(&p, &a) > 0;
+  int_free(&a);
+  int_free(&p);
+  int_free(&one);
+  int_free(&w);
+  return ok;
+}
+
+static bool check(const jl_int *x, uint64_t k) {
+  jl_int z, r, t;
+  int_init(&z);
+  int_init(&r);
+  int_init(&t);
+  bool ok = int_root(&z, x, k) == 0 && is_root(&z, x, k);
+
+  if (k == 2 && !x->neg) {
+    // s^2 + r = x, and the root alone is the same.
+    ok &= int_sqrtrem(&z, &r, x) == 0 && is_root(&z, x, 2);
+    int_mul(&t, &z, &z);
+    int_add(&t, &t, &r);
+    ok &= int_cmp(&t, x) == 0 && !r.neg;
+    ok &= int_sqrt(&t, x) == 0 && int_cmp(&t, &z) == 0;
+  }
+
+  int_free(&z);
+  int_free(&r);
+  int_free(&t);
+  return ok;
+}
+
+static bool run_testcase(size_t i) {
+  static const uint64_t degrees[] = {2, 2, 2, 3, 4, 5, 7, 16, 64, 100, 1000};
+  const uint64_t k = degrees[rnd() % (sizeof degrees / sizeof degrees[0])];
+  const size_t max_size = i % 4 == 0 ? 4000 : 300;
+
+  jl_int x, y, one;
+  int_init(&x);
+  int_init(&y);
+  int_init(&one);
+  int_set_u64(&one, 1);
+  bool ok = true;
+  if (i % 2 == 0) {
+    random_int(&x, rnd() % max_size);
+    if (k % 2 == 1 && rnd() % 2 == 0)
+      int_neg(&x, &x);
+    ok &= check(&x, k);
+  } else {
+    // y^k - 1, y^k and y^k + 1, for y > 0.
+    random_int(&y, 1 + rnd() % (max_size / k + 1));
+    int_add(&y, &y, &one);
+    power(&x, &y, k);
+    ok &= check(&x, k);
+    int_sub(&y, &x, &one);
+    ok &= check(&y, k);
+    int_add(&y, &x, &one);
+    ok &= check(&y, k);
+  }
+
+  // Outputs that are also inputs.
+  int_abs(&x, &x);
+  int_root(&y, &x, k);
+  ok &= int_root(&x, &x, k) == 0 && int_cmp(&x, &y) == 0;
+
+  int_free(&x);
+  int_free(&y);
+  int_free(&one);
+  return ok;
+}
+
+static bool run_small_cases() {
+  jl_int x, z, one;
+  int_init(&x);
+  int_init(&z);
+  int_init(&one);
+  int_set_u64(&one, 1);
+  bool ok = true;
+
+  for (uint64_t v = 0; v < 2000; v++) {
+    int_set_u64(&x, v);
+    for (uint64_t k = 2; k < 12; k++)
+      ok &= check(&x, k);
+  }
+  int_set_u64(&x, UINT64_MAX);
+  ok &= check(&x, 2) && check(&x, 3);
+  ok &= int_root(&z, &x, UINT64_MAX) == 0 && int_cmp(&z, &one) == 0;
+
+  int_set_i64(&x, -27);
+  ok &= int_root(&z, &x, 3) == 0 && int_sgn(&z) == -1 &&
+        int_limbs(&z)[0] == 3;
+  ok &= int_root(&z, &x, 2) == 3 && int_sqrt(&z, &x) == 3 &&
+        int_root(&z, &x, 0) == 3;
+  ok &= int_root(&z, &x, 1) == 0 && int_cmp(&z, &x) == 0;
+
+  // 1000000 = 1000^2, 100^3.
+  const uint8_t a[] = {0x40, 0x42, 0x0F};
+  uint8_t s[2], r[2], flags;
+  ok &= sqrtrem_bstrings(a, s, r, &flags, 3, 2, 2) == 0 && flags == 0 &&
+        s[0] == 0xE8 && s[1] == 0x03 && r[0] == 0 && r[1] == 0;
+  ok &= sqrtrem_bstrings(a, s, r, &flags, 2, 1, 1) == 0 && flags == 0 &&
+        s[0] == 0x82 && r[0] == 0x3C;
+  ok &= sqrtrem_bstrings(a, s, NULL, &flags, 3, 1, 0) == 0 && flags == 1 &&
+        s[0] == 0xE8;
+  ok &= root_bstrings(a, s, &flags, 3, 3, 2) == 0 && flags == 0 &&
+        s[0] == 100 && s[1] == 0;
+  ok &= root_bstrings(a, s, &flags, 0, 3, 2) == 3;
+
+  ok &= int_sqrtrem(NULL, &z, &x) == 1 && int_root(&z, NULL, 2) == 1 &&
+        sqrtrem_bstrings(a, NULL, r, &flags, 3, 2, 2) == 1 &&
+        root_bstrings(NULL, s, &flags, 3, 3, 2) == 1;
+
+  int_free(&x);
+  int_free(&z);
+  int_free(&one);
+  return ok;
+}
+
+int main() {
+  const size_t num_cases = 200;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"int_root\"\n");
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (run_testcase(i))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+
+  if (!run_small_cases()) {
+    passed--;
+    printf("Failed small cases and error checks.\n");
+  }
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+
+  return 0;
+}
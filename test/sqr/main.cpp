@@ -0,0 +1,221 @@
+#include "cases.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/mul_par.h"
+#include "../../src/ntt.h"
+#include "../../src/pool.h"
+#include "../../src/toom.h"
+#include "../testutils.h"
+}
+
+void preprocess_case(size_t case_id) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  // x in BE.
+  std::reverse(x.begin(), x.end());
+  // x in LE.
+}
+
+void postprocess_case(size_t case_id, std::vector<uint8_t> &result) {
+  std::vector<uint8_t> &x = cases_x[case_id];
+  // x in LE.
+  // z_test in LE.
+  std::reverse(x.begin(), x.end());
+  // x, z in BE.
+  // z_test in LE.
+  std::reverse(result.begin(), result.end());
+  // x, z, z_test in BE.
+}
+
+void on_bad_rc(size_t case_id, int rc) {
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("Indeterminate test case: %lu.\n", case_id);
+  printf("\tError code %d returned.\n", rc);
+}
+
+void on_failure(size_t case_id, std::vector<uint8_t> &result) { // Cases data.
+  std::vector<uint8_t> x = cases_x[case_id];
+  std::vector<uint8_t> z = cases_z[case_id];
+
+  const size_t max_size = std::max({x.size(), z.size(), result.size()});
+
+  printf("\n");
+  printf("Failed test case %d.\n", (int)case_id);
+  printf("\tSquaring x\n");
+  printf("\t\tx_size  : %lu\n", x.size());
+  printf("\t\tz_size  : %lu\n", z.size());
+  printf("\t\tx       : ");
+  for (int i = 0; i < max_size - x.size(); i++) {
+    printf("   ");
+  }
+  printhex_be(x.data(), x.size() * 8);
+  printf("\n\tResults\n");
+  printf("\t\tExpected: ");
+  for (int i = 0; i < max_size - z.size(); i++) {
+    printf("   ");
+  }
+  printhex_be(z.data(), z.size() * 8);
+  printf("\n");
+  printf("\t\tComputed: ");
+  for (int i = 0; i < max_size - result.size(); i++) {
+    printf("   ");
+  }
+  printhex_be(result.data(), result.size() * 8);
+  printf("\n");
+}
+
+typedef uint8_t (*sqr_fn)(const uint8_t *, uint8_t *, uint8_t *, size_t,
+                          size_t);
+
+int run_testcase_sqr(size_t case_id, size_t *duration, sqr_fn sqr) {
+  // Case.
+  std::vector<uint8_t> &x = cases_x[case_id];
+  std::vector<uint8_t> &z = cases_z[case_id];
+  // Test.
+  std::vector<uint8_t> z_test(z.size(), 0);
+
+  // 1. Preprocess
+  // 2. Trial
+  // 3. Postprocess
+  // 4. Report
+
+  preprocess_case(case_id);
+
+  // Start stopclock.
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  uint8_t flags = 0;
+  int rc = sqr(x.data(), z_test.data(), &flags, x.size(), z_test.size());
+
+  // End stopclock and get duration.
+  auto t2 = std::chrono::high_resolution_clock::now();
+  *duration =
+      (std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+       z.size()); // Normalize (ns per byte processed).
+
+  postprocess_case(case_id, z_test);
+
+  if (rc) {
+    on_bad_rc(case_id, rc);
+    return -1;
+  }
+
+  bool success = z == z_test;
+  if (!success) {
+    on_failure(case_id, z_test);
+  }
+
+  return success;
+}
+
+void run_all_testcases_sqr(const char *name, sqr_fn sqr) {
+  const size_t num_cases = std::max({cases_x.size(), cases_z.size()});
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  int failed = 0;
+  size_t duration = 0;
+  size_t total_duration = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    int rc = run_testcase_sqr(i, &duration, sqr);
+    total_duration += duration;
+    if (rc == 1)
+      passed++;
+    else if (rc == 0) {
+      failed++;
+    } else if (rc == 2) {
+      // ND.
+    }
+  }
+
+  size_t avg_duration = total_duration / num_cases;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %d / %lu\n", failed, num_cases);
+  printf("\tNdeter: %lu / %lu\n", num_cases - passed - failed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per byte processed: %lu\n", avg_duration);
+}
+
+// mul_bstrings(x, x, ...) goes through sqr_limbs too, by way of mul_limbs.
+uint8_t sqr_via_mul(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                    size_t x_size, size_t z_size) {
+  return mul_bstrings(x, x, z, flags, x_size, x_size, z_size);
+}
+
+// Runs sqr_bstrings_arena in an arena of exactly sqr_bstrings_itch bytes, which
+// must be enough, and must all be given back (error code 5 if not).
+uint8_t sqr_via_arena(const uint8_t *x, uint8_t *z, uint8_t *flags,
+                      size_t x_size, size_t z_size) {
+  const size_t itch = sqr_bstrings_itch(x_size);
+  std::vector<jl_limb_t> buf(itch / sizeof(jl_limb_t) + 1);
+  jl_arena arena;
+  arena_init(&arena, buf.data(), itch);
+  uint8_t rc = sqr_bstrings_arena(x, z, flags, x_size, z_size, &arena);
+  if (rc == 0 && arena.used != 0)
+    rc = 5;
+  return rc;
+}
+
+int main() {
+  run_all_testcases_sqr("sqr_bstrings_basecase", sqr_bstrings_basecase);
+  run_all_testcases_sqr("sqr_bstrings", sqr_bstrings);
+  run_all_testcases_sqr("mul_bstrings (x, x)", sqr_via_mul);
+  run_all_testcases_sqr("sqr_bstrings_arena", sqr_via_arena);
+
+  // Push every squaring tier down onto the test sizes.
+  set_sqr_karatsuba_threshold(2);
+  set_mul_toom3_threshold(8);
+  set_mul_toom4_threshold(16);
+  set_mul_ntt_threshold(JL_MUL_NTT_MIN_LIMBS);
+  run_all_testcases_sqr("sqr_bstrings (low thresholds)", sqr_bstrings);
+  run_all_testcases_sqr("sqr_bstrings_arena (low thresholds)", sqr_via_arena);
+  set_sqr_karatsuba_threshold(JL_SQR_KARATSUBA_THRESHOLD);
+  set_mul_toom3_threshold(JL_MUL_TOOM3_THRESHOLD);
+  set_mul_toom4_threshold(JL_MUL_TOOM4_THRESHOLD);
+  set_mul_ntt_threshold(JL_MUL_NTT_THRESHOLD);
+
+  // Split the same squares into tasks on a pool, down to two limbs.
+  set_pool_threads(4);
+  set_mul_par_grain(2);
+  set_mul_ntt_threshold(JL_MUL_NTT_MIN_LIMBS);
+  run_all_testcases_sqr("sqr_bstrings (4 threads)", sqr_bstrings);
+  run_all_testcases_sqr("sqr_bstrings_arena (4 threads)", sqr_via_arena);
+  set_mul_ntt_threshold(JL_MUL_NTT_THRESHOLD);
+  set_mul_par_grain(JL_MUL_PAR_GRAIN);
+  set_pool_threads(0);
+
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t res = 0;
+    uint8_t flags = 0;
+    sqr_bstrings((uint8_t *)&i, (uint8_t *)&res, &flags, 1, 2);
+    uint16_t expected = i * i;
+    if (res - expected)
+      printf("Failed: %x\n", i);
+  }
+
+  return 0;
+};
@@ -0,0 +1,192 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../../src/mul_par.h"
+#include "../../src/pool.h"
+#include "../../src/stream.h"
+#include "../testutils.h"
+}
+
+// The file operations against the byte-string ones on the same values, with
+// the chunk size set small enough that carries and borrows cross many chunk
+// boundaries, and operands that end on a boundary, just past one, or are
+// empty.
+
+static uint64_t rnd_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+// A length near a multiple of the chunk size, or anything up to max_size.
+static size_t random_size(size_t max_size) {
+  const size_t chunk = get_stream_chunk();
+  switch (rnd() % 4) {
+  case 0:
+    return chunk * (rnd() % (max_size / chunk + 1));
+  case 1:
+    return chunk * (rnd() % (max_size / chunk + 1)) + 1;
+  default:
+    return rnd() % (max_size + 1);
+  }
+}
+
+// Random bytes, or all ones, to carry (or borrow) the whole way.
+static std::vector<uint8_t> random_bytes(size_t size) {
+  std::vector<uint8_t> x(size);
+  const bool ones = rnd() % 4 == 0;
+  for (size_t i = 0; i < size; i++)
+    x[i] = ones ? 0xFF : (uint8_t)rnd();
+  return x;
+}
+
+static FILE *file_of(const std::vector<uint8_t> &x) {
+  FILE *f = tmpfile();
+  if (!x.empty())
+    fwrite(x.data(), 1, x.size(), f);
+  rewind(f);
+  return f;
+}
+
+static std::vector<uint8_t> contents(FILE *f) {
+  std::vector<uint8_t> x;
+  rewind(f);
+  int c;
+  while ((c = fgetc(f)) != EOF)
+    x.push_back((uint8_t)c);
+  return x;
+}
+
+static bool run_testcase_add_sub(size_t max_size) {
+  std::vector<uint8_t> x = random_bytes(random_size(max_size));
+  std::vector<uint8_t> y = random_bytes(random_size(max_size));
+  const int sub = rnd() % 2;
+  const size_t n = x.size() > y.size() ? x.size() : y.size();
+
+  std::vector<uint8_t> expected(n + 1);
+  uint8_t expected_flags;
+  uint8_t dummy = 0;
+  const uint8_t *xp = x.empty() ? &dummy : x.data();
+  const uint8_t *yp = y.empty() ? &dummy : y.data();
+  if (sub)
+    sub_bstrings(xp, yp, expected.data(), &expected_flags, x.size(), y.size(),
+                 n);
+  else
+    add_bstrings(xp, yp, expected.data(), &expected_flags, x.size(), y.size(),
+                 n);
+  expected.resize(n);
+
+  FILE *xf = file_of(x), *yf = file_of(y), *zf = tmpfile();
+  uint8_t flags;
+  uint64_t z_size;
+  const uint8_t rc = sub ? sub_files(xf, yf, zf, &flags, &z_size)
+                         : add_files(xf, yf, zf, &flags, &z_size);
+  const bool ok = rc == 0 && z_size == n && contents(zf) == expected &&
+                  (flags & 1) == (expected_flags & 1);
+  fclose(xf);
+  fclose(yf);
+  fclose(zf);
+  return ok;
+}
+
+static bool run_testcase_mul(size_t max_size) {
+  std::vector<uint8_t> x = random_bytes(random_size(max_size));
+  std::vector<uint8_t> y = random_bytes(rnd() % (max_size / 4 + 1));
+  const size_t n = x.size() + y.size();
+
+  std::vector<uint8_t> expected(n + 1);
+  uint8_t flags;
+  uint8_t dummy = 0;
+  mul_bstrings(x.empty() ? &dummy : x.data(), y.empty() ? &dummy : y.data(),
+               expected.data(), &flags, x.size(), y.size(), n);
+  expected.resize(n);
+
+  FILE *xf = file_of(x), *zf = tmpfile();
+  uint64_t z_size;
+  const uint8_t rc = mul_file_bstring(xf, y.empty() ? &dummy : y.data(), zf,
+                                      y.size(), &z_size);
+  const bool ok = rc == 0 && z_size == n && contents(zf) == expected;
+  fclose(xf);
+  fclose(zf);
+  return ok;
+}
+
+// A 38-limb y by 144-limb chunks and a 97-limb last chunk on the pool, whose
+// scratch needs more than a whole chunk's.
+static bool run_testcase_mul_short_last(size_t) {
+  const size_t chunk = get_stream_chunk();
+  set_stream_chunk(144 * 8);
+  std::vector<uint8_t> x = random_bytes((144 + 97) * 8);
+  std::vector<uint8_t> y = random_bytes(38 * 8);
+  const size_t n = x.size() + y.size();
+  std::vector<uint8_t> expected(n);
+  uint8_t flags;
+  mul_bstrings(x.data(), y.data(), expected.data(), &flags, x.size(),
+               y.size(), n);
+
+  FILE *xf = file_of(x), *zf = tmpfile();
+  uint64_t z_size;
+  const uint8_t rc = mul_file_bstring(xf, y.data(), zf, y.size(), &z_size);
+  const bool ok = rc == 0 && z_size == n && contents(zf) == expected;
+  fclose(xf);
+  fclose(zf);
+  set_stream_chunk(chunk);
+  return ok;
+}
+
+static void run_all_testcases(const char *name, bool (*run)(size_t)) {
+  const size_t num_cases = 600;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  const size_t chunk = get_stream_chunk();
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    // Chunks of 8 to 64 bytes, then the default with operands inside one.
+    set_stream_chunk(i % 3 == 2 ? chunk : 8 << (i % 4));
+    if (run(i % 3 == 2 ? 3000 : 600))
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+  set_stream_chunk(chunk);
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+}
+
+int main() {
+  run_all_testcases("add_files/sub_files", run_testcase_add_sub);
+  run_all_testcases("mul_file_bstring", run_testcase_mul);
+
+  // The chunk products split into tasks on a pool, down to two limbs.
+  set_pool_threads(4);
+  set_mul_par_grain(2);
+  run_all_testcases("mul_file_bstring (4 threads)", run_testcase_mul);
+  run_all_testcases("mul_file_bstring (4 threads, short last chunk)",
+                    run_testcase_mul_short_last);
+  set_mul_par_grain(JL_MUL_PAR_GRAIN);
+  set_pool_threads(0);
+  return 0;
+}
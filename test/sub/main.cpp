@@ -8,7 +8,9 @@
 #include <vector>
 
 extern "C" {
+#include "../../src/add_par.h"
 #include "../../src/add_sub_mul.h"
+#include "../../src/pool.h"
 #include "../testutils.h"
 }
 
@@ -109,7 +111,7 @@ int run_testcase_sub(size_t case_id, size_t *duration) {
   return success;
 }
 
-void run_all_testcases_sub() {
+void run_all_testcases_sub(const char *name) {
   const size_t num_cases =
       std::max({cases_x.size(), cases_y.size(), cases_z.size()});
 
@@ -118,7 +120,7 @@ void run_all_testcases_sub() {
     printf("=");
   printf("\n");
   printf("TESTING\n");
-  printf("\tFunction: \"sub_bstrings\"\n");
+  printf("\tFunction: \"%s\"\n", name);
   for (int i = 0; i < 72; i++)
     printf("-");
   printf("\n");
@@ -153,6 +155,31 @@ void run_all_testcases_sub() {
 }
 
 int main() {
-  run_all_testcases_sub();
+  run_all_testcases_sub("sub_bstrings");
+
+  // Cut every borrow chain into limb-sized chunks on a pool.
+  set_pool_threads(4);
+  set_add_par_grain(8);
+  run_all_testcases_sub("sub_bstrings (4 threads)");
+
+  // A borrow that has to run through every chunk: both operands as long, so
+  // that the whole chain goes through sub_bytes_par, stopping at the top byte
+  // or running out of it.
+  std::vector<uint8_t> x(4099, 0), y(x.size(), 0);
+  y[0] = 1;
+  for (uint8_t top = 0; top < 2; top++) {
+    x.back() = top ? 0x80 : 0;
+    std::vector<uint8_t> z(x.size(), 0xAA);
+    uint8_t flags = 0;
+    sub_bstrings(x.data(), y.data(), z.data(), &flags, x.size(), y.size(),
+                 z.size());
+    if ((flags & 1) != !top || z.back() != (top ? 0x7F : 0xFF) ||
+        std::count(z.begin(), z.end() - 1, 0xFF) != (long)x.size() - 1)
+      printf("Failed: sub_bstrings (4 threads) borrow through %zu bytes\n",
+             x.size());
+  }
+  set_add_par_grain(JL_ADD_PAR_GRAIN);
+  set_pool_threads(0);
+
   return 0;
 };
@@ -0,0 +1,175 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+#include "../../src/add_sub_mul.h"
+#include "../testutils.h"
+}
+#include "../../src/jl_uint.hpp"
+
+// jl::uint<Bits> against the C byte-string functions on the same bytes: every
+// result and flag should match add_bstrings, sub_bstrings and mul_bstrings
+// called with Bits / 8 byte operands.
+
+// Evaluated by the compiler.
+constexpr jl::uint128 c_max = jl::uint128(0) - jl::uint128(1);
+static_assert(c_max.limb[0] == ~0ull && c_max.limb[1] == ~0ull, "sub");
+static_assert((c_max + jl::uint128(1)) == jl::uint128(0), "add");
+static_assert((c_max * c_max) == jl::uint128(1), "mul");
+static_assert(jl::mul_wide(c_max, c_max).limb[2] == ~0ull - 1, "mul_wide");
+static_assert(jl::uint256(3) < jl::uint256(4) && !(c_max < c_max), "<");
+static_assert(jl::cmp(jl::uint128(5), c_max) == -1, "cmp");
+
+static uint64_t rnd_state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t rnd() {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+// Random bytes, or one of the patterns carries like: all ones, zero, a single
+// low or high limb.
+static void fill(uint8_t *x, size_t size) {
+  const unsigned kind = rnd() % 6;
+  for (size_t i = 0; i < size; i++) {
+    switch (kind) {
+    case 0:
+      x[i] = 0xFF;
+      break;
+    case 1:
+      x[i] = 0;
+      break;
+    case 2:
+      x[i] = i < 8 ? (uint8_t)rnd() : 0;
+      break;
+    case 3:
+      x[i] = i + 8 >= size ? (uint8_t)rnd() : 0;
+      break;
+    default:
+      x[i] = (uint8_t)rnd();
+    }
+  }
+}
+
+template <size_t Bits> static bool run_testcase_uint() {
+  typedef jl::uint<Bits> U;
+  const size_t n = U::bytes;
+  uint8_t x[n], y[n], z[n], w[2 * n], t[2 * n];
+  fill(x, n);
+  fill(y, n);
+  const U a = U::from_bytes(x, n);
+  const U b = U::from_bytes(y, n);
+  bool ok = true;
+
+  U c;
+  uint8_t flags = 0;
+  uint8_t f = jl::add(c, a, b);
+  add_bstrings(x, y, z, &flags, n, n, n);
+  c.to_bytes(t, n);
+  ok &= f == flags && memcmp(t, z, n) == 0;
+
+  f = jl::sub(c, a, b);
+  sub_bstrings(x, y, z, &flags, n, n, n);
+  c.to_bytes(t, n);
+  ok &= f == flags && memcmp(t, z, n) == 0;
+
+  f = jl::mul(c, a, b);
+  mul_bstrings(x, y, z, &flags, n, n, n);
+  c.to_bytes(t, n);
+  ok &= f == flags && memcmp(t, z, n) == 0;
+
+  mul_bstrings(x, y, w, &flags, n, n, 2 * n);
+  jl::mul_wide(a, b).to_bytes(t, 2 * n);
+  ok &= memcmp(t, w, 2 * n) == 0;
+
+  // Compare through the sign of x - y.
+  sub_bstrings(x, y, z, &flags, n, n, n);
+  bool zero = true;
+  for (size_t i = 0; i < n; i++)
+    zero &= z[i] == 0;
+  const int expected = flags ? -1 : zero ? 0 : 1;
+  ok &= jl::cmp(a, b) == expected && (a < b) == (expected < 0) &&
+        (a == b) == (expected == 0) && (a >= b) == (expected >= 0);
+
+  // Bytes past the value read as zero, and are written as zero.
+  w[n] = 0xAB;
+  ok &= U::from_bytes(w, n + 1) == U::from_bytes(w, n);
+  a.to_bytes(t, n + 3);
+  ok &= t[n] == 0 && t[n + 2] == 0;
+
+  return ok;
+}
+
+template <size_t Bits> static void run_all_testcases_uint(const char *name) {
+  const size_t num_cases = 2000;
+
+  printf("\n");
+  for (int i = 0; i < 72; i++)
+    printf("=");
+  printf("\n");
+  printf("TESTING\n");
+  printf("\tFunction: \"%s\"\n", name);
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+
+  int passed = 0;
+  for (size_t i = 0; i < num_cases; i++) {
+    if (run_testcase_uint<Bits>())
+      passed++;
+    else
+      printf("Failed test case %d.\n", (int)i);
+  }
+
+  // A chain of dependent products, in registers and through the C path.
+  typedef jl::uint<Bits> U;
+  const size_t reps = 100000;
+  U a(rnd() | 1), b(rnd() | 1);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < reps; i++)
+    a = a * b + b;
+  auto t2 = std::chrono::high_resolution_clock::now();
+  uint8_t x[U::bytes], y[U::bytes], z[U::bytes], flags;
+  a.to_bytes(x, U::bytes);
+  b.to_bytes(y, U::bytes);
+  for (size_t i = 0; i < reps; i++) {
+    mul_bstrings(x, y, z, &flags, U::bytes, U::bytes, U::bytes);
+    add_bstrings(z, y, x, &flags, U::bytes, U::bytes, U::bytes);
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+  volatile uint64_t sink = a.limb[0] + x[0];
+  (void)sink;
+
+  for (int i = 0; i < 72; i++)
+    printf("-");
+  printf("\n");
+  printf("RESULTS\n");
+  printf("\tPassed: %d / %lu\n", passed, num_cases);
+  printf("\tFailed: %lu / %lu\n", num_cases - passed, num_cases);
+  printf("\n");
+  printf("\tAvg. ns per a * b + b: %lu (byte strings: %lu)\n",
+         (unsigned long)(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             t2 - t1)
+                             .count() /
+                         reps),
+         (unsigned long)(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             t3 - t2)
+                             .count() /
+                         reps));
+}
+
+int main() {
+  run_all_testcases_uint<64>("jl::uint<64>");
+  run_all_testcases_uint<128>("jl::uint<128>");
+  run_all_testcases_uint<192>("jl::uint<192>");
+  run_all_testcases_uint<256>("jl::uint<256>");
+  run_all_testcases_uint<512>("jl::uint<512>");
+  return 0;
+}